@@ -0,0 +1,222 @@
+/*
+* aho_corasick.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a multi-pattern matcher: Aho-Corasick automaton compiled to a flat DFA
+* - Aho and Corasick, "Efficient string matching", CACM 18(6), 1975
+* - bytes are mapped to classes first: all bytes that occur in no pattern share class 0
+* - transitions are one contiguous table, a row per state and a column per class
+* - each table entry holds the offset of the next state's row, so the scan loop is a
+*   single load per byte; the top bit of an entry marks states that have matches
+* - empty patterns are ignored: they never match
+*/
+
+#ifndef SIGCPP_AHO_CORASICK_H
+#define SIGCPP_AHO_CORASICK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "array.h"
+#include "string_view.h"
+
+namespace sigcpp
+{
+	class aho_corasick
+	{
+	public:
+		using size_type = std::size_t;
+
+		//a match of pattern number pattern starting at position in the text
+		struct match
+		{
+			size_type pattern;
+			size_type position;
+		};
+
+		//ctors
+		aho_corasick() { _compile({}); }
+
+		aho_corasick(std::initializer_list<string_view> patterns) : aho_corasick(patterns.begin(), patterns.end()) {}
+
+		//range of any type convertible to string_view
+		template<typename InputIt>
+		aho_corasick(InputIt first, InputIt last)
+		{
+			std::vector<string_view> patterns;
+			for (; first != last; ++first)
+				patterns.push_back(string_view(*first));
+			_compile(patterns);
+		}
+
+		//capacity
+		size_type pattern_count() const noexcept { return lengths_.size(); }
+		size_type state_count() const noexcept { return dict_.size(); }
+		size_type class_count() const noexcept { return classes_; }
+
+		//call f(match) for every match in the text, in order of the match's end position
+		//matches that end at the same position are reported longest first
+		template<typename F>
+		void for_each_match(string_view text, F f) const
+		{
+			const auto* const delta = delta_.data();
+			std::uint32_t entry = 0;
+			for (size_type i = 0, n = text.size(); i < n; ++i) {
+				entry = delta[(entry & row_mask) + class_of_[static_cast<unsigned char>(text[i])]];
+				if (entry & match_flag)
+					_report((entry & row_mask) / classes_, i + 1, f);
+			}
+		}
+
+		//collect all matches
+		std::vector<match> find_all(string_view text) const
+		{
+			std::vector<match> result;
+			for_each_match(text, [&result](const match& m) { result.push_back(m); });
+			return result;
+		}
+
+		//first match to end in the text; position is npos if there is no match
+		match find_first(string_view text) const
+		{
+			const auto* const delta = delta_.data();
+			std::uint32_t entry = 0;
+			for (size_type i = 0, n = text.size(); i < n; ++i) {
+				entry = delta[(entry & row_mask) + class_of_[static_cast<unsigned char>(text[i])]];
+				if (entry & match_flag) {
+					match m{ npos, npos };
+					auto keep_first = [&m](const match& found) {
+						if (m.position == npos)
+							m = found;
+					};
+					_report((entry & row_mask) / classes_, i + 1, keep_first);
+					return m;
+				}
+			}
+			return { npos, npos };
+		}
+
+		bool contains_any(string_view text) const { return find_first(text).position != npos; }
+
+		static constexpr size_type npos = size_type(-1);
+
+	private:
+		static constexpr std::uint32_t match_flag = 0x80000000u;
+		static constexpr std::uint32_t row_mask = ~match_flag;
+		static constexpr std::uint32_t none = ~std::uint32_t(0);
+
+		array<std::uint8_t, 256> class_of_{};  //byte -> class
+		std::uint32_t classes_{ 1 };           //number of classes, including class 0
+		std::vector<std::uint32_t> delta_;     //row offset of next state, plus match_flag
+		std::vector<std::uint32_t> dict_;      //state -> nearest state on its fail chain with output
+		std::vector<std::uint32_t> head_;      //state -> first pattern ending at the state
+		std::vector<std::uint32_t> next_;      //pattern -> next pattern with the same text
+		std::vector<size_type> lengths_;       //pattern -> length
+
+		template<typename F>
+		void _report(std::uint32_t state, size_type end, F& f) const
+		{
+			for (auto s = head_[state] != none ? state : dict_[state]; s != none; s = dict_[s])
+				for (auto p = head_[s]; p != none; p = next_[p])
+					f(match{ p, end - lengths_[p] });
+		}
+
+		void _compile(const std::vector<string_view>& patterns)
+		{
+			//byte classes: bytes used in patterns get their own class
+			array<bool, 256> used{};
+			size_type total_length = 0;
+			for (const auto& p : patterns) {
+				total_length += p.size();
+				for (const char c : p)
+					used[static_cast<unsigned char>(c)] = true;
+			}
+
+			classes_ = 1;
+			for (size_type b = 0; b < 256; ++b)
+				class_of_[b] = used[b] ? static_cast<std::uint8_t>(classes_++) : 0;
+
+			if (static_cast<std::uint64_t>(total_length + 1) * classes_ > row_mask)
+				throw std::length_error("aho_corasick: too many patterns");
+
+			//trie: 0 in delta_ means no edge while building (the root is never a child)
+			delta_.assign(classes_, 0);
+			head_.assign(1, none);
+			next_.assign(patterns.size(), none);
+			lengths_.resize(patterns.size());
+
+			std::vector<std::uint32_t> tails(1, none);
+			for (size_type id = 0; id < patterns.size(); ++id) {
+				const auto& p = patterns[id];
+				lengths_[id] = p.size();
+				if (p.empty())
+					continue;
+
+				std::uint32_t state = 0;
+				for (const char c : p) {
+					const size_type edge = state * classes_ + class_of_[static_cast<unsigned char>(c)];
+					if (delta_[edge] == 0) {
+						delta_[edge] = static_cast<std::uint32_t>(head_.size());
+						delta_.resize(delta_.size() + classes_, 0);
+						head_.push_back(none);
+						tails.push_back(none);
+					}
+					state = delta_[edge];
+				}
+
+				//append to the state's list of patterns, keeping the list in pattern order
+				const auto id32 = static_cast<std::uint32_t>(id);
+				if (head_[state] == none)
+					head_[state] = id32;
+				else
+					next_[tails[state]] = id32;
+				tails[state] = id32;
+			}
+
+			//breadth-first: fail links, dictionary links, and missing edges
+			const auto states = static_cast<std::uint32_t>(head_.size());
+			std::vector<std::uint32_t> fail(states, 0), queue;
+			queue.reserve(states);
+			dict_.assign(states, none);
+
+			for (std::uint32_t c = 0; c < classes_; ++c)
+				if (delta_[c] != 0)
+					queue.push_back(delta_[c]);
+
+			for (size_type q = 0; q < queue.size(); ++q) {
+				const auto s = queue[q];
+				const auto f = fail[s];
+				dict_[s] = head_[f] != none ? f : dict_[f];
+
+				for (std::uint32_t c = 0; c < classes_; ++c) {
+					auto& edge = delta_[s * classes_ + c];
+					if (edge != 0) {
+						fail[edge] = delta_[f * classes_ + c];
+						queue.push_back(edge);
+					}
+					else
+						edge = delta_[f * classes_ + c];
+				}
+			}
+
+			//convert state numbers to row offsets and flag states with output
+			for (auto& edge : delta_) {
+				const bool has_output = head_[edge] != none || dict_[edge] != none;
+				edge = edge * classes_ | (has_output ? match_flag : 0);
+			}
+		}
+
+	}; //class aho_corasick
+
+}	//namespace sigcpp
+
+#endif
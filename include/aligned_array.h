@@ -0,0 +1,332 @@
+/*
+* aligned_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define array variants with control over placement in memory
+* - aligned_array: an array whose first element is aligned to Align bytes, for aligned
+*   SIMD loads; it is an array in every other respect
+* - padded_array: an array with each element on its own cache line, so that threads
+*   updating adjacent elements do not share (and contend for) a line
+* - padded_array elements are not contiguous: it has no data(), and its iterators are
+*   random-access but not contiguous
+*/
+
+#ifndef SIGCPP_ALIGNED_ARRAY_H
+#define SIGCPP_ALIGNED_ARRAY_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	//size of a cache line on current x64 and most ARM64 cores
+	//fixed rather than std::hardware_destructive_interference_size: that value may differ
+	//between compiler flags, which would change the layout of types in headers
+	constexpr std::size_t cache_line_size = 64;
+
+
+	template<typename T, std::size_t N, std::size_t Align = cache_line_size>
+	struct alignas(Align) aligned_array : array<T, N>
+	{
+		static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+		static_assert(Align >= alignof(T), "Align must not weaken the alignment of T");
+
+		static constexpr std::size_t alignment = Align;
+
+	}; //template aligned_array
+
+
+	namespace detail
+	{
+		//one element padded to a whole number of lines
+		template<typename T, std::size_t Pad>
+		struct padded_slot
+		{
+			alignas(Pad) T value;
+		};
+	}
+
+
+	//random-access iterator over the elements of padded slots
+	//S is the slot type, const-qualified for a const_iterator
+	template<typename S>
+	class padded_iterator
+	{
+		using element = std::conditional_t<std::is_const_v<S>,
+			const decltype(S::value), decltype(S::value)>;
+
+	public:
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::remove_cv_t<element>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = element*;
+		using reference = element&;
+
+		//ctors
+		constexpr padded_iterator() noexcept = default;
+		constexpr explicit padded_iterator(S* slot) noexcept : slot_{ slot } {}
+
+		//iterator to const_iterator conversion
+		template<typename Q, typename = std::enable_if_t<std::is_convertible_v<Q*, S*>>>
+		constexpr padded_iterator(const padded_iterator<Q>& it) noexcept : slot_{ it.base() } {}
+
+		//the wrapped slot pointer
+		constexpr S* base() const noexcept { return slot_; }
+
+		//dereference and member access
+		constexpr reference operator*() const { return slot_->value; }
+		constexpr pointer operator->() const noexcept { return &slot_->value; }
+
+		//element access
+		constexpr reference operator[](difference_type n) const { return slot_[n].value; }
+
+		//increment and decrement
+		constexpr padded_iterator& operator++()
+		{
+			++slot_;
+			return *this;
+		}
+
+		constexpr padded_iterator operator++(int)
+		{
+			padded_iterator beforeIncrement = *this;
+			++slot_;
+			return beforeIncrement;
+		}
+
+		constexpr padded_iterator& operator--()
+		{
+			--slot_;
+			return *this;
+		}
+
+		constexpr padded_iterator operator--(int)
+		{
+			padded_iterator beforeDecrement = *this;
+			--slot_;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr padded_iterator operator+(difference_type n) const { return padded_iterator(slot_ + n); }
+		constexpr padded_iterator operator-(difference_type n) const { return padded_iterator(slot_ - n); }
+
+		constexpr padded_iterator& operator+=(difference_type n)
+		{
+			slot_ += n;
+			return *this;
+		}
+
+		constexpr padded_iterator& operator-=(difference_type n)
+		{
+			slot_ -= n;
+			return *this;
+		}
+
+	private:
+		S* slot_{ nullptr };
+
+	}; //template padded_iterator
+
+
+	//difference and comparison: non-members so that an iterator and a const_iterator mix in
+	//either order
+	template<typename S, typename R>
+	constexpr auto operator-(const padded_iterator<S>& x, const padded_iterator<R>& y) -> decltype(x.base() - y.base())
+	{
+		return x.base() - y.base();
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator==(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return x.base() == y.base();
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator!=(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator<(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return x.base() < y.base();
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator>(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return y < x;
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator<=(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename S, typename R>
+	constexpr bool operator>=(const padded_iterator<S>& x, const padded_iterator<R>& y)
+	{
+		return !(x < y);
+	}
+
+
+	//n + it
+	template<typename S>
+	constexpr padded_iterator<S> operator+(typename padded_iterator<S>::difference_type n,
+		const padded_iterator<S>& it)
+	{
+		return it + n;
+	}
+
+
+	template<typename T, std::size_t N, std::size_t Pad = cache_line_size>
+	struct padded_array
+	{
+		static_assert(Pad != 0 && (Pad & (Pad - 1)) == 0, "Pad must be a power of 2");
+
+		using slot_type = detail::padded_slot<T, Pad>;
+
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = padded_iterator<slot_type>;
+		using const_iterator = padded_iterator<const slot_type>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//underlying slots: create one slot if size is zero
+		slot_type slots[N == 0 ? 1 : N];
+
+		//utility
+		void fill(const T& u)
+		{
+			for (auto& s : slots)
+				s.value = u;
+		}
+
+		void swap(padded_array& a) noexcept(std::is_nothrow_swappable_v<T>)
+		{
+			std::swap_ranges(begin(), end(), a.begin());
+		}
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(slots); }
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr iterator end() noexcept { return iterator(slots + N); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		constexpr const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_iterator cbegin() const noexcept { return const_iterator(slots); }
+		constexpr const_iterator cend() const noexcept { return const_iterator(slots + N); }
+		constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return N == 0; }
+		constexpr size_type size() const noexcept { return N; }
+		constexpr size_type max_size() const noexcept { return N; }
+
+		//unchecked element access
+		constexpr reference operator[](size_type pos) { return slots[pos].value; }
+		constexpr const_reference operator[](size_type pos) const { return slots[pos].value; }
+
+		//checked element access
+		constexpr reference at(size_type pos)
+		{
+			return const_cast<reference>(_at(pos));
+		}
+
+		constexpr const_reference at(size_type pos) const { return _at(pos); }
+
+		constexpr reference front() { return slots[0].value; }
+		constexpr const_reference front() const { return slots[0].value; }
+
+		constexpr reference back() { return slots[N == 0 ? 0 : N - 1].value; }
+		constexpr const_reference back() const { return slots[N == 0 ? 0 : N - 1].value; }
+
+	private:
+		constexpr const_reference _at(size_type pos) const
+		{
+			if (pos < N)
+				return slots[pos].value;
+			else
+				throw std::out_of_range("padded_array index out of range");
+		}
+
+	}; //template padded_array
+
+
+	//specialized algorithms
+	template<typename T, std::size_t N, std::size_t Pad>
+	void swap(padded_array<T, N, Pad>& x, padded_array<T, N, Pad>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator==(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return std::equal(x.begin(), x.end(), y.begin());
+	}
+
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator!=(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator<(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+	}
+
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator>(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return y < x;
+	}
+
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator<=(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename T, std::size_t N, std::size_t Pad>
+	bool operator>=(const padded_array<T, N, Pad>& x, const padded_array<T, N, Pad>& y)
+	{
+		return !(x < y);
+	}
+
+}	//namespace sigcpp
+
+#endif
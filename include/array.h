@@ -12,22 +12,53 @@
 * - see C++17 [array.overview], [array.syn]
 * - https://timsong-cpp.github.io/cppwp/n4659/array
 * - https://timsong-cpp.github.io/cppwp/n4659/array.syn
+*
+* Bulk operations work on raw bytes where that is equivalent (see block_ops.h)
+* - fill and swap: trivially copyable elements
+* - comparison: integer elements
 */
 
 #ifndef SIGCPP_ARRAY_H
 #define SIGCPP_ARRAY_H
 
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
 #include <algorithm>
 #include <iterator>
 #include <type_traits>
 
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#include <compare>
+#endif
+
 #include "array_iterator.h"
+#include "block_ops.h"
 
 namespace sigcpp
 {
+	namespace detail
+	{
+		//smallest array, in bytes, that fill and swap hand to the bulk byte kernels
+		constexpr std::size_t array_block_min_size = 32;
+
+		//integers compare equal exactly when their bytes are equal
+		template<typename T>
+		constexpr bool is_bytewise_comparable_v = std::is_integral_v<T> &&
+			std::has_unique_object_representations_v<T>;
+
+		//unsigned bytes also order the way memcmp orders them
+		template<typename T>
+		constexpr bool is_memcmp_ordered_v = is_bytewise_comparable_v<T> && sizeof(T) == 1 &&
+			std::is_unsigned_v<T>;
+
+		//N elements of T never reach the AVX2 byte kernels: containers of fixed capacity
+		//compare and swap with the short kernels
+		template<typename T, std::size_t N>
+		constexpr bool is_short_block_v = sizeof(T) * N < avx2_block_min_size;
+	}
+
 	template<typename T, std::size_t N>
 	struct array
 	{
@@ -50,11 +81,37 @@ namespace sigcpp
 		value_type values[N==0 ? 1 : N];
 
 		//utility
-		void fill(const T& u) { std::fill_n(values, N, u); }
+		//trivially copyable values: copy the first element, then double the filled prefix
+		//with memcpy; byte-sized values: memset
+		void fill(const T& u)
+		{
+			if constexpr (N != 0 && std::is_trivially_copyable_v<T> && sizeof(T) == 1) {
+				unsigned char b;
+				std::memcpy(&b, &u, 1);
+				std::memset(values, b, N);
+			}
+			else if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) * N >= detail::array_block_min_size) {
+				values[0] = u;
+				for (size_type filled = 1; filled < N; ) {
+					const auto count = std::min(filled, N - filled);
+					std::memcpy(values + filled, values, count * sizeof(T));
+					filled += count;
+				}
+			}
+			else
+				std::fill_n(values, N, u);
+		}
 
 		void swap(array& a) noexcept(std::is_nothrow_swappable_v<T>)
 		{
-			std::swap_ranges(values, values + N, a.values);
+			if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) * N >= detail::array_block_min_size) {
+				if constexpr (detail::is_short_block_v<T, N>)
+					detail::swap_bytes_short(values, a.values, sizeof(T) * N);
+				else
+					detail::swap_bytes(values, a.values, sizeof(T) * N);
+			}
+			else
+				std::swap_ranges(values, values + N, a.values);
 		}
 
 		//iterators
@@ -188,6 +245,152 @@ namespace sigcpp
 
 	}; //template array
 
+
+	//specialized algorithms
+	template<typename T, std::size_t N>
+	void swap(array<T, N>& x, array<T, N>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	namespace detail
+	{
+		//helpers to compare element sequences: shared by all containers with contiguous elements
+		//equality of the bytes decides for integers; others use the element operators
+
+		//index of the first element that differs in two sequences of n elements; n if none
+		//Short: the sequences are known to be shorter than avx2_block_min_size bytes
+		template<typename T, bool Short = false>
+		constexpr std::size_t mismatch_elements(const T* x, const T* y, std::size_t n)
+		{
+			if constexpr (is_bytewise_comparable_v<T>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED()) {
+					if constexpr (Short)
+						return mismatch_bytes_short(x, y, n * sizeof(T)) / sizeof(T);
+					else
+						return mismatch_bytes(x, y, n * sizeof(T)) / sizeof(T);
+				}
+			}
+
+			std::size_t i = 0;
+			while (i < n && x[i] == y[i])
+				++i;
+			return i;
+		}
+
+
+		template<typename T>
+		constexpr bool equal_elements(const T* x, const T* y, std::size_t n)
+		{
+			if constexpr (is_bytewise_comparable_v<T>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+					return n == 0 || std::memcmp(x, y, n * sizeof(T)) == 0;
+			}
+
+			for (std::size_t i = 0; i < n; ++i)
+				if (!(x[i] == y[i]))
+					return false;
+			return true;
+		}
+
+
+		//lexicographical: integers skip the common prefix with the byte kernels, then compare
+		//one element; unsigned bytes go straight to memcmp
+		template<typename T, bool Short = false>
+		constexpr bool less_elements(const T* x, std::size_t nx, const T* y, std::size_t ny)
+		{
+			const auto n = nx < ny ? nx : ny;
+			if constexpr (is_memcmp_ordered_v<T>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED() && n != 0) {
+					const auto c = std::memcmp(x, y, n);
+					return c != 0 ? c < 0 : nx < ny;
+				}
+			}
+
+			if constexpr (is_bytewise_comparable_v<T>) {
+				const auto i = mismatch_elements<T, Short>(x, y, n);
+				return i != n ? x[i] < y[i] : nx < ny;
+			}
+			else {
+				for (std::size_t i = 0; i < n; ++i) {
+					if (x[i] < y[i])
+						return true;
+					if (y[i] < x[i])
+						return false;
+				}
+				return nx < ny;
+			}
+		}
+
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+		template<typename T, bool Short = false>
+		constexpr std::compare_three_way_result_t<T> three_way_elements(const T* x, std::size_t nx,
+			const T* y, std::size_t ny)
+		{
+			const auto n = nx < ny ? nx : ny;
+			if constexpr (is_bytewise_comparable_v<T>) {
+				const auto i = mismatch_elements<T, Short>(x, y, n);
+				return i != n ? x[i] <=> y[i] : nx <=> ny;
+			}
+			else {
+				for (std::size_t i = 0; i < n; ++i)
+					if (const auto c = x[i] <=> y[i]; c != 0)
+						return c;
+				return nx <=> ny;
+			}
+		}
+#endif
+	}
+
+
+	//comparison: see C++17 [array.overview], [container.requirements.general]
+	template<typename T, std::size_t N>
+	constexpr bool operator==(const array<T, N>& x, const array<T, N>& y)
+	{
+		return detail::equal_elements(x.values, y.values, N);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator!=(const array<T, N>& x, const array<T, N>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<(const array<T, N>& x, const array<T, N>& y)
+	{
+		return detail::less_elements<T, detail::is_short_block_v<T, N>>(x.values, N, y.values, N);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>(const array<T, N>& x, const array<T, N>& y)
+	{
+		return y < x;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<=(const array<T, N>& x, const array<T, N>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>=(const array<T, N>& x, const array<T, N>& y)
+	{
+		return !(x < y);
+	}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	//three-way comparison for element types that have <=>: see C++20 [array.syn]
+	template<typename T, std::size_t N>
+	constexpr std::compare_three_way_result_t<T> operator<=>(const array<T, N>& x, const array<T, N>& y)
+	{
+		return detail::three_way_elements<T, detail::is_short_block_v<T, N>>(x.values, N, y.values, N);
+	}
+#endif
+
 }	//namespace sigcpp
 
 #endif
\ No newline at end of file
@@ -9,6 +9,9 @@
 * Define a template for random-access iterators: wraps a raw array
 * - see C++17 [iterator.requirements]
 * - https://timsong-cpp.github.io/cppwp/n4659/iterator.requirements
+* - in C++20, also a contiguous iterator: see C++20 [iterator.concept.contiguous]
+* - with the MSVC STL, std algorithms unwrap the iterator to a raw pointer so that
+*   copy, fill, equal, etc. on trivially copyable elements use memmove/memset/memcmp
 */
 
 #ifndef SIGCPP_ARRAY_ITERATOR_H
@@ -16,6 +19,7 @@
 
 #include <cstddef>
 #include <iterator>
+#include <type_traits>
 
 namespace sigcpp
 {
@@ -30,10 +34,19 @@ namespace sigcpp
 		using difference_type = typename std::iterator_traits<P>::difference_type;
 		using pointer = typename std::iterator_traits<P>::pointer;
 		using reference = typename std::iterator_traits<P>::reference;
+		using element_type = std::remove_reference_t<reference>;
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+		using iterator_concept = std::contiguous_iterator_tag;
+#endif
 
 		//ctors
-		array_iterator() noexcept = default;
-		array_iterator(P p) noexcept : basePtr(p){}
+		constexpr array_iterator() noexcept = default;
+		constexpr array_iterator(P p) noexcept : basePtr(p){}
+
+		//iterator to const_iterator conversion
+		template<typename Q, typename = std::enable_if_t<std::is_convertible_v<Q, P>>>
+		constexpr array_iterator(const array_iterator<Q>& it) noexcept : basePtr(it.base()) {}
 
 		//the wrapped iter
 		constexpr P base() const noexcept { return basePtr; }
@@ -90,53 +103,99 @@ namespace sigcpp
 			return t;
 		}
 
-		array_iterator& operator+=(difference_type n)
+		constexpr array_iterator& operator+=(difference_type n)
 		{
 			basePtr += n;
 			return *this;
 		}
 
-		array_iterator& operator-=(difference_type n)
+		constexpr array_iterator& operator-=(difference_type n)
 		{
 			basePtr -= n;
 			return *this;
 		}
 
-		//comparison
-		constexpr bool operator==(const array_iterator& r) const 
-		{
-			return basePtr == r.basePtr;
-		}
+#if defined(_MSVC_STL_VERSION)
+		//MSVC STL unwrapping protocol: std algorithms operate on the raw pointer
+		using _Prevent_inheriting_unwrap = array_iterator;
+		static constexpr bool _Unwrap_when_unverified = true;
 
-		constexpr bool operator!=(const array_iterator& r) const
-		{
-			return basePtr != r.basePtr;
-		}
+		constexpr P _Unwrapped() const noexcept { return basePtr; }
+		constexpr void _Seek_to(P p) noexcept { basePtr = p; }
+#endif
 
-		constexpr bool operator<(const array_iterator& r) const
-		{
-			return basePtr < r.basePtr;
-		}
+	private:
+		P basePtr{ nullptr };
 
-		constexpr bool operator>(const array_iterator& r) const
-		{
-			return basePtr > r.basePtr;
-		}
+	}; //template array_iterator
 
-		constexpr bool operator<=(const array_iterator& r) const
-		{
-			return !(r > *this);
-		}
 
-		constexpr bool operator>=(const array_iterator& r) const
-		{
-			return !(*this < r);
-		}
+	//difference and comparison: non-members so that an iterator and a const_iterator mix in
+	//either order
+	template<typename P, typename Q>
+	constexpr auto operator-(const array_iterator<P>& x, const array_iterator<Q>& y) -> decltype(x.base() - y.base())
+	{
+		return x.base() - y.base();
+	}
 
-	private:
-		P basePtr{ nullptr };
+	template<typename P, typename Q>
+	constexpr bool operator==(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return x.base() == y.base();
+	}
 
-	}; //template array_iterator
+	template<typename P, typename Q>
+	constexpr bool operator!=(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename P, typename Q>
+	constexpr bool operator<(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return x.base() < y.base();
+	}
+
+	template<typename P, typename Q>
+	constexpr bool operator>(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return y < x;
+	}
+
+	template<typename P, typename Q>
+	constexpr bool operator<=(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename P, typename Q>
+	constexpr bool operator>=(const array_iterator<P>& x, const array_iterator<Q>& y)
+	{
+		return !(x < y);
+	}
+
+
+	//n + it
+	template<typename P>
+	constexpr array_iterator<P> operator+(typename array_iterator<P>::difference_type n,
+		const array_iterator<P>& it)
+	{
+		return it + n;
+	}
+
+
+	namespace detail
+	{
+		//input iterators, as opposed to counts, in overloads that take two arguments
+		template<typename It>
+		using enable_if_input_iterator_t = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+			typename std::iterator_traits<It>::iterator_category>>;
+
+		//forward iterators can be traversed twice: count first, then copy
+		template<typename It>
+		constexpr bool is_forward_iterator_v = std::is_base_of_v<std::forward_iterator_tag,
+			typename std::iterator_traits<It>::iterator_category>;
+	}
 
 }	//namespace sigcpp
 
@@ -0,0 +1,264 @@
+/*
+* bit_ops.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define kernels over arrays of 64-bit words used as bit sets: count and combine
+* - count has an AVX2 path (Mula's nibble lookup), a POPCNT path, and a scalar path
+* - combine (and, or, xor, and-not) has an AVX2 path, an SSE2 path, and a scalar path
+* - the path is chosen at run time (see simd.h)
+* - see Mula, Kurz, and Lemire, "Faster population counts using AVX2 instructions" (2018)
+*/
+
+#ifndef SIGCPP_BIT_OPS_H
+#define SIGCPP_BIT_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.h"
+
+namespace sigcpp::detail
+{
+	//the ways to combine a word of one set with a word of another
+	enum class word_op { and_op, or_op, xor_op, and_not_op };
+
+
+	//scalar paths
+
+	inline std::size_t count_bits_scalar(const std::uint64_t* words, std::size_t n) noexcept
+	{
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < n; ++i)
+			count += simd::popcount64(words[i]);
+		return count;
+	}
+
+
+	template<word_op Op>
+	inline std::uint64_t combine_word(std::uint64_t x, std::uint64_t y) noexcept
+	{
+		if constexpr (Op == word_op::and_op)
+			return x & y;
+		else if constexpr (Op == word_op::or_op)
+			return x | y;
+		else if constexpr (Op == word_op::xor_op)
+			return x ^ y;
+		else
+			return x & ~y;
+	}
+
+
+	template<word_op Op>
+	inline void combine_words_scalar(std::uint64_t* dest, const std::uint64_t* src, std::size_t n) noexcept
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			dest[i] = combine_word<Op>(dest[i], src[i]);
+	}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+	//POPCNT path: four sums, so that the adds do not wait on one another
+
+	//the instruction itself: a lambda here would not inherit the target of its caller
+	SIGCPP_TARGET_POPCNT
+	inline std::size_t popcount_popcnt(std::uint64_t x) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+		return static_cast<std::size_t>(__popcnt64(x));
+#elif defined(_MSC_VER) && !defined(__clang__)
+		return static_cast<std::size_t>(__popcnt(static_cast<std::uint32_t>(x)) +
+			__popcnt(static_cast<std::uint32_t>(x >> 32)));
+#else
+		return static_cast<std::size_t>(__builtin_popcountll(x));
+#endif
+	}
+
+
+	SIGCPP_TARGET_POPCNT
+	inline std::size_t count_bits_popcnt(const std::uint64_t* words, std::size_t n) noexcept
+	{
+		//the tail counts down from n: gcc misreads an index carried over from the first loop
+		std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+		const auto blocks = n / 4;
+		for (std::size_t i = 0; i < blocks * 4; i += 4) {
+			c0 += popcount_popcnt(words[i]);
+			c1 += popcount_popcnt(words[i + 1]);
+			c2 += popcount_popcnt(words[i + 2]);
+			c3 += popcount_popcnt(words[i + 3]);
+		}
+		for (std::size_t i = n; i != blocks * 4; --i)
+			c0 += popcount_popcnt(words[i - 1]);
+		return c0 + c1 + c2 + c3;
+	}
+
+
+	//SSE2 paths: 16-byte registers
+
+	template<word_op Op>
+	inline __m128i combine_sse2(__m128i x, __m128i y) noexcept
+	{
+		if constexpr (Op == word_op::and_op)
+			return _mm_and_si128(x, y);
+		else if constexpr (Op == word_op::or_op)
+			return _mm_or_si128(x, y);
+		else if constexpr (Op == word_op::xor_op)
+			return _mm_xor_si128(x, y);
+		else
+			return _mm_andnot_si128(y, x);
+	}
+
+
+	template<word_op Op>
+	inline void combine_words_sse2(std::uint64_t* dest, const std::uint64_t* src, std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			const auto pd = reinterpret_cast<__m128i*>(dest + i);
+			const auto ps = reinterpret_cast<const __m128i*>(src + i);
+			const __m128i d0 = combine_sse2<Op>(_mm_loadu_si128(pd), _mm_loadu_si128(ps));
+			const __m128i d1 = combine_sse2<Op>(_mm_loadu_si128(pd + 1), _mm_loadu_si128(ps + 1));
+			_mm_storeu_si128(pd, d0);
+			_mm_storeu_si128(pd + 1, d1);
+		}
+
+		combine_words_scalar<Op>(dest + i, src + i, n - i);
+	}
+
+
+	//AVX2 paths: 32-byte registers
+
+	//bits in each byte of v: the count of each nibble by table lookup
+	SIGCPP_TARGET_AVX2
+	inline __m256i byte_counts_avx2(__m256i v) noexcept
+	{
+		const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0F);
+		const __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low));
+		const __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+		return _mm256_add_epi8(lo, hi);
+	}
+
+
+	//byte counts summed into four 64-bit lanes
+	SIGCPP_TARGET_AVX2
+	inline std::size_t count_bits_avx2(const std::uint64_t* words, std::size_t n) noexcept
+	{
+		__m256i sums = _mm256_setzero_si256();
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			const auto p = reinterpret_cast<const __m256i*>(words + i);
+			//two vectors per step: each byte is at most 16, far from overflow
+			const __m256i bytes = _mm256_add_epi8(byte_counts_avx2(_mm256_loadu_si256(p)),
+				byte_counts_avx2(_mm256_loadu_si256(p + 1)));
+			sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+
+		alignas(32) std::uint64_t lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+		return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+			count_bits_popcnt(words + i, n - i);
+	}
+
+
+	template<word_op Op>
+	SIGCPP_TARGET_AVX2
+	inline __m256i combine_avx2(__m256i x, __m256i y) noexcept
+	{
+		if constexpr (Op == word_op::and_op)
+			return _mm256_and_si256(x, y);
+		else if constexpr (Op == word_op::or_op)
+			return _mm256_or_si256(x, y);
+		else if constexpr (Op == word_op::xor_op)
+			return _mm256_xor_si256(x, y);
+		else
+			return _mm256_andnot_si256(y, x);
+	}
+
+
+	template<word_op Op>
+	SIGCPP_TARGET_AVX2
+	inline void combine_words_avx2(std::uint64_t* dest, const std::uint64_t* src, std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			const auto pd = reinterpret_cast<__m256i*>(dest + i);
+			const auto ps = reinterpret_cast<const __m256i*>(src + i);
+			const __m256i d0 = combine_avx2<Op>(_mm256_loadu_si256(pd), _mm256_loadu_si256(ps));
+			const __m256i d1 = combine_avx2<Op>(_mm256_loadu_si256(pd + 1), _mm256_loadu_si256(ps + 1));
+			_mm256_storeu_si256(pd, d0);
+			_mm256_storeu_si256(pd + 1, d1);
+		}
+
+		combine_words_sse2<Op>(dest + i, src + i, n - i);
+	}
+
+#endif //SIGCPP_SIMD_SSE2
+
+
+	//dispatchers
+
+	//number of set bits in [words, words + n)
+	//without the AVX2 kernel: for fewer than 16 words, its setup does not pay
+	inline std::size_t count_bits_short(const std::uint64_t* words, std::size_t n) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (simd::has_popcnt())
+			return count_bits_popcnt(words, n);
+#endif
+		return count_bits_scalar(words, n);
+	}
+
+
+	inline std::size_t count_bits(const std::uint64_t* words, std::size_t n) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 16 && simd::has_avx2())
+			return count_bits_avx2(words, n);
+#endif
+		return count_bits_short(words, n);
+	}
+
+
+	//dest[i] = dest[i] op src[i]: dest and src are equal or do not overlap
+	template<word_op Op>
+	inline void combine_words(std::uint64_t* dest, const std::uint64_t* src, std::size_t n) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 8 && simd::has_avx2())
+			combine_words_avx2<Op>(dest, src, n);
+		else
+			combine_words_sse2<Op>(dest, src, n);
+#else
+		combine_words_scalar<Op>(dest, src, n);
+#endif
+	}
+
+
+	//position of the first set bit at or after pos, in words of n; n * 64 if none
+	inline std::size_t find_set_bit(const std::uint64_t* words, std::size_t n, std::size_t pos) noexcept
+	{
+		auto i = pos / 64;
+		if (i >= n)
+			return n * 64;
+
+		//bits below pos in the first word are ignored
+		auto word = words[i] & (~std::uint64_t{ 0 } << (pos % 64));
+		while (word == 0) {
+			if (++i == n)
+				return n * 64;
+			word = words[i];
+		}
+		return i * 64 + simd::lowest_bit64(word);
+	}
+
+} //namespace sigcpp::detail
+
+#endif
@@ -0,0 +1,451 @@
+/*
+* bit_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a bit set whose size changes at run time, and a rank/select index over it
+* - bit_vector: the operations of sigcpp::bitset (see bitset.h), plus push_back, resize,
+*   and the other members of a sequence of bits; stored as a sigcpp::vector of 64-bit words
+*   drawn from Allocator
+* - the bulk operations require operands of the same size; else they throw
+*   std::invalid_argument
+*
+* rank_select: constant-time rank and fast select over a bit_vector that no longer changes
+* - rank(pos) is the number of set bits before pos; select(k) is the position of set bit
+*   k (counting from 0)
+* - the layout is Vigna's rank9: per block of 8 words (one cache line), the set bits before
+*   the block, and seven 9-bit counts of the set bits before each word in the block; rank
+*   reads the two counts and one word
+* - select samples the block of every 512th set bit, then binary-searches the blocks
+*   between two samples, then the counts in the block, then finds the byte of the word
+*   by broadword compares and the bit by table lookup (or uses PDEP if the build has BMI2)
+* - the index refers to the bits of the bit_vector: the bit_vector must outlive the index,
+*   and a change to the bits requires a new index; the counts and samples draw from
+*   Allocator, rebound
+* - see Vigna, "Broadword implementation of rank/select queries" (2008)
+*/
+
+#ifndef SIGCPP_BIT_VECTOR_H
+#define SIGCPP_BIT_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <initializer_list>
+#include <memory>
+
+#include "bit_ops.h"
+#include "bitset.h"
+#include "simd.h"
+#include "vector.h"
+
+#if defined(__BMI2__) && !defined(SIGCPP_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+namespace sigcpp
+{
+	template<typename Allocator = std::allocator<std::uint64_t>>
+	class bit_vector
+	{
+	public:
+		//types
+		using word_type = std::uint64_t;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using reference = bit_reference;
+
+		static constexpr size_type word_bits = 64;
+
+		//ctors
+		bit_vector() noexcept(noexcept(Allocator())) : bit_vector(Allocator()) {}
+		explicit bit_vector(const Allocator& alloc) noexcept : words_(alloc), size_{ 0 } {}
+
+		explicit bit_vector(size_type count, bool value = false, const Allocator& alloc = Allocator())
+			: words_(_words_for(count), value ? ~word_type{ 0 } : 0, alloc), size_{ count }
+		{
+			_trim();
+		}
+
+		bit_vector(std::initializer_list<bool> il, const Allocator& alloc = Allocator())
+			: words_(_words_for(il.size()), 0, alloc), size_{ il.size() }
+		{
+			size_type pos = 0;
+			for (bool value : il)
+				(*this)[pos++] = value;
+		}
+
+		allocator_type get_allocator() const noexcept { return words_.get_allocator(); }
+
+		//element access
+		bool operator[](size_type pos) const { return (words_[pos / word_bits] >> (pos % word_bits)) & 1; }
+		reference operator[](size_type pos) { return reference(&words_[pos / word_bits], pos % word_bits); }
+
+		bool test(size_type pos) const
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		bool all() const noexcept { return count() == size_; }
+		bool any() const noexcept { return !none(); }
+
+		bool none() const noexcept
+		{
+			for (size_type i = 0; i < words_.size(); ++i)
+				if (words_[i] != 0)
+					return false;
+			return true;
+		}
+
+		size_type count() const noexcept { return detail::count_bits(words_.data(), words_.size()); }
+
+		//capacity
+		bool empty() const noexcept { return size_ == 0; }
+		size_type size() const noexcept { return size_; }
+		size_type capacity() const noexcept { return words_.capacity() * word_bits; }
+		void reserve(size_type count) { words_.reserve(_words_for(count)); }
+		void shrink_to_fit() { words_.shrink_to_fit(); }
+
+		//modifiers
+		void push_back(bool value)
+		{
+			if (size_ % word_bits == 0)
+				words_.push_back(0);
+			++size_;
+			(*this)[size_ - 1] = value;
+		}
+
+		void pop_back()
+		{
+			--size_;
+			if (size_ % word_bits == 0)
+				words_.pop_back();
+			else
+				_trim();
+		}
+
+		//new bits are value
+		void resize(size_type count, bool value = false)
+		{
+			const auto oldSize = size_;
+			words_.resize(_words_for(count), value ? ~word_type{ 0 } : 0);
+			size_ = count;
+
+			//bits from the old size to the end of its last word were zero
+			if (value && count > oldSize && oldSize % word_bits != 0)
+				words_[oldSize / word_bits] |= ~word_type{ 0 } << (oldSize % word_bits);
+			_trim();
+		}
+
+		void clear() noexcept
+		{
+			words_.clear();
+			size_ = 0;
+		}
+
+		void swap(bit_vector& b) noexcept
+		{
+			words_.swap(b.words_);
+			std::swap(size_, b.size_);
+		}
+
+		bit_vector& operator&=(const bit_vector& b) { return _combine<detail::word_op::and_op>(b); }
+		bit_vector& operator|=(const bit_vector& b) { return _combine<detail::word_op::or_op>(b); }
+		bit_vector& operator^=(const bit_vector& b) { return _combine<detail::word_op::xor_op>(b); }
+
+		//clear the bits set in b: *this & ~b without a temporary
+		bit_vector& and_not(const bit_vector& b) { return _combine<detail::word_op::and_not_op>(b); }
+
+		bit_vector& set() noexcept
+		{
+			for (size_type i = 0; i < words_.size(); ++i)
+				words_[i] = ~word_type{ 0 };
+			_trim();
+			return *this;
+		}
+
+		bit_vector& set(size_type pos, bool value = true)
+		{
+			_check(pos);
+			(*this)[pos] = value;
+			return *this;
+		}
+
+		bit_vector& reset() noexcept
+		{
+			for (size_type i = 0; i < words_.size(); ++i)
+				words_[i] = 0;
+			return *this;
+		}
+
+		bit_vector& reset(size_type pos) { return set(pos, false); }
+
+		bit_vector& flip() noexcept
+		{
+			for (size_type i = 0; i < words_.size(); ++i)
+				words_[i] = ~words_[i];
+			_trim();
+			return *this;
+		}
+
+		bit_vector& flip(size_type pos)
+		{
+			_check(pos);
+			(*this)[pos].flip();
+			return *this;
+		}
+
+		bit_vector operator~() const { return bit_vector(*this).flip(); }
+
+		//set bits
+		//position of the first set bit at or after pos; size() if there is none
+		size_type find_first() const noexcept { return find_next(0); }
+		size_type find_next(size_type pos) const noexcept
+		{
+			const auto found = detail::find_set_bit(words_.data(), words_.size(), pos);
+			return found < size_ ? found : size_;
+		}
+
+		template<typename F>
+		void for_each_set(F f) const { detail::for_each_set_bit(words_.data(), words_.size(), f); }
+
+		set_bits ones() const noexcept { return set_bits(words_.data(), words_.size()); }
+
+		//underlying words: bit i is bit i % 64 of word i / 64
+		const word_type* data() const noexcept { return words_.data(); }
+		size_type word_count() const noexcept { return words_.size(); }
+
+		//comparison
+		friend bool operator==(const bit_vector& x, const bit_vector& y)
+		{
+			return x.size_ == y.size_ && x.words_ == y.words_;
+		}
+
+		friend bool operator!=(const bit_vector& x, const bit_vector& y) { return !(x == y); }
+
+	private:
+		static size_type _words_for(size_type count) noexcept { return (count + word_bits - 1) / word_bits; }
+
+		template<detail::word_op Op>
+		bit_vector& _combine(const bit_vector& b)
+		{
+			if (b.size_ != size_)
+				throw std::invalid_argument("bit_vector sizes differ");
+			detail::combine_words<Op>(words_.data(), b.words_.data(), words_.size());
+			return *this;
+		}
+
+		//clear the bits past size() in the last word
+		void _trim() noexcept
+		{
+			if (size_ % word_bits != 0)
+				words_.back() &= (word_type{ 1 } << (size_ % word_bits)) - 1;
+		}
+
+		void _check(size_type pos) const
+		{
+			if (pos >= size_)
+				throw std::out_of_range("bit_vector index out of range");
+		}
+
+		vector<word_type, Allocator> words_;
+		size_type size_;
+
+	}; //template bit_vector
+
+
+	//specialized algorithms
+	template<typename Allocator>
+	void swap(bit_vector<Allocator>& x, bit_vector<Allocator>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+
+	namespace detail
+	{
+		//position of set bit k of a byte, at index k * 256 + byte; 8 if there is none
+		struct select_in_byte_table
+		{
+			std::uint8_t positions[8 * 256];
+
+			constexpr select_in_byte_table() : positions{}
+			{
+				for (unsigned byte = 0; byte < 256; ++byte) {
+					unsigned k = 0;
+					for (unsigned bit = 0; bit < 8; ++bit)
+						if ((byte >> bit) & 1)
+							positions[k++ * 256 + byte] = static_cast<std::uint8_t>(bit);
+					for (; k < 8; ++k)
+						positions[k * 256 + byte] = 8;
+				}
+			}
+		};
+
+		inline constexpr select_in_byte_table select_in_byte{};
+
+
+		//position of set bit k of word: k must be less than the number of set bits
+		inline unsigned select_in_word(std::uint64_t word, unsigned k) noexcept
+		{
+#if defined(__BMI2__) && !defined(SIGCPP_NO_SIMD)
+			//deposit bit k of a mask into the set bits of word: it lands on set bit k
+			return simd::lowest_bit64(_pdep_u64(std::uint64_t{ 1 } << k, word));
+#else
+			constexpr auto ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+
+			//set bits per byte, then running totals: byte i holds the set bits in bytes 0 to i
+			auto counts = word - ((word >> 1) & 0x5555555555555555ull);
+			counts = (counts & 0x3333333333333333ull) + ((counts >> 2) & 0x3333333333333333ull);
+			counts = (counts + (counts >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			const auto totals = counts * ones;
+
+			//the high bit of byte i is set where totals[i] <= k: totals are at most 64, so
+			//subtracting them from k | 0x80 in every byte never borrows across bytes
+			const auto atMost = ((k * ones | highs) - totals) & highs;
+			const auto byte = static_cast<unsigned>(((atMost >> 7) * ones) >> 56);
+
+			const auto before = static_cast<unsigned>(((totals << 8) >> (byte * 8)) & 0xFF);
+			return byte * 8 + select_in_byte.positions[(k - before) * 256 + ((word >> (byte * 8)) & 0xFF)];
+#endif
+		}
+	}
+
+
+	template<typename Allocator = std::allocator<std::uint64_t>>
+	class rank_select
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+		using count_allocator = typename alloc_traits::template rebind_alloc<std::uint64_t>;
+		using sample_allocator = typename alloc_traits::template rebind_alloc<std::size_t>;
+
+	public:
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+
+		static constexpr size_type word_bits = 64;
+
+		//words per block: one cache line
+		static constexpr size_type block_words = 8;
+
+		//set bits between samples for select
+		static constexpr size_type select_sample = 512;
+
+		template<typename BitAllocator>
+		explicit rank_select(const bit_vector<BitAllocator>& bits, const Allocator& alloc = Allocator())
+			: words_{ bits.data() }, wordCount_{ bits.word_count() }, size_{ bits.size() },
+			counts_(count_allocator(alloc)), samples_(sample_allocator(alloc)), ones_{ 0 }
+		{
+			_build();
+		}
+
+		allocator_type get_allocator() const noexcept { return Allocator(counts_.get_allocator()); }
+
+		size_type size() const noexcept { return size_; }
+		size_type count() const noexcept { return ones_; }
+
+		//set bits in [0, pos): pos must not exceed size()
+		size_type rank(size_type pos) const noexcept
+		{
+			const auto word = pos / word_bits, bit = pos % word_bits;
+			const auto block = word / block_words;
+
+			//the 9-bit count of word j in the block is field j - 1; word 0 has no field: for
+			//j == 0, j - 1 wraps and the shift becomes 63, which reads the always-zero top bit
+			const auto j = static_cast<std::uint64_t>(word % block_words) - 1;
+			const auto inBlock = (counts_[2 * block + 1] >> ((j + ((j >> 60) & 8)) * 9)) & 0x1FF;
+
+			auto rank = counts_[2 * block] + inBlock;
+			if (bit != 0)
+				rank += simd::popcount64(words_[word] & ((std::uint64_t{ 1 } << bit) - 1));
+			return static_cast<size_type>(rank);
+		}
+
+		//position of set bit k, counting from 0; size() if there are k or fewer set bits
+		size_type select(size_type k) const noexcept
+		{
+			if (k >= ones_)
+				return size();
+
+			//the last block that starts with at most k set bits, between the samples
+			auto low = samples_[k / select_sample], high = samples_[k / select_sample + 1];
+			while (low < high) {
+				const auto middle = low + (high - low + 1) / 2;
+				if (counts_[2 * middle] <= k)
+					low = middle;
+				else
+					high = middle - 1;
+			}
+
+			auto rest = k - static_cast<size_type>(counts_[2 * low]);
+			const auto packed = counts_[2 * low + 1];
+			size_type j = 1;
+			for (; j < block_words && ((packed >> ((j - 1) * 9)) & 0x1FF) <= rest; ++j) {}
+			--j;
+			if (j != 0)
+				rest -= static_cast<size_type>((packed >> ((j - 1) * 9)) & 0x1FF);
+
+			const auto word = low * block_words + j;
+			return word * word_bits +
+				detail::select_in_word(words_[word], static_cast<unsigned>(rest));
+		}
+
+	private:
+		void _build()
+		{
+			const auto words = words_;
+			const auto wordCount = wordCount_;
+			const auto blockCount = wordCount / block_words + 1;
+
+			//one block past the last word: rank(size()) reads it when size() ends a block
+			counts_.resize(2 * blockCount);
+			std::uint64_t total = 0;
+			for (size_type block = 0; block < blockCount; ++block) {
+				counts_[2 * block] = total;
+				std::uint64_t packed = 0, inBlock = 0;
+				for (size_type j = 0; j < block_words; ++j) {
+					if (j != 0)
+						packed |= inBlock << ((j - 1) * 9);
+					const auto word = block * block_words + j;
+					if (word < wordCount)
+						inBlock += simd::popcount64(words[word]);
+				}
+				counts_[2 * block + 1] = packed;
+				total += inBlock;
+			}
+			ones_ = static_cast<size_type>(total);
+
+			//the block of set bit i * select_sample, and a last entry to bound the search
+			samples_.reserve(ones_ / select_sample + 2);
+			size_type block = 0;
+			for (size_type k = 0; k < ones_; k += select_sample) {
+				while (block + 1 < blockCount && counts_[2 * (block + 1)] <= k)
+					++block;
+				samples_.push_back(block);
+			}
+			samples_.push_back(blockCount - 1);
+		}
+
+		const std::uint64_t* words_;
+		size_type wordCount_;
+		size_type size_;
+		vector<std::uint64_t, count_allocator> counts_;
+		vector<size_type, sample_allocator> samples_;
+		size_type ones_;
+
+	}; //template rank_select
+
+
+	//the index of a bit_vector draws from its allocator
+	template<typename Allocator>
+	rank_select(const bit_vector<Allocator>&) -> rank_select<Allocator>;
+
+}	//namespace sigcpp
+
+#endif
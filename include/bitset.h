@@ -0,0 +1,364 @@
+/*
+* bitset.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for fixed-size bit sets, stored as a sigcpp::array of 64-bit words
+* - see C++17 [template.bitset] https://timsong-cpp.github.io/cppwp/n4659/template.bitset;
+*   without the string conversions
+* - count and the bulk operations (&=, |=, ^=, and_not) run word kernels (see bit_ops.h)
+* - set bits are visited a word at a time: the lowest set bit of a word is found by
+*   counting trailing zeros and then cleared, so a visit costs per set bit and per word,
+*   not per bit; for_each_set, find_first/find_next, and the range ones() all do so
+* - bits past N in the last word are always zero
+* - see bit_vector.h for a bit set whose size changes at run time
+*/
+
+#ifndef SIGCPP_BITSET_H
+#define SIGCPP_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <iterator>
+
+#include "array.h"
+#include "bit_ops.h"
+#include "simd.h"
+
+namespace sigcpp
+{
+	//a single bit of a word: the reference type of bit sets
+	class bit_reference
+	{
+	public:
+		constexpr bit_reference(std::uint64_t* word, unsigned bit) noexcept : word_{ word }, mask_{ std::uint64_t{ 1 } << bit } {}
+		bit_reference(const bit_reference&) = default;
+
+		constexpr operator bool() const noexcept { return (*word_ & mask_) != 0; }
+		constexpr bool operator~() const noexcept { return (*word_ & mask_) == 0; }
+
+		//assignment sets the bit: it does not rebind the reference
+		constexpr bit_reference& operator=(bool value) noexcept
+		{
+			*word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+			return *this;
+		}
+
+		constexpr bit_reference& operator=(const bit_reference& r) noexcept { return *this = static_cast<bool>(r); }
+
+		constexpr bit_reference& flip() noexcept
+		{
+			*word_ ^= mask_;
+			return *this;
+		}
+
+	private:
+		std::uint64_t* word_;
+		std::uint64_t mask_;
+
+	}; //class bit_reference
+
+
+	//forward iterator over the positions of the set bits in an array of words
+	class set_bit_iterator
+	{
+	public:
+		//types
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::size_t*;
+		using reference = std::size_t;
+
+		//ctors
+		set_bit_iterator() noexcept : words_{ nullptr }, count_{ 0 }, index_{ 0 }, word_{ 0 } {}
+
+		//the first set bit of words[0, count), or the end if index == count
+		set_bit_iterator(const std::uint64_t* words, std::size_t count, std::size_t index) noexcept
+			: words_{ words }, count_{ count }, index_{ index }, word_{ index < count ? words[index] : 0 }
+		{
+			_skip();
+		}
+
+		std::size_t operator*() const noexcept { return index_ * 64 + simd::lowest_bit64(word_); }
+
+		set_bit_iterator& operator++() noexcept
+		{
+			word_ &= word_ - 1;
+			_skip();
+			return *this;
+		}
+
+		set_bit_iterator operator++(int) noexcept
+		{
+			set_bit_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		//comparison: iterators over the same words
+		bool operator==(const set_bit_iterator& r) const noexcept { return index_ == r.index_ && word_ == r.word_; }
+		bool operator!=(const set_bit_iterator& r) const noexcept { return !(*this == r); }
+
+	private:
+		//move to the next word with a set bit, if the current word has none
+		void _skip() noexcept
+		{
+			while (word_ == 0 && index_ < count_ && ++index_ < count_)
+				word_ = words_[index_];
+		}
+
+		const std::uint64_t* words_;
+		std::size_t count_;
+		std::size_t index_;
+		std::uint64_t word_;
+
+	}; //class set_bit_iterator
+
+
+	//the positions of the set bits, for a range-for loop
+	class set_bits
+	{
+	public:
+		set_bits(const std::uint64_t* words, std::size_t count) noexcept : words_{ words }, count_{ count } {}
+
+		set_bit_iterator begin() const noexcept { return set_bit_iterator(words_, count_, 0); }
+		set_bit_iterator end() const noexcept { return set_bit_iterator(words_, count_, count_); }
+
+	private:
+		const std::uint64_t* words_;
+		std::size_t count_;
+
+	}; //class set_bits
+
+
+	namespace detail
+	{
+		//call f with the position of every set bit in words[0, count)
+		template<typename F>
+		void for_each_set_bit(const std::uint64_t* words, std::size_t count, F f)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				for (auto word = words[i]; word != 0; word &= word - 1)
+					f(i * 64 + simd::lowest_bit64(word));
+		}
+	}
+
+
+	template<std::size_t N>
+	class bitset
+	{
+	public:
+		//types
+		using word_type = std::uint64_t;
+		using size_type = std::size_t;
+		using reference = bit_reference;
+
+		static constexpr size_type word_bits = 64;
+		static constexpr size_type word_count = (N + word_bits - 1) / word_bits;
+
+		//ctors
+		constexpr bitset() noexcept : words_{} {}
+
+		//the low N bits of value
+		constexpr bitset(unsigned long long value) noexcept : words_{}
+		{
+			if constexpr (word_count != 0) {
+				words_[0] = value;
+				_trim();
+			}
+		}
+
+		//element access
+		constexpr bool operator[](size_type pos) const { return (words_[pos / word_bits] >> (pos % word_bits)) & 1; }
+		constexpr reference operator[](size_type pos) { return reference(&words_[pos / word_bits], pos % word_bits); }
+
+		constexpr bool test(size_type pos) const
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		bool all() const noexcept { return count() == N; }
+		bool any() const noexcept { return !none(); }
+
+		bool none() const noexcept
+		{
+			for (size_type i = 0; i < word_count; ++i)
+				if (words_[i] != 0)
+					return false;
+			return true;
+		}
+
+		//word_count is known here: a bitset of fewer than 16 words never reaches the AVX2 kernel
+		size_type count() const noexcept
+		{
+			if constexpr (word_count >= 16)
+				return detail::count_bits(words_.data(), word_count);
+			else
+				return detail::count_bits_short(words_.data(), word_count);
+		}
+		constexpr size_type size() const noexcept { return N; }
+
+		//modifiers
+		bitset& operator&=(const bitset& b) noexcept { return _combine<detail::word_op::and_op>(b); }
+		bitset& operator|=(const bitset& b) noexcept { return _combine<detail::word_op::or_op>(b); }
+		bitset& operator^=(const bitset& b) noexcept { return _combine<detail::word_op::xor_op>(b); }
+
+		//clear the bits set in b: *this & ~b without a temporary
+		bitset& and_not(const bitset& b) noexcept { return _combine<detail::word_op::and_not_op>(b); }
+
+		bitset& operator<<=(size_type n) noexcept
+		{
+			if (n >= N)
+				return reset();
+
+			const auto shift = n / word_bits, offset = n % word_bits;
+			for (auto i = word_count; i-- != 0; ) {
+				word_type word = 0;
+				if (i >= shift) {
+					word = words_[i - shift] << offset;
+					if (offset != 0 && i > shift)
+						word |= words_[i - shift - 1] >> (word_bits - offset);
+				}
+				words_[i] = word;
+			}
+			_trim();
+			return *this;
+		}
+
+		bitset& operator>>=(size_type n) noexcept
+		{
+			if (n >= N)
+				return reset();
+
+			const auto shift = n / word_bits, offset = n % word_bits;
+			for (size_type i = 0; i < word_count; ++i) {
+				word_type word = 0;
+				if (i + shift < word_count) {
+					word = words_[i + shift] >> offset;
+					if (offset != 0 && i + shift + 1 < word_count)
+						word |= words_[i + shift + 1] << (word_bits - offset);
+				}
+				words_[i] = word;
+			}
+			return *this;
+		}
+
+		bitset& set() noexcept
+		{
+			for (size_type i = 0; i < word_count; ++i)
+				words_[i] = ~word_type{ 0 };
+			_trim();
+			return *this;
+		}
+
+		bitset& set(size_type pos, bool value = true)
+		{
+			_check(pos);
+			(*this)[pos] = value;
+			return *this;
+		}
+
+		bitset& reset() noexcept
+		{
+			for (size_type i = 0; i < word_count; ++i)
+				words_[i] = 0;
+			return *this;
+		}
+
+		bitset& reset(size_type pos) { return set(pos, false); }
+
+		bitset& flip() noexcept
+		{
+			for (size_type i = 0; i < word_count; ++i)
+				words_[i] = ~words_[i];
+			_trim();
+			return *this;
+		}
+
+		bitset& flip(size_type pos)
+		{
+			_check(pos);
+			(*this)[pos].flip();
+			return *this;
+		}
+
+		bitset operator~() const noexcept { return bitset(*this).flip(); }
+		bitset operator<<(size_type n) const noexcept { return bitset(*this) <<= n; }
+		bitset operator>>(size_type n) const noexcept { return bitset(*this) >>= n; }
+
+		//set bits
+		//position of the first set bit at or after pos; size() if there is none
+		size_type find_first() const noexcept { return find_next(0); }
+		size_type find_next(size_type pos) const noexcept
+		{
+			const auto found = detail::find_set_bit(words_.data(), word_count, pos);
+			return found < N ? found : N;
+		}
+
+		template<typename F>
+		void for_each_set(F f) const { detail::for_each_set_bit(words_.data(), word_count, f); }
+
+		set_bits ones() const noexcept { return set_bits(words_.data(), word_count); }
+
+		//underlying words: bit i is bit i % 64 of word i / 64
+		constexpr const word_type* data() const noexcept { return words_.data(); }
+
+		//comparison
+		friend bool operator==(const bitset& x, const bitset& y) noexcept { return x.words_ == y.words_; }
+		friend bool operator!=(const bitset& x, const bitset& y) noexcept { return !(x == y); }
+
+	private:
+		template<detail::word_op Op>
+		bitset& _combine(const bitset& b) noexcept
+		{
+			detail::combine_words<Op>(words_.data(), b.words_.data(), word_count);
+			return *this;
+		}
+
+		//clear the bits past N
+		constexpr void _trim() noexcept
+		{
+			if constexpr (N % word_bits != 0)
+				words_[word_count - 1] &= (word_type{ 1 } << (N % word_bits)) - 1;
+		}
+
+		static constexpr void _check(size_type pos)
+		{
+			if (pos >= N)
+				throw std::out_of_range("bitset index out of range");
+		}
+
+		array<word_type, word_count> words_;
+
+	}; //template bitset
+
+
+	template<std::size_t N>
+	bitset<N> operator&(const bitset<N>& x, const bitset<N>& y) noexcept
+	{
+		return bitset<N>(x) &= y;
+	}
+
+	template<std::size_t N>
+	bitset<N> operator|(const bitset<N>& x, const bitset<N>& y) noexcept
+	{
+		return bitset<N>(x) |= y;
+	}
+
+	template<std::size_t N>
+	bitset<N> operator^(const bitset<N>& x, const bitset<N>& y) noexcept
+	{
+		return bitset<N>(x) ^= y;
+	}
+
+}	//namespace sigcpp
+
+#endif
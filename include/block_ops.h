@@ -0,0 +1,204 @@
+/*
+* block_ops.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define kernels over raw bytes of trivially copyable objects: swap and mismatch
+* - each kernel has an AVX2 path, an SSE2 path, and a scalar path
+* - the path is chosen at run time (see simd.h)
+* - blocks passed to a kernel must not partially overlap
+*/
+
+#ifndef SIGCPP_BLOCK_OPS_H
+#define SIGCPP_BLOCK_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "simd.h"
+
+namespace sigcpp::detail
+{
+	//scalar paths: 8 bytes per step, then single bytes
+
+	inline void swap_bytes_scalar(unsigned char* a, unsigned char* b, std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			std::uint64_t x, y;
+			std::memcpy(&x, a + i, 8);
+			std::memcpy(&y, b + i, 8);
+			std::memcpy(a + i, &y, 8);
+			std::memcpy(b + i, &x, 8);
+		}
+
+		for (; i < n; ++i) {
+			const auto x = a[i];
+			a[i] = b[i];
+			b[i] = x;
+		}
+	}
+
+
+	//index of the first byte that differs, or n if the blocks are equal
+	inline std::size_t mismatch_bytes_scalar(const unsigned char* a, const unsigned char* b,
+		std::size_t n) noexcept
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			if (a[i] != b[i])
+				return i;
+		return n;
+	}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+	//SSE2 paths: 16-byte registers
+
+	inline void swap_bytes_sse2(unsigned char* a, unsigned char* b, std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			const auto pa = reinterpret_cast<__m128i*>(a + i);
+			const auto pb = reinterpret_cast<__m128i*>(b + i);
+			const __m128i a0 = _mm_loadu_si128(pa), a1 = _mm_loadu_si128(pa + 1);
+			const __m128i b0 = _mm_loadu_si128(pb), b1 = _mm_loadu_si128(pb + 1);
+			_mm_storeu_si128(pa, b0);
+			_mm_storeu_si128(pa + 1, b1);
+			_mm_storeu_si128(pb, a0);
+			_mm_storeu_si128(pb + 1, a1);
+		}
+
+		swap_bytes_scalar(a + i, b + i, n - i);
+	}
+
+
+	inline std::size_t mismatch_bytes_sse2(const unsigned char* a, const unsigned char* b,
+		std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+			if (mask != 0xFFFFu)
+				return i + simd::lowest_bit(~mask);
+		}
+
+		return i + mismatch_bytes_scalar(a + i, b + i, n - i);
+	}
+
+
+	//AVX2 paths: 32-byte registers
+
+	SIGCPP_TARGET_AVX2
+	inline void swap_bytes_avx2(unsigned char* a, unsigned char* b, std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 64 <= n; i += 64) {
+			const auto pa = reinterpret_cast<__m256i*>(a + i);
+			const auto pb = reinterpret_cast<__m256i*>(b + i);
+			const __m256i a0 = _mm256_loadu_si256(pa), a1 = _mm256_loadu_si256(pa + 1);
+			const __m256i b0 = _mm256_loadu_si256(pb), b1 = _mm256_loadu_si256(pb + 1);
+			_mm256_storeu_si256(pa, b0);
+			_mm256_storeu_si256(pa + 1, b1);
+			_mm256_storeu_si256(pb, a0);
+			_mm256_storeu_si256(pb + 1, a1);
+		}
+
+		swap_bytes_sse2(a + i, b + i, n - i);
+	}
+
+
+	SIGCPP_TARGET_AVX2
+	inline std::size_t mismatch_bytes_avx2(const unsigned char* a, const unsigned char* b,
+		std::size_t n) noexcept
+	{
+		std::size_t i = 0;
+
+		//4 blocks per step with one branch: locate the block only after a difference
+		for (; i + 128 <= n; i += 128) {
+			const auto pa = reinterpret_cast<const __m256i*>(a + i);
+			const auto pb = reinterpret_cast<const __m256i*>(b + i);
+			const __m256i e0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(pa), _mm256_loadu_si256(pb));
+			const __m256i e1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 1), _mm256_loadu_si256(pb + 1));
+			const __m256i e2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 2), _mm256_loadu_si256(pb + 2));
+			const __m256i e3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 3), _mm256_loadu_si256(pb + 3));
+			const __m256i all = _mm256_and_si256(_mm256_and_si256(e0, e1), _mm256_and_si256(e2, e3));
+			if (static_cast<std::uint32_t>(_mm256_movemask_epi8(all)) != 0xFFFFFFFFu)
+				break;
+		}
+
+		for (; i + 32 <= n; i += 32) {
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+			const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+			const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+			if (mask != 0xFFFFFFFFu)
+				return i + simd::lowest_bit(~mask);
+		}
+
+		return i + mismatch_bytes_sse2(a + i, b + i, n - i);
+	}
+
+#endif //SIGCPP_SIMD_SSE2
+
+
+	//dispatchers
+
+	//blocks shorter than this skip the AVX2 kernels: their setup does not pay
+	constexpr std::size_t avx2_block_min_size = 64;
+
+	//without the AVX2 kernel: for blocks known at compile time to be short, so that the
+	//kernel is not instantiated for them (gcc warns of reads past a short buffer in it)
+	inline void swap_bytes_short(void* a, void* b, std::size_t n) noexcept
+	{
+		const auto x = static_cast<unsigned char*>(a), y = static_cast<unsigned char*>(b);
+#if defined(SIGCPP_SIMD_SSE2)
+		swap_bytes_sse2(x, y, n);
+#else
+		swap_bytes_scalar(x, y, n);
+#endif
+	}
+
+
+	//exchange the contents of [a, a + n) and [b, b + n)
+	inline void swap_bytes(void* a, void* b, std::size_t n) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= avx2_block_min_size && simd::has_avx2())
+			return swap_bytes_avx2(static_cast<unsigned char*>(a), static_cast<unsigned char*>(b), n);
+#endif
+		swap_bytes_short(a, b, n);
+	}
+
+
+	inline std::size_t mismatch_bytes_short(const void* a, const void* b, std::size_t n) noexcept
+	{
+		const auto x = static_cast<const unsigned char*>(a), y = static_cast<const unsigned char*>(b);
+#if defined(SIGCPP_SIMD_SSE2)
+		return mismatch_bytes_sse2(x, y, n);
+#else
+		return mismatch_bytes_scalar(x, y, n);
+#endif
+	}
+
+
+	//index of the first byte that differs in [a, a + n) and [b, b + n); n if none differ
+	inline std::size_t mismatch_bytes(const void* a, const void* b, std::size_t n) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= avx2_block_min_size && simd::has_avx2())
+			return mismatch_bytes_avx2(static_cast<const unsigned char*>(a), static_cast<const unsigned char*>(b), n);
+#endif
+		return mismatch_bytes_short(a, b, n);
+	}
+
+} //namespace sigcpp::detail
+
+#endif
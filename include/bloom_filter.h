@@ -0,0 +1,279 @@
+/*
+* bloom_filter.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for a register-blocked Bloom filter of string keys
+* - the filter is an array of 256-bit blocks; a key sets 8 bits, all in the one block its
+*   hash selects: one bit in each 32-bit lane, so a lookup reads one block (half a cache
+*   line) and, with AVX2, tests all 8 bits with one compare (vptest)
+* - the bit of a lane is the top 5 bits of the low half of the hash times an odd salt per
+*   lane; the block is the high half of the hash times the block count, shifted down, so
+*   the count need not be a power of 2
+* - contains may return true for a key never inserted (a false positive), but never false
+*   for a key inserted; keys cannot be erased (see cuckoo_filter.h for a filter that erases)
+* - at 12 bits per key the false-positive rate is about 0.5%; blocking costs some rate
+*   against a classic Bloom filter of the same size, for one memory access per lookup
+* - blocks are aligned to 32 bytes within the storage vector, so none crosses a cache line;
+*   the vector draws from Allocator
+* - keys are hashed with Hash (string_hash by default: see flat_hash_map.h) and mixed
+* - see Putze, Sanders, and Singler, "Cache-, hash- and space-efficient Bloom filters"
+*   (2007), and the Bloom filter of Apache Impala
+*/
+
+#ifndef SIGCPP_BLOOM_FILTER_H
+#define SIGCPP_BLOOM_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "flat_hash_map.h"
+#include "hash_ops.h"
+#include "simd.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//odd multipliers, one per lane of a block
+		inline constexpr std::uint32_t bloom_salts[8] = { 0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+			0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u };
+
+		//the lane bits of a key, scalar path
+		inline void bloom_mask_scalar(std::uint32_t key, std::uint32_t* mask) noexcept
+		{
+			for (unsigned i = 0; i < 8; ++i)
+				mask[i] = std::uint32_t{ 1 } << ((key * bloom_salts[i]) >> 27);
+		}
+
+		inline void bloom_insert_scalar(std::uint32_t* block, std::uint32_t key) noexcept
+		{
+			std::uint32_t mask[8];
+			bloom_mask_scalar(key, mask);
+			for (unsigned i = 0; i < 8; ++i)
+				block[i] |= mask[i];
+		}
+
+		inline bool bloom_contains_scalar(const std::uint32_t* block, std::uint32_t key) noexcept
+		{
+			std::uint32_t mask[8];
+			bloom_mask_scalar(key, mask);
+			std::uint32_t missing = 0;
+			for (unsigned i = 0; i < 8; ++i)
+				missing |= mask[i] & ~block[i];
+			return missing == 0;
+		}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+		SIGCPP_TARGET_AVX2
+		inline __m256i bloom_mask_avx2(std::uint32_t key) noexcept
+		{
+			const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloom_salts));
+			const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+			return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+		}
+
+		SIGCPP_TARGET_AVX2
+		inline void bloom_insert_avx2(std::uint32_t* block, std::uint32_t key) noexcept
+		{
+			const auto p = reinterpret_cast<__m256i*>(block);
+			_mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), bloom_mask_avx2(key)));
+		}
+
+		//vptest: the carry flag is set if every bit of the mask is set in the block
+		SIGCPP_TARGET_AVX2
+		inline bool bloom_contains_avx2(const std::uint32_t* block, std::uint32_t key) noexcept
+		{
+			return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)), bloom_mask_avx2(key)) != 0;
+		}
+
+#endif //SIGCPP_SIMD_SSE2
+	}
+
+
+	template<typename Hash = string_hash, typename Allocator = std::allocator<std::uint32_t>>
+	class bloom_filter
+	{
+	public:
+		//types
+		using size_type = std::size_t;
+		using hasher = Hash;
+		using allocator_type = Allocator;
+
+		//a block: 256 bits as eight 32-bit lanes
+		static constexpr size_type block_lanes = 8;
+		static constexpr size_type block_bytes = block_lanes * sizeof(std::uint32_t);
+
+		//ctors
+		//room for expectedCount keys at bitsPerKey bits each, in at least one block
+		explicit bloom_filter(size_type expectedCount, size_type bitsPerKey = 12, const Hash& hash = Hash(),
+			const Allocator& alloc = Allocator())
+			: lanes_(alloc), block_count_{ std::max(size_type{ 1 }, (expectedCount * bitsPerKey + 255) / 256) }, hash_(hash)
+		{
+			if (block_count_ > size_type{ 0xFFFFFFFF })
+				throw std::length_error("bloom_filter too large");
+
+			//one spare block: the blocks start at the first lane aligned to 32 bytes
+			lanes_.resize((block_count_ + 1) * block_lanes, 0);
+			_align();
+		}
+
+		bloom_filter(const bloom_filter& b) : lanes_(b.lanes_), block_count_{ b.block_count_ }, hash_(b.hash_)
+		{
+			_align_from(b.first_);
+		}
+
+		bloom_filter(bloom_filter&& b) noexcept = default;
+
+		//the lanes keep this filter's allocator, so the blocks are aligned afresh
+		bloom_filter& operator=(const bloom_filter& b)
+		{
+			if (this != &b) {
+				lanes_ = b.lanes_;
+				block_count_ = b.block_count_;
+				hash_ = b.hash_;
+				_align_from(b.first_);
+			}
+			return *this;
+		}
+
+		//an allocator that does not propagate may move the lanes one by one to another buffer
+		bloom_filter& operator=(bloom_filter&& b) noexcept(std::is_nothrow_move_assignable_v<vector<std::uint32_t, Allocator>>)
+		{
+			const auto source = b.lanes_.data();
+			lanes_ = std::move(b.lanes_);
+			block_count_ = b.block_count_;
+			hash_ = std::move(b.hash_);
+			if (lanes_.data() == source)
+				first_ = b.first_;
+			else
+				_align_from(b.first_);
+			return *this;
+		}
+
+		//modifiers
+		template<typename K>
+		void insert(const K& key)
+		{
+			const auto h = _hash(key);
+			const auto block = _block(h);
+#if defined(SIGCPP_SIMD_SSE2)
+			if (simd::has_avx2())
+				return detail::bloom_insert_avx2(block, static_cast<std::uint32_t>(h));
+#endif
+			detail::bloom_insert_scalar(block, static_cast<std::uint32_t>(h));
+		}
+
+		//add the keys of b, a filter of the same size and hash
+		void merge(const bloom_filter& b)
+		{
+			if (b.block_count_ != block_count_)
+				throw std::invalid_argument("bloom_filter merge: sizes differ");
+
+			for (size_type i = 0; i < block_count_ * block_lanes; ++i)
+				lanes_[first_ + i] |= b.lanes_[b.first_ + i];
+		}
+
+		void clear() noexcept
+		{
+			for (auto& lane : lanes_)
+				lane = 0;
+		}
+
+		void swap(bloom_filter& b) noexcept
+		{
+			using std::swap;
+			lanes_.swap(b.lanes_);
+			swap(first_, b.first_);
+			swap(block_count_, b.block_count_);
+			swap(hash_, b.hash_);
+		}
+
+		//lookup: true if key may have been inserted; false if it certainly was not
+		template<typename K>
+		bool contains(const K& key) const
+		{
+			const auto h = _hash(key);
+			const auto block = _block(h);
+#if defined(SIGCPP_SIMD_SSE2)
+			if (simd::has_avx2())
+				return detail::bloom_contains_avx2(block, static_cast<std::uint32_t>(h));
+#endif
+			return detail::bloom_contains_scalar(block, static_cast<std::uint32_t>(h));
+		}
+
+		//capacity
+		size_type block_count() const noexcept { return block_count_; }
+		size_type size_bytes() const noexcept { return block_count_ * block_bytes; }
+
+		hasher hash_function() const { return hash_; }
+		allocator_type get_allocator() const noexcept { return lanes_.get_allocator(); }
+
+	private:
+		template<typename K>
+		std::uint64_t _hash(const K& key) const
+		{
+			return detail::mix64(static_cast<std::uint64_t>(hash_(key)));
+		}
+
+		//the block of a hash: its high half scaled to [0, block_count_)
+		std::uint32_t* _block(std::uint64_t h) noexcept
+		{
+			return lanes_.data() + first_ + ((h >> 32) * block_count_ >> 32) * block_lanes;
+		}
+
+		const std::uint32_t* _block(std::uint64_t h) const noexcept
+		{
+			return lanes_.data() + first_ + ((h >> 32) * block_count_ >> 32) * block_lanes;
+		}
+
+		//first_: the first lane aligned to 32 bytes; the buffer holds 4-byte lanes, so it is
+		//at most 7 lanes in
+		void _align() noexcept
+		{
+			const auto address = reinterpret_cast<std::uintptr_t>(lanes_.data());
+			first_ = (block_bytes - address % block_bytes) % block_bytes / sizeof(std::uint32_t);
+		}
+
+		//after a copy: move the blocks from where they were aligned in the source buffer
+		void _align_from(size_type sourceFirst) noexcept
+		{
+			_align();
+			if (first_ != sourceFirst) {
+				const auto p = lanes_.data();
+				std::memmove(p + first_, p + sourceFirst, block_count_ * block_bytes);
+			}
+		}
+
+		vector<std::uint32_t, Allocator> lanes_;
+		size_type first_;
+		size_type block_count_;
+		Hash hash_;
+
+	}; //template bloom_filter
+
+
+	//specialized algorithms
+	template<typename Hash, typename Allocator>
+	void swap(bloom_filter<Hash, Allocator>& x, bloom_filter<Hash, Allocator>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
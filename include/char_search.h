@@ -0,0 +1,377 @@
+/*
+* char_search.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define kernels to scan char sequences for a char or for a set of chars
+* - each kernel has an AVX2 path, an SSE2 path, and a scalar path
+* - the path is chosen at run time (see simd.h)
+* - kernels return an index, or not_found if no char qualifies
+*/
+
+#ifndef SIGCPP_CHAR_SEARCH_H
+#define SIGCPP_CHAR_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.h"
+
+namespace sigcpp::detail
+{
+	constexpr std::size_t not_found = static_cast<std::size_t>(-1);
+
+	//largest set for which SSE2 compares each set member against the text
+	//larger sets use the AVX2 nibble lookup or the scalar bitmap
+	constexpr std::size_t sse2_max_set_size = 8;
+
+
+	//membership tables for a set of chars
+	//- bitmap: one bit per char value, for scalar code
+	//- nibble tables: for char c with low nibble l and high nibble h, bit (h % 8) of
+	//  low_rows[l] (h < 8) or high_rows[l] (h >= 8) is set; used with pshufb
+	struct char_set
+	{
+		std::uint8_t bitmap[32]{};
+		alignas(16) std::uint8_t low_rows[16]{};
+		alignas(16) std::uint8_t high_rows[16]{};
+
+		char_set(const char* set, std::size_t m) noexcept
+		{
+			for (std::size_t i = 0; i < m; ++i) {
+				const auto c = static_cast<unsigned char>(set[i]);
+				bitmap[c >> 3] |= static_cast<std::uint8_t>(1u << (c & 7));
+
+				const auto bit = static_cast<std::uint8_t>(1u << ((c >> 4) & 7));
+				if (c < 128)
+					low_rows[c & 15] |= bit;
+				else
+					high_rows[c & 15] |= bit;
+			}
+		}
+
+		bool contains(char ch) const noexcept
+		{
+			const auto c = static_cast<unsigned char>(ch);
+			return (bitmap[c >> 3] & (1u << (c & 7))) != 0;
+		}
+	};
+
+
+	//scalar paths
+
+	inline std::size_t find_char_scalar(const char* s, std::size_t n, char c) noexcept
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			if (s[i] == c)
+				return i;
+		return not_found;
+	}
+
+
+	inline std::size_t rfind_char_scalar(const char* s, std::size_t n, char c) noexcept
+	{
+		while (n-- != 0)
+			if (s[n] == c)
+				return n;
+		return not_found;
+	}
+
+
+	inline std::size_t find_in_set_scalar(const char* s, std::size_t n, const char_set& set,
+		bool in_set) noexcept
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			if (set.contains(s[i]) == in_set)
+				return i;
+		return not_found;
+	}
+
+
+	inline std::size_t rfind_in_set_scalar(const char* s, std::size_t n, const char_set& set,
+		bool in_set) noexcept
+	{
+		while (n-- != 0)
+			if (set.contains(s[n]) == in_set)
+				return n;
+		return not_found;
+	}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+	//SSE2 paths: 16 chars per step
+
+	inline std::size_t find_char_sse2(const char* s, std::size_t n, char c) noexcept
+	{
+		const __m128i needle = _mm_set1_epi8(c);
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+			const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(text, needle)));
+			if (mask != 0)
+				return i + simd::lowest_bit(mask);
+		}
+
+		const auto pos = find_char_scalar(s + i, n - i, c);
+		return pos == not_found ? not_found : i + pos;
+	}
+
+
+	inline std::size_t rfind_char_sse2(const char* s, std::size_t n, char c) noexcept
+	{
+		const __m128i needle = _mm_set1_epi8(c);
+		for (; n >= 16; n -= 16) {
+			const __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + n - 16));
+			const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(text, needle)));
+			if (mask != 0)
+				return n - 16 + simd::highest_bit(mask);
+		}
+
+		return rfind_char_scalar(s, n, c);
+	}
+
+
+	//mask of positions in a 16-char block whose membership in set matches in_set
+	//compares each block against every member of a small set
+	inline std::uint32_t set_mask_sse2(__m128i text, const char* set, std::size_t m,
+		bool in_set) noexcept
+	{
+		__m128i match = _mm_setzero_si128();
+		for (std::size_t j = 0; j < m; ++j)
+			match = _mm_or_si128(match, _mm_cmpeq_epi8(text, _mm_set1_epi8(set[j])));
+
+		const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(match));
+		return in_set ? mask : ~mask & 0xFFFFu;
+	}
+
+
+	inline std::size_t find_in_set_sse2(const char* s, std::size_t n, const char* set, std::size_t m,
+		const char_set& table, bool in_set) noexcept
+	{
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+			const auto mask = set_mask_sse2(text, set, m, in_set);
+			if (mask != 0)
+				return i + simd::lowest_bit(mask);
+		}
+
+		const auto pos = find_in_set_scalar(s + i, n - i, table, in_set);
+		return pos == not_found ? not_found : i + pos;
+	}
+
+
+	inline std::size_t rfind_in_set_sse2(const char* s, std::size_t n, const char* set, std::size_t m,
+		const char_set& table, bool in_set) noexcept
+	{
+		for (; n >= 16; n -= 16) {
+			const __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + n - 16));
+			const auto mask = set_mask_sse2(text, set, m, in_set);
+			if (mask != 0)
+				return n - 16 + simd::highest_bit(mask);
+		}
+
+		return rfind_in_set_scalar(s, n, table, in_set);
+	}
+
+
+	//AVX2 paths: 32 chars per step
+
+	SIGCPP_TARGET_AVX2
+	inline std::size_t find_char_avx2(const char* s, std::size_t n, char c) noexcept
+	{
+		const __m256i needle = _mm256_set1_epi8(c);
+		std::size_t i = 0;
+
+		//4 blocks per step with one branch: locate the block only after a hit
+		for (; i + 128 <= n; i += 128) {
+			const auto p = reinterpret_cast<const __m256i*>(s + i);
+			const __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p), needle);
+			const __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), needle);
+			const __m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 2), needle);
+			const __m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 3), needle);
+			const __m256i any = _mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3));
+			if (_mm256_movemask_epi8(any) != 0)
+				break;
+		}
+
+		for (; i + 32 <= n; i += 32) {
+			const __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+			const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(text, needle)));
+			if (mask != 0)
+				return i + simd::lowest_bit(mask);
+		}
+
+		const auto pos = find_char_sse2(s + i, n - i, c);
+		return pos == not_found ? not_found : i + pos;
+	}
+
+
+	SIGCPP_TARGET_AVX2
+	inline std::size_t rfind_char_avx2(const char* s, std::size_t n, char c) noexcept
+	{
+		const __m256i needle = _mm256_set1_epi8(c);
+		for (; n >= 128; n -= 128) {
+			const auto p = reinterpret_cast<const __m256i*>(s + n - 128);
+			const __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p), needle);
+			const __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), needle);
+			const __m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 2), needle);
+			const __m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 3), needle);
+			const __m256i any = _mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3));
+			if (_mm256_movemask_epi8(any) != 0)
+				break;
+		}
+
+		for (; n >= 32; n -= 32) {
+			const __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + n - 32));
+			const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(text, needle)));
+			if (mask != 0)
+				return n - 32 + simd::highest_bit(mask);
+		}
+
+		return rfind_char_sse2(s, n, c);
+	}
+
+
+	//mask of positions in a 32-char block whose membership in set matches in_set
+	//looks up each char's row by its low nibble and tests the bit selected by its high nibble
+	//works for sets of any size at a fixed cost per block
+	SIGCPP_TARGET_AVX2
+	inline std::uint32_t set_mask_avx2(__m256i text, __m256i low_rows, __m256i high_rows,
+		bool in_set) noexcept
+	{
+		const __m256i nibble = _mm256_set1_epi8(0x0F);
+		const __m256i bits = _mm256_setr_epi8(
+			1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+			1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+		const __m256i lo = _mm256_and_si256(text, nibble);
+		const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(text, 4), nibble);
+
+		//choose the row from the high table for chars >= 128 (sign bit set)
+		const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, lo),
+			_mm256_shuffle_epi8(high_rows, lo), text);
+		const __m256i bit = _mm256_shuffle_epi8(bits, hi);
+		const __m256i match = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+
+		const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+		return in_set ? mask : ~mask;
+	}
+
+
+	SIGCPP_TARGET_AVX2
+	inline std::size_t find_in_set_avx2(const char* s, std::size_t n, const char_set& table,
+		bool in_set) noexcept
+	{
+		const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(table.low_rows));
+		const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(table.high_rows));
+		const __m256i low_rows = _mm256_broadcastsi128_si256(low);
+		const __m256i high_rows = _mm256_broadcastsi128_si256(high);
+
+		std::size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			const __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+			const auto mask = set_mask_avx2(text, low_rows, high_rows, in_set);
+			if (mask != 0)
+				return i + simd::lowest_bit(mask);
+		}
+
+		const auto pos = find_in_set_scalar(s + i, n - i, table, in_set);
+		return pos == not_found ? not_found : i + pos;
+	}
+
+
+	SIGCPP_TARGET_AVX2
+	inline std::size_t rfind_in_set_avx2(const char* s, std::size_t n, const char_set& table,
+		bool in_set) noexcept
+	{
+		const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(table.low_rows));
+		const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(table.high_rows));
+		const __m256i low_rows = _mm256_broadcastsi128_si256(low);
+		const __m256i high_rows = _mm256_broadcastsi128_si256(high);
+
+		for (; n >= 32; n -= 32) {
+			const __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + n - 32));
+			const auto mask = set_mask_avx2(text, low_rows, high_rows, in_set);
+			if (mask != 0)
+				return n - 32 + simd::highest_bit(mask);
+		}
+
+		return rfind_in_set_scalar(s, n, table, in_set);
+	}
+
+#endif //SIGCPP_SIMD_SSE2
+
+
+	//dispatchers
+
+	//first position of c in [s, s + n)
+	inline std::size_t find_char(const char* s, std::size_t n, char c) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 32 && simd::has_avx2())
+			return find_char_avx2(s, n, c);
+		return find_char_sse2(s, n, c);
+#else
+		return find_char_scalar(s, n, c);
+#endif
+	}
+
+
+	//last position of c in [s, s + n)
+	inline std::size_t rfind_char(const char* s, std::size_t n, char c) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 32 && simd::has_avx2())
+			return rfind_char_avx2(s, n, c);
+		return rfind_char_sse2(s, n, c);
+#else
+		return rfind_char_scalar(s, n, c);
+#endif
+	}
+
+
+	//first position in [s, s + n) whose membership in set [set, set + m) equals in_set
+	inline std::size_t find_in_set(const char* s, std::size_t n, const char* set, std::size_t m,
+		bool in_set) noexcept
+	{
+		if (in_set && m == 1)
+			return find_char(s, n, set[0]);
+
+		const char_set table(set, m);
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 32 && simd::has_avx2())
+			return find_in_set_avx2(s, n, table, in_set);
+		if (m <= sse2_max_set_size)
+			return find_in_set_sse2(s, n, set, m, table, in_set);
+#endif
+		return find_in_set_scalar(s, n, table, in_set);
+	}
+
+
+	//last position in [s, s + n) whose membership in set [set, set + m) equals in_set
+	inline std::size_t rfind_in_set(const char* s, std::size_t n, const char* set, std::size_t m,
+		bool in_set) noexcept
+	{
+		if (in_set && m == 1)
+			return rfind_char(s, n, set[0]);
+
+		const char_set table(set, m);
+#if defined(SIGCPP_SIMD_SSE2)
+		if (n >= 32 && simd::has_avx2())
+			return rfind_in_set_avx2(s, n, table, in_set);
+		if (m <= sse2_max_set_size)
+			return rfind_in_set_sse2(s, n, set, m, table, in_set);
+#endif
+		return rfind_in_set_scalar(s, n, table, in_set);
+	}
+
+} //namespace sigcpp::detail
+
+#endif
@@ -0,0 +1,432 @@
+/*
+* compressed_sorted_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a read-only sequence of sorted 32-bit unsigned integers, stored compressed
+* - the values are split into blocks of 128; a block stores its first value, and the
+*   differences of adjacent values bit-packed at the width of the largest difference
+*   (see packed_array.h), so a block of width w takes 2 * w words
+* - the skip index is the largest (last) value of every block, in its own array: lower_bound
+*   binary-searches it and decodes just one block
+* - a block decodes with the bulk unpack of packed_array (AVX2 where it applies), and then
+*   a prefix sum (SSE2 where it applies)
+* - iterators are forward iterators that hold the decoded block; an iterator is large, as
+*   it holds 128 values, and stays valid as long as the array does
+* - values may repeat: the input must be in non-decreasing order; else the ctor throws
+*   std::invalid_argument
+* - the words, the blocks, and the skip index draw from Allocator, rebound
+* - see Lemire and Boytsov, "Decoding billions of integers per second through
+*   vectorization" (2015)
+*/
+
+#ifndef SIGCPP_COMPRESSED_SORTED_ARRAY_H
+#define SIGCPP_COMPRESSED_SORTED_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "array.h"
+#include "packed_array.h"
+#include "simd.h"
+#include "span.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//values[i] = base + sum of values[0, i]: the differences of a block to its values
+		inline void prefix_sum_scalar(std::uint32_t* values, std::size_t n, std::uint32_t base) noexcept
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				values[i] = base += values[i];
+		}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+		//4 values per step: two shifted adds sum the lanes, and the last lane carries on
+		inline void prefix_sum_sse2(std::uint32_t* values, std::size_t n, std::uint32_t base) noexcept
+		{
+			__m128i carry = _mm_set1_epi32(static_cast<int>(base));
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const auto p = reinterpret_cast<__m128i*>(values + i);
+				__m128i x = _mm_loadu_si128(p);
+				x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+				x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+				x = _mm_add_epi32(x, carry);
+				_mm_storeu_si128(p, x);
+				carry = _mm_shuffle_epi32(x, 0xFF);
+			}
+
+			prefix_sum_scalar(values + i, n - i, i == 0 ? base : values[i - 1]);
+		}
+
+#endif //SIGCPP_SIMD_SSE2
+
+
+		inline void prefix_sum(std::uint32_t* values, std::size_t n, std::uint32_t base) noexcept
+		{
+#if defined(SIGCPP_SIMD_SSE2)
+			prefix_sum_sse2(values, n, base);
+#else
+			prefix_sum_scalar(values, n, base);
+#endif
+		}
+
+
+		//pack and unpack the first count values of words at a width known only at run time:
+		//a table of the instances for widths 0 to 32; width 0 stores nothing
+		using pack_function = void(*)(std::uint64_t*, std::size_t, const std::uint32_t*);
+		using unpack_function = void(*)(const std::uint64_t*, std::size_t, std::size_t, std::uint32_t*);
+
+		template<unsigned Bits>
+		void pack_width(std::uint64_t* words, std::size_t count, const std::uint32_t* in) noexcept
+		{
+			if constexpr (Bits != 0)
+				pack_scalar<Bits>(words, 0, count, in);
+		}
+
+		template<unsigned Bits>
+		void unpack_width(const std::uint64_t* words, std::size_t wordCount, std::size_t count, std::uint32_t* out) noexcept
+		{
+			if constexpr (Bits == 0)
+				std::fill(out, out + count, std::uint32_t{ 0 });
+			else
+				unpack<Bits>(words, wordCount, 0, count, out);
+		}
+
+		template<std::size_t... Widths>
+		constexpr array<pack_function, sizeof...(Widths)> make_pack_table(std::index_sequence<Widths...>) noexcept
+		{
+			return { pack_width<Widths>... };
+		}
+
+		template<std::size_t... Widths>
+		constexpr array<unpack_function, sizeof...(Widths)> make_unpack_table(std::index_sequence<Widths...>) noexcept
+		{
+			return { unpack_width<Widths>... };
+		}
+
+		inline constexpr auto pack_table = make_pack_table(std::make_index_sequence<33>());
+		inline constexpr auto unpack_table = make_unpack_table(std::make_index_sequence<33>());
+	}
+
+
+	template<typename Allocator = std::allocator<std::uint32_t>>
+	class compressed_sorted_array
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+
+	public:
+		//types
+		using value_type = std::uint32_t;
+		using word_type = std::uint64_t;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		static constexpr size_type block_size = 128;
+
+		class const_iterator;
+		using iterator = const_iterator;
+
+		//ctors
+		compressed_sorted_array() : compressed_sorted_array(Allocator()) {}
+
+		explicit compressed_sorted_array(const Allocator& alloc) noexcept
+			: words_(word_allocator(alloc)), blocks_(block_allocator(alloc)), maxima_(alloc), size_{ 0 } {}
+
+		//values must be in non-decreasing order
+		explicit compressed_sorted_array(span<const value_type> values, const Allocator& alloc = Allocator())
+			: compressed_sorted_array(alloc)
+		{
+			size_ = values.size();
+			_encode(values);
+		}
+
+		compressed_sorted_array(std::initializer_list<value_type> il, const Allocator& alloc = Allocator())
+			: compressed_sorted_array(span<const value_type>(il.begin(), il.size()), alloc) {}
+
+		allocator_type get_allocator() const noexcept { return maxima_.get_allocator(); }
+
+		//capacity
+		bool empty() const noexcept { return size_ == 0; }
+		size_type size() const noexcept { return size_; }
+		size_type block_count() const noexcept { return maxima_.size(); }
+
+		//bytes of the compressed values and the index: the memory the array uses, apart from
+		//spare capacity
+		size_type size_bytes() const noexcept
+		{
+			return words_.size() * sizeof(word_type) + blocks_.size() * sizeof(block_info) +
+				maxima_.size() * sizeof(value_type);
+		}
+
+		//iterators
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, size_); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		//call f with every value in order: faster than the iterators, whose position lives
+		//next to the buffer in memory rather than in a register
+		template<typename F>
+		void for_each(F f) const
+		{
+			array<value_type, block_size> buffer;
+			for (size_type block = 0; block < maxima_.size(); ++block) {
+				const auto count = std::min(block_size, size_ - block * block_size);
+				_decode(block, count, buffer.data());
+				for (size_type i = 0; i < count; ++i)
+					f(buffer[i]);
+			}
+		}
+
+		//search: the first value not less than value, or end()
+		const_iterator lower_bound(value_type value) const
+		{
+			const auto block = _block_for(value, 0);
+			if (block == maxima_.size())
+				return end();
+
+			const_iterator it(this, block * block_size);
+			it._seek_in_block(value);
+			return it;
+		}
+
+		bool contains(value_type value) const
+		{
+			const auto it = lower_bound(value);
+			return it != end() && *it == value;
+		}
+
+		//block access
+		value_type block_max(size_type block) const { return maxima_[block]; }
+
+		//the values of a block into out; the number of values: block_size, except perhaps
+		//for the last block; out must have room for them
+		size_type decode_block(size_type block, span<value_type> out) const
+		{
+			if (block >= maxima_.size())
+				throw std::out_of_range("compressed_sorted_array block out of range");
+
+			const auto count = std::min(block_size, size_ - block * block_size);
+			if (out.size() < count)
+				throw std::invalid_argument("compressed_sorted_array decode_block: out is too small");
+
+			_decode(block, count, out.data());
+			return count;
+		}
+
+		void swap(compressed_sorted_array& a) noexcept
+		{
+			words_.swap(a.words_);
+			blocks_.swap(a.blocks_);
+			maxima_.swap(a.maxima_);
+			std::swap(size_, a.size_);
+		}
+
+		//comparison: equal values are encoded equally
+		friend bool operator==(const compressed_sorted_array& x, const compressed_sorted_array& y)
+		{
+			return x.size_ == y.size_ && x.blocks_ == y.blocks_ && x.words_ == y.words_;
+		}
+
+		friend bool operator!=(const compressed_sorted_array& x, const compressed_sorted_array& y) { return !(x == y); }
+
+	private:
+		//a block: its first value, the width of its differences, and its first word
+		struct block_info
+		{
+			value_type first;
+			std::uint32_t width;
+			size_type offset;
+
+			friend bool operator==(const block_info& x, const block_info& y)
+			{
+				return x.first == y.first && x.width == y.width && x.offset == y.offset;
+			}
+		};
+
+		using word_allocator = typename alloc_traits::template rebind_alloc<word_type>;
+		using block_allocator = typename alloc_traits::template rebind_alloc<block_info>;
+
+		void _encode(span<const value_type> values)
+		{
+			const auto count = (size_ + block_size - 1) / block_size;
+			blocks_.reserve(count);
+			maxima_.reserve(count);
+
+			array<value_type, block_size> deltas;
+			size_type offset = 0;
+			for (size_type start = 0; start < size_; start += block_size) {
+				const auto n = std::min(block_size, size_ - start);
+				const auto first = values[start];
+
+				//the first difference is 0, as the block stores its first value
+				value_type largest = 0;
+				deltas[0] = 0;
+				for (size_type i = 1; i < n; ++i) {
+					if (values[start + i] < values[start + i - 1])
+						throw std::invalid_argument("compressed_sorted_array: values are not sorted");
+					deltas[i] = values[start + i] - values[start + i - 1];
+					largest = std::max(largest, deltas[i]);
+				}
+				if (start != 0 && first < values[start - 1])
+					throw std::invalid_argument("compressed_sorted_array: values are not sorted");
+
+				const auto width = largest == 0 ? 0u : simd::highest_bit(largest) + 1;
+
+				//every block has room for block_size values; one more word follows the last
+				//block, for the two-word reads of the unpack
+				words_.resize(offset + 2 * width + 1, 0);
+				detail::pack_table[width](words_.data() + offset, n, deltas.data());
+
+				blocks_.push_back(block_info{ first, width, offset });
+				maxima_.push_back(values[start + n - 1]);
+				offset += 2 * width;
+			}
+		}
+
+		void _decode(size_type block, size_type count, value_type* out) const
+		{
+			const auto& info = blocks_[block];
+			detail::unpack_table[info.width](words_.data() + info.offset, words_.size() - info.offset, count, out);
+			detail::prefix_sum(out, count, info.first);
+		}
+
+		//the first block at or after from whose largest value is not less than value
+		size_type _block_for(value_type value, size_type from) const
+		{
+			const auto it = std::lower_bound(maxima_.begin() + from, maxima_.end(), value);
+			return static_cast<size_type>(it - maxima_.begin());
+		}
+
+		vector<word_type, word_allocator> words_;
+		vector<block_info, block_allocator> blocks_;
+		vector<value_type, Allocator> maxima_;
+		size_type size_;
+
+	public:
+		//forward iterator: holds the decoded block of the current value
+		class const_iterator
+		{
+		public:
+			//types
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::uint32_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			//ctors
+			const_iterator() noexcept : owner_{ nullptr }, pos_{ 0 }, count_{ 0 } {}
+
+			reference operator*() const { return buffer_[pos_ % block_size]; }
+			pointer operator->() const { return &**this; }
+
+			const_iterator& operator++()
+			{
+				if (++pos_ % block_size == 0)
+					_load();
+				return *this;
+			}
+
+			const_iterator operator++(int)
+			{
+				const_iterator beforeIncrement = *this;
+				++*this;
+				return beforeIncrement;
+			}
+
+			//move to the first value not less than value, at or after the current value: the
+			//skip index passes over the blocks in between without decoding them
+			const_iterator& seek(value_type value)
+			{
+				if (pos_ >= owner_->size_)
+					return *this;
+
+				const auto block = pos_ / block_size;
+				if (owner_->maxima_[block] < value) {
+					const auto next = owner_->_block_for(value, block + 1);
+					pos_ = next * block_size;
+					if (next == owner_->maxima_.size()) {
+						pos_ = owner_->size_;
+						return *this;
+					}
+					_load();
+				}
+				_seek_in_block(value);
+				return *this;
+			}
+
+			//position of the current value in the array
+			size_type index() const noexcept { return pos_; }
+
+			//comparison: iterators of the same array
+			bool operator==(const const_iterator& r) const noexcept { return pos_ == r.pos_; }
+			bool operator!=(const const_iterator& r) const noexcept { return pos_ != r.pos_; }
+
+		private:
+			friend class compressed_sorted_array;
+
+			const_iterator(const compressed_sorted_array* owner, size_type pos) : owner_{ owner }, pos_{ pos }, count_{ 0 }
+			{
+				_load();
+			}
+
+			//decode the block of pos_, unless pos_ is the end
+			void _load()
+			{
+				if (pos_ >= owner_->size_) {
+					pos_ = owner_->size_;
+					return;
+				}
+
+				const auto block = pos_ / block_size;
+				count_ = std::min(block_size, owner_->size_ - block * block_size);
+				owner_->_decode(block, count_, buffer_.data());
+			}
+
+			//in the decoded block, whose largest value is not less than value
+			void _seek_in_block(value_type value)
+			{
+				const auto offset = pos_ % block_size;
+				const auto found = std::lower_bound(buffer_.data() + offset, buffer_.data() + count_, value);
+				pos_ += static_cast<size_type>(found - (buffer_.data() + offset));
+			}
+
+			const compressed_sorted_array* owner_;
+			size_type pos_;
+			size_type count_;
+			array<value_type, block_size> buffer_;
+
+		}; //class const_iterator
+
+	}; //template compressed_sorted_array
+
+
+	//specialized algorithms
+	template<typename Allocator>
+	void swap(compressed_sorted_array<Allocator>& x, compressed_sorted_array<Allocator>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
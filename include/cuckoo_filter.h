@@ -0,0 +1,287 @@
+/*
+* cuckoo_filter.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for a cuckoo filter of string keys: a membership filter that
+* supports erase
+* - a key is stored as a fingerprint (8 or 16 bits of its hash, never 0) in one of two
+*   buckets of 4 slots; the second bucket is the first xor a hash of the fingerprint, so
+*   either bucket is found from the other and the fingerprint alone
+* - a bucket is one word (32 bits for 8-bit fingerprints, 64 for 16-bit), and a lookup
+*   compares the 4 slots of a bucket at once, with SWAR arithmetic in a register
+* - insert relocates fingerprints between their buckets to make room; after 500 moves the
+*   filter is full: the last fingerprint moved out is kept aside (so no inserted key is
+*   ever reported absent), and insert returns false from then on
+* - contains may return true for a key never inserted (a false positive), at a rate of
+*   about 8 / 2^Bits: about 3% for 8-bit and 0.012% for 16-bit fingerprints
+* - erase must only be given keys that were inserted: erasing any other key whose
+*   fingerprint matches one stored removes that one
+* - the bucket count is a power of 2 for a load factor of at most 95% at expectedCount
+* - keys are hashed with Hash (string_hash by default: see flat_hash_map.h) and mixed
+* - the buckets draw from Allocator, rebound to the bucket word
+* - see Fan, Andersen, Kaminsky, and Mitzenmacher, "Cuckoo filter: practically better
+*   than Bloom" (2014)
+*/
+
+#ifndef SIGCPP_CUCKOO_FILTER_H
+#define SIGCPP_CUCKOO_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "flat_hash_map.h"
+#include "hash_ops.h"
+#include "simd.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	template<typename Fingerprint = std::uint16_t, typename Hash = string_hash,
+		typename Allocator = std::allocator<Fingerprint>>
+	class cuckoo_filter
+	{
+		static_assert(std::is_same_v<Fingerprint, std::uint8_t> || std::is_same_v<Fingerprint, std::uint16_t>,
+			"Fingerprint must be std::uint8_t or std::uint16_t");
+
+	public:
+		//types
+		using size_type = std::size_t;
+		using fingerprint_type = Fingerprint;
+		using bucket_type = std::conditional_t<sizeof(Fingerprint) == 1, std::uint32_t, std::uint64_t>;
+		using hasher = Hash;
+		using allocator_type = Allocator;
+
+		static constexpr size_type bucket_slots = 4;
+		static constexpr unsigned fingerprint_bits = sizeof(Fingerprint) * 8;
+		static constexpr unsigned max_moves = 500;
+
+		//ctors
+		explicit cuckoo_filter(size_type expectedCount, const Hash& hash = Hash(), const Allocator& alloc = Allocator())
+			: buckets_(_bucket_count_for(expectedCount), 0, bucket_allocator(alloc)), size_{ 0 }, victim_{ 0 }, victimBucket_{ 0 },
+			state_{ 0x9E3779B97F4A7C15ull }, hash_(hash)
+		{
+		}
+
+		//modifiers
+		//false if the filter is already full (see full()): the key is then not stored
+		template<typename K>
+		bool insert(const K& key)
+		{
+			if (victim_ != 0)
+				return false;
+
+			auto [bucket, fp] = _locate(key);
+			if (_put(bucket, fp) || _put(_alternate(bucket, fp), fp)) {
+				++size_;
+				return true;
+			}
+
+			//evict a random fingerprint of either bucket to its other bucket, and so on
+			if ((_random() & 1) != 0)
+				bucket = _alternate(bucket, fp);
+			for (unsigned move = 0; move < max_moves; ++move) {
+				const auto slot = static_cast<unsigned>(_random() % bucket_slots);
+				const auto evicted = _slot(buckets_[bucket], slot);
+				_set_slot(buckets_[bucket], slot, fp);
+				fp = evicted;
+				bucket = _alternate(bucket, fp);
+				if (_put(bucket, fp)) {
+					++size_;
+					return true;
+				}
+			}
+
+			//full: the key is in the filter, but the last evicted fingerprint is set aside
+			victim_ = fp;
+			victimBucket_ = bucket;
+			++size_;
+			return true;
+		}
+
+		//remove one copy of a key that was inserted; false if no fingerprint matched
+		template<typename K>
+		bool erase(const K& key)
+		{
+			const auto [bucket, fp] = _locate(key);
+			if (_take(bucket, fp) || _take(_alternate(bucket, fp), fp) || _take_victim(bucket, fp)) {
+				--size_;
+
+				//the victim moves back in, now that there may be room
+				if (victim_ != 0) {
+					const auto victim = victim_;
+					victim_ = 0;
+					if (_put(victimBucket_, victim) || _put(_alternate(victimBucket_, victim), victim))
+						return true;
+					victim_ = victim;
+				}
+				return true;
+			}
+			return false;
+		}
+
+		void clear() noexcept
+		{
+			for (auto& bucket : buckets_)
+				bucket = 0;
+			size_ = 0;
+			victim_ = 0;
+		}
+
+		void swap(cuckoo_filter& f) noexcept
+		{
+			using std::swap;
+			buckets_.swap(f.buckets_);
+			swap(size_, f.size_);
+			swap(victim_, f.victim_);
+			swap(victimBucket_, f.victimBucket_);
+			swap(state_, f.state_);
+			swap(hash_, f.hash_);
+		}
+
+		//lookup: true if key may have been inserted; false if it certainly was not
+		template<typename K>
+		bool contains(const K& key) const
+		{
+			const auto [bucket, fp] = _locate(key);
+			return _has(buckets_[bucket], fp) || _has(buckets_[_alternate(bucket, fp)], fp) ||
+				(victim_ == fp && (victimBucket_ == bucket || victimBucket_ == _alternate(bucket, fp)));
+		}
+
+		//capacity
+		bool empty() const noexcept { return size_ == 0; }
+		size_type size() const noexcept { return size_; }
+		size_type bucket_count() const noexcept { return buckets_.size(); }
+		size_type capacity() const noexcept { return buckets_.size() * bucket_slots; }
+		bool full() const noexcept { return victim_ != 0; }
+		double load_factor() const noexcept { return static_cast<double>(size_) / capacity(); }
+		size_type size_bytes() const noexcept { return buckets_.size() * sizeof(bucket_type); }
+
+		hasher hash_function() const { return hash_; }
+		allocator_type get_allocator() const noexcept { return Allocator(buckets_.get_allocator()); }
+
+	private:
+		using bucket_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<bucket_type>;
+
+		//SWAR constants: 1 and the high bit in every slot
+		static constexpr bucket_type slot_mask = std::numeric_limits<Fingerprint>::max();
+		static constexpr bucket_type low_bits = static_cast<bucket_type>(~bucket_type{ 0 } / slot_mask);
+		static constexpr bucket_type high_bits = static_cast<bucket_type>(low_bits << (fingerprint_bits - 1));
+
+		static size_type _bucket_count_for(size_type expectedCount) noexcept
+		{
+			const auto slots = expectedCount + expectedCount / 19 + 1;
+			return detail::ceil_power_of_2((slots + bucket_slots - 1) / bucket_slots);
+		}
+
+		//the first bucket from the low half of the hash, the fingerprint from the high half
+		template<typename K>
+		std::pair<size_type, bucket_type> _locate(const K& key) const
+		{
+			const auto h = detail::mix64(static_cast<std::uint64_t>(hash_(key)));
+			auto fp = static_cast<bucket_type>((h >> 32) & slot_mask);
+			if (fp == 0)
+				fp = 1;
+			return { static_cast<size_type>(h) & (buckets_.size() - 1), fp };
+		}
+
+		size_type _alternate(size_type bucket, bucket_type fp) const noexcept
+		{
+			return (bucket ^ static_cast<size_type>(detail::mix64(fp))) & (buckets_.size() - 1);
+		}
+
+		//high bit set in every slot that is 0: exact for the lowest such slot, and nonzero if
+		//and only if some slot is 0
+		static constexpr bucket_type _zero_slots(bucket_type bucket) noexcept
+		{
+			return static_cast<bucket_type>((bucket - low_bits) & ~bucket & high_bits);
+		}
+
+		static constexpr bool _has(bucket_type bucket, bucket_type fp) noexcept
+		{
+			return _zero_slots(bucket ^ (fp * low_bits)) != 0;
+		}
+
+		static constexpr bucket_type _slot(bucket_type bucket, unsigned slot) noexcept
+		{
+			return (bucket >> (slot * fingerprint_bits)) & slot_mask;
+		}
+
+		static constexpr void _set_slot(bucket_type& bucket, unsigned slot, bucket_type fp) noexcept
+		{
+			const auto shift = slot * fingerprint_bits;
+			bucket = static_cast<bucket_type>((bucket & ~(slot_mask << shift)) | (fp << shift));
+		}
+
+		//the lowest slot that matches: the slot of the lowest high bit of the SWAR result
+		static unsigned _lowest_slot(bucket_type matches) noexcept
+		{
+			return simd::lowest_bit64(matches) / fingerprint_bits;
+		}
+
+		//store fp in a free slot of the bucket
+		bool _put(size_type bucket, bucket_type fp) noexcept
+		{
+			const auto free = _zero_slots(buckets_[bucket]);
+			if (free == 0)
+				return false;
+			_set_slot(buckets_[bucket], _lowest_slot(free), fp);
+			return true;
+		}
+
+		//clear one slot of the bucket that holds fp
+		bool _take(size_type bucket, bucket_type fp) noexcept
+		{
+			const auto matches = _zero_slots(buckets_[bucket] ^ (fp * low_bits));
+			if (matches == 0)
+				return false;
+			_set_slot(buckets_[bucket], _lowest_slot(matches), 0);
+			return true;
+		}
+
+		bool _take_victim(size_type bucket, bucket_type fp) noexcept
+		{
+			if (victim_ != fp || (victimBucket_ != bucket && victimBucket_ != _alternate(bucket, fp)))
+				return false;
+			victim_ = 0;
+			return true;
+		}
+
+		//xorshift64: the slot to evict
+		std::uint64_t _random() noexcept
+		{
+			state_ ^= state_ << 13;
+			state_ ^= state_ >> 7;
+			state_ ^= state_ << 17;
+			return state_;
+		}
+
+		vector<bucket_type, bucket_allocator> buckets_;
+		size_type size_;
+		bucket_type victim_;
+		size_type victimBucket_;
+		std::uint64_t state_;
+		Hash hash_;
+
+	}; //template cuckoo_filter
+
+
+	//specialized algorithms
+	template<typename Fingerprint, typename Hash, typename Allocator>
+	void swap(cuckoo_filter<Fingerprint, Hash, Allocator>& x, cuckoo_filter<Fingerprint, Hash, Allocator>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,979 @@
+/*
+* flat_hash_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for an open-addressing hash map
+* - the interface follows C++17 [unord.map] https://timsong-cpp.github.io/cppwp/n4659/unord.map
+*   except: no bucket interface; insertion and rehash invalidate iterators and references
+* - elements are stored in one contiguous slot array; a parallel array holds one control
+*   byte per slot: empty, deleted, or the low 7 bits of the hash (h2) of a full slot
+* - slots are probed in aligned groups of 16: one SSE2 compare finds every slot in a group
+*   whose h2 matches, so a lookup usually compares one key (see "Swiss tables")
+* - a lookup stops at the first group on its probe sequence with an empty slot; erase leaves
+*   an empty slot (not a tombstone) if its group already had one, because no probe sequence
+*   has then ever passed through the group
+* - the table grows at a load factor of 7/8
+* - a rehash gives the strong guarantee unless an element can be neither copied nor moved
+*   without throwing: if the hasher or a copy throws, the map is unchanged
+* - std::string keys hash and compare transparently: find, contains, and count accept
+*   std::string_view, sigcpp::string_view, or const char* without building a string
+*/
+
+#ifndef SIGCPP_FLAT_HASH_MAP_H
+#define SIGCPP_FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "relocate.h"
+#include "simd.h"
+
+namespace sigcpp
+{
+	//transparent hash for strings: any char sequence with data() and size(), or a C string
+	struct string_hash
+	{
+		using is_transparent = void;
+
+		std::size_t operator()(std::string_view s) const noexcept
+		{
+			return std::hash<std::string_view>{}(s);
+		}
+
+		std::size_t operator()(const char* s) const noexcept
+		{
+			return operator()(std::string_view(s));
+		}
+
+		template<typename S>
+		auto operator()(const S& s) const noexcept -> decltype(std::string_view(s.data(), s.size()), std::size_t())
+		{
+			return operator()(std::string_view(s.data(), s.size()));
+		}
+	};
+
+
+	//transparent equality to go with string_hash
+	struct string_equal
+	{
+		using is_transparent = void;
+
+		template<typename S1, typename S2>
+		bool operator()(const S1& x, const S2& y) const noexcept
+		{
+			return _view(x) == _view(y);
+		}
+
+	private:
+		static std::string_view _view(const char* s) noexcept { return s; }
+
+		template<typename S>
+		static auto _view(const S& s) noexcept -> decltype(std::string_view(s.data(), s.size()))
+		{
+			return std::string_view(s.data(), s.size());
+		}
+	};
+
+
+	namespace detail
+	{
+		//default hash and equality: transparent for std::string keys
+		template<typename Key>
+		struct flat_hash_defaults
+		{
+			using hasher = std::hash<Key>;
+			using key_equal = std::equal_to<Key>;
+		};
+
+		template<>
+		struct flat_hash_defaults<std::string>
+		{
+			using hasher = string_hash;
+			using key_equal = string_equal;
+		};
+
+
+		template<typename F, typename = void>
+		constexpr bool is_transparent_v = false;
+
+		template<typename F>
+		constexpr bool is_transparent_v<F, std::void_t<typename F::is_transparent>> = true;
+
+
+		//spread every bit of a hash over the whole word: h1 uses the high bits and h2 the low
+		//7, and std::hash of an integer is often the integer itself
+		inline std::size_t mix_hash(std::size_t h) noexcept
+		{
+			if constexpr (sizeof(std::size_t) == 8) {
+				h ^= h >> 32;
+				h *= 0x9E3779B97F4A7C15ull;
+				return h ^ (h >> 29);
+			}
+			else {
+				h ^= h >> 16;
+				h *= 0x9E3779B9u;
+				return h ^ (h >> 15);
+			}
+		}
+
+
+		//control bytes: a full slot holds h2 in [0, 127]
+		using ctrl_type = std::int8_t;
+		constexpr ctrl_type ctrl_empty = -128;
+		constexpr ctrl_type ctrl_deleted = -2;
+		constexpr ctrl_type ctrl_sentinel = -1;	//one past the last slot: stops iteration
+
+		//the control bytes of an empty table: a sentinel, so that begin() == end(), and
+		//enough empty slots that a lookup stops at the first group
+		alignas(16) inline const ctrl_type empty_group[16]{
+			ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+			ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+		};
+
+
+		//16 control bytes: each match returns a mask with bit i set if slot i matches
+		class ctrl_group
+		{
+		public:
+			static constexpr std::size_t width = 16;
+
+			explicit ctrl_group(const ctrl_type* ctrl) noexcept
+			{
+#if defined(SIGCPP_SIMD_SSE2)
+				bytes_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+				std::memcpy(bytes_, ctrl, width);
+#endif
+			}
+
+			std::uint32_t match(ctrl_type h2) const noexcept
+			{
+#if defined(SIGCPP_SIMD_SSE2)
+				return _movemask(_mm_cmpeq_epi8(bytes_, _mm_set1_epi8(h2)));
+#else
+				return _match_if([h2](ctrl_type c) { return c == h2; });
+#endif
+			}
+
+			std::uint32_t match_empty() const noexcept
+			{
+#if defined(SIGCPP_SIMD_SSE2)
+				return _movemask(_mm_cmpeq_epi8(bytes_, _mm_set1_epi8(ctrl_empty)));
+#else
+				return _match_if([](ctrl_type c) { return c == ctrl_empty; });
+#endif
+			}
+
+			//empty and deleted are the only negative values within a group
+			std::uint32_t match_free() const noexcept
+			{
+#if defined(SIGCPP_SIMD_SSE2)
+				return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes_));
+#else
+				return _match_if([](ctrl_type c) { return c < 0; });
+#endif
+			}
+
+		private:
+#if defined(SIGCPP_SIMD_SSE2)
+			__m128i bytes_;
+
+			static std::uint32_t _movemask(__m128i m) noexcept
+			{
+				return static_cast<std::uint32_t>(_mm_movemask_epi8(m));
+			}
+#else
+			ctrl_type bytes_[width];
+
+			template<typename Pred>
+			std::uint32_t _match_if(Pred pred) const noexcept
+			{
+				std::uint32_t mask = 0;
+				for (std::size_t i = 0; i < width; ++i)
+					if (pred(bytes_[i]))
+						mask |= 1u << i;
+				return mask;
+			}
+#endif
+		};
+	}
+
+
+	//forward iterator over the full slots of a flat_hash_map
+	//V is the slot's value type, const-qualified for a const_iterator
+	template<typename V>
+	class flat_hash_iterator
+	{
+	public:
+		//types
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::remove_cv_t<V>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = V*;
+		using reference = V&;
+
+		//ctors
+		flat_hash_iterator() noexcept = default;
+
+		flat_hash_iterator(const detail::ctrl_type* ctrl, V* slot) noexcept : ctrl_{ ctrl }, slot_{ slot }
+		{
+			_skip_free();
+		}
+
+		//iterator to const_iterator conversion
+		template<typename Q, typename = std::enable_if_t<std::is_convertible_v<Q*, V*>>>
+		flat_hash_iterator(const flat_hash_iterator<Q>& it) noexcept : ctrl_{ it.ctrl_ }, slot_{ it.slot_ } {}
+
+		reference operator*() const { return *slot_; }
+		pointer operator->() const noexcept { return slot_; }
+
+		flat_hash_iterator& operator++()
+		{
+			++ctrl_;
+			++slot_;
+			_skip_free();
+			return *this;
+		}
+
+		flat_hash_iterator operator++(int)
+		{
+			flat_hash_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		bool operator==(const flat_hash_iterator& r) const noexcept { return slot_ == r.slot_; }
+		bool operator!=(const flat_hash_iterator& r) const noexcept { return slot_ != r.slot_; }
+
+	private:
+		template<typename Q>
+		friend class flat_hash_iterator;
+
+		template<typename K, typename T, typename H, typename E, typename A>
+		friend class flat_hash_map;
+
+		const detail::ctrl_type* ctrl_{ nullptr };
+		V* slot_{ nullptr };
+
+		//stop at a full slot or at the sentinel after the last slot
+		void _skip_free() noexcept
+		{
+			while (*ctrl_ < detail::ctrl_sentinel) {
+				++ctrl_;
+				++slot_;
+			}
+		}
+
+	}; //template flat_hash_iterator
+
+
+	template<typename Key, typename T,
+		typename Hash = typename detail::flat_hash_defaults<Key>::hasher,
+		typename KeyEqual = typename detail::flat_hash_defaults<Key>::key_equal,
+		typename Allocator = std::allocator<std::pair<const Key, T>>>
+	class flat_hash_map
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+		using ctrl_allocator = typename alloc_traits::template rebind_alloc<detail::ctrl_type>;
+		using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+		using index_allocator = typename alloc_traits::template rebind_alloc<std::size_t>;
+		using index_traits = std::allocator_traits<index_allocator>;
+		using ctrl_type = detail::ctrl_type;
+		using group = detail::ctrl_group;
+
+		//lookup by K other than Key is allowed if both Hash and KeyEqual are transparent
+		template<typename K>
+		using enable_if_lookup_t = std::enable_if_t<std::is_same_v<K, Key> ||
+			(detail::is_transparent_v<Hash> && detail::is_transparent_v<KeyEqual>)>;
+
+	public:
+		//types
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<const Key, T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator_type = Allocator;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+
+		using iterator = flat_hash_iterator<value_type>;
+		using const_iterator = flat_hash_iterator<const value_type>;
+
+		//ctors
+		flat_hash_map() : impl_{ Hash(), KeyEqual(), Allocator() } {}
+
+		explicit flat_hash_map(size_type count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+			const Allocator& alloc = Allocator()) : impl_{ hash, equal, alloc }
+		{
+			reserve(count);
+		}
+
+		template<typename InputIt>
+		flat_hash_map(InputIt first, InputIt last, size_type count = 0, const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+			: flat_hash_map(count, hash, equal, alloc)
+		{
+			insert(first, last);
+		}
+
+		flat_hash_map(std::initializer_list<value_type> il, size_type count = 0, const Hash& hash = Hash(),
+			const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+			: flat_hash_map(il.begin(), il.end(), std::max(count, il.size()), hash, equal, alloc) {}
+
+		flat_hash_map(const flat_hash_map& m) : impl_{ m.impl_.hash, m.impl_.equal,
+			alloc_traits::select_on_container_copy_construction(m.get_allocator()) }
+		{
+			reserve(m.size());
+			for (const auto& e : m)
+				_insert_unique(_hash(e.first), e);
+		}
+
+		flat_hash_map(flat_hash_map&& m) noexcept : impl_{ std::move(m.impl_) }
+		{
+			m.impl_.reset();
+		}
+
+		~flat_hash_map() { _release(); }
+
+		//assignment
+		//the allocator is replaced only if it propagates; else the elements are copied into
+		//this map's own storage
+		flat_hash_map& operator=(const flat_hash_map& m)
+		{
+			if (this == &m)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				if (!alloc_traits::is_always_equal::value && !(impl_.alloc() == m.impl_.alloc()))
+					_release();
+				impl_.alloc() = m.impl_.alloc();
+			}
+			clear();
+			impl_.hash = m.impl_.hash;
+			impl_.equal = m.impl_.equal;
+			reserve(m.size());
+			for (const auto& e : m)
+				_insert_unique(_hash(e.first), e);
+			return *this;
+		}
+
+		//steal the table if the allocators allow it; else move element by element
+		flat_hash_map& operator=(flat_hash_map&& m) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+			alloc_traits::is_always_equal::value)
+		{
+			if (this == &m)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+				_release();
+				impl_.alloc() = std::move(m.impl_.alloc());
+				_take(m);
+			}
+			else if (alloc_traits::is_always_equal::value || impl_.alloc() == m.impl_.alloc()) {
+				_release();
+				_take(m);
+			}
+			else {
+				clear();
+				impl_.hash = m.impl_.hash;
+				impl_.equal = m.impl_.equal;
+				reserve(m.size());
+				for (auto& e : m)
+					_insert_unique(_hash(e.first), std::move(e));
+				m.clear();
+			}
+			return *this;
+		}
+
+		flat_hash_map& operator=(std::initializer_list<value_type> il)
+		{
+			clear();
+			insert(il);
+			return *this;
+		}
+
+		allocator_type get_allocator() const noexcept { return impl_.alloc(); }
+		hasher hash_function() const { return impl_.hash; }
+		key_equal key_eq() const { return impl_.equal; }
+
+		//iterators
+		iterator begin() noexcept { return empty() ? end() : iterator(impl_.ctrl, impl_.slots); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return _end(); }
+		const_iterator end() const noexcept { return cend(); }
+
+		const_iterator cbegin() const noexcept
+		{
+			return empty() ? cend() : const_iterator(impl_.ctrl, impl_.slots);
+		}
+
+		const_iterator cend() const noexcept { return const_cast<flat_hash_map*>(this)->_end(); }
+
+		//capacity
+		bool empty() const noexcept { return impl_.size == 0; }
+		size_type size() const noexcept { return impl_.size; }
+		size_type max_size() const noexcept { return alloc_traits::max_size(impl_.alloc()) / 2; }
+
+		//hash policy: capacity is the number of slots
+		size_type capacity() const noexcept { return impl_.capacity; }
+		float load_factor() const noexcept
+		{
+			return impl_.capacity == 0 ? 0.0f : static_cast<float>(impl_.size) / impl_.capacity;
+		}
+		static constexpr float max_load_factor() noexcept { return 0.875f; }
+
+		//make room for count elements without a rehash
+		void reserve(size_type count)
+		{
+			const auto capacity = _capacity_for(count);
+			if (capacity > impl_.capacity)
+				_rehash(capacity);
+		}
+
+		//rehash to the smallest capacity of at least count slots that holds size() elements
+		void rehash(size_type count)
+		{
+			const auto capacity = std::max(_capacity_for(impl_.size), count == 0 ? 0 : _round_capacity(count));
+			if (capacity == 0)
+				_release();
+			else if (capacity != impl_.capacity)
+				_rehash(capacity);
+		}
+
+		//modifiers
+		std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+		std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+
+		template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+		std::pair<iterator, bool> insert(P&& value) { return emplace(std::forward<P>(value)); }
+
+		template<typename InputIt>
+		void insert(InputIt first, InputIt last)
+		{
+			for (; first != last; ++first)
+				emplace(*first);
+		}
+
+		void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+		//construct the element first to learn its key; it is discarded if the key is present
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type value(std::forward<Args>(args)...);
+			auto [index, inserted] = _find_or_prepare(value.first);
+			if (inserted)
+				_construct(index, std::move(value));
+			return { _iterator(index), inserted };
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+		{
+			return _try_emplace(key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+		{
+			return _try_emplace(std::move(key), std::forward<Args>(args)...);
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+		{
+			auto result = try_emplace(key, std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+		{
+			auto result = try_emplace(std::move(key), std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		//return the iterator after pos
+		iterator erase(const_iterator pos)
+		{
+			auto next = _iterator(static_cast<size_type>(pos.slot_ - impl_.slots));
+			++next;
+			_erase(static_cast<size_type>(pos.slot_ - impl_.slots));
+			return next;
+		}
+
+		iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+		template<typename K = key_type, typename = enable_if_lookup_t<K>>
+		size_type erase(const K& key)
+		{
+			const auto index = _find(key, _hash(key));
+			if (index == impl_.capacity)
+				return 0;
+			_erase(index);
+			return 1;
+		}
+
+		void clear() noexcept
+		{
+			if (impl_.capacity == 0)
+				return;
+
+			_destroy_all();
+			std::memset(impl_.ctrl, detail::ctrl_empty, impl_.capacity);
+			impl_.size = 0;
+			impl_.growth_left = _max_load(impl_.capacity);
+		}
+
+		//the allocators are exchanged only if they propagate on swap
+		void swap(flat_hash_map& m) noexcept
+		{
+			using std::swap;
+			swap(impl_.hash, m.impl_.hash);
+			swap(impl_.equal, m.impl_.equal);
+			swap(impl_.ctrl, m.impl_.ctrl);
+			swap(impl_.slots, m.impl_.slots);
+			swap(impl_.size, m.impl_.size);
+			swap(impl_.capacity, m.impl_.capacity);
+			swap(impl_.growth_left, m.impl_.growth_left);
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+				swap(impl_.alloc(), m.impl_.alloc());
+		}
+
+		//element access
+		T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+		T& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+		T& at(const key_type& key) { return const_cast<T&>(_at(key)); }
+		const T& at(const key_type& key) const { return _at(key); }
+
+		//lookup
+		template<typename K = key_type, typename = enable_if_lookup_t<K>>
+		iterator find(const K& key)
+		{
+			const auto index = _find(key, _hash(key));
+			return index == impl_.capacity ? end() : _iterator(index);
+		}
+
+		template<typename K = key_type, typename = enable_if_lookup_t<K>>
+		const_iterator find(const K& key) const
+		{
+			return const_cast<flat_hash_map*>(this)->find(key);
+		}
+
+		template<typename K = key_type, typename = enable_if_lookup_t<K>>
+		bool contains(const K& key) const
+		{
+			return _find(key, _hash(key)) != impl_.capacity;
+		}
+
+		template<typename K = key_type, typename = enable_if_lookup_t<K>>
+		size_type count(const K& key) const
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+	private:
+		//state, deriving from the allocator so that an empty one takes no space
+		//ctrl has capacity + 1 bytes: the last is the sentinel
+		struct impl : Allocator
+		{
+			Hash hash;
+			KeyEqual equal;
+			ctrl_type* ctrl{ const_cast<ctrl_type*>(detail::empty_group) };
+			value_type* slots{ nullptr };
+			size_type size{ 0 };
+			size_type capacity{ 0 };
+			size_type growth_left{ 0 };	//insertions into empty slots before a rehash
+
+			impl(const Hash& h, const KeyEqual& e, const Allocator& a) : Allocator(a), hash(h), equal(e) {}
+
+			Allocator& alloc() noexcept { return *this; }
+			const Allocator& alloc() const noexcept { return *this; }
+
+			//forget the table without freeing it
+			void reset() noexcept
+			{
+				ctrl = const_cast<ctrl_type*>(detail::empty_group);
+				slots = nullptr;
+				size = capacity = growth_left = 0;
+			}
+		};
+
+		impl impl_;
+
+		iterator _end() noexcept
+		{
+			return iterator(impl_.ctrl + impl_.capacity, impl_.slots + impl_.capacity);
+		}
+
+		iterator _iterator(size_type index) noexcept { return iterator(impl_.ctrl + index, impl_.slots + index); }
+
+		template<typename K>
+		std::size_t _hash(const K& key) const { return detail::mix_hash(impl_.hash(key)); }
+
+		static ctrl_type _h2(std::size_t hash) noexcept { return static_cast<ctrl_type>(hash & 0x7F); }
+
+		//number of full slots allowed in a table of the given capacity
+		static size_type _max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+		//power of 2, and at least one group
+		static size_type _round_capacity(size_type count) noexcept
+		{
+			size_type capacity = group::width;
+			while (capacity < count)
+				capacity *= 2;
+			return capacity;
+		}
+
+		//smallest capacity that holds count elements
+		static size_type _capacity_for(size_type count) noexcept
+		{
+			if (count == 0)
+				return 0;
+
+			auto capacity = _round_capacity(count);
+			if (_max_load(capacity) < count)
+				capacity *= 2;
+			return capacity;
+		}
+
+		//probe the groups from the one that h1 selects: step 1, 2, 3, ... groups (a triangular
+		//sequence), which visits every group once when the group count is a power of 2
+		template<typename Visit>
+		static size_type _probe(const ctrl_type* ctrl, size_type capacity, std::size_t hash, Visit visit)
+		{
+			const auto group_mask = (capacity == 0 ? 1 : capacity / group::width) - 1;
+			auto g = (hash >> 7) & group_mask;
+			for (size_type step = 1;; ++step) {
+				const auto base = g * group::width;
+				const auto result = visit(base, group(ctrl + base));
+				if (result != npos)
+					return result;
+				g = (g + step) & group_mask;
+			}
+		}
+
+		template<typename Visit>
+		size_type _probe(std::size_t hash, Visit visit) const
+		{
+			return _probe(impl_.ctrl, impl_.capacity, hash, visit);
+		}
+
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		//index of the slot holding key, or capacity if not found
+		template<typename K>
+		size_type _find(const K& key, std::size_t hash) const
+		{
+			const auto h2 = _h2(hash);
+			return _probe(hash, [&](size_type base, const group& g) {
+				for (auto mask = g.match(h2); mask != 0; mask &= mask - 1) {
+					const auto index = base + simd::lowest_bit(mask);
+					if (impl_.equal(impl_.slots[index].first, key))
+						return index;
+				}
+				return g.match_empty() != 0 ? impl_.capacity : npos;
+			});
+		}
+
+		//first free slot on hash's probe sequence in a control array; the table must have one
+		static size_type _find_free(const ctrl_type* ctrl, size_type capacity, std::size_t hash)
+		{
+			return _probe(ctrl, capacity, hash, [](size_type base, const group& g) {
+				const auto mask = g.match_free();
+				return mask != 0 ? base + simd::lowest_bit(mask) : npos;
+			});
+		}
+
+		size_type _find_free(std::size_t hash) const { return _find_free(impl_.ctrl, impl_.capacity, hash); }
+
+		//index of key and false if present; else the index of a free slot for key and true
+		template<typename K>
+		std::pair<size_type, bool> _find_or_prepare(const K& key)
+		{
+			const auto hash = _hash(key);
+			const auto index = _find(key, hash);
+			if (index != impl_.capacity)
+				return { index, false };
+			return { _prepare_insert(hash), true };
+		}
+
+		//claim a free slot for hash, growing or cleaning up the table if needed
+		size_type _prepare_insert(std::size_t hash)
+		{
+			auto index = impl_.capacity == 0 ? npos : _find_free(hash);
+			if (index == npos || (impl_.growth_left == 0 && impl_.ctrl[index] != detail::ctrl_deleted)) {
+				//mostly tombstones: rehash in place; else double
+				const auto capacity = impl_.capacity == 0 ? group::width :
+					impl_.size < _max_load(impl_.capacity) / 2 ? impl_.capacity : impl_.capacity * 2;
+				_rehash(capacity);
+				index = _find_free(hash);
+			}
+
+			if (impl_.ctrl[index] == detail::ctrl_empty)
+				--impl_.growth_left;
+			impl_.ctrl[index] = _h2(hash);
+			return index;
+		}
+
+		//construct the element in a slot that _prepare_insert claimed: release the claim on failure
+		template<typename... Args>
+		void _construct(size_type index, Args&&... args)
+		{
+			try {
+				::new (static_cast<void*>(impl_.slots + index)) value_type(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				_set_free(index);
+				throw;
+			}
+			++impl_.size;
+		}
+
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> _try_emplace(K&& key, Args&&... args)
+		{
+			auto [index, inserted] = _find_or_prepare(key);
+			if (inserted)
+				_construct(index, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+					std::forward_as_tuple(std::forward<Args>(args)...));
+			return { _iterator(index), inserted };
+		}
+
+		//insert an element whose key is known to be absent
+		template<typename V>
+		void _insert_unique(std::size_t hash, V&& value)
+		{
+			_construct(_prepare_insert(hash), std::forward<V>(value));
+		}
+
+		void _erase(size_type index)
+		{
+			impl_.slots[index].~value_type();
+			--impl_.size;
+			_set_free(index);
+		}
+
+		//mark a slot free: empty if its group has an empty slot, else a tombstone
+		void _set_free(size_type index) noexcept
+		{
+			const auto base = index & ~(group::width - 1);
+			if (group(impl_.ctrl + base).match_empty() != 0) {
+				impl_.ctrl[index] = detail::ctrl_empty;
+				++impl_.growth_left;
+			}
+			else
+				impl_.ctrl[index] = detail::ctrl_deleted;
+		}
+
+		const T& _at(const key_type& key) const
+		{
+			const auto index = _find(key, _hash(key));
+			if (index == impl_.capacity)
+				throw std::out_of_range("flat_hash_map key not found");
+			return impl_.slots[index].second;
+		}
+
+		//elements whose move cannot throw are relocated to a new table; others are copied (or
+		//moved, if they cannot be copied) and the originals destroyed once all are placed
+		static constexpr bool nothrow_relocatable = (is_trivially_relocatable_v<Key> && is_trivially_relocatable_v<T>) ||
+			(std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<T>);
+
+		//move every element to a new table of the given capacity
+		//strong guarantee: if the hasher, an allocation, or a copy throws, the map is unchanged;
+		//if the move of an element that cannot be copied throws, the moved-from elements remain
+		void _rehash(size_type capacity)
+		{
+			ctrl_allocator ctrlAlloc(impl_.alloc());
+			index_allocator indexAlloc(impl_.alloc());
+			const auto ctrl = ctrl_traits::allocate(ctrlAlloc, capacity + 1);
+			value_type* slots = nullptr;
+			size_type* targets = nullptr;
+			try {
+				slots = alloc_traits::allocate(impl_.alloc(), capacity);
+				if (impl_.size != 0)
+					targets = index_traits::allocate(indexAlloc, impl_.size);
+			}
+			catch (...) {
+				if (slots != nullptr)
+					alloc_traits::deallocate(impl_.alloc(), slots, capacity);
+				ctrl_traits::deallocate(ctrlAlloc, ctrl, capacity + 1);
+				throw;
+			}
+
+			//place every element in the new control array before any element moves
+			const auto release_new = [&]() noexcept {
+				if (targets != nullptr)
+					index_traits::deallocate(indexAlloc, targets, impl_.size);
+				alloc_traits::deallocate(impl_.alloc(), slots, capacity);
+				ctrl_traits::deallocate(ctrlAlloc, ctrl, capacity + 1);
+			};
+
+			std::memset(ctrl, detail::ctrl_empty, capacity);
+			ctrl[capacity] = detail::ctrl_sentinel;
+			try {
+				for (size_type i = 0, j = 0; i < impl_.capacity; ++i) {
+					if (impl_.ctrl[i] < 0)
+						continue;
+
+					const auto hash = _hash(impl_.slots[i].first);
+					const auto index = _find_free(ctrl, capacity, hash);
+					ctrl[index] = _h2(hash);
+					targets[j++] = index;
+				}
+			}
+			catch (...) {
+				release_new();
+				throw;
+			}
+
+			if constexpr (nothrow_relocatable) {
+				for (size_type i = 0, j = 0; i < impl_.capacity; ++i)
+					if (impl_.ctrl[i] >= 0)
+						_relocate(impl_.slots + i, slots + targets[j++]);
+			}
+			else {
+				size_type j = 0;
+				try {
+					for (size_type i = 0; i < impl_.capacity; ++i) {
+						if (impl_.ctrl[i] < 0)
+							continue;
+
+						auto& e = impl_.slots[i];
+						::new (static_cast<void*>(slots + targets[j])) value_type(
+							std::move_if_noexcept(const_cast<Key&>(e.first)), std::move_if_noexcept(e.second));
+						++j;
+					}
+				}
+				catch (...) {
+					for (size_type k = 0; k < j; ++k)
+						slots[targets[k]].~value_type();
+					release_new();
+					throw;
+				}
+				_destroy_all();
+			}
+
+			if (targets != nullptr)
+				index_traits::deallocate(indexAlloc, targets, impl_.size);
+			if (impl_.capacity != 0) {
+				ctrl_traits::deallocate(ctrlAlloc, impl_.ctrl, impl_.capacity + 1);
+				alloc_traits::deallocate(impl_.alloc(), impl_.slots, impl_.capacity);
+			}
+			impl_.ctrl = ctrl;
+			impl_.slots = slots;
+			impl_.capacity = capacity;
+			impl_.growth_left = _max_load(capacity) - impl_.size;
+		}
+
+		//move an element to a free slot and end the original: only if the move cannot throw
+		//the key is const only to users: the original is destroyed right after the move
+		static void _relocate(value_type* from, value_type* to) noexcept
+		{
+			static_assert(nothrow_relocatable);
+			if constexpr (is_trivially_relocatable_v<Key> && is_trivially_relocatable_v<T>)
+				std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), sizeof(value_type));
+			else {
+				::new (static_cast<void*>(to)) value_type(std::move(const_cast<Key&>(from->first)),
+					std::move(from->second));
+				from->~value_type();
+			}
+		}
+
+		void _destroy_all() noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<value_type>)
+				for (size_type i = 0; i < impl_.capacity; ++i)
+					if (impl_.ctrl[i] >= 0)
+						impl_.slots[i].~value_type();
+		}
+
+		//take the table, hash, and equality of m into this released map; leave m empty
+		void _take(flat_hash_map& m) noexcept
+		{
+			impl_.hash = std::move(m.impl_.hash);
+			impl_.equal = std::move(m.impl_.equal);
+			impl_.ctrl = m.impl_.ctrl;
+			impl_.slots = m.impl_.slots;
+			impl_.size = m.impl_.size;
+			impl_.capacity = m.impl_.capacity;
+			impl_.growth_left = m.impl_.growth_left;
+			m.impl_.reset();
+		}
+
+		void _release() noexcept
+		{
+			if (impl_.capacity == 0)
+				return;
+
+			_destroy_all();
+			ctrl_allocator ctrlAlloc(impl_.alloc());
+			ctrl_traits::deallocate(ctrlAlloc, impl_.ctrl, impl_.capacity + 1);
+			alloc_traits::deallocate(impl_.alloc(), impl_.slots, impl_.capacity);
+			impl_.reset();
+		}
+
+	}; //template flat_hash_map
+
+
+	//specialized algorithms
+	template<typename K, typename T, typename H, typename E, typename A>
+	void swap(flat_hash_map<K, T, H, E, A>& x, flat_hash_map<K, T, H, E, A>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: same elements, in any order
+	template<typename K, typename T, typename H, typename E, typename A>
+	bool operator==(const flat_hash_map<K, T, H, E, A>& x, const flat_hash_map<K, T, H, E, A>& y)
+	{
+		if (x.size() != y.size())
+			return false;
+
+		for (const auto& e : x) {
+			const auto it = y.find(e.first);
+			if (it == y.end() || !(it->second == e.second))
+				return false;
+		}
+		return true;
+	}
+
+	template<typename K, typename T, typename H, typename E, typename A>
+	bool operator!=(const flat_hash_map<K, T, H, E, A>& x, const flat_hash_map<K, T, H, E, A>& y)
+	{
+		return !(x == y);
+	}
+
+}	//namespace sigcpp
+
+#endif
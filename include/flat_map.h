@@ -0,0 +1,622 @@
+/*
+* flat_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for maps kept as sorted sequences
+* - see C++23 [flat.map] https://timsong-cpp.github.io/cppwp/n4950/flat.map
+* - keys and mapped values are in two containers kept in lockstep: a lookup binary-searches
+*   only the keys, so more keys share each cache line (see sorted_search.h)
+* - construction from unsorted containers sorts once (stably: of equivalent keys, the
+*   first stays) and removes duplicates; bulk insert sorts the new elements and merges them
+* - the containers may be fixed-size, such as sigcpp::array<Key, N> and array<T, N>: the
+*   map is then read-only apart from mapped values, and its keys must be unique
+* - iterators are random-access proxies: dereferencing yields pair<const Key&, T&>
+*/
+
+#ifndef SIGCPP_FLAT_MAP_H
+#define SIGCPP_FLAT_MAP_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+
+#include "array_iterator.h"
+#include "flat_set.h"
+#include "sorted_search.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	//random-access iterator over a key iterator and a mapped iterator in lockstep
+	template<typename KeyIt, typename MappedIt>
+	class flat_map_iterator
+	{
+		using key_reference = typename std::iterator_traits<KeyIt>::reference;
+		using mapped_reference = typename std::iterator_traits<MappedIt>::reference;
+
+	public:
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::pair<typename std::iterator_traits<KeyIt>::value_type,
+			typename std::iterator_traits<MappedIt>::value_type>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<key_reference, mapped_reference>;
+
+		//operator-> returns a proxy that holds the pair of references
+		struct pointer
+		{
+			reference ref;
+			reference* operator->() noexcept { return &ref; }
+		};
+
+		//ctors
+		flat_map_iterator() = default;
+		flat_map_iterator(KeyIt key, MappedIt mapped) : key_{ key }, mapped_{ mapped } {}
+
+		//iterator to const_iterator conversion
+		template<typename K, typename M, typename = std::enable_if_t<std::is_convertible_v<K, KeyIt> &&
+			std::is_convertible_v<M, MappedIt>>>
+		flat_map_iterator(const flat_map_iterator<K, M>& it) : key_{ it.key_iterator() },
+			mapped_{ it.mapped_iterator() } {}
+
+		KeyIt key_iterator() const { return key_; }
+		MappedIt mapped_iterator() const { return mapped_; }
+
+		//dereference and member access
+		reference operator*() const { return reference(*key_, *mapped_); }
+		pointer operator->() const { return pointer{ **this }; }
+		reference operator[](difference_type n) const { return *(*this + n); }
+
+		//increment and decrement
+		flat_map_iterator& operator++()
+		{
+			++key_;
+			++mapped_;
+			return *this;
+		}
+
+		flat_map_iterator operator++(int)
+		{
+			flat_map_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		flat_map_iterator& operator--()
+		{
+			--key_;
+			--mapped_;
+			return *this;
+		}
+
+		flat_map_iterator operator--(int)
+		{
+			flat_map_iterator beforeDecrement = *this;
+			--*this;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		flat_map_iterator& operator+=(difference_type n)
+		{
+			key_ += n;
+			mapped_ += n;
+			return *this;
+		}
+
+		flat_map_iterator& operator-=(difference_type n) { return *this += -n; }
+
+		flat_map_iterator operator+(difference_type n) const { return flat_map_iterator(key_ + n, mapped_ + n); }
+		flat_map_iterator operator-(difference_type n) const { return flat_map_iterator(key_ - n, mapped_ - n); }
+
+		template<typename K, typename M>
+		difference_type operator-(const flat_map_iterator<K, M>& r) const { return key_ - r.key_iterator(); }
+
+		//comparison
+		template<typename K, typename M>
+		bool operator==(const flat_map_iterator<K, M>& r) const { return key_ == r.key_iterator(); }
+
+		template<typename K, typename M>
+		bool operator!=(const flat_map_iterator<K, M>& r) const { return key_ != r.key_iterator(); }
+
+		template<typename K, typename M>
+		bool operator<(const flat_map_iterator<K, M>& r) const { return key_ < r.key_iterator(); }
+
+		template<typename K, typename M>
+		bool operator>(const flat_map_iterator<K, M>& r) const { return key_ > r.key_iterator(); }
+
+		template<typename K, typename M>
+		bool operator<=(const flat_map_iterator<K, M>& r) const { return key_ <= r.key_iterator(); }
+
+		template<typename K, typename M>
+		bool operator>=(const flat_map_iterator<K, M>& r) const { return key_ >= r.key_iterator(); }
+
+	private:
+		KeyIt key_{};
+		MappedIt mapped_{};
+
+	}; //template flat_map_iterator
+
+
+	//n + it
+	template<typename KeyIt, typename MappedIt>
+	flat_map_iterator<KeyIt, MappedIt> operator+(std::ptrdiff_t n, const flat_map_iterator<KeyIt, MappedIt>& it)
+	{
+		return it + n;
+	}
+
+
+	template<typename Key, typename T, typename Compare = std::less<Key>,
+		typename KeyContainer = vector<Key>, typename MappedContainer = vector<T>>
+	class flat_map
+	{
+		static_assert(std::is_same_v<typename KeyContainer::value_type, Key>, "key container must hold Key");
+		static_assert(std::is_same_v<typename MappedContainer::value_type, T>, "mapped container must hold T");
+
+	public:
+		//types
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<key_type, mapped_type>;
+		using key_compare = Compare;
+		using reference = std::pair<const key_type&, mapped_type&>;
+		using const_reference = std::pair<const key_type&, const mapped_type&>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using key_container_type = KeyContainer;
+		using mapped_container_type = MappedContainer;
+
+		using iterator = flat_map_iterator<typename KeyContainer::const_iterator,
+			typename MappedContainer::iterator>;
+		using const_iterator = flat_map_iterator<typename KeyContainer::const_iterator,
+			typename MappedContainer::const_iterator>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		struct containers
+		{
+			key_container_type keys;
+			mapped_container_type values;
+		};
+
+		//compare elements by key
+		class value_compare
+		{
+		public:
+			template<typename P1, typename P2>
+			bool operator()(const P1& x, const P2& y) const { return comp_(x.first, y.first); }
+
+		private:
+			friend class flat_map;
+			explicit value_compare(const Compare& comp) : comp_{ comp } {}
+			Compare comp_;
+		};
+
+		//ctors
+		flat_map() : flat_map(Compare()) {}
+		explicit flat_map(const Compare& comp) : c_(), comp_(comp) {}
+
+		//sort by key and remove duplicates; the containers must be the same size
+		flat_map(key_container_type keys, mapped_container_type values, const Compare& comp = Compare())
+			: c_{ std::move(keys), std::move(values) }, comp_(comp)
+		{
+			_check_sizes();
+			_sort_unique_from(0);
+		}
+
+		flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values,
+			const Compare& comp = Compare()) : c_{ std::move(keys), std::move(values) }, comp_(comp)
+		{
+			_check_sizes();
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		flat_map(InputIt first, InputIt last, const Compare& comp = Compare()) : c_(), comp_(comp)
+		{
+			insert(first, last);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		flat_map(sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare()) : c_(), comp_(comp)
+		{
+			_append(first, last);
+		}
+
+		flat_map(std::initializer_list<value_type> il, const Compare& comp = Compare())
+			: flat_map(il.begin(), il.end(), comp) {}
+
+		flat_map(sorted_unique_t, std::initializer_list<value_type> il, const Compare& comp = Compare())
+			: flat_map(sorted_unique, il.begin(), il.end(), comp) {}
+
+		flat_map& operator=(std::initializer_list<value_type> il)
+		{
+			clear();
+			insert(il);
+			return *this;
+		}
+
+		//iterators
+		iterator begin() noexcept { return iterator(c_.keys.cbegin(), c_.values.begin()); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(c_.keys.cend(), c_.values.end()); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(c_.keys.cbegin(), c_.values.cbegin()); }
+		const_iterator cend() const noexcept { return const_iterator(c_.keys.cend(), c_.values.cend()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		bool empty() const noexcept { return c_.keys.empty(); }
+		size_type size() const noexcept { return c_.keys.size(); }
+		size_type max_size() const noexcept { return std::min<size_type>(c_.keys.max_size(), c_.values.max_size()); }
+
+		//element access
+		mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+		mapped_type& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+		mapped_type& at(const key_type& key) { return const_cast<mapped_type&>(_at(key)); }
+		const mapped_type& at(const key_type& key) const { return _at(key); }
+
+		//modifiers: apart from assigning mapped values, not available with fixed-size containers
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type value(std::forward<Args>(args)...);
+			return try_emplace(std::move(value.first), std::move(value.second));
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+		std::pair<iterator, bool> insert(value_type&& value)
+		{
+			return try_emplace(std::move(value.first), std::move(value.second));
+		}
+
+		//append, sort the new elements, and merge
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void insert(InputIt first, InputIt last)
+		{
+			const auto old_size = size();
+			_append(first, last);
+			_sort_unique_from(old_size);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void insert(sorted_unique_t, InputIt first, InputIt last)
+		{
+			insert(first, last);
+		}
+
+		void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+		{
+			return _try_emplace(key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+		{
+			return _try_emplace(std::move(key), std::forward<Args>(args)...);
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+		{
+			auto result = try_emplace(key, std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+		{
+			auto result = try_emplace(std::move(key), std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+		iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const auto index = first - cbegin();
+			const auto count = last - first;
+			c_.keys.erase(c_.keys.cbegin() + index, c_.keys.cbegin() + index + count);
+			c_.values.erase(c_.values.cbegin() + index, c_.values.cbegin() + index + count);
+			return begin() + index;
+		}
+
+		size_type erase(const key_type& key)
+		{
+			const auto [first, last] = equal_range(key);
+			const auto count = static_cast<size_type>(last - first);
+			erase(first, last);
+			return count;
+		}
+
+		void clear() noexcept
+		{
+			c_.keys.clear();
+			c_.values.clear();
+		}
+
+		//the containers: the map is left empty
+		containers extract() &&
+		{
+			auto c = std::move(c_);
+			clear();
+			return c;
+		}
+
+		//keys must be sorted and unique, and the containers the same size
+		void replace(key_container_type&& keys, mapped_container_type&& values)
+		{
+			c_.keys = std::move(keys);
+			c_.values = std::move(values);
+			_check_sizes();
+		}
+
+		void swap(flat_map& m) noexcept(std::is_nothrow_swappable_v<KeyContainer> &&
+			std::is_nothrow_swappable_v<MappedContainer> && std::is_nothrow_swappable_v<Compare>)
+		{
+			using std::swap;
+			swap(c_.keys, m.c_.keys);
+			swap(c_.values, m.c_.values);
+			swap(comp_, m.comp_);
+		}
+
+		//observers
+		key_compare key_comp() const { return comp_; }
+		value_compare value_comp() const { return value_compare(comp_); }
+		const key_container_type& keys() const noexcept { return c_.keys; }
+		const mapped_container_type& values() const noexcept { return c_.values; }
+
+		//lookup; K other than Key requires a transparent Compare
+		iterator find(const key_type& key) { return _iterator(_find(key)); }
+		const_iterator find(const key_type& key) const { return _const_iterator(_find(key)); }
+		bool contains(const key_type& key) const { return _find(key) != size(); }
+		size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+		iterator lower_bound(const key_type& key) { return _iterator(_lower_bound(key)); }
+		const_iterator lower_bound(const key_type& key) const { return _const_iterator(_lower_bound(key)); }
+		iterator upper_bound(const key_type& key) { return _iterator(_upper_bound(key)); }
+		const_iterator upper_bound(const key_type& key) const { return _const_iterator(_upper_bound(key)); }
+
+		std::pair<iterator, iterator> equal_range(const key_type& key)
+		{
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+		{
+			return { lower_bound(key), upper_bound(key) };
+		}
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& key) { return _iterator(_find(key)); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator find(const K& key) const { return _const_iterator(_find(key)); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		bool contains(const K& key) const { return _find(key) != size(); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		size_type count(const K& key) const { return _upper_bound(key) - _lower_bound(key); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& key) { return _iterator(_lower_bound(key)); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator lower_bound(const K& key) const { return _const_iterator(_lower_bound(key)); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& key) { return _iterator(_upper_bound(key)); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		const_iterator upper_bound(const K& key) const { return _const_iterator(_upper_bound(key)); }
+
+	private:
+		containers c_;
+		Compare comp_;
+
+		iterator _iterator(size_type index) { return begin() + static_cast<difference_type>(index); }
+		const_iterator _const_iterator(size_type index) const { return cbegin() + static_cast<difference_type>(index); }
+
+		//positions as indexes into the containers
+		template<typename K>
+		size_type _lower_bound(const K& key) const
+		{
+			return static_cast<size_type>(branchless_lower_bound(c_.keys.begin(), c_.keys.end(), key, comp_) -
+				c_.keys.begin());
+		}
+
+		template<typename K>
+		size_type _upper_bound(const K& key) const
+		{
+			return static_cast<size_type>(branchless_upper_bound(c_.keys.begin(), c_.keys.end(), key, comp_) -
+				c_.keys.begin());
+		}
+
+		//index of key, or size() if not found
+		template<typename K>
+		size_type _find(const K& key) const
+		{
+			const auto index = _lower_bound(key);
+			return index != size() && !comp_(key, c_.keys[index]) ? index : size();
+		}
+
+		const mapped_type& _at(const key_type& key) const
+		{
+			const auto index = _find(key);
+			if (index == size())
+				throw std::out_of_range("flat_map key not found");
+			return c_.values[index];
+		}
+
+		void _check_sizes() const
+		{
+			if (c_.keys.size() != c_.values.size())
+				throw std::invalid_argument("flat_map key and mapped containers differ in size");
+		}
+
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> _try_emplace(K&& key, Args&&... args)
+		{
+			const auto index = _lower_bound(key);
+			if (index != size() && !comp_(key, c_.keys[index]))
+				return { _iterator(index), false };
+
+			const auto offset = static_cast<difference_type>(index);
+			c_.keys.insert(c_.keys.cbegin() + offset, std::forward<K>(key));
+			try {
+				c_.values.emplace(c_.values.cbegin() + offset, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				c_.keys.erase(c_.keys.cbegin() + offset);
+				throw;
+			}
+			return { _iterator(index), true };
+		}
+
+		template<typename InputIt>
+		void _append(InputIt first, InputIt last)
+		{
+			for (; first != last; ++first) {
+				const value_type& value = *first;
+				c_.keys.insert(c_.keys.cend(), value.first);
+				c_.values.insert(c_.values.cend(), value.second);
+			}
+		}
+
+		//the elements before old_size are sorted and unique: sort the rest (stably), merge,
+		//and drop all but the first of equivalent keys
+		void _sort_unique_from(size_type old_size)
+		{
+			const auto n = size();
+			const auto less = [this](size_type i, size_type j) { return comp_(c_.keys[i], c_.keys[j]); };
+
+			if (!std::is_sorted(c_.keys.begin() + static_cast<difference_type>(old_size), c_.keys.end(), comp_) ||
+				(old_size != 0 && old_size != n && !comp_(c_.keys[old_size - 1], c_.keys[old_size]))) {
+				vector<size_type> order(n);
+				std::iota(order.begin(), order.end(), size_type(0));
+				const auto middle = order.begin() + static_cast<difference_type>(old_size);
+				std::stable_sort(middle, order.end(), less);
+				std::inplace_merge(order.begin(), middle, order.end(), less);
+				_permute(order);
+			}
+
+			//compact in place: keep the first of each run of equivalent keys
+			size_type kept = 0;
+			for (size_type i = 1; i < n; ++i) {
+				if (comp_(c_.keys[kept], c_.keys[i]) && ++kept != i) {
+					_key(kept) = std::move(_key(i));
+					c_.values[kept] = std::move(c_.values[i]);
+				}
+			}
+			detail::trim_unique(n == 0 ? 0 : kept + 1, c_.keys, c_.values);
+		}
+
+		//rearrange both containers so that position i holds the element at order[i]
+		//follows each cycle of the permutation once; order is consumed
+		void _permute(vector<size_type>& order)
+		{
+			for (size_type start = 0; start < order.size(); ++start) {
+				if (order[start] == start)
+					continue;
+
+				auto key = std::move(_key(start));
+				auto value = std::move(c_.values[start]);
+				auto i = start;
+				while (order[i] != start) {
+					const auto next = order[i];
+					_key(i) = std::move(_key(next));
+					c_.values[i] = std::move(c_.values[next]);
+					order[i] = i;
+					i = next;
+				}
+				_key(i) = std::move(key);
+				c_.values[i] = std::move(value);
+				order[i] = i;
+			}
+		}
+
+		key_type& _key(size_type i) { return c_.keys[i]; }
+
+	}; //template flat_map
+
+
+	//specialized algorithms
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	void swap(flat_map<Key, T, Compare, KC, MC>& x, flat_map<Key, T, Compare, KC, MC>& y)
+		noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator==(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return x.size() == y.size() && std::equal(x.keys().begin(), x.keys().end(), y.keys().begin()) &&
+			std::equal(x.values().begin(), x.values().end(), y.values().begin());
+	}
+
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator!=(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator<(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+	}
+
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator>(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return y < x;
+	}
+
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator<=(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename Key, typename T, typename Compare, typename KC, typename MC>
+	bool operator>=(const flat_map<Key, T, Compare, KC, MC>& x, const flat_map<Key, T, Compare, KC, MC>& y)
+	{
+		return !(x < y);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,368 @@
+/*
+* flat_set.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for sets kept as a sorted sequence
+* - see C++23 [flat.set] https://timsong-cpp.github.io/cppwp/n4950/flat.set
+* - keys are kept sorted and unique in a random-access container: lookup is a branchless
+*   binary search over contiguous memory (see sorted_search.h)
+* - construction from a container sorts once (stably: of equivalent keys, the first stays)
+*   and removes duplicates; bulk insert appends, sorts the new keys, and merges them in
+* - the container may be fixed-size, such as sigcpp::array<Key, N>: the set is then
+*   read-only, and its keys must be unique (construction throws std::invalid_argument)
+*/
+
+#ifndef SIGCPP_FLAT_SET_H
+#define SIGCPP_FLAT_SET_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+#include "array_iterator.h"
+#include "sorted_search.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	//tag: the input is already sorted and has no duplicates
+	struct sorted_unique_t
+	{
+		explicit sorted_unique_t() = default;
+	};
+
+	inline constexpr sorted_unique_t sorted_unique{};
+
+
+	namespace detail
+	{
+		//a container that can shrink; else it is fixed-size, like array
+		template<typename C, typename = void>
+		constexpr bool is_resizable_v = false;
+
+		template<typename C>
+		constexpr bool is_resizable_v<C, std::void_t<decltype(std::declval<C&>().erase(
+			std::declval<C&>().begin(), std::declval<C&>().end()))>> = true;
+
+
+		//end of the unique prefix of a sorted range: duplicates are moved past it
+		template<typename It, typename Compare>
+		It unique_sorted(It first, It last, Compare comp)
+		{
+			return std::unique(first, last, [&comp](const auto& x, const auto& y) { return !comp(x, y); });
+		}
+
+
+		//trim the keys (and other containers in lockstep) to the unique prefix of length n
+		//fixed-size containers have no room to trim: they must not contain duplicates
+		template<typename C, typename... Cs>
+		void trim_unique(std::size_t n, C& c, Cs&... cs)
+		{
+			if (n == c.size())
+				return;
+
+			if constexpr (is_resizable_v<C>) {
+				c.erase(c.begin() + static_cast<std::ptrdiff_t>(n), c.end());
+				(cs.erase(cs.begin() + static_cast<std::ptrdiff_t>(n), cs.end()), ...);
+			}
+			else
+				throw std::invalid_argument("duplicate keys in a fixed-size container");
+		}
+	}
+
+
+	template<typename Key, typename Compare = std::less<Key>, typename KeyContainer = vector<Key>>
+	class flat_set
+	{
+		static_assert(std::is_same_v<typename KeyContainer::value_type, Key>, "container must hold Key");
+
+	public:
+		//types
+		using key_type = Key;
+		using value_type = Key;
+		using key_compare = Compare;
+		using value_compare = Compare;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = typename KeyContainer::size_type;
+		using difference_type = typename KeyContainer::difference_type;
+		using container_type = KeyContainer;
+
+		//keys are immutable in place: both iterators are const
+		using iterator = typename KeyContainer::const_iterator;
+		using const_iterator = typename KeyContainer::const_iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//ctors
+		flat_set() : flat_set(Compare()) {}
+		explicit flat_set(const Compare& comp) : keys_(), comp_(comp) {}
+
+		//sort and remove duplicates
+		explicit flat_set(container_type keys, const Compare& comp = Compare())
+			: keys_(std::move(keys)), comp_(comp)
+		{
+			_sort_unique();
+		}
+
+		flat_set(sorted_unique_t, container_type keys, const Compare& comp = Compare())
+			: keys_(std::move(keys)), comp_(comp) {}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		flat_set(InputIt first, InputIt last, const Compare& comp = Compare()) : keys_(), comp_(comp)
+		{
+			insert(first, last);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		flat_set(sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare())
+			: keys_(first, last), comp_(comp) {}
+
+		flat_set(std::initializer_list<Key> il, const Compare& comp = Compare())
+			: flat_set(il.begin(), il.end(), comp) {}
+
+		flat_set(sorted_unique_t, std::initializer_list<Key> il, const Compare& comp = Compare())
+			: flat_set(sorted_unique, il.begin(), il.end(), comp) {}
+
+		flat_set& operator=(std::initializer_list<Key> il)
+		{
+			clear();
+			insert(il);
+			return *this;
+		}
+
+		//iterators
+		iterator begin() const noexcept { return keys_.begin(); }
+		iterator end() const noexcept { return keys_.end(); }
+		reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+		reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+		const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+		const_reverse_iterator crend() const noexcept { return rend(); }
+
+		//capacity
+		bool empty() const noexcept { return keys_.empty(); }
+		size_type size() const noexcept { return keys_.size(); }
+		size_type max_size() const noexcept { return keys_.max_size(); }
+
+		//modifiers: not available with a fixed-size container
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			return _insert(Key(std::forward<Args>(args)...));
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value) { return _insert(value); }
+		std::pair<iterator, bool> insert(value_type&& value) { return _insert(std::move(value)); }
+
+		//append, sort the new keys, and merge: O(n + m log m) rather than O(n m)
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void insert(InputIt first, InputIt last)
+		{
+			const auto old_size = keys_.size();
+			keys_.insert(keys_.end(), first, last);
+			std::stable_sort(_begin() + static_cast<difference_type>(old_size), _end(), comp_);
+			_merge_unique(old_size);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void insert(sorted_unique_t, InputIt first, InputIt last)
+		{
+			const auto old_size = keys_.size();
+			keys_.insert(keys_.end(), first, last);
+			_merge_unique(old_size);
+		}
+
+		void insert(std::initializer_list<Key> il) { insert(il.begin(), il.end()); }
+
+		iterator erase(const_iterator pos) { return keys_.erase(pos); }
+		iterator erase(const_iterator first, const_iterator last) { return keys_.erase(first, last); }
+
+		size_type erase(const key_type& key)
+		{
+			const auto [first, last] = equal_range(key);
+			const auto count = static_cast<size_type>(last - first);
+			keys_.erase(first, last);
+			return count;
+		}
+
+		void clear() noexcept { keys_.clear(); }
+
+		//the keys: the set is left empty
+		container_type extract() &&
+		{
+			auto keys = std::move(keys_);
+			keys_.clear();
+			return keys;
+		}
+
+		//keys must be sorted and unique
+		void replace(container_type&& keys) { keys_ = std::move(keys); }
+
+		void swap(flat_set& s) noexcept(std::is_nothrow_swappable_v<KeyContainer> &&
+			std::is_nothrow_swappable_v<Compare>)
+		{
+			using std::swap;
+			swap(keys_, s.keys_);
+			swap(comp_, s.comp_);
+		}
+
+		//observers
+		key_compare key_comp() const { return comp_; }
+		value_compare value_comp() const { return comp_; }
+
+		//lookup; K other than Key requires a transparent Compare
+		iterator find(const key_type& key) const { return _find(key); }
+		bool contains(const key_type& key) const { return _find(key) != end(); }
+		size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+		iterator lower_bound(const key_type& key) const { return _lower_bound(key); }
+		iterator upper_bound(const key_type& key) const { return _upper_bound(key); }
+
+		std::pair<iterator, iterator> equal_range(const key_type& key) const
+		{
+			return { _lower_bound(key), _upper_bound(key) };
+		}
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator find(const K& key) const { return _find(key); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		bool contains(const K& key) const { return _find(key) != end(); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		size_type count(const K& key) const
+		{
+			const auto [first, last] = equal_range(key);
+			return static_cast<size_type>(last - first);
+		}
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator lower_bound(const K& key) const { return _lower_bound(key); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		iterator upper_bound(const K& key) const { return _upper_bound(key); }
+
+		template<typename K, typename C = Compare, typename = typename C::is_transparent>
+		std::pair<iterator, iterator> equal_range(const K& key) const
+		{
+			return { _lower_bound(key), _upper_bound(key) };
+		}
+
+	private:
+		KeyContainer keys_;
+		Compare comp_;
+
+		auto _begin() { return keys_.begin(); }
+		auto _end() { return keys_.end(); }
+
+		template<typename K>
+		iterator _lower_bound(const K& key) const
+		{
+			return branchless_lower_bound(begin(), end(), key, comp_);
+		}
+
+		template<typename K>
+		iterator _upper_bound(const K& key) const
+		{
+			return branchless_upper_bound(begin(), end(), key, comp_);
+		}
+
+		template<typename K>
+		iterator _find(const K& key) const
+		{
+			const auto it = _lower_bound(key);
+			return it != end() && !comp_(key, *it) ? it : end();
+		}
+
+		void _sort_unique()
+		{
+			if (!std::is_sorted(_begin(), _end(), comp_))
+				std::stable_sort(_begin(), _end(), comp_);
+			const auto last = detail::unique_sorted(_begin(), _end(), comp_);
+			detail::trim_unique(static_cast<size_type>(last - _begin()), keys_);
+		}
+
+		//merge the sorted keys past old_size with those before it, then drop duplicates
+		//the merge is stable: of equivalent keys, the one already in the set stays
+		void _merge_unique(size_type old_size)
+		{
+			const auto middle = _begin() + static_cast<difference_type>(old_size);
+			std::inplace_merge(_begin(), middle, _end(), comp_);
+			const auto last = detail::unique_sorted(_begin(), _end(), comp_);
+			detail::trim_unique(static_cast<size_type>(last - _begin()), keys_);
+		}
+
+		template<typename V>
+		std::pair<iterator, bool> _insert(V&& value)
+		{
+			const auto it = _lower_bound(value);
+			if (it != end() && !comp_(value, *it))
+				return { it, false };
+			return { keys_.insert(it, std::forward<V>(value)), true };
+		}
+
+	}; //template flat_set
+
+
+	//specialized algorithms
+	template<typename Key, typename Compare, typename KeyContainer>
+	void swap(flat_set<Key, Compare, KeyContainer>& x, flat_set<Key, Compare, KeyContainer>& y)
+		noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator==(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());
+	}
+
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator!=(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator<(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+	}
+
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator>(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return y < x;
+	}
+
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator<=(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename Key, typename Compare, typename KeyContainer>
+	bool operator>=(const flat_set<Key, Compare, KeyContainer>& x, const flat_set<Key, Compare, KeyContainer>& y)
+	{
+		return !(x < y);
+	}
+
+}	//namespace sigcpp
+
+#endif
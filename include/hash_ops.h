@@ -0,0 +1,49 @@
+/*
+* hash_ops.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define the integer kernels that hashed tables and filters share
+* - mix64 spreads a hash so that its high and low bits can both select a slot
+* - ceil_power_of_2 sizes a table whose slot is the hash masked by the size less 1
+*/
+
+#ifndef SIGCPP_HASH_OPS_H
+#define SIGCPP_HASH_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//finalizer of splitmix64: every bit of the result depends on every bit of x
+		constexpr std::uint64_t mix64(std::uint64_t x) noexcept
+		{
+			x ^= x >> 30;
+			x *= 0xBF58476D1CE4E5B9ull;
+			x ^= x >> 27;
+			x *= 0x94D049BB133111EBull;
+			return x ^ (x >> 31);
+		}
+
+
+		//smallest power of 2 not less than n
+		constexpr std::size_t ceil_power_of_2(std::size_t n) noexcept
+		{
+			std::size_t p = 1;
+			while (p < n)
+				p *= 2;
+			return p;
+		}
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,164 @@
+/*
+* mdarray.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a fixed-size multi-dimensional array: mdarray<T, Extents...>
+* - the elements are one sigcpp::array in row-major order, so m(i, j) is one multiply-add
+*   with constant strides, where nested arrays index twice
+* - an aggregate, like sigcpp::array: mdarray<int, 2, 3> m{ 1, 2, 3, 4, 5, 6 }
+* - to_mdspan() views the elements as an mdspan (see mdspan.h), for submdspan and for
+*   functions that take views of any size
+* - iterators visit every element in memory order
+*/
+
+#ifndef SIGCPP_MDARRAY_H
+#define SIGCPP_MDARRAY_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "array.h"
+#include "mdspan.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t... Extents>
+	struct mdarray
+	{
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using storage_type = array<T, (std::size_t{ 1 } * ... * Extents)>;
+		using iterator = typename storage_type::iterator;
+		using const_iterator = typename storage_type::const_iterator;
+		using reverse_iterator = typename storage_type::reverse_iterator;
+		using const_reverse_iterator = typename storage_type::const_reverse_iterator;
+
+		using extents_type = array<std::size_t, sizeof...(Extents)>;
+		using mapping_type = layout_right::mapping<sizeof...(Extents)>;
+		using mdspan_type = mdspan<T, sizeof...(Extents)>;
+		using const_mdspan_type = mdspan<const T, sizeof...(Extents)>;
+
+		//the elements in row-major order
+		storage_type values;
+
+		//utility
+		void fill(const T& u) { values.fill(u); }
+		void swap(mdarray& m) noexcept(std::is_nothrow_swappable_v<T>) { values.swap(m.values); }
+
+		//iterators
+		constexpr iterator begin() noexcept { return values.begin(); }
+		constexpr const_iterator begin() const noexcept { return values.begin(); }
+		constexpr iterator end() noexcept { return values.end(); }
+		constexpr const_iterator end() const noexcept { return values.end(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return values.rbegin(); }
+		constexpr const_reverse_iterator rbegin() const noexcept { return values.rbegin(); }
+		constexpr reverse_iterator rend() noexcept { return values.rend(); }
+		constexpr const_reverse_iterator rend() const noexcept { return values.rend(); }
+
+		constexpr const_iterator cbegin() const noexcept { return values.cbegin(); }
+		constexpr const_iterator cend() const noexcept { return values.cend(); }
+		constexpr const_reverse_iterator crbegin() const noexcept { return values.crbegin(); }
+		constexpr const_reverse_iterator crend() const noexcept { return values.crend(); }
+
+		//capacity and shape
+		static constexpr size_type rank() noexcept { return sizeof...(Extents); }
+		static constexpr extents_type extents() noexcept { return extents_type{ Extents... }; }
+		static constexpr size_type extent(size_type r) noexcept { return extents()[r]; }
+		static constexpr size_type stride(size_type r) noexcept { return mapping_.stride(r); }
+
+		constexpr bool empty() const noexcept { return values.empty(); }
+		constexpr size_type size() const noexcept { return values.size(); }
+		constexpr size_type max_size() const noexcept { return values.max_size(); }
+
+		//unchecked element access
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == sizeof...(Extents) &&
+			detail::are_indices_v<Indices...>>>
+		constexpr reference operator()(Indices... indices)
+		{
+			return values[mapping_(extents_type{ static_cast<std::size_t>(indices)... })];
+		}
+
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == sizeof...(Extents) &&
+			detail::are_indices_v<Indices...>>>
+		constexpr const_reference operator()(Indices... indices) const
+		{
+			return values[mapping_(extents_type{ static_cast<std::size_t>(indices)... })];
+		}
+
+		//checked element access
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == sizeof...(Extents) &&
+			detail::are_indices_v<Indices...>>>
+		constexpr reference at(Indices... indices)
+		{
+			return values[_checked_offset(extents_type{ static_cast<std::size_t>(indices)... })];
+		}
+
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == sizeof...(Extents) &&
+			detail::are_indices_v<Indices...>>>
+		constexpr const_reference at(Indices... indices) const
+		{
+			return values[_checked_offset(extents_type{ static_cast<std::size_t>(indices)... })];
+		}
+
+		//underlying raw data
+		constexpr pointer data() noexcept { return values.data(); }
+		constexpr const_pointer data() const noexcept { return values.data(); }
+
+		//views
+		constexpr mdspan_type to_mdspan() noexcept { return mdspan_type(data(), mapping_); }
+		constexpr const_mdspan_type to_mdspan() const noexcept { return const_mdspan_type(data(), mapping_); }
+
+	private:
+		//strides are constants: the compiler folds them into the index arithmetic
+		static constexpr mapping_type mapping_{ extents_type{ Extents... } };
+
+		static constexpr size_type _checked_offset(const extents_type& indices)
+		{
+			for (size_type r = 0; r < rank(); ++r)
+				if (indices[r] >= extent(r))
+					throw std::out_of_range("mdarray index out of range");
+			return mapping_(indices);
+		}
+
+	}; //template mdarray
+
+
+	//specialized algorithms
+	template<typename T, std::size_t... Extents>
+	void swap(mdarray<T, Extents...>& x, mdarray<T, Extents...>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: same elements in the same order
+	template<typename T, std::size_t... Extents>
+	bool operator==(const mdarray<T, Extents...>& x, const mdarray<T, Extents...>& y)
+	{
+		return x.values == y.values;
+	}
+
+	template<typename T, std::size_t... Extents>
+	bool operator!=(const mdarray<T, Extents...>& x, const mdarray<T, Extents...>& y)
+	{
+		return !(x == y);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,400 @@
+/*
+* mdspan.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a non-owning multi-dimensional view of elements, with layout policies
+* - after C++23 [mdspan] https://timsong-cpp.github.io/cppwp/n4950/views.multidim, with
+*   run-time extents only: mdspan<T, Rank, Layout>
+* - elements are accessed as m(i, j, ...): C++17 has no multi-argument operator[]
+* - a layout maps indices to an offset from the data pointer:
+*   - layout_right: row-major, the last index is contiguous (as in nested arrays)
+*   - layout_left: column-major, the first index is contiguous
+*   - layout_stride: any stride per dimension; the layout of every submdspan
+*   - layout_blocked<Block>: tiles of Block elements per dimension, each tile contiguous
+*     and the tiles in row-major order; a loop that walks a row of one view and a column
+*     of another (as in a transpose) then touches a few pages rather than one per element
+* - submdspan(m, slices...) views part of m: a slice is an index (which drops that
+*   dimension), a range std::pair{ first, last }, or full_extent
+*/
+
+#ifndef SIGCPP_MDSPAN_H
+#define SIGCPP_MDSPAN_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		template<std::size_t Rank>
+		constexpr std::size_t extents_product(const array<std::size_t, Rank>& extents) noexcept
+		{
+			std::size_t product = 1;
+			for (std::size_t r = 0; r < Rank; ++r)
+				product *= extents[r];
+			return product;
+		}
+
+		template<typename... Indices>
+		constexpr bool are_indices_v = (std::is_convertible_v<Indices, std::size_t> && ...);
+	}
+
+
+	//row-major: the last index is contiguous
+	struct layout_right
+	{
+		template<std::size_t Rank>
+		class mapping
+		{
+		public:
+			using extents_type = array<std::size_t, Rank>;
+
+			constexpr mapping() noexcept : extents_{}, strides_{} {}
+
+			constexpr explicit mapping(const extents_type& extents) noexcept : extents_{ extents }, strides_{}
+			{
+				std::size_t stride = 1;
+				for (auto r = Rank; r-- != 0; ) {
+					strides_[r] = stride;
+					stride *= extents_[r];
+				}
+			}
+
+			constexpr const extents_type& extents() const noexcept { return extents_; }
+			constexpr std::size_t stride(std::size_t r) const noexcept { return strides_[r]; }
+			constexpr std::size_t required_span_size() const noexcept { return detail::extents_product(extents_); }
+
+			constexpr std::size_t operator()(const extents_type& indices) const noexcept
+			{
+				std::size_t offset = 0;
+				for (std::size_t r = 0; r < Rank; ++r)
+					offset += indices[r] * strides_[r];
+				return offset;
+			}
+
+		private:
+			extents_type extents_;
+			extents_type strides_;
+
+		}; //template mapping
+	};
+
+
+	//column-major: the first index is contiguous
+	struct layout_left
+	{
+		template<std::size_t Rank>
+		class mapping
+		{
+		public:
+			using extents_type = array<std::size_t, Rank>;
+
+			constexpr mapping() noexcept : extents_{}, strides_{} {}
+
+			constexpr explicit mapping(const extents_type& extents) noexcept : extents_{ extents }, strides_{}
+			{
+				std::size_t stride = 1;
+				for (std::size_t r = 0; r < Rank; ++r) {
+					strides_[r] = stride;
+					stride *= extents_[r];
+				}
+			}
+
+			constexpr const extents_type& extents() const noexcept { return extents_; }
+			constexpr std::size_t stride(std::size_t r) const noexcept { return strides_[r]; }
+			constexpr std::size_t required_span_size() const noexcept { return detail::extents_product(extents_); }
+
+			constexpr std::size_t operator()(const extents_type& indices) const noexcept
+			{
+				std::size_t offset = 0;
+				for (std::size_t r = 0; r < Rank; ++r)
+					offset += indices[r] * strides_[r];
+				return offset;
+			}
+
+		private:
+			extents_type extents_;
+			extents_type strides_;
+
+		}; //template mapping
+	};
+
+
+	//any stride per dimension, possibly 0: such a view repeats elements
+	struct layout_stride
+	{
+		template<std::size_t Rank>
+		class mapping
+		{
+		public:
+			using extents_type = array<std::size_t, Rank>;
+
+			constexpr mapping() noexcept : extents_{}, strides_{} {}
+
+			constexpr mapping(const extents_type& extents, const extents_type& strides) noexcept
+				: extents_{ extents }, strides_{ strides } {}
+
+			//the strides of any mapping that has them
+			template<typename Mapping, typename = decltype(std::declval<const Mapping&>().stride(0))>
+			constexpr mapping(const Mapping& m) noexcept : extents_{ m.extents() }, strides_{}
+			{
+				for (std::size_t r = 0; r < Rank; ++r)
+					strides_[r] = m.stride(r);
+			}
+
+			constexpr const extents_type& extents() const noexcept { return extents_; }
+			constexpr std::size_t stride(std::size_t r) const noexcept { return strides_[r]; }
+
+			//one past the largest offset
+			constexpr std::size_t required_span_size() const noexcept
+			{
+				std::size_t size = 1;
+				for (std::size_t r = 0; r < Rank; ++r) {
+					if (extents_[r] == 0)
+						return 0;
+					size += (extents_[r] - 1) * strides_[r];
+				}
+				return size;
+			}
+
+			constexpr std::size_t operator()(const extents_type& indices) const noexcept
+			{
+				std::size_t offset = 0;
+				for (std::size_t r = 0; r < Rank; ++r)
+					offset += indices[r] * strides_[r];
+				return offset;
+			}
+
+		private:
+			extents_type extents_;
+			extents_type strides_;
+
+		}; //template mapping
+	};
+
+
+	//tiles of Block elements per dimension: a tile is contiguous and row-major, and the
+	//tiles are row-major; extents are padded to whole tiles
+	//Block is a power of 2, so an offset takes shifts and masks rather than divisions
+	//there are no strides: a submdspan of a blocked view is not supported
+	template<std::size_t Block>
+	struct layout_blocked
+	{
+		static_assert(Block != 0 && (Block & (Block - 1)) == 0, "Block must be a power of 2");
+
+		static constexpr std::size_t block_size = Block;
+
+		template<std::size_t Rank>
+		class mapping
+		{
+		public:
+			using extents_type = array<std::size_t, Rank>;
+
+			constexpr mapping() noexcept : extents_{}, tiles_{} {}
+
+			constexpr explicit mapping(const extents_type& extents) noexcept : extents_{ extents }, tiles_{}
+			{
+				for (std::size_t r = 0; r < Rank; ++r)
+					tiles_[r] = (extents_[r] + Block - 1) / Block;
+			}
+
+			constexpr const extents_type& extents() const noexcept { return extents_; }
+
+			//elements in a tile
+			static constexpr std::size_t tile_size() noexcept
+			{
+				std::size_t size = 1;
+				for (std::size_t r = 0; r < Rank; ++r)
+					size *= Block;
+				return size;
+			}
+
+			//includes the padding of the last tile in each dimension
+			constexpr std::size_t required_span_size() const noexcept
+			{
+				return detail::extents_product(tiles_) * tile_size();
+			}
+
+			constexpr std::size_t operator()(const extents_type& indices) const noexcept
+			{
+				std::size_t tile = 0, inner = 0;
+				for (std::size_t r = 0; r < Rank; ++r) {
+					tile = tile * tiles_[r] + indices[r] / Block;
+					inner = inner * Block + indices[r] % Block;
+				}
+				return tile * tile_size() + inner;
+			}
+
+		private:
+			extents_type extents_;
+			extents_type tiles_;
+
+		}; //template mapping
+	};
+
+
+	template<typename T, std::size_t Rank, typename Layout = layout_right>
+	class mdspan
+	{
+	public:
+		//types
+		using layout_type = Layout;
+		using mapping_type = typename Layout::template mapping<Rank>;
+		using extents_type = array<std::size_t, Rank>;
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using size_type = std::size_t;
+		using pointer = T*;
+		using reference = T&;
+
+		//ctors
+		constexpr mdspan() noexcept : data_{ nullptr }, mapping_{} {}
+
+		template<typename... Extents, typename = std::enable_if_t<sizeof...(Extents) == Rank &&
+			detail::are_indices_v<Extents...>>>
+		constexpr explicit mdspan(pointer data, Extents... extents)
+			: data_{ data }, mapping_{ extents_type{ static_cast<std::size_t>(extents)... } } {}
+
+		constexpr mdspan(pointer data, const extents_type& extents) : data_{ data }, mapping_{ extents } {}
+		constexpr mdspan(pointer data, const mapping_type& mapping) noexcept : data_{ data }, mapping_{ mapping } {}
+
+		//mdspan<T> to mdspan<const T>
+		template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+		constexpr mdspan(const mdspan<U, Rank, Layout>& m) noexcept : data_{ m.data() }, mapping_{ m.mapping() } {}
+
+		//observers
+		static constexpr size_type rank() noexcept { return Rank; }
+
+		constexpr pointer data() const noexcept { return data_; }
+		constexpr const mapping_type& mapping() const noexcept { return mapping_; }
+		constexpr const extents_type& extents() const noexcept { return mapping_.extents(); }
+		constexpr size_type extent(size_type r) const noexcept { return mapping_.extents()[r]; }
+
+		//available with layouts that have strides: not with layout_blocked
+		constexpr size_type stride(size_type r) const noexcept { return mapping_.stride(r); }
+
+		//elements in the view, and elements the view spans in memory
+		constexpr size_type size() const noexcept { return detail::extents_product(extents()); }
+		constexpr bool empty() const noexcept { return size() == 0; }
+		constexpr size_type required_span_size() const noexcept { return mapping_.required_span_size(); }
+
+		//unchecked element access
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == Rank &&
+			detail::are_indices_v<Indices...>>>
+		constexpr reference operator()(Indices... indices) const
+		{
+			return data_[mapping_(extents_type{ static_cast<std::size_t>(indices)... })];
+		}
+
+		constexpr reference operator()(const extents_type& indices) const { return data_[mapping_(indices)]; }
+
+		//checked element access
+		template<typename... Indices, typename = std::enable_if_t<sizeof...(Indices) == Rank &&
+			detail::are_indices_v<Indices...>>>
+		constexpr reference at(Indices... indices) const
+		{
+			return at(extents_type{ static_cast<std::size_t>(indices)... });
+		}
+
+		constexpr reference at(const extents_type& indices) const
+		{
+			for (size_type r = 0; r < Rank; ++r)
+				if (indices[r] >= extent(r))
+					throw std::out_of_range("mdspan index out of range");
+			return (*this)(indices);
+		}
+
+	private:
+		pointer data_;
+		mapping_type mapping_;
+
+	}; //template mdspan
+
+
+	//deduce the rank from the extents
+	template<typename T, typename... Extents, typename = std::enable_if_t<detail::are_indices_v<Extents...>>>
+	mdspan(T*, Extents...) -> mdspan<T, sizeof...(Extents)>;
+
+
+	//a slice that keeps a whole dimension
+	struct full_extent_t
+	{
+		explicit full_extent_t() = default;
+	};
+
+	inline constexpr full_extent_t full_extent{};
+
+
+	namespace detail
+	{
+		template<typename Slice>
+		constexpr bool is_index_slice_v = std::is_convertible_v<Slice, std::size_t>;
+
+		//the first index of a slice of an extent, and the extent the slice keeps
+		constexpr std::pair<std::size_t, std::size_t> slice_bounds(std::size_t index, std::size_t) noexcept
+		{
+			return { index, 0 };
+		}
+
+		constexpr std::pair<std::size_t, std::size_t> slice_bounds(full_extent_t, std::size_t extent) noexcept
+		{
+			return { 0, extent };
+		}
+
+		template<typename First, typename Last>
+		constexpr std::pair<std::size_t, std::size_t> slice_bounds(const std::pair<First, Last>& range, std::size_t) noexcept
+		{
+			return { static_cast<std::size_t>(range.first),
+				static_cast<std::size_t>(range.second) - static_cast<std::size_t>(range.first) };
+		}
+	}
+
+
+	namespace detail
+	{
+		template<typename T, std::size_t Rank, typename Layout, std::size_t... I, typename... Slices>
+		constexpr auto sub_view(const mdspan<T, Rank, Layout>& m, std::index_sequence<I...>, Slices... slices)
+		{
+			constexpr std::size_t subRank = (std::size_t{ 0 } + ... + std::size_t{ !is_index_slice_v<Slices> });
+			constexpr array<bool, Rank> kept{ { !is_index_slice_v<Slices>... } };
+			const array<std::pair<std::size_t, std::size_t>, Rank> bounds{ { slice_bounds(slices, m.extent(I))... } };
+
+			std::size_t offset = 0, k = 0;
+			array<std::size_t, subRank> extents{}, strides{};
+			for (std::size_t r = 0; r < Rank; ++r) {
+				offset += bounds[r].first * m.stride(r);
+				if (kept[r]) {
+					extents[k] = bounds[r].second;
+					strides[k] = m.stride(r);
+					++k;
+				}
+			}
+			return mdspan<T, subRank, layout_stride>(m.data() + offset,
+				layout_stride::mapping<subRank>(extents, strides));
+		}
+	}
+
+
+	//view part of m: each slice is an index, a range std::pair{ first, last }, or full_extent
+	//the view has one dimension per slice that is not an index, with the strides of m
+	template<typename T, std::size_t Rank, typename Layout, typename... Slices>
+	constexpr auto submdspan(const mdspan<T, Rank, Layout>& m, Slices... slices)
+	{
+		static_assert(sizeof...(Slices) == Rank, "submdspan needs one slice per dimension");
+		return detail::sub_view(m, std::index_sequence_for<Slices...>(), slices...);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,386 @@
+/*
+* memory_resource.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define memory resources and an allocator that draws from any memory resource
+* - the resources derive from std::pmr::memory_resource (C++17 [mem.res]), so they serve
+*   std::pmr containers as well as sigcpp containers
+* - monotonic_arena: allocation bumps a pointer; deallocation does nothing; reset() rewinds
+*   to the start in O(1) and keeps the chunks for the next round, so a per-request arena
+*   frees thousands of objects without visiting any; release() returns the chunks upstream
+*   - an initial buffer, such as a sigcpp::array<std::byte, N> on the stack, serves the
+*     first allocations; chunks from upstream follow, each 1.5 times the previous
+* - pool_resource: blocks of one size from chunks, with a free list threaded through the
+*   free blocks; an allocation larger than a block, or more aligned than max_align_t, goes
+*   upstream
+* - resource_allocator<T>: an allocator that holds a memory_resource*; as with
+*   std::pmr::polymorphic_allocator, it does not propagate, and a copy of a container
+*   uses the default resource; it converts to and from std::pmr::polymorphic_allocator
+*   - like polymorphic_allocator, it passes itself to the elements it constructs that use
+*     an allocator, so vector<vector<int, A>, A> puts the inner elements in the same
+*     resource; unlike polymorphic_allocator, it does not do so for the members of a pair
+* - the sigcpp containers that allocate take an Allocator and accept resource_allocator:
+*   vector, small_vector, flat_hash_map, slot_map, bit_vector, rank_select,
+*   compressed_sorted_array, bloom_filter, cuckoo_filter, and basic_soa_vector; those with
+*   several arrays rebind it for each
+* - none of these is thread-safe: share a resource between threads only with a lock
+*/
+
+#ifndef SIGCPP_MEMORY_RESOURCE_H
+#define SIGCPP_MEMORY_RESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	class monotonic_arena : public std::pmr::memory_resource
+	{
+	public:
+		using size_type = std::size_t;
+
+		//size of the first chunk, if there is no initial buffer
+		static constexpr size_type default_chunk_size = 1024;
+
+		//ctors
+		explicit monotonic_arena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: monotonic_arena(nullptr, 0, default_chunk_size, upstream) {}
+
+		explicit monotonic_arena(size_type chunkSize, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: monotonic_arena(nullptr, 0, chunkSize, upstream) {}
+
+		//the buffer serves the first allocations: the arena does not own it
+		monotonic_arena(void* buffer, size_type size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: monotonic_arena(buffer, size, std::max(size, default_chunk_size), upstream) {}
+
+		template<std::size_t N>
+		explicit monotonic_arena(array<std::byte, N>& buffer, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: monotonic_arena(buffer.data(), N, upstream) {}
+
+		monotonic_arena(const monotonic_arena&) = delete;
+		monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+		~monotonic_arena() override { release(); }
+
+		//start over: the memory of every allocation is reused, and no chunk is freed
+		void reset() noexcept
+		{
+			current_ = nullptr;
+			_use(buffer_, bufferSize_);
+		}
+
+		//start over and return every chunk upstream
+		void release() noexcept
+		{
+			for (auto c = chunks_; c != nullptr; ) {
+				const auto next = c->next;
+				upstream_->deallocate(c, c->size, alignof(std::max_align_t));
+				c = next;
+			}
+			chunks_ = nullptr;
+			last_ = nullptr;
+			nextChunkSize_ = std::max(firstChunkSize_, size_type{ 64 });
+			reset();
+		}
+
+		std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+		//bytes left in the current chunk or buffer
+		size_type remaining() const noexcept { return static_cast<size_type>(end_ - next_); }
+
+	protected:
+		void* do_allocate(size_type bytes, size_type alignment) override
+		{
+			if (auto p = _bump(bytes, alignment))
+				return p;
+
+			//chunks past the current one, kept by reset(), before a new chunk
+			for (auto c = current_ != nullptr ? current_->next : chunks_; c != nullptr; c = c->next) {
+				current_ = c;
+				_use(c + 1, c->size - sizeof(chunk));
+				if (auto p = _bump(bytes, alignment))
+					return p;
+			}
+
+			//a chunk with room for the header and any padding: too large a request throws
+			if (bytes > std::numeric_limits<size_type>::max() - alignment - sizeof(chunk))
+				throw std::bad_alloc();
+
+			_add_chunk(bytes + alignment);
+			if (auto p = _bump(bytes, alignment))
+				return p;
+			throw std::bad_alloc();
+		}
+
+		void do_deallocate(void*, size_type, size_type) override {}
+
+		bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override { return this == &r; }
+
+	private:
+		//header of a chunk from upstream: the chunks form a list in the order allocated
+		struct chunk
+		{
+			chunk* next;
+			size_type size;
+		};
+
+		monotonic_arena(void* buffer, size_type size, size_type chunkSize, std::pmr::memory_resource* upstream) noexcept
+			: upstream_{ upstream }, buffer_{ static_cast<std::byte*>(buffer) }, bufferSize_{ size },
+			chunks_{ nullptr }, last_{ nullptr }, current_{ nullptr }, firstChunkSize_{ chunkSize },
+			nextChunkSize_{ std::max(chunkSize, size_type{ 64 }) }
+		{
+			reset();
+		}
+
+		void _use(void* p, size_type size) noexcept
+		{
+			next_ = static_cast<std::byte*>(p);
+			end_ = next_ + size;
+		}
+
+		//nullptr if the rest of the current chunk is too small
+		void* _bump(size_type bytes, size_type alignment) noexcept
+		{
+			if (next_ == nullptr)
+				return nullptr;
+
+			const auto address = reinterpret_cast<std::uintptr_t>(next_);
+			const auto padding = (alignment - address % alignment) % alignment;
+			if (padding > remaining() || bytes > remaining() - padding)
+				return nullptr;
+
+			const auto p = next_ + padding;
+			next_ = p + bytes;
+			return p;
+		}
+
+		//a chunk of at least minimum usable bytes, appended to the list: the chunks kept
+		//by reset() all turned out too small
+		void _add_chunk(size_type minimum)
+		{
+			const auto size = std::max(nextChunkSize_, minimum + sizeof(chunk));
+			const auto c = static_cast<chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+			c->next = nullptr;
+			c->size = size;
+			if (last_ == nullptr)
+				chunks_ = c;
+			else
+				last_->next = c;
+			last_ = c;
+			current_ = c;
+			_use(c + 1, size - sizeof(chunk));
+			nextChunkSize_ = size <= std::numeric_limits<size_type>::max() / 3 * 2 ? size + size / 2 : size;
+		}
+
+		std::pmr::memory_resource* upstream_;
+		std::byte* buffer_;
+		size_type bufferSize_;
+		chunk* chunks_;
+		chunk* last_;
+		chunk* current_;
+		std::byte* next_;
+		std::byte* end_;
+		size_type firstChunkSize_;
+		size_type nextChunkSize_;
+
+	}; //class monotonic_arena
+
+
+	class pool_resource : public std::pmr::memory_resource
+	{
+	public:
+		using size_type = std::size_t;
+
+		//blocks of at least blockSize bytes, blocksPerChunk at a time from upstream
+		explicit pool_resource(size_type blockSize, size_type blocksPerChunk = 64,
+			std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+			: upstream_{ upstream }, blockSize_{ _round_block_size(blockSize) },
+			blocksPerChunk_{ std::max(blocksPerChunk, size_type{ 1 }) }, free_{ nullptr }, chunks_{ nullptr }
+		{
+		}
+
+		pool_resource(const pool_resource&) = delete;
+		pool_resource& operator=(const pool_resource&) = delete;
+
+		~pool_resource() override { release(); }
+
+		//return every chunk upstream: every block is freed at once
+		void release() noexcept
+		{
+			for (auto c = chunks_; c != nullptr; ) {
+				const auto next = c->next;
+				upstream_->deallocate(c, _chunk_bytes(), alignof(std::max_align_t));
+				c = next;
+			}
+			chunks_ = nullptr;
+			free_ = nullptr;
+		}
+
+		size_type block_size() const noexcept { return blockSize_; }
+		std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+	protected:
+		void* do_allocate(size_type bytes, size_type alignment) override
+		{
+			if (!_pooled(bytes, alignment))
+				return upstream_->allocate(bytes, alignment);
+
+			if (free_ == nullptr)
+				_add_chunk();
+
+			const auto block = free_;
+			free_ = block->next;
+			return block;
+		}
+
+		void do_deallocate(void* p, size_type bytes, size_type alignment) override
+		{
+			if (!_pooled(bytes, alignment))
+				return upstream_->deallocate(p, bytes, alignment);
+
+			const auto block = static_cast<free_block*>(p);
+			block->next = free_;
+			free_ = block;
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override { return this == &r; }
+
+	private:
+		struct free_block
+		{
+			free_block* next;
+		};
+
+		//a chunk: its header, padded to max_align_t, then the blocks
+		struct alignas(std::max_align_t) chunk
+		{
+			chunk* next;
+		};
+
+		//a multiple of max_align_t: every block is aligned as any scalar
+		static constexpr size_type _round_block_size(size_type size) noexcept
+		{
+			constexpr auto align = alignof(std::max_align_t);
+			return (std::max(size, sizeof(free_block)) + align - 1) / align * align;
+		}
+
+		bool _pooled(size_type bytes, size_type alignment) const noexcept
+		{
+			return bytes <= blockSize_ && alignment <= alignof(std::max_align_t);
+		}
+
+		size_type _chunk_bytes() const noexcept { return sizeof(chunk) + blockSize_ * blocksPerChunk_; }
+
+		//thread the blocks of a new chunk onto the free list, the first block first
+		void _add_chunk()
+		{
+			const auto c = static_cast<chunk*>(upstream_->allocate(_chunk_bytes(), alignof(std::max_align_t)));
+			c->next = chunks_;
+			chunks_ = c;
+
+			const auto blocks = reinterpret_cast<std::byte*>(c + 1);
+			for (auto i = blocksPerChunk_; i-- != 0; ) {
+				const auto block = ::new (blocks + i * blockSize_) free_block;
+				block->next = free_;
+				free_ = block;
+			}
+		}
+
+		std::pmr::memory_resource* upstream_;
+		size_type blockSize_;
+		size_type blocksPerChunk_;
+		free_block* free_;
+		chunk* chunks_;
+
+	}; //class pool_resource
+
+
+	template<typename T>
+	class resource_allocator
+	{
+	public:
+		//types
+		using value_type = T;
+
+		//a copy of a container gets the default resource; the allocator does not propagate
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::false_type;
+		using propagate_on_container_swap = std::false_type;
+
+		//ctors
+		resource_allocator() noexcept : resource_{ std::pmr::get_default_resource() } {}
+		resource_allocator(std::pmr::memory_resource* r) noexcept : resource_{ r } {}
+
+		template<typename U>
+		resource_allocator(const resource_allocator<U>& a) noexcept : resource_{ a.resource() } {}
+
+		template<typename U>
+		resource_allocator(const std::pmr::polymorphic_allocator<U>& a) noexcept : resource_{ a.resource() } {}
+
+		T* allocate(std::size_t n)
+		{
+			if (n > static_cast<std::size_t>(-1) / sizeof(T))
+				throw std::bad_array_new_length();
+			return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+		//uses-allocator construction (C++17 [allocator.uses.construction]): an element whose
+		//allocator_type this converts to gets this allocator, so a nested container draws from
+		//the same resource; other elements are built by allocator_traits with placement new
+		template<typename U, typename... Args, typename = std::enable_if_t<std::uses_allocator_v<U, resource_allocator>>>
+		void construct(U* p, Args&&... args)
+		{
+			if constexpr (std::is_constructible_v<U, std::allocator_arg_t, const resource_allocator&, Args...>)
+				::new (static_cast<void*>(p)) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+			else
+				::new (static_cast<void*>(p)) U(std::forward<Args>(args)..., *this);
+		}
+
+		resource_allocator select_on_container_copy_construction() const noexcept { return resource_allocator(); }
+
+		std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+		//the same allocator for std::pmr containers, of any element type: so that a std::pmr
+		//container nested in a sigcpp container gets the resource
+		template<typename U>
+		operator std::pmr::polymorphic_allocator<U>() const noexcept { return std::pmr::polymorphic_allocator<U>(resource_); }
+
+	private:
+		std::pmr::memory_resource* resource_;
+
+	}; //template resource_allocator
+
+
+	//allocators are equal if memory from one can be freed by the other
+	template<typename T, typename U>
+	bool operator==(const resource_allocator<T>& x, const resource_allocator<U>& y) noexcept
+	{
+		return *x.resource() == *y.resource();
+	}
+
+	template<typename T, typename U>
+	bool operator!=(const resource_allocator<T>& x, const resource_allocator<U>& y) noexcept
+	{
+		return !(x == y);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,212 @@
+/*
+* mpmc_queue.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for a bounded multi-producer/multi-consumer queue
+* - after Dmitry Vyukov's bounded MPMC queue: no lock; each cell carries a sequence number
+*   that says whose turn it is
+* - cell i starts at sequence i; the producer that claims position pos waits for sequence
+*   pos, then publishes pos + 1; the consumer of pos waits for pos + 1, then publishes
+*   pos + N to hand the cell to the producer one lap later
+* - try_push and try_pop claim a position with a CAS only when its cell is ready, so they
+*   fail rather than wait
+* - push and pop (C++20) claim a position unconditionally and block on the cell's sequence
+*   with atomic::wait; they may be mixed freely with try_push and try_pop
+* - each cell is padded to a whole number of cache lines, so threads working on adjacent
+*   positions do not contend for a line
+* - a claimed cell must be published: a move assignment of T that throws stalls the queue
+*/
+
+#ifndef SIGCPP_MPMC_QUEUE_H
+#define SIGCPP_MPMC_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "array.h"
+#include "aligned_array.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		template<typename T>
+		struct alignas(cache_line_size) mpmc_cell
+		{
+			std::atomic<std::size_t> sequence;
+			T value;
+		};
+	}
+
+
+	template<typename T, std::size_t N>
+	class mpmc_queue
+	{
+		static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of 2");
+		static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+		static_assert(std::is_move_assignable_v<T>, "T must be move assignable");
+
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		//ctors
+		mpmc_queue() noexcept(std::is_nothrow_default_constructible_v<T>)
+		{
+			for (size_type i = 0; i < N; ++i)
+				cells_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+		//capacity
+		static constexpr size_type capacity() noexcept { return N; }
+
+		//approximate while other threads push or pop
+		size_type size() const noexcept
+		{
+			const auto head = dequeue_pos_.load(std::memory_order_acquire);
+			const auto tail = enqueue_pos_.load(std::memory_order_acquire);
+			const auto size = static_cast<std::ptrdiff_t>(tail - head);
+			return size < 0 ? 0 : static_cast<size_type>(size) > N ? N : static_cast<size_type>(size);
+		}
+
+		bool empty() const noexcept { return size() == 0; }
+
+		//non-blocking
+		bool try_push(const T& value) { return _try_push(value); }
+		bool try_push(T&& value) { return _try_push(std::move(value)); }
+
+		template<typename... Args>
+		bool try_emplace(Args&&... args)
+		{
+			return _try_push(T(std::forward<Args>(args)...));
+		}
+
+		bool try_pop(T& value)
+		{
+			auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+			cell_type* cell;
+			for (;;) {
+				cell = &cells_[pos & mask];
+				const auto sequence = cell->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+				if (diff == 0) {
+					if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+
+			value = std::move(cell->value);
+			_publish(*cell, pos + N);
+			return true;
+		}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+		//blocking: wait for a free cell
+		void push(const T& value) { _push(value); }
+		void push(T&& value) { _push(std::move(value)); }
+
+		template<typename... Args>
+		void emplace(Args&&... args)
+		{
+			_push(T(std::forward<Args>(args)...));
+		}
+
+		//blocking: wait for an element
+		T pop()
+		{
+			const auto pos = dequeue_pos_.fetch_add(1, std::memory_order_relaxed);
+			auto& cell = cells_[pos & mask];
+			_wait_for(cell, pos + 1);
+
+			T value = std::move(cell.value);
+			_publish(cell, pos + N);
+			return value;
+		}
+#endif
+
+	private:
+		using cell_type = detail::mpmc_cell<T>;
+		static constexpr size_type mask = N - 1;
+
+		//producers and consumers each hammer one counter: keep them on separate lines
+		alignas(cache_line_size) std::atomic<size_type> enqueue_pos_{ 0 };
+		alignas(cache_line_size) std::atomic<size_type> dequeue_pos_{ 0 };
+		array<cell_type, N> cells_;
+
+		template<typename U>
+		bool _try_push(U&& value)
+		{
+			auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+			cell_type* cell;
+			for (;;) {
+				cell = &cells_[pos & mask];
+				const auto sequence = cell->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+				if (diff == 0) {
+					if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+
+			cell->value = std::forward<U>(value);
+			_publish(*cell, pos + 1);
+			return true;
+		}
+
+		//hand the cell to the next owner and wake it if it is blocked
+		void _publish(cell_type& cell, size_type sequence) noexcept
+		{
+			cell.sequence.store(sequence, std::memory_order_release);
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+			cell.sequence.notify_all();
+#endif
+		}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+		template<typename U>
+		void _push(U&& value)
+		{
+			const auto pos = enqueue_pos_.fetch_add(1, std::memory_order_relaxed);
+			auto& cell = cells_[pos & mask];
+			_wait_for(cell, pos);
+
+			cell.value = std::forward<U>(value);
+			_publish(cell, pos + 1);
+		}
+
+		//block until the cell reaches the sequence; a cell's sequence only increases
+		static void _wait_for(cell_type& cell, size_type sequence) noexcept
+		{
+			for (auto current = cell.sequence.load(std::memory_order_acquire); current != sequence;
+				current = cell.sequence.load(std::memory_order_acquire))
+				cell.sequence.wait(current, std::memory_order_acquire);
+		}
+#endif
+
+	}; //template mpmc_queue
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,495 @@
+/*
+* packed_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a fixed-size array of unsigned integers of Bits bits each, packed end to end
+* - packed_array<Bits, N>: N values in N * Bits bits (rounded up to 64-bit words, plus one
+*   word so that a value that ends past a word is read with two loads and no branch)
+* - the members of sigcpp::array, apart from data(): elements are accessed through proxy
+*   references, and iterators are random-access proxies, so standard algorithms such as
+*   std::sort work on the values
+* - assigning a value keeps its low Bits bits
+* - bulk access: unpack_into(span<uint32_t>) and pack_from(span<const uint32_t>)
+*   - unpack_into decodes 8 values per step with AVX2 if Bits <= 25: 8 values fill Bits
+*     bytes, so one byte shuffle moves the (at most 4) bytes of each value into its own
+*     lane, and a variable shift and a mask finish it; else a branchless scalar loop
+*   - pack_from gathers bits in a 64-bit accumulator and stores each word once: adjacent
+*     values share bytes, which a SIMD store cannot merge
+*/
+
+#ifndef SIGCPP_PACKED_ARRAY_H
+#define SIGCPP_PACKED_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "array.h"
+#include "simd.h"
+#include "span.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		template<unsigned Bits>
+		constexpr std::uint64_t packed_mask = (std::uint64_t{ 1 } << Bits) - 1;
+
+		//value i: the word after the first supplies the bits past the first word; shifting
+		//it by 1 and then by 63 - offset is defined for every offset, and yields 0 at 0
+		template<unsigned Bits>
+		constexpr std::uint32_t get_packed(const std::uint64_t* words, std::size_t i) noexcept
+		{
+			const auto pos = i * Bits, word = pos / 64, offset = pos % 64;
+			return static_cast<std::uint32_t>(((words[word] >> offset) |
+				((words[word + 1] << 1) << (63 - offset))) & packed_mask<Bits>);
+		}
+
+		template<unsigned Bits>
+		constexpr void set_packed(std::uint64_t* words, std::size_t i, std::uint32_t value) noexcept
+		{
+			const auto pos = i * Bits, word = pos / 64, offset = pos % 64;
+			const auto v = value & packed_mask<Bits>;
+			words[word] = (words[word] & ~(packed_mask<Bits> << offset)) | (v << offset);
+
+			//the part past the first word: the mask is zero if there is none
+			const auto highMask = (packed_mask<Bits> >> 1) >> (63 - offset);
+			words[word + 1] = (words[word + 1] & ~highMask) | ((v >> 1) >> (63 - offset));
+		}
+
+
+		//values [first, first + count) into out
+		template<unsigned Bits>
+		void unpack_scalar(const std::uint64_t* words, std::size_t first, std::size_t count, std::uint32_t* out) noexcept
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				out[i] = get_packed<Bits>(words, first + i);
+		}
+
+
+		//values from in into [first, first + count): whole words are assembled in a register
+		//and stored once, rather than read, masked, and written for every value
+		template<unsigned Bits>
+		void pack_scalar(std::uint64_t* words, std::size_t first, std::size_t count, const std::uint32_t* in) noexcept
+		{
+			//values up to the first word boundary
+			std::size_t i = 0;
+			for (; i < count && (first + i) * Bits % 64 != 0; ++i)
+				set_packed<Bits>(words, first + i, in[i]);
+
+			//whole words: the bits of a value that crosses a word start the next word
+			const auto wholeWords = (first + count) * Bits / 64;
+			auto word = (first + i) * Bits / 64;
+			std::uint64_t accumulator = 0;
+			unsigned filled = 0;
+			while (word < wholeWords) {
+				const std::uint64_t v = in[i++] & packed_mask<Bits>;
+				accumulator |= v << filled;
+				filled += Bits;
+				if (filled >= 64) {
+					words[word++] = accumulator;
+					filled -= 64;
+					accumulator = filled == 0 ? 0 : v >> (Bits - filled);
+				}
+			}
+
+			//the value that crosses into the last, partial word, and the values after it
+			if (filled != 0)
+				--i;
+			for (; i < count; ++i)
+				set_packed<Bits>(words, first + i, in[i]);
+		}
+
+
+#if defined(SIGCPP_SIMD_SSE2)
+
+		//byte shuffle and shifts that move each of 8 values into its own 32-bit lane: the
+		//low 128 bits hold values 0-3 from the group's first byte, the high 128 bits values
+		//4-7 from byte 4 * Bits / 8
+		template<unsigned Bits>
+		struct unpack_pattern
+		{
+			alignas(32) std::int8_t shuffle[32];
+			alignas(32) std::int32_t shifts[8];
+
+			constexpr unpack_pattern() : shuffle{}, shifts{}
+			{
+				for (unsigned half = 0; half < 2; ++half) {
+					const unsigned first = half * (4 * Bits % 8);
+					for (unsigned k = 0; k < 4; ++k) {
+						const auto bit = first + k * Bits;
+						for (unsigned b = 0; b < 4; ++b)
+							shuffle[half * 16 + k * 4 + b] = static_cast<std::int8_t>(bit / 8 + b);
+						shifts[half * 4 + k] = static_cast<std::int32_t>(bit % 8);
+					}
+				}
+			}
+		};
+
+
+		//groups of 8 values from bytes, which starts at a group boundary: every load must
+		//stay within the words, which the caller ensures
+		template<unsigned Bits>
+		SIGCPP_TARGET_AVX2
+		inline void unpack_groups_avx2(const unsigned char* bytes, std::size_t groups, std::uint32_t* out) noexcept
+		{
+			static_assert(Bits <= 25, "a value and its offset must fit a 32-bit lane");
+
+			static constexpr unpack_pattern<Bits> pattern{};
+			const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(pattern.shuffle));
+			const __m256i shifts = _mm256_load_si256(reinterpret_cast<const __m256i*>(pattern.shifts));
+			const __m256i mask = _mm256_set1_epi32(static_cast<int>(packed_mask<Bits>));
+
+			for (std::size_t g = 0; g < groups; ++g) {
+				const auto p = bytes + g * Bits;
+				const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4 * Bits / 8));
+				__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+				v = _mm256_shuffle_epi8(v, shuffle);
+				v = _mm256_and_si256(_mm256_srlv_epi32(v, shifts), mask);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8 * g), v);
+			}
+		}
+
+#endif //SIGCPP_SIMD_SSE2
+
+
+		//values [first, first + count) into out; wordCount words hold the values
+		template<unsigned Bits>
+		void unpack(const std::uint64_t* words, std::size_t wordCount, std::size_t first, std::size_t count,
+			std::uint32_t* out) noexcept
+		{
+#if defined(SIGCPP_SIMD_SSE2)
+			if constexpr (Bits <= 25) {
+				if (count >= 16 && simd::has_avx2()) {
+					//values up to a group boundary
+					const auto head = std::min(count, (8 - first % 8) % 8);
+					unpack_scalar<Bits>(words, first, head, out);
+					first += head;
+					out += head;
+					count -= head;
+
+					//groups whose loads end within the words
+					const auto byteCount = wordCount * 8, loadSpan = std::size_t{ 16 + 4 * Bits / 8 };
+					const auto endGroup = byteCount >= loadSpan ? (byteCount - loadSpan) / Bits + 1 : 0;
+					const auto firstGroup = first / 8;
+					const auto groups = std::min(count / 8, endGroup > firstGroup ? endGroup - firstGroup : 0);
+					const auto bytes = reinterpret_cast<const unsigned char*>(words);
+					unpack_groups_avx2<Bits>(bytes + firstGroup * Bits, groups, out);
+					first += groups * 8;
+					out += groups * 8;
+					count -= groups * 8;
+				}
+			}
+#endif
+			(void)wordCount;
+			unpack_scalar<Bits>(words, first, count, out);
+		}
+	}
+
+
+	//the value at one index of packed words: the reference type of packed_array
+	template<unsigned Bits>
+	class packed_reference
+	{
+	public:
+		using value_type = std::uint32_t;
+
+		constexpr packed_reference(std::uint64_t* words, std::size_t index) noexcept : words_{ words }, index_{ index } {}
+		packed_reference(const packed_reference&) = default;
+
+		constexpr operator value_type() const noexcept { return detail::get_packed<Bits>(words_, index_); }
+
+		//assignment stores the value: it does not rebind the reference
+		constexpr packed_reference& operator=(value_type value) noexcept
+		{
+			detail::set_packed<Bits>(words_, index_, value);
+			return *this;
+		}
+
+		constexpr packed_reference& operator=(const packed_reference& r) noexcept
+		{
+			return *this = static_cast<value_type>(r);
+		}
+
+		//swap the values of two elements: the proxies are prvalues, so take them by value
+		friend constexpr void swap(packed_reference x, packed_reference y) noexcept
+		{
+			const value_type v = x;
+			x = static_cast<value_type>(y);
+			y = v;
+		}
+
+	private:
+		std::uint64_t* words_;
+		std::size_t index_;
+
+	}; //template packed_reference
+
+
+	//random-access iterator over packed values; Const for a const_iterator
+	template<unsigned Bits, bool Const>
+	class packed_iterator
+	{
+		using words_pointer = std::conditional_t<Const, const std::uint64_t*, std::uint64_t*>;
+
+	public:
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::uint32_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, value_type, packed_reference<Bits>>;
+		using pointer = void;
+
+		//ctors
+		constexpr packed_iterator() noexcept : words_{ nullptr }, index_{ 0 } {}
+		constexpr packed_iterator(words_pointer words, difference_type index) noexcept : words_{ words }, index_{ index } {}
+
+		//iterator to const_iterator conversion
+		template<bool C, typename = std::enable_if_t<Const && !C>>
+		constexpr packed_iterator(const packed_iterator<Bits, C>& it) noexcept : words_{ it.words() }, index_{ it.index() } {}
+
+		constexpr words_pointer words() const noexcept { return words_; }
+		constexpr difference_type index() const noexcept { return index_; }
+
+		//dereference
+		constexpr reference operator*() const { return (*this)[0]; }
+
+		constexpr reference operator[](difference_type n) const
+		{
+			if constexpr (Const)
+				return detail::get_packed<Bits>(words_, static_cast<std::size_t>(index_ + n));
+			else
+				return reference(words_, static_cast<std::size_t>(index_ + n));
+		}
+
+		//increment and decrement
+		constexpr packed_iterator& operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		constexpr packed_iterator operator++(int)
+		{
+			packed_iterator beforeIncrement = *this;
+			++index_;
+			return beforeIncrement;
+		}
+
+		constexpr packed_iterator& operator--()
+		{
+			--index_;
+			return *this;
+		}
+
+		constexpr packed_iterator operator--(int)
+		{
+			packed_iterator beforeDecrement = *this;
+			--index_;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr packed_iterator& operator+=(difference_type n)
+		{
+			index_ += n;
+			return *this;
+		}
+
+		constexpr packed_iterator& operator-=(difference_type n)
+		{
+			index_ -= n;
+			return *this;
+		}
+
+		constexpr packed_iterator operator+(difference_type n) const { return packed_iterator(words_, index_ + n); }
+		constexpr packed_iterator operator-(difference_type n) const { return packed_iterator(words_, index_ - n); }
+
+		template<bool C>
+		constexpr difference_type operator-(const packed_iterator<Bits, C>& r) const { return index_ - r.index(); }
+
+		//comparison: iterators into the same array differ only in the index
+		template<bool C>
+		constexpr bool operator==(const packed_iterator<Bits, C>& r) const { return index_ == r.index(); }
+
+		template<bool C>
+		constexpr bool operator!=(const packed_iterator<Bits, C>& r) const { return index_ != r.index(); }
+
+		template<bool C>
+		constexpr bool operator<(const packed_iterator<Bits, C>& r) const { return index_ < r.index(); }
+
+		template<bool C>
+		constexpr bool operator>(const packed_iterator<Bits, C>& r) const { return index_ > r.index(); }
+
+		template<bool C>
+		constexpr bool operator<=(const packed_iterator<Bits, C>& r) const { return index_ <= r.index(); }
+
+		template<bool C>
+		constexpr bool operator>=(const packed_iterator<Bits, C>& r) const { return index_ >= r.index(); }
+
+	private:
+		words_pointer words_;
+		difference_type index_;
+
+	}; //template packed_iterator
+
+
+	//n + it
+	template<unsigned Bits, bool Const>
+	constexpr packed_iterator<Bits, Const> operator+(std::ptrdiff_t n, const packed_iterator<Bits, Const>& it)
+	{
+		return it + n;
+	}
+
+
+	template<unsigned Bits, std::size_t N>
+	class packed_array
+	{
+		static_assert(Bits >= 1 && Bits <= 32, "Bits must be from 1 to 32");
+
+	public:
+		//types
+		using value_type = std::uint32_t;
+		using word_type = std::uint64_t;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = packed_reference<Bits>;
+		using const_reference = value_type;
+
+		using iterator = packed_iterator<Bits, false>;
+		using const_iterator = packed_iterator<Bits, true>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr unsigned bits = Bits;
+		static constexpr value_type max_value = static_cast<value_type>(detail::packed_mask<Bits>);
+
+		//words of values, and one more that a value never ends in
+		static constexpr size_type word_count = (N * Bits + 63) / 64 + 1;
+
+		//ctors
+		constexpr packed_array() noexcept : words_{} {}
+
+		//values past the list are zero; extra values are ignored
+		constexpr packed_array(std::initializer_list<value_type> il) noexcept : words_{}
+		{
+			size_type i = 0;
+			for (auto it = il.begin(); it != il.end() && i < N; ++it, ++i)
+				detail::set_packed<Bits>(words_.values, i, *it);
+		}
+
+		//utility
+		constexpr void fill(value_type value) noexcept
+		{
+			for (size_type i = 0; i < N; ++i)
+				detail::set_packed<Bits>(words_.values, i, value);
+		}
+
+		void swap(packed_array& a) noexcept { words_.swap(a.words_); }
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(words_.values, 0); }
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr iterator end() noexcept { return iterator(words_.values, N); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		constexpr const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_iterator cbegin() const noexcept { return const_iterator(words_.values, 0); }
+		constexpr const_iterator cend() const noexcept { return const_iterator(words_.values, N); }
+		constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return N == 0; }
+		constexpr size_type size() const noexcept { return N; }
+		constexpr size_type max_size() const noexcept { return N; }
+
+		//unchecked element access
+		constexpr reference operator[](size_type pos) { return reference(words_.values, pos); }
+		constexpr const_reference operator[](size_type pos) const { return detail::get_packed<Bits>(words_.values, pos); }
+
+		//checked element access
+		constexpr reference at(size_type pos)
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		constexpr const_reference at(size_type pos) const
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		constexpr reference front() { return (*this)[0]; }
+		constexpr const_reference front() const { return (*this)[0]; }
+		constexpr reference back() { return (*this)[N - 1]; }
+		constexpr const_reference back() const { return (*this)[N - 1]; }
+
+		//underlying words: value i is bits [i * Bits, (i + 1) * Bits) of the words, from the
+		//low bit of word 0
+		constexpr const word_type* words() const noexcept { return words_.values; }
+
+		//bulk access: values [first, first + out.size()) into out
+		void unpack_into(span<value_type> out, size_type first = 0) const
+		{
+			_check_range(first, out.size());
+			detail::unpack<Bits>(words_.values, word_count, first, out.size(), out.data());
+		}
+
+		//values of in into [first, first + in.size())
+		void pack_from(span<const value_type> in, size_type first = 0)
+		{
+			_check_range(first, in.size());
+			detail::pack_scalar<Bits>(words_.values, first, in.size(), in.data());
+		}
+
+		//comparison: bits outside the values are always zero
+		friend constexpr bool operator==(const packed_array& x, const packed_array& y) { return x.words_ == y.words_; }
+		friend constexpr bool operator!=(const packed_array& x, const packed_array& y) { return !(x == y); }
+
+	private:
+		static constexpr void _check(size_type pos)
+		{
+			if (pos >= N)
+				throw std::out_of_range("packed_array index out of range");
+		}
+
+		//[first, first + count) must be in the array
+		static constexpr void _check_range(size_type first, size_type count)
+		{
+			if (first > N || count > N - first)
+				throw std::out_of_range("packed_array range out of range");
+		}
+
+		array<word_type, word_count> words_;
+
+	}; //template packed_array
+
+
+	//specialized algorithms
+	template<unsigned Bits, std::size_t N>
+	void swap(packed_array<Bits, N>& x, packed_array<Bits, N>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
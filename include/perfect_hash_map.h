@@ -0,0 +1,214 @@
+/*
+* perfect_hash_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a read-only map from string keys fixed at compile time, with a perfect hash
+* - build it from a sigcpp::array of (key, value) pairs, in a constexpr variable: the
+*   table is then computed by the compiler, and duplicate keys are a compile error
+* - keys are string views (std::string_view or sigcpp::string_view): anything with size()
+*   and operator[] over chars, and with operator==
+* - a lookup hashes the key once and compares it with one stored key: no probing
+* - the hash is "hash and displace" (CHD): the keys are split into buckets of about 4 by
+*   the hash, and each bucket gets the first seed that sends all its keys to free slots;
+*   buckets are placed largest first, while the table is still mostly empty
+* - empty slots hold a copy of some other key: a lookup for that key never reaches them,
+*   so a lookup needs no separate check for an empty slot
+* - see Belazzougui, Botelho, and Dietzfelbinger, "Hash, displace, and compress" (2009)
+*/
+
+#ifndef SIGCPP_PERFECT_HASH_MAP_H
+#define SIGCPP_PERFECT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+
+#include "array.h"
+#include "hash_ops.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//FNV-1a over the chars of a string view
+		template<typename S>
+		constexpr std::uint64_t fnv1a(const S& s) noexcept
+		{
+			using uchar = std::make_unsigned_t<std::remove_cv_t<std::remove_reference_t<decltype(s[0])>>>;
+			std::uint64_t h = 0xCBF29CE484222325ull;
+			for (std::size_t i = 0; i < s.size(); ++i) {
+				h ^= static_cast<uchar>(s[i]);
+				h *= 0x100000001B3ull;
+			}
+			return h;
+		}
+	}
+
+
+	template<typename Key, typename T, std::size_t N>
+	class perfect_hash_map
+	{
+	public:
+		//types
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<Key, T>;
+		using size_type = std::size_t;
+
+		//slots: a power of 2 with a load factor of at most 0.8; and one seed per bucket
+		static constexpr size_type slot_count = detail::ceil_power_of_2(N + N / 4 + 1);
+		static constexpr size_type bucket_count = (N + 3) / 4 + 1;
+
+		//seeds tried for one bucket before giving up: a few dozen are needed even for the
+		//last buckets, when the table is almost full
+		static constexpr std::uint32_t max_seed = 1u << 16;
+
+		//ctors
+		//keys and values are assigned slot by slot: both must be default constructible
+		constexpr explicit perfect_hash_map(const array<value_type, N>& entries) : keys_{}, values_{}, seeds_{}
+		{
+			_build(entries);
+		}
+
+		//capacity
+		constexpr size_type size() const noexcept { return N; }
+		constexpr bool empty() const noexcept { return N == 0; }
+
+		//lookup
+		//the value of key; nullptr if there is no such key
+		constexpr const T* find(const Key& key) const
+		{
+			if constexpr (N == 0)
+				return nullptr;
+			else {
+				const auto slot = _slot(detail::fnv1a(key));
+				return keys_[slot] == key ? &values_[slot] : nullptr;
+			}
+		}
+
+		constexpr bool contains(const Key& key) const { return find(key) != nullptr; }
+
+		constexpr const T& at(const Key& key) const
+		{
+			const auto value = find(key);
+			if (value == nullptr)
+				throw std::out_of_range("key not found");
+			return *value;
+		}
+
+	private:
+		//map the high half of the mixed hash onto [0, bucket_count) without a division
+		static constexpr size_type _bucket(std::uint64_t hash) noexcept
+		{
+			return static_cast<size_type>(((detail::mix64(hash) >> 32) * bucket_count) >> 32);
+		}
+
+		static constexpr size_type _slot(std::uint64_t hash, std::uint32_t seed) noexcept
+		{
+			return static_cast<size_type>(detail::mix64(hash + seed * 0x9E3779B97F4A7C15ull) & (slot_count - 1));
+		}
+
+		constexpr size_type _slot(std::uint64_t hash) const noexcept
+		{
+			return _slot(hash, seeds_[_bucket(hash)]);
+		}
+
+		constexpr void _build(const array<value_type, N>& entries)
+		{
+			if constexpr (N != 0) {
+				array<std::uint64_t, N> hashes{};
+				for (size_type i = 0; i < N; ++i)
+					hashes[i] = detail::fnv1a(entries[i].first);
+
+				//keys with the same hash share every slot: unplaceable if they are equal
+				for (size_type i = 0; i < N; ++i)
+					for (size_type j = i + 1; j < N; ++j)
+						if (hashes[i] == hashes[j] && entries[i].first == entries[j].first)
+							throw std::invalid_argument("duplicate key");
+
+				//group the keys by bucket: bucket b holds members[first[b]] to members[first[b + 1]]
+				array<size_type, bucket_count + 1> first{};
+				for (size_type i = 0; i < N; ++i)
+					++first[_bucket(hashes[i]) + 1];
+				for (size_type b = 0; b < bucket_count; ++b)
+					first[b + 1] += first[b];
+
+				array<size_type, N> members{};
+				array<size_type, bucket_count> filled{};
+				for (size_type i = 0; i < N; ++i) {
+					const auto b = _bucket(hashes[i]);
+					members[first[b] + filled[b]++] = i;
+				}
+
+				//largest buckets first: insertion sort, as std::sort is not constexpr in C++17
+				array<size_type, bucket_count> order{};
+				for (size_type b = 0; b < bucket_count; ++b) {
+					auto j = b;
+					for (; j > 0 && filled[order[j - 1]] < filled[b]; --j)
+						order[j] = order[j - 1];
+					order[j] = b;
+				}
+
+				array<bool, slot_count> used{};
+				for (size_type k = 0; k < bucket_count && filled[order[k]] != 0; ++k)
+					_place(order[k], entries, hashes, members, first, used);
+
+				for (size_type s = 0; s < slot_count; ++s)
+					if (!used[s])
+						keys_[s] = entries[0].first;
+			}
+		}
+
+		//find the first seed that sends every key of bucket b to a distinct free slot
+		constexpr void _place(size_type b, const array<value_type, N>& entries, const array<std::uint64_t, N>& hashes,
+			const array<size_type, N>& members, const array<size_type, bucket_count + 1>& first,
+			array<bool, slot_count>& used)
+		{
+			for (std::uint32_t seed = 0; seed < max_seed; ++seed) {
+				bool fits = true;
+				for (auto m = first[b]; fits && m < first[b + 1]; ++m) {
+					const auto slot = _slot(hashes[members[m]], seed);
+					fits = !used[slot];
+					for (auto other = first[b]; fits && other < m; ++other)
+						fits = _slot(hashes[members[other]], seed) != slot;
+				}
+				if (!fits)
+					continue;
+
+				seeds_[b] = seed;
+				for (auto m = first[b]; m < first[b + 1]; ++m) {
+					const auto slot = _slot(hashes[members[m]], seed);
+					used[slot] = true;
+					keys_[slot] = entries[members[m]].first;
+					values_[slot] = entries[members[m]].second;
+				}
+				return;
+			}
+			throw std::logic_error("no perfect hash found");
+		}
+
+		array<Key, slot_count> keys_;
+		array<T, slot_count> values_;
+		array<std::uint32_t, bucket_count> seeds_;
+
+	}; //template perfect_hash_map
+
+
+	//deduce the key, value, and size from the entries
+	template<typename Key, typename T, std::size_t N>
+	constexpr perfect_hash_map<Key, T, N> make_perfect_hash_map(const array<std::pair<Key, T>, N>& entries)
+	{
+		return perfect_hash_map<Key, T, N>(entries);
+	}
+
+}	//namespace sigcpp
+
+#endif
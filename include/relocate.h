@@ -0,0 +1,91 @@
+/*
+* relocate.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define relocation: moving objects to new storage and ending the originals
+* - a type is trivially relocatable if a byte copy to the new address followed by
+*   forgetting the original is equivalent to move construction plus destruction
+* - every trivially copyable type is; specialize is_trivially_relocatable to opt in other
+*   types (for example, types that own a heap buffer but hold no pointer into themselves)
+*/
+
+#ifndef SIGCPP_RELOCATE_H
+#define SIGCPP_RELOCATE_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace sigcpp
+{
+	template<typename T>
+	struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+	template<typename T>
+	constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+
+	namespace detail
+	{
+		template<typename T>
+		constexpr bool is_nothrow_relocatable_v = is_trivially_relocatable_v<T> ||
+			std::is_nothrow_move_constructible_v<T>;
+
+
+		//an allocator with its own construct for T: elements must be built through
+		//allocator_traits, never copied in bulk (relocation of built elements may still be)
+		template<typename A, typename T, typename = void>
+		struct has_allocator_construct : std::false_type {};
+
+		template<typename A, typename T>
+		struct has_allocator_construct<A, T, std::void_t<decltype(std::declval<A&>().construct(std::declval<T*>(),
+			std::declval<const T&>()))>> : std::true_type {};
+
+		template<typename A, typename T>
+		constexpr bool has_allocator_construct_v = has_allocator_construct<A, T>::value;
+
+
+		//relocate n objects at first to uninitialized, non-overlapping storage at dest
+		//if a copy throws (types whose move may throw are copied), the originals are intact
+		template<typename T>
+		void relocate(T* first, std::size_t n, T* dest) noexcept(is_nothrow_relocatable_v<T>)
+		{
+			if constexpr (is_trivially_relocatable_v<T>) {
+				if (n != 0)
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+			}
+			else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+				for (std::size_t i = 0; i < n; ++i) {
+					::new (static_cast<void*>(dest + i)) T(std::move(first[i]));
+					first[i].~T();
+				}
+			}
+			else {
+				std::size_t i = 0;
+				try {
+					for (; i < n; ++i)
+						::new (static_cast<void*>(dest + i)) T(std::move_if_noexcept(first[i]));
+				}
+				catch (...) {
+					while (i-- != 0)
+						dest[i].~T();
+					throw;
+				}
+
+				for (i = 0; i < n; ++i)
+					first[i].~T();
+			}
+		}
+	}
+
+}	//namespace sigcpp
+
+#endif
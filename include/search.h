@@ -0,0 +1,294 @@
+/*
+* search.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define searchers and the search algorithm
+* - see C++17 [func.search], [alg.search]
+* - https://timsong-cpp.github.io/cppwp/n4659/func.search
+* - https://timsong-cpp.github.io/cppwp/n4659/alg.search
+*
+* Searchers precompute everything they need from the pattern at construction and never
+* allocate, so one searcher may be applied to any number of haystacks
+* - boyer_moore_horspool_searcher: sublinear on average; requires byte-sized elements
+* - two_way_searcher: linear worst case (Crochemore-Perrin Two-Way)
+*/
+
+#ifndef SIGCPP_SEARCH_H
+#define SIGCPP_SEARCH_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	//searcher that does what the pattern-based search does: see [func.search.default]
+	template<typename ForwardIt1, typename BinaryPredicate = std::equal_to<>>
+	class default_searcher
+	{
+	public:
+		constexpr default_searcher(ForwardIt1 pat_first, ForwardIt1 pat_last,
+			BinaryPredicate pred = BinaryPredicate())
+			: pat_first_{ pat_first }, pat_last_{ pat_last }, pred_{ pred } {}
+
+		template<typename ForwardIt2>
+		constexpr std::pair<ForwardIt2, ForwardIt2> operator()(ForwardIt2 first, ForwardIt2 last) const
+		{
+			for (;; ++first) {
+				ForwardIt2 it = first;
+				for (ForwardIt1 p = pat_first_; ; ++it, ++p) {
+					if (p == pat_last_)
+						return { first, it };
+					if (it == last)
+						return { last, last };
+					if (!pred_(*it, *p))
+						break;
+				}
+			}
+		}
+
+	private:
+		ForwardIt1 pat_first_;
+		ForwardIt1 pat_last_;
+		BinaryPredicate pred_;
+	};
+
+
+	//Boyer-Moore-Horspool: see [func.search.bmh]
+	//the skip table has one entry per byte value and lives inside the searcher
+	template<typename RandomIt1>
+	class boyer_moore_horspool_searcher
+	{
+	public:
+		using value_type = typename std::iterator_traits<RandomIt1>::value_type;
+		using difference_type = typename std::iterator_traits<RandomIt1>::difference_type;
+
+		static_assert(sizeof(value_type) == 1, "requires byte-sized value type");
+
+		constexpr boyer_moore_horspool_searcher(RandomIt1 pat_first, RandomIt1 pat_last)
+			: pat_first_{ pat_first }, size_{ pat_last - pat_first }, skip_{}
+		{
+			for (auto& s : skip_)
+				s = size_;
+
+			//distance from the last occurrence of each char (except the last char) to the end
+			for (difference_type i = 0; i < size_ - 1; ++i)
+				skip_[_index(pat_first_[i])] = size_ - 1 - i;
+		}
+
+		template<typename RandomIt2>
+		constexpr std::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first, RandomIt2 last) const
+		{
+			if (size_ == 0)
+				return { first, first };
+
+			const auto last_char = pat_first_[size_ - 1];
+			for (auto n = last - first; n >= size_; ) {
+				const auto c = first[size_ - 1];
+				if (c == last_char && _equal(first, size_ - 1))
+					return { first, first + size_ };
+
+				const auto skip = skip_[_index(c)];
+				first += skip;
+				n -= skip;
+			}
+			return { last, last };
+		}
+
+	private:
+		RandomIt1 pat_first_;
+		difference_type size_;
+		array<difference_type, 256> skip_;
+
+		template<typename T>
+		static constexpr std::size_t _index(T c) { return static_cast<unsigned char>(c); }
+
+		template<typename RandomIt2>
+		constexpr bool _equal(RandomIt2 first, difference_type n) const
+		{
+			for (difference_type i = 0; i < n; ++i)
+				if (!(first[i] == pat_first_[i]))
+					return false;
+			return true;
+		}
+	};
+
+
+	//Two-Way string matching (Crochemore and Perrin, 1991)
+	//the pattern is split at a critical factorization u.v; v is matched left to right, then u
+	//right to left; on mismatch the shift follows from the period of the pattern
+	//for byte-sized elements, a bad-character shift on the last char of each window skips
+	//most windows without comparing: sublinear on average, still linear in the worst case
+	//requires value_type to be equality comparable and totally ordered by <
+	template<typename RandomIt1>
+	class two_way_searcher
+	{
+	public:
+		using value_type = typename std::iterator_traits<RandomIt1>::value_type;
+		using difference_type = typename std::iterator_traits<RandomIt1>::difference_type;
+
+		constexpr two_way_searcher(RandomIt1 pat_first, RandomIt1 pat_last)
+			: pat_first_{ pat_first }, size_{ pat_last - pat_first }, shift_{}
+		{
+			if (size_ == 0)
+				return;
+
+			const auto [ms_less, p_less] = _maximal_suffix(false);
+			const auto [ms_greater, p_greater] = _maximal_suffix(true);
+			if (ms_less > ms_greater) {
+				suffix_ = ms_less + 1;
+				period_ = p_less;
+			}
+			else {
+				suffix_ = ms_greater + 1;
+				period_ = p_greater;
+			}
+
+			//pattern is periodic if the prefix before suffix_ repeats at period_
+			periodic_ = period_ + suffix_ <= size_ && _equal(pat_first_, pat_first_ + period_, suffix_);
+			if (!periodic_)
+				period_ = std::max(suffix_, size_ - suffix_) + 1;
+
+			if constexpr (has_shift_table) {
+				for (auto& s : shift_)
+					s = size_;
+				for (difference_type i = 0; i < size_; ++i)
+					shift_[_index(pat_first_[i])] = size_ - 1 - i;
+			}
+		}
+
+		template<typename RandomIt2>
+		constexpr std::pair<RandomIt2, RandomIt2> operator()(RandomIt2 first, RandomIt2 last) const
+		{
+			if (size_ == 0)
+				return { first, first };
+
+			const auto n = last - first;
+			const auto& p = pat_first_;
+
+			//the last char of a window is known to match once its shift is zero
+			const difference_type right_end = has_shift_table ? size_ - 1 : size_;
+
+			//memory: length of the prefix known to match after a shift by the period
+			difference_type memory = 0;
+			for (difference_type j = 0; j <= n - size_; ) {
+				if constexpr (has_shift_table) {
+					auto shift = shift_[_index(first[j + size_ - 1])];
+					if (shift != 0) {
+						if (memory != 0 && shift < period_)
+							shift = size_ - period_;
+						memory = 0;
+						j += shift;
+						continue;
+					}
+				}
+
+				auto i = std::max(suffix_, memory);
+				while (i < right_end && p[i] == first[i + j])
+					++i;
+
+				if (i < right_end) {
+					j += i - suffix_ + 1;
+					memory = 0;
+					continue;
+				}
+
+				i = suffix_ - 1;
+				while (i >= memory && p[i] == first[i + j])
+					--i;
+
+				if (i < memory)
+					return { first + j, first + j + size_ };
+
+				j += period_;
+				memory = periodic_ ? size_ - period_ : 0;
+			}
+			return { last, last };
+		}
+
+	private:
+		static constexpr bool has_shift_table = sizeof(value_type) == 1;
+
+		RandomIt1 pat_first_;
+		difference_type size_;
+		difference_type suffix_{ 0 };
+		difference_type period_{ 1 };
+		bool periodic_{ false };
+		array<difference_type, has_shift_table ? 256 : 0> shift_;
+
+		template<typename T>
+		static constexpr std::size_t _index(T c) { return static_cast<unsigned char>(c); }
+
+		//start (minus 1) and period of the maximal suffix under < or under reverse <
+		constexpr std::pair<difference_type, difference_type> _maximal_suffix(bool reversed) const
+		{
+			const auto& p = pat_first_;
+			difference_type ms = -1, j = 0, k = 1, period = 1;
+			while (j + k < size_) {
+				const auto& a = p[j + k];
+				const auto& b = p[ms + k];
+				if (reversed ? b < a : a < b) {
+					j += k;
+					k = 1;
+					period = j - ms;
+				}
+				else if (a == b) {
+					if (k != period)
+						++k;
+					else {
+						j += period;
+						k = 1;
+					}
+				}
+				else {
+					ms = j++;
+					k = period = 1;
+				}
+			}
+			return { ms, period };
+		}
+
+		static constexpr bool _equal(RandomIt1 a, RandomIt1 b, difference_type n)
+		{
+			for (difference_type i = 0; i < n; ++i)
+				if (!(a[i] == b[i]))
+					return false;
+			return true;
+		}
+	};
+
+
+	//search for a pattern: see [alg.search]
+	template<typename ForwardIt1, typename ForwardIt2>
+	constexpr ForwardIt1 search(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last)
+	{
+		return default_searcher<ForwardIt2>(s_first, s_last)(first, last).first;
+	}
+
+	template<typename ForwardIt1, typename ForwardIt2, typename BinaryPredicate>
+	constexpr ForwardIt1 search(ForwardIt1 first, ForwardIt1 last, ForwardIt2 s_first, ForwardIt2 s_last,
+		BinaryPredicate pred)
+	{
+		return default_searcher<ForwardIt2, BinaryPredicate>(s_first, s_last, pred)(first, last).first;
+	}
+
+	//search with a searcher
+	template<typename ForwardIt, typename Searcher>
+	constexpr ForwardIt search(ForwardIt first, ForwardIt last, const Searcher& searcher)
+	{
+		return searcher(first, last).first;
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,376 @@
+/*
+* search_index.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define static search indexes: read-only copies of a sorted range in a layout that is
+* faster to search than the range itself once it outgrows the cache
+* - lower_bound returns the position in the original range, so that one index can serve
+*   a sorted array (or a set of parallel arrays) without changing it
+* - the input must be sorted by the index's comparator; else construction throws
+*   std::invalid_argument
+* - elements are copied bytewise: they must be trivially copyable
+* - see Khuong and Morin, "Array layouts for comparison-based searching" (2017)
+*
+* eytzinger_index: elements in breadth-first (Eytzinger) order of a complete binary tree
+* - the children of node k are nodes 2k and 2k+1: the search is a branchless loop, and the
+*   16 descendants four levels down share one cache line, which is prefetched each step
+*
+* s_tree_index: a static B+ tree whose nodes are one cache line
+* - leaves hold the sorted elements; the node at each inner level is picked by counting the
+*   keys in one line that are less than the key, so each level costs one line read
+* - the count uses SSE2 for std::int32_t and float with std::less; else a loop over the node
+*/
+
+#ifndef SIGCPP_SEARCH_INDEX_H
+#define SIGCPP_SEARCH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+#include "aligned_array.h"
+#include "array.h"
+#include "array_iterator.h"
+#include "simd.h"
+#include "span.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//uninitialized storage for trivially copyable elements, aligned to a cache line
+		template<typename T>
+		class line_aligned_buffer
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "the buffer copies elements bytewise");
+
+		public:
+			line_aligned_buffer() noexcept = default;
+			explicit line_aligned_buffer(std::size_t size) : data_{ _allocate(size) }, size_{ size } {}
+
+			line_aligned_buffer(const line_aligned_buffer& b) : line_aligned_buffer(b.size_)
+			{
+				if (size_ != 0)
+					std::memcpy(static_cast<void*>(data_), static_cast<const void*>(b.data_), size_ * sizeof(T));
+			}
+
+			line_aligned_buffer(line_aligned_buffer&& b) noexcept
+				: data_{ std::exchange(b.data_, nullptr) }, size_{ std::exchange(b.size_, 0) } {}
+
+			line_aligned_buffer& operator=(line_aligned_buffer b) noexcept
+			{
+				swap(b);
+				return *this;
+			}
+
+			~line_aligned_buffer()
+			{
+				if (data_ != nullptr)
+					::operator delete(static_cast<void*>(data_), std::align_val_t{ cache_line_size });
+			}
+
+			T* data() noexcept { return data_; }
+			const T* data() const noexcept { return data_; }
+			std::size_t size() const noexcept { return size_; }
+
+			void swap(line_aligned_buffer& b) noexcept
+			{
+				std::swap(data_, b.data_);
+				std::swap(size_, b.size_);
+			}
+
+		private:
+			static T* _allocate(std::size_t size)
+			{
+				if (size == 0)
+					return nullptr;
+				return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t{ cache_line_size }));
+			}
+
+			T* data_{ nullptr };
+			std::size_t size_{ 0 };
+		};
+
+
+		//number of elements that are sorted before the input ends: throw if that is not all of them
+		template<typename ForwardIt, typename Compare>
+		std::size_t sorted_distance(ForwardIt first, ForwardIt last, const Compare& comp)
+		{
+			static_assert(is_forward_iterator_v<ForwardIt>, "a search index reads its input twice");
+			if (!std::is_sorted(first, last, comp))
+				throw std::invalid_argument("search index input is not sorted");
+			return static_cast<std::size_t>(std::distance(first, last));
+		}
+	}
+
+
+	template<typename T, typename Compare = std::less<T>>
+	class eytzinger_index
+	{
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+		using key_compare = Compare;
+
+		//ctors
+		eytzinger_index() : eytzinger_index(Compare()) {}
+		explicit eytzinger_index(const Compare& comp) : data_(), size_{ 0 }, comp_(comp) {}
+
+		template<typename ForwardIt, typename = detail::enable_if_input_iterator_t<ForwardIt>>
+		eytzinger_index(ForwardIt first, ForwardIt last, const Compare& comp = Compare())
+			: data_(), size_{ detail::sorted_distance(first, last, comp) }, comp_(comp)
+		{
+			//node 0 is unused: numbering from 1 makes the children of k exactly 2k and 2k+1
+			data_ = detail::line_aligned_buffer<T>(size_ + 1);
+			_fill(first, 1);
+		}
+
+		//one ctor for arrays of every size, vectors, and C arrays
+		explicit eytzinger_index(span<const T> s, const Compare& comp = Compare())
+			: eytzinger_index(s.data(), s.data() + s.size(), comp) {}
+
+		//capacity
+		size_type size() const noexcept { return size_; }
+		bool empty() const noexcept { return size_ == 0; }
+
+		//observers
+		key_compare key_comp() const { return comp_; }
+
+		//lookup
+		//position of the first element not less than key in the original range; size() if none
+		size_type lower_bound(const T& key) const
+		{
+			const auto k = _search(key);
+			return k == 0 ? size_ : _rank(k);
+		}
+
+		bool contains(const T& key) const
+		{
+			const auto k = _search(key);
+			return k != 0 && !comp_(key, data_.data()[k]);
+		}
+
+	private:
+		//nodes a search step prefetches ahead: the descendants of k that many levels down are
+		//numbered from k * stride, and they fill one aligned line when T divides the line
+		static constexpr size_type _prefetch_stride()
+		{
+			size_type stride = 2;
+			while (stride * 2 * sizeof(T) <= cache_line_size)
+				stride *= 2;
+			return stride;
+		}
+
+		//copy the sorted input in order of an in-order walk of the tree
+		template<typename ForwardIt>
+		void _fill(ForwardIt& it, size_type k)
+		{
+			if (k > size_)
+				return;
+
+			_fill(it, 2 * k);
+			::new (static_cast<void*>(data_.data() + k)) T(*it);
+			++it;
+			_fill(it, 2 * k + 1);
+		}
+
+		//node of the lower bound; 0 if every element is less than key
+		//each step appends the comparison result to k: going right sets a bit, going left
+		//clears one, so the last left turn (the answer) is found by dropping the trailing 1s
+		//and the 0 before them
+		size_type _search(const T& key) const
+		{
+			const T* nodes = data_.data();
+			const auto base = reinterpret_cast<std::uintptr_t>(nodes);
+
+			size_type k = 1;
+			while (k <= size_) {
+				//an address past the end is fine: prefetch does not fault
+				simd::prefetch(reinterpret_cast<const void*>(base + k * _prefetch_stride() * sizeof(T)));
+				k = 2 * k + static_cast<size_type>(comp_(nodes[k], key));
+			}
+			return static_cast<size_type>(k >> (simd::lowest_bit64(~static_cast<std::uint64_t>(k)) + 1));
+		}
+
+		//position in sorted order of node k
+		//a perfect tree puts node p of level d at (2p + 1) * 2^(levels below d) - 1; from that
+		//subtract the slots of the partial last level that precede the node but are empty
+		size_type _rank(size_type k) const noexcept
+		{
+			const auto height = simd::highest_bit64(size_), depth = simd::highest_bit64(k);
+			const auto p = k - (size_type{ 1 } << depth);
+			if (depth == height)
+				return 2 * p;
+
+			const auto below = height - depth;
+			const auto preceding = (2 * p + 1) << (below - 1);
+			const auto present = size_ - ((size_type{ 1 } << height) - 1);
+			return ((2 * p + 1) << below) - 1 - (preceding > present ? preceding - present : 0);
+		}
+
+		detail::line_aligned_buffer<T> data_;
+		size_type size_;
+		Compare comp_;
+
+	}; //template eytzinger_index
+
+
+	template<typename T, typename Compare = std::less<T>>
+	class s_tree_index
+	{
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+		using key_compare = Compare;
+
+		//keys per node: as many as fit one line, but at least 2
+		static constexpr size_type node_size = sizeof(T) * 2 <= cache_line_size ? cache_line_size / sizeof(T) : 2;
+
+		//ctors
+		s_tree_index() : s_tree_index(Compare()) {}
+		explicit s_tree_index(const Compare& comp) : data_(), size_{ 0 }, layers_{ 0 }, comp_(comp) {}
+
+		template<typename ForwardIt, typename = detail::enable_if_input_iterator_t<ForwardIt>>
+		s_tree_index(ForwardIt first, ForwardIt last, const Compare& comp = Compare())
+			: data_(), size_{ detail::sorted_distance(first, last, comp) }, layers_{ 0 }, comp_(comp)
+		{
+			_build(first);
+		}
+
+		//one ctor for arrays of every size, vectors, and C arrays
+		explicit s_tree_index(span<const T> s, const Compare& comp = Compare())
+			: s_tree_index(s.data(), s.data() + s.size(), comp) {}
+
+		//capacity
+		size_type size() const noexcept { return size_; }
+		bool empty() const noexcept { return size_ == 0; }
+
+		//observers
+		key_compare key_comp() const { return comp_; }
+
+		//lookup
+		//position of the first element not less than key in the original range; size() if none
+		size_type lower_bound(const T& key) const
+		{
+			//past the last element: the inner levels only route keys that are in range
+			if (size_ == 0 || comp_(_leaves()[size_ - 1], key))
+				return size_;
+
+			size_type node = 0;
+			for (auto layer = layers_ - 1; layer > 0; --layer)
+				node = node * (node_size + 1) + _count(data_.data() + offsets_[layer] + node * node_size, key);
+			return node * node_size + _count(_leaves() + node * node_size, key);
+		}
+
+		bool contains(const T& key) const
+		{
+			const auto i = lower_bound(key);
+			return i != size_ && !comp_(key, _leaves()[i]);
+		}
+
+	private:
+		//levels of a tree over 2^64 keys with the smallest fan-out of 3
+		static constexpr size_type max_layers = 48;
+
+		//SSE2 compares four 32-bit keys at once: a node is four loads
+		static constexpr bool _count_sse2 = (std::is_same_v<T, std::int32_t> || std::is_same_v<T, float>) &&
+			(std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>) && node_size == 16;
+
+		const T* _leaves() const noexcept { return data_.data() + offsets_[0]; }
+
+		//layer 0 is the leaves: the sorted input, padded to whole nodes with copies of the
+		//last element; the node at index i of an inner layer routes to children i * (B + 1)
+		//through i * (B + 1) + B of the layer below, and its key j is the smallest element
+		//under child j + 1
+		//layers are stored from the root down, so the top of the tree shares a few lines
+		template<typename ForwardIt>
+		void _build(ForwardIt first)
+		{
+			if (size_ == 0)
+				return;
+
+			size_type counts[max_layers]{ (size_ + node_size - 1) / node_size };
+			layers_ = 1;
+			while (counts[layers_ - 1] > 1) {
+				counts[layers_] = (counts[layers_ - 1] + node_size) / (node_size + 1);
+				++layers_;
+			}
+
+			size_type nodes = 0;
+			for (auto layer = layers_; layer > 0; --layer) {
+				offsets_[layer - 1] = nodes * node_size;
+				nodes += counts[layer - 1];
+			}
+			data_ = detail::line_aligned_buffer<T>(nodes * node_size);
+
+			auto leaves = data_.data() + offsets_[0];
+			for (size_type i = 0; i < size_; ++i, ++first)
+				::new (static_cast<void*>(leaves + i)) T(*first);
+			for (auto i = size_; i < counts[0] * node_size; ++i)
+				::new (static_cast<void*>(leaves + i)) T(leaves[size_ - 1]);
+
+			size_type span = 1;
+			for (size_type layer = 1; layer < layers_; ++layer, span *= node_size + 1) {
+				auto keys = data_.data() + offsets_[layer];
+				for (size_type node = 0; node < counts[layer]; ++node) {
+					for (size_type j = 0; j < node_size; ++j) {
+						const auto child = node * (node_size + 1) + j + 1;
+						const auto& key = child < counts[layer - 1] ? leaves[child * span * node_size] : leaves[size_ - 1];
+						::new (static_cast<void*>(keys + node * node_size + j)) T(key);
+					}
+				}
+			}
+		}
+
+		//number of keys in a node that are less than key
+		size_type _count(const T* node, const T& key) const
+		{
+#if defined(SIGCPP_SIMD_SSE2)
+			if constexpr (_count_sse2) {
+				//each compare sets lanes to -1 where the node key is less: subtract to count
+				__m128i count = _mm_setzero_si128();
+				for (size_type j = 0; j < node_size; j += 4) {
+					if constexpr (std::is_same_v<T, float>)
+						count = _mm_sub_epi32(count, _mm_castps_si128(_mm_cmplt_ps(_mm_load_ps(node + j),
+							_mm_set1_ps(key))));
+					else
+						count = _mm_sub_epi32(count, _mm_cmpgt_epi32(_mm_set1_epi32(key),
+							_mm_load_si128(reinterpret_cast<const __m128i*>(node + j))));
+				}
+				count = _mm_add_epi32(count, _mm_shuffle_epi32(count, 0x4E));
+				count = _mm_add_epi32(count, _mm_shuffle_epi32(count, 0xB1));
+				return static_cast<size_type>(_mm_cvtsi128_si32(count));
+			}
+#endif
+			size_type count = 0;
+			for (size_type j = 0; j < node_size; ++j)
+				count += static_cast<size_type>(comp_(node[j], key));
+			return count;
+		}
+
+		detail::line_aligned_buffer<T> data_;
+		size_type size_;
+		size_type layers_;
+		size_type offsets_[max_layers]{};
+		Compare comp_;
+
+	}; //template s_tree_index
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,198 @@
+/*
+* simd.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Detect SIMD support and define small portable helpers for SIMD kernels
+* - SSE2 is detected at compile time (it is baseline on x64)
+* - AVX2 and POPCNT are detected at run time so that one binary runs on any x64 machine
+* - define SIGCPP_NO_SIMD to force scalar code everywhere
+*/
+
+#ifndef SIGCPP_SIMD_H
+#define SIGCPP_SIMD_H
+
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(SIGCPP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SIGCPP_SIMD_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+//MSVC allows any intrinsic in any function; gcc and clang need per-function opt-in
+#if defined(SIGCPP_SIMD_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#define SIGCPP_TARGET_AVX2
+#elif defined(SIGCPP_SIMD_SSE2)
+#define SIGCPP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(SIGCPP_SIMD_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#define SIGCPP_TARGET_POPCNT
+#elif defined(SIGCPP_SIMD_SSE2)
+#define SIGCPP_TARGET_POPCNT __attribute__((target("popcnt")))
+#endif
+
+//true only while a constexpr function is evaluated at compile time
+//SIMD kernels are not constexpr, so callers use this macro to pick the scalar path
+#if defined(__cpp_lib_is_constant_evaluated)
+#define SIGCPP_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define SIGCPP_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+namespace sigcpp::simd
+{
+	//index of the lowest set bit: mask must not be zero
+	inline unsigned lowest_bit(std::uint32_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+
+	//index of the highest set bit: mask must not be zero
+	inline unsigned highest_bit(std::uint32_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanReverse(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+	}
+
+
+	//64-bit variants: mask must not be zero
+	inline unsigned lowest_bit64(std::uint64_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+		const auto low = static_cast<std::uint32_t>(mask);
+		return low != 0 ? lowest_bit(low) : 32u + lowest_bit(static_cast<std::uint32_t>(mask >> 32));
+#else
+		return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+	}
+
+	inline unsigned highest_bit64(std::uint64_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanReverse64(&index, mask);
+		return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+		const auto high = static_cast<std::uint32_t>(mask >> 32);
+		return high != 0 ? 32u + highest_bit(high) : highest_bit(static_cast<std::uint32_t>(mask));
+#else
+		return 63u - static_cast<unsigned>(__builtin_clzll(mask));
+#endif
+	}
+
+
+	//number of set bits: the POPCNT instruction only if the build targets it (bulk counts
+	//pick it at run time: see bit_ops.h); else in-register adds of ever wider bit fields
+	inline unsigned popcount64(std::uint64_t x) noexcept
+	{
+#if defined(__POPCNT__) && !defined(SIGCPP_NO_SIMD)
+		return static_cast<unsigned>(__builtin_popcountll(x));
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(__AVX__) && defined(_M_X64) && !defined(SIGCPP_NO_SIMD)
+		return static_cast<unsigned>(__popcnt64(x));
+#else
+		x = x - ((x >> 1) & 0x5555555555555555ull);
+		x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+		x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+	}
+
+
+	//hint that the line holding address is read soon: never faults, even on a bad address
+	inline void prefetch(const void* address) noexcept
+	{
+#if defined(SIGCPP_SIMD_SSE2)
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(address);
+#else
+		(void)address;
+#endif
+	}
+
+
+	//query the CPU once: AVX2 requires both CPU support and OS support for YMM state
+	inline bool detect_avx2() noexcept
+	{
+#if !defined(SIGCPP_SIMD_SSE2)
+		return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		int regs[4];
+		__cpuid(regs, 0);
+		if (regs[0] < 7)
+			return false;
+
+		__cpuid(regs, 1);
+		const bool osxsave = (regs[2] & (1 << 27)) != 0, avx = (regs[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+
+	inline bool has_avx2() noexcept
+	{
+		static const bool value{ detect_avx2() };
+		return value;
+	}
+
+
+	//POPCNT is reported in CPUID leaf 1: it predates AVX2 by years
+	inline bool detect_popcnt() noexcept
+	{
+#if !defined(SIGCPP_SIMD_SSE2)
+		return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		int regs[4];
+		__cpuid(regs, 1);
+		return (regs[2] & (1 << 23)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("popcnt");
+#endif
+	}
+
+
+	inline bool has_popcnt() noexcept
+	{
+		static const bool value{ detect_popcnt() };
+		return value;
+	}
+
+} //namespace sigcpp::simd
+
+#endif
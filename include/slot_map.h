@@ -0,0 +1,270 @@
+/*
+* slot_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for a container that hands out stable handles to its values
+* - insert returns a handle: a slot index and the generation of the slot; the handle finds
+*   its value in O(1) until the value is erased, after which it finds nothing, even if the
+*   slot is reused (the erase advanced the generation of the slot)
+* - values are dense: they are contiguous in one sigcpp::vector, so iteration is a walk of
+*   array_iterator, as over a vector; erase moves the last value into the gap
+* - a slot holds the index of its value, and the dense array holds the slot of each value,
+*   so erase can update the slot of the value it moves; free slots form a list
+* - insert and erase invalidate iterators, references, and pointers to values (as in a
+*   vector), never handles
+* - the three arrays draw from Allocator, rebound (see memory_resource.h for arenas and pools)
+* - a generation is 32 bits: a handle to a slot reused 2^32 times could find a new value
+* - see the slot map of Allan Deutsch and the proposal P0661 (slot_map) for SG14
+*/
+
+#ifndef SIGCPP_SLOT_MAP_H
+#define SIGCPP_SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <memory>
+#include <utility>
+
+#include "vector.h"
+
+namespace sigcpp
+{
+	//handle to a value in a slot_map
+	struct slot_handle
+	{
+		std::uint32_t index;
+		std::uint32_t generation;
+
+		friend constexpr bool operator==(const slot_handle& x, const slot_handle& y) noexcept
+		{
+			return x.index == y.index && x.generation == y.generation;
+		}
+
+		friend constexpr bool operator!=(const slot_handle& x, const slot_handle& y) noexcept { return !(x == y); }
+	};
+
+
+	template<typename T, typename Allocator = std::allocator<T>>
+	class slot_map
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+		using index_allocator = typename alloc_traits::template rebind_alloc<std::uint32_t>;
+
+	public:
+		//types
+		using value_type = T;
+		using allocator_type = Allocator;
+		using handle_type = slot_handle;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+
+		using iterator = typename vector<T, Allocator>::iterator;
+		using const_iterator = typename vector<T, Allocator>::const_iterator;
+
+		//ctors
+		slot_map() : slot_map(Allocator()) {}
+
+		explicit slot_map(const Allocator& alloc)
+			: values_(alloc), slots_of_(index_allocator(alloc)), slots_(slot_allocator(alloc)), free_{ no_slot } {}
+
+		allocator_type get_allocator() const noexcept { return values_.get_allocator(); }
+
+		//iterators: over the dense values, in no particular order
+		iterator begin() noexcept { return values_.begin(); }
+		const_iterator begin() const noexcept { return values_.begin(); }
+		iterator end() noexcept { return values_.end(); }
+		const_iterator end() const noexcept { return values_.end(); }
+		const_iterator cbegin() const noexcept { return values_.cbegin(); }
+		const_iterator cend() const noexcept { return values_.cend(); }
+
+		//capacity
+		bool empty() const noexcept { return values_.empty(); }
+		size_type size() const noexcept { return values_.size(); }
+		size_type capacity() const noexcept { return values_.capacity(); }
+
+		void reserve(size_type count)
+		{
+			values_.reserve(count);
+			slots_of_.reserve(count);
+			slots_.reserve(count);
+		}
+
+		//modifiers
+		template<typename... Args>
+		handle_type emplace(Args&&... args)
+		{
+			//room in the index arrays first: only the value's emplace may throw after this;
+			//values_ grows itself, so args may alias a value of this map
+			const auto count = values_.size() < 8 ? 8 : values_.size() + values_.size() / 2;
+			if (slots_of_.size() == slots_of_.capacity())
+				slots_of_.reserve(count);
+			if (free_ == no_slot && slots_.size() == slots_.capacity())
+				slots_.reserve(count);
+
+			values_.emplace_back(std::forward<Args>(args)...);
+
+			if (free_ == no_slot) {
+				slots_.push_back(slot{ no_slot, 0 });
+				free_ = static_cast<std::uint32_t>(slots_.size() - 1);
+			}
+
+			const auto index = free_;
+			auto& s = slots_[index];
+			free_ = s.index;
+			s.index = static_cast<std::uint32_t>(values_.size() - 1);
+			slots_of_.push_back(index);
+			return handle_type{ index, s.generation };
+		}
+
+		handle_type insert(const T& value) { return emplace(value); }
+		handle_type insert(T&& value) { return emplace(std::move(value)); }
+
+		//false if the handle finds no value
+		bool erase(handle_type h)
+		{
+			if (!contains(h))
+				return false;
+			_erase_at(slots_[h.index].index);
+			return true;
+		}
+
+		//the value at pos; the iterator to the value moved into its place
+		iterator erase(const_iterator pos)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			_erase_at(index);
+			return begin() + static_cast<difference_type>(index);
+		}
+
+		//erase every value: every handle stops finding its value
+		void clear() noexcept
+		{
+			for (auto index : slots_of_)
+				_free(index);
+			values_.clear();
+			slots_of_.clear();
+		}
+
+		void swap(slot_map& m) noexcept
+		{
+			values_.swap(m.values_);
+			slots_of_.swap(m.slots_of_);
+			slots_.swap(m.slots_);
+			std::swap(free_, m.free_);
+		}
+
+		//lookup
+		bool contains(handle_type h) const noexcept
+		{
+			return h.index < slots_.size() && slots_[h.index].generation == h.generation;
+		}
+
+		iterator find(handle_type h) noexcept
+		{
+			return contains(h) ? begin() + slots_[h.index].index : end();
+		}
+
+		const_iterator find(handle_type h) const noexcept
+		{
+			return contains(h) ? begin() + slots_[h.index].index : end();
+		}
+
+		//unchecked: the handle must find a value
+		reference operator[](handle_type h) { return values_[slots_[h.index].index]; }
+		const_reference operator[](handle_type h) const { return values_[slots_[h.index].index]; }
+
+		//checked
+		reference at(handle_type h)
+		{
+			_check(h);
+			return (*this)[h];
+		}
+
+		const_reference at(handle_type h) const
+		{
+			_check(h);
+			return (*this)[h];
+		}
+
+		//the handle of the value at pos
+		handle_type handle_of(const_iterator pos) const noexcept
+		{
+			const auto index = slots_of_[static_cast<size_type>(pos - cbegin())];
+			return handle_type{ index, slots_[index].generation };
+		}
+
+		//the dense values
+		T* data() noexcept { return values_.data(); }
+		const T* data() const noexcept { return values_.data(); }
+
+	private:
+		//a live slot: the index of its value; a free slot: the next free slot
+		struct slot
+		{
+			std::uint32_t index;
+			std::uint32_t generation;
+		};
+
+		using slot_allocator = typename alloc_traits::template rebind_alloc<slot>;
+
+		static constexpr std::uint32_t no_slot = static_cast<std::uint32_t>(-1);
+
+		//move the last value into the gap, then drop the last place
+		void _erase_at(size_type index)
+		{
+			const auto last = values_.size() - 1;
+			const auto erased = slots_of_[index];
+			if (index != last) {
+				values_[index] = std::move(values_[last]);
+				slots_of_[index] = slots_of_[last];
+				slots_[slots_of_[index]].index = static_cast<std::uint32_t>(index);
+			}
+			values_.pop_back();
+			slots_of_.pop_back();
+			_free(erased);
+		}
+
+		//a new generation, so that no handle to the slot finds a value
+		void _free(std::uint32_t index) noexcept
+		{
+			auto& s = slots_[index];
+			++s.generation;
+			s.index = free_;
+			free_ = index;
+		}
+
+		void _check(handle_type h) const
+		{
+			if (!contains(h))
+				throw std::out_of_range("slot_map handle finds no value");
+		}
+
+		vector<T, Allocator> values_;
+		vector<std::uint32_t, index_allocator> slots_of_;
+		vector<slot, slot_allocator> slots_;
+		std::uint32_t free_;
+
+	}; //template slot_map
+
+
+	//specialized algorithms
+	template<typename T, typename Allocator>
+	void swap(slot_map<T, Allocator>& x, slot_map<T, Allocator>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
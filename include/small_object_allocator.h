@@ -0,0 +1,446 @@
+/*
+* small_object_allocator.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a thread-caching allocator for small objects
+* - a request of at most 256 bytes is rounded up to a size class, a multiple of 16 bytes;
+*   a larger request, or one for a type more aligned than 16 bytes, goes to operator new
+* - each thread caches free blocks in a list per size class: allocation and deallocation
+*   pop and push that list, with no atomic operation and no lock
+* - blocks move between threads in batches through a central list per size class, an
+*   mpmc_queue of batches (see mpmc_queue.h): a thread whose list grows past twice a
+*   batch gives a batch back, and a thread whose list is empty takes a batch, or carves a
+*   new span of 64 KiB from operator new if the central list is empty too
+* - a block freed by a thread other than the one that allocated it joins the cache of the
+*   thread that frees it; the central list evens out the caches
+* - a thread returns its cache to the central lists when it exits, or on
+*   small_object_flush(); a central list holds 256 batches, and blocks past that stay
+*   with the thread
+* - spans are never returned to the system: the allocator keeps the peak of small-object
+*   memory in use for the life of the program, as a malloc arena does
+* - statistics: small_object_thread_statistics() for the calling thread, exact; and
+*   small_object_statistics() for all threads, as of each thread's last batch transfer
+* - small_object_allocator<T> is stateless: every instance frees memory from any other, so
+*   it serves any sigcpp container with an Allocator parameter, and the std containers
+* - see the thread caches of TCMalloc (Ghemawat and Menage) and the small-object allocator
+*   of Alexandrescu, "Modern C++ Design" (2001), ch. 4
+*/
+
+#ifndef SIGCPP_SMALL_OBJECT_ALLOCATOR_H
+#define SIGCPP_SMALL_OBJECT_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+#include "array.h"
+#include "aligned_array.h"
+#include "mpmc_queue.h"
+
+namespace sigcpp
+{
+	//allocation counts: for one thread, or for all threads
+	struct small_object_stats
+	{
+		std::size_t allocations = 0;		//small blocks handed out
+		std::size_t deallocations = 0;		//small blocks taken back
+		std::size_t large_allocations = 0;	//requests passed to operator new
+		std::size_t batch_fetches = 0;		//batches taken from the central lists
+		std::size_t batch_returns = 0;		//batches given to the central lists
+		std::size_t spans = 0;				//spans carved from operator new
+	};
+
+
+	namespace detail
+	{
+		inline constexpr std::size_t small_granule = 16;
+		inline constexpr std::size_t small_max_size = 256;
+		inline constexpr std::size_t small_class_count = small_max_size / small_granule;
+		inline constexpr std::size_t small_span_size = 64 * 1024;
+		inline constexpr std::size_t small_central_batches = 256;
+
+		//class 0 serves 1 to 16 bytes, class 15 serves 241 to 256 (and 0 bytes is class 0)
+		constexpr std::size_t small_class_of(std::size_t bytes) noexcept
+		{
+			return bytes == 0 ? 0 : (bytes - 1) / small_granule;
+		}
+
+		constexpr std::size_t small_class_size(std::size_t c) noexcept { return (c + 1) * small_granule; }
+
+		//blocks per batch: about 8 KiB, from 32 of the largest class to 128 of the smallest
+		constexpr std::size_t small_batch_size(std::size_t c) noexcept
+		{
+			const auto count = 8192 / small_class_size(c);
+			return count > 128 ? 128 : count;
+		}
+
+		//a free block: its first bytes link it to the next free block of its class
+		struct small_free_node
+		{
+			small_free_node* next;
+		};
+
+		//a list of free blocks that moves between a thread and a central list
+		struct small_batch
+		{
+			small_free_node* head = nullptr;
+			std::size_t count = 0;
+		};
+
+
+		//the central lists and the spans: one for the program
+		class small_object_heap
+		{
+		public:
+			using size_type = std::size_t;
+
+			static small_object_heap& instance()
+			{
+				static small_object_heap heap;
+				return heap;
+			}
+
+			bool try_push(size_type c, const small_batch& batch) { return central_[c].try_push(batch); }
+			bool try_pop(size_type c, small_batch& batch) { return central_[c].try_pop(batch); }
+
+			//a new span, cut into blocks of class c: the blocks in address order
+			small_batch carve(size_type c)
+			{
+				const auto s = static_cast<span*>(::operator new(small_span_size, std::align_val_t{ small_granule }));
+
+				//push only: no span is ever taken off, so there is no ABA
+				s->next = spans_.load(std::memory_order_relaxed);
+				while (!spans_.compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed)) {}
+
+				const auto size = small_class_size(c);
+				const auto blocks = reinterpret_cast<std::byte*>(s + 1);
+				small_batch batch;
+				batch.count = (small_span_size - sizeof(span)) / size;
+				for (auto i = batch.count; i-- != 0; ) {
+					const auto node = ::new (blocks + i * size) small_free_node;
+					node->next = batch.head;
+					batch.head = node;
+				}
+				return batch;
+			}
+
+			//add the counts of a thread since its last report
+			void report(const small_object_stats& delta) noexcept
+			{
+				allocations_.fetch_add(delta.allocations, std::memory_order_relaxed);
+				deallocations_.fetch_add(delta.deallocations, std::memory_order_relaxed);
+				largeAllocations_.fetch_add(delta.large_allocations, std::memory_order_relaxed);
+				batchFetches_.fetch_add(delta.batch_fetches, std::memory_order_relaxed);
+				batchReturns_.fetch_add(delta.batch_returns, std::memory_order_relaxed);
+				spanCount_.fetch_add(delta.spans, std::memory_order_relaxed);
+			}
+
+			small_object_stats statistics() const noexcept
+			{
+				small_object_stats s;
+				s.allocations = allocations_.load(std::memory_order_relaxed);
+				s.deallocations = deallocations_.load(std::memory_order_relaxed);
+				s.large_allocations = largeAllocations_.load(std::memory_order_relaxed);
+				s.batch_fetches = batchFetches_.load(std::memory_order_relaxed);
+				s.batch_returns = batchReturns_.load(std::memory_order_relaxed);
+				s.spans = spanCount_.load(std::memory_order_relaxed);
+				return s;
+			}
+
+		private:
+			//header of a span, padded so that the blocks are aligned to 16 bytes; the list
+			//keeps every span reachable
+			struct alignas(small_granule) span
+			{
+				span* next;
+			};
+
+			small_object_heap() = default;
+
+			array<mpmc_queue<small_batch, small_central_batches>, small_class_count> central_;
+			std::atomic<span*> spans_{ nullptr };
+
+			//written at batch transfers only: on a line apart from the queues
+			alignas(cache_line_size) std::atomic<size_type> allocations_{ 0 };
+			std::atomic<size_type> deallocations_{ 0 };
+			std::atomic<size_type> largeAllocations_{ 0 };
+			std::atomic<size_type> batchFetches_{ 0 };
+			std::atomic<size_type> batchReturns_{ 0 };
+			std::atomic<size_type> spanCount_{ 0 };
+
+		}; //class small_object_heap
+
+
+		//the free blocks of one thread
+		class small_object_cache
+		{
+		public:
+			using size_type = std::size_t;
+
+			//the cache of the calling thread; nullptr once the thread has destroyed its cache
+			//(a thread_local object destroyed later may still free memory)
+			static small_object_cache* local()
+			{
+				if (_gone())
+					return nullptr;
+				thread_local small_object_cache cache;
+				return &cache;
+			}
+
+			small_object_cache(const small_object_cache&) = delete;
+			small_object_cache& operator=(const small_object_cache&) = delete;
+
+			~small_object_cache()
+			{
+				flush();
+				_gone() = true;
+			}
+
+			void* allocate(size_type c)
+			{
+				auto& list = lists_[c];
+				if (list.head == nullptr)
+					_refill(c);
+
+				const auto node = list.head;
+				list.head = node->next;
+				--list.count;
+				++stats_.allocations;
+				return node;
+			}
+
+			void deallocate(void* p, size_type c) noexcept
+			{
+				auto& list = lists_[c];
+				const auto node = static_cast<small_free_node*>(p);
+				node->next = list.head;
+				list.head = node;
+				++list.count;
+				++stats_.deallocations;
+				if (list.count > list.limit)
+					_release(c);
+			}
+
+			void count_large() noexcept { ++stats_.large_allocations; }
+
+			//every cached block to the central lists, as far as they have room
+			void flush() noexcept
+			{
+				for (size_type c = 0; c < small_class_count; ++c) {
+					while (lists_[c].count != 0 && _give(c, lists_[c].count)) {}
+				}
+				_report();
+			}
+
+			const small_object_stats& statistics() const noexcept { return stats_; }
+
+		private:
+			struct free_list
+			{
+				small_free_node* head = nullptr;
+				size_type count = 0;
+				size_type limit = 0;
+			};
+
+			small_object_cache() : heap_{ small_object_heap::instance() }
+			{
+				for (size_type c = 0; c < small_class_count; ++c)
+					lists_[c].limit = 2 * small_batch_size(c);
+			}
+
+			//trivially destructible, so it is still valid after the cache is destroyed
+			static bool& _gone() noexcept
+			{
+				thread_local bool gone = false;
+				return gone;
+			}
+
+			//a batch from the central list, else a new span: the thread keeps one batch of
+			//the span and shares the rest
+			void _refill(size_type c)
+			{
+				auto& list = lists_[c];
+				small_batch batch;
+				if (heap_.try_pop(c, batch))
+					++stats_.batch_fetches;
+				else {
+					batch = heap_.carve(c);
+					++stats_.spans;
+				}
+				list.head = batch.head;
+				list.count = batch.count;
+
+				while (list.count > small_batch_size(c) && _give(c, small_batch_size(c))) {}
+				_report();
+			}
+
+			//a batch to the central list; if that is full, keep the blocks and try again only
+			//after another batch of frees
+			void _release(size_type c) noexcept
+			{
+				if (!_give(c, small_batch_size(c)))
+					lists_[c].limit += small_batch_size(c);
+				_report();
+			}
+
+			//the first count blocks of the list (count > 0) as one batch; false if the
+			//central list is full, and the list is unchanged
+			bool _give(size_type c, size_type count) noexcept
+			{
+				auto& list = lists_[c];
+				if (count > small_batch_size(c))
+					count = small_batch_size(c);
+
+				auto last = list.head;
+				for (size_type i = 1; i < count; ++i)
+					last = last->next;
+
+				const small_batch batch{ list.head, count };
+				const auto rest = last->next;
+				last->next = nullptr;
+				if (!heap_.try_push(c, batch)) {
+					last->next = rest;
+					return false;
+				}
+
+				list.head = rest;
+				list.count -= count;
+				++stats_.batch_returns;
+				return true;
+			}
+
+			//publish the counts since the last report to the program-wide counts
+			void _report() noexcept
+			{
+				small_object_stats delta;
+				delta.allocations = stats_.allocations - reported_.allocations;
+				delta.deallocations = stats_.deallocations - reported_.deallocations;
+				delta.large_allocations = stats_.large_allocations - reported_.large_allocations;
+				delta.batch_fetches = stats_.batch_fetches - reported_.batch_fetches;
+				delta.batch_returns = stats_.batch_returns - reported_.batch_returns;
+				delta.spans = stats_.spans - reported_.spans;
+				heap_.report(delta);
+				reported_ = stats_;
+			}
+
+			small_object_heap& heap_;
+			array<free_list, small_class_count> lists_;
+			small_object_stats stats_;
+			small_object_stats reported_;
+
+		}; //class small_object_cache
+	}
+
+
+	//a block of at least bytes bytes, aligned to 16 bytes
+	inline void* small_object_allocate(std::size_t bytes)
+	{
+		using namespace detail;
+
+		const auto cache = small_object_cache::local();
+		if (bytes > small_max_size) {
+			if (cache != nullptr)
+				cache->count_large();
+			return ::operator new(bytes);
+		}
+
+		if (cache != nullptr)
+			return cache->allocate(small_class_of(bytes));
+
+		//the thread is exiting: a block of the whole class, so that it can join a free list
+		return ::operator new(small_class_size(small_class_of(bytes)), std::align_val_t{ small_granule });
+	}
+
+	//bytes: as given to small_object_allocate for p
+	inline void small_object_deallocate(void* p, std::size_t bytes) noexcept
+	{
+		using namespace detail;
+
+		if (bytes > small_max_size)
+			return ::operator delete(p);
+
+		//once the thread has destroyed its cache, the block is dropped: it stays in its span
+		if (const auto cache = small_object_cache::local(); cache != nullptr)
+			cache->deallocate(p, small_class_of(bytes));
+	}
+
+	//give the blocks cached by the calling thread to the central lists: for a thread that
+	//is done allocating but does not exit, such as one in a pool
+	inline void small_object_flush() noexcept
+	{
+		if (const auto cache = detail::small_object_cache::local(); cache != nullptr)
+			cache->flush();
+	}
+
+	inline small_object_stats small_object_statistics() noexcept
+	{
+		return detail::small_object_heap::instance().statistics();
+	}
+
+	inline small_object_stats small_object_thread_statistics() noexcept
+	{
+		const auto cache = detail::small_object_cache::local();
+		return cache != nullptr ? cache->statistics() : small_object_stats{};
+	}
+
+
+	template<typename T>
+	class small_object_allocator
+	{
+	public:
+		//types
+		using value_type = T;
+		using is_always_equal = std::true_type;
+
+		//ctors
+		small_object_allocator() noexcept = default;
+
+		template<typename U>
+		small_object_allocator(const small_object_allocator<U>&) noexcept {}
+
+		T* allocate(std::size_t n)
+		{
+			if (n > static_cast<std::size_t>(-1) / sizeof(T))
+				throw std::bad_array_new_length();
+
+			if constexpr (alignof(T) > detail::small_granule)
+				return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignof(T) }));
+			else
+				return static_cast<T*>(small_object_allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept
+		{
+			if constexpr (alignof(T) > detail::small_granule)
+				::operator delete(p, std::align_val_t{ alignof(T) });
+			else
+				small_object_deallocate(p, n * sizeof(T));
+		}
+
+	}; //template small_object_allocator
+
+
+	//every instance frees memory from every other
+	template<typename T, typename U>
+	constexpr bool operator==(const small_object_allocator<T>&, const small_object_allocator<U>&) noexcept
+	{
+		return true;
+	}
+
+	template<typename T, typename U>
+	constexpr bool operator!=(const small_object_allocator<T>&, const small_object_allocator<U>&) noexcept
+	{
+		return false;
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,642 @@
+/*
+* small_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for vectors that keep up to N elements inside the object
+* - interface of vector: see C++17 [vector] https://timsong-cpp.github.io/cppwp/n4659/vector
+* - no allocation until the size exceeds N; after that, elements live on the heap
+* - the heap buffer is stolen on move; inline elements are relocated one by one
+* - elements are relocated with memcpy when trivially relocatable (see relocate.h)
+* - the allocator provides the heap buffer and constructs and destroys every element, inline
+*   ones too (see allocator_traits)
+*/
+
+#ifndef SIGCPP_SMALL_VECTOR_H
+#define SIGCPP_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+
+#include "array.h"
+#include "array_iterator.h"
+#include "relocate.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+	class small_vector
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+
+	public:
+		//types
+		using value_type = T;
+		using allocator_type = Allocator;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		//the iterators of array<T, N>
+		using iterator = array_iterator<pointer>;
+		using const_iterator = array_iterator<const_pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "allocator must allocate T");
+
+		//ctors
+		small_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) : impl_{ Allocator(), _buffer() } {}
+		explicit small_vector(const Allocator& alloc) noexcept : impl_{ alloc, _buffer() } {}
+
+		explicit small_vector(size_type count, const Allocator& alloc = Allocator()) : impl_{ alloc, _buffer() }
+		{
+			resize(count);
+		}
+
+		small_vector(size_type count, const T& value, const Allocator& alloc = Allocator()) : impl_{ alloc, _buffer() }
+		{
+			assign(count, value);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		small_vector(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : impl_{ alloc, _buffer() }
+		{
+			assign(first, last);
+		}
+
+		small_vector(std::initializer_list<T> il, const Allocator& alloc = Allocator()) : impl_{ alloc, _buffer() }
+		{
+			assign(il.begin(), il.end());
+		}
+
+		small_vector(const small_vector& v)
+			: impl_{ alloc_traits::select_on_container_copy_construction(v.get_allocator()), _buffer() }
+		{
+			_append_copy(v);
+		}
+
+		small_vector(small_vector&& v) noexcept(detail::is_nothrow_relocatable_v<T>)
+			: impl_{ std::move(v.impl_.alloc()), _buffer() }
+		{
+			_take(v);
+		}
+
+		//allocator-extended copy and move: see uses-allocator construction
+		small_vector(const small_vector& v, const Allocator& alloc) : impl_{ alloc, _buffer() }
+		{
+			_append_copy(v);
+		}
+
+		//steal v's heap buffer only if the allocators are equal; else move element by element
+		small_vector(small_vector&& v, const Allocator& alloc) : impl_{ alloc, _buffer() }
+		{
+			if (alloc_traits::is_always_equal::value || impl_.alloc() == v.impl_.alloc())
+				_take(v);
+			else {
+				reserve(v.size());
+				for (auto& e : v) {
+					_construct(impl_.data + impl_.size, std::move(e));
+					++impl_.size;
+				}
+				v.clear();
+			}
+		}
+
+		~small_vector() { _release(); }
+
+		//assignment
+		//adopt v's allocator if it propagates: free the heap buffer first if the allocators differ
+		small_vector& operator=(const small_vector& v)
+		{
+			if (this != &v) {
+				if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+					if (!alloc_traits::is_always_equal::value && !(impl_.alloc() == v.impl_.alloc()))
+						_release();
+					impl_.alloc() = v.impl_.alloc();
+				}
+				clear();
+				_append_copy(v);
+			}
+			return *this;
+		}
+
+		//steal the heap buffer if the allocators allow it; else move element by element
+		small_vector& operator=(small_vector&& v) noexcept(detail::is_nothrow_relocatable_v<T> &&
+			(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value))
+		{
+			if (this == &v)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+				_release();
+				impl_.alloc() = std::move(v.impl_.alloc());
+				_take(v);
+			}
+			else if (alloc_traits::is_always_equal::value || impl_.alloc() == v.impl_.alloc()) {
+				_release();
+				_take(v);
+			}
+			else {
+				clear();
+				reserve(v.size());
+				for (auto& e : v) {
+					_construct(impl_.data + impl_.size, std::move(e));
+					++impl_.size;
+				}
+				v.clear();
+			}
+			return *this;
+		}
+
+		small_vector& operator=(std::initializer_list<T> il)
+		{
+			assign(il.begin(), il.end());
+			return *this;
+		}
+
+		void assign(size_type count, const T& value)
+		{
+			clear();
+			reserve(count);
+			for (; impl_.size < count; ++impl_.size)
+				_construct(impl_.data + impl_.size, value);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void assign(InputIt first, InputIt last)
+		{
+			clear();
+			if constexpr (detail::is_forward_iterator_v<InputIt>)
+				reserve(static_cast<size_type>(std::distance(first, last)));
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+		allocator_type get_allocator() const noexcept { return impl_.alloc(); }
+
+		//iterators
+		iterator begin() noexcept { return iterator(impl_.data); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(impl_.data + impl_.size); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(impl_.data); }
+		const_iterator cend() const noexcept { return const_iterator(impl_.data + impl_.size); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		bool empty() const noexcept { return impl_.size == 0; }
+		size_type size() const noexcept { return impl_.size; }
+		size_type capacity() const noexcept { return impl_.capacity; }
+		size_type max_size() const noexcept { return alloc_traits::max_size(impl_.alloc()); }
+		static constexpr size_type inline_capacity() noexcept { return N; }
+
+		//true while the elements are inside the object
+		bool is_inline() const noexcept { return impl_.data == _buffer(); }
+
+		void reserve(size_type count)
+		{
+			if (count > impl_.capacity)
+				_reallocate(count);
+		}
+
+		//move back inside the object if the elements fit; else shrink the heap buffer
+		void shrink_to_fit()
+		{
+			if (is_inline() || impl_.size == impl_.capacity)
+				return;
+
+			if (impl_.size <= N) {
+				const auto old = impl_.data;
+				const auto old_capacity = impl_.capacity;
+				detail::relocate(old, impl_.size, _buffer());
+				impl_.data = _buffer();
+				impl_.capacity = N;
+				alloc_traits::deallocate(impl_.alloc(), old, old_capacity);
+			}
+			else
+				_reallocate(impl_.size);
+		}
+
+		void resize(size_type count) { _resize(count); }
+		void resize(size_type count, const T& value)
+		{
+			//value may alias an element that reallocation moves out of
+			if (count > impl_.capacity) {
+				const T copy(value);
+				_resize(count, copy);
+			}
+			else
+				_resize(count, value);
+		}
+
+		//unchecked element access
+		reference operator[](size_type pos) { return impl_.data[pos]; }
+		const_reference operator[](size_type pos) const { return impl_.data[pos]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			return const_cast<reference>(_at(pos));
+		}
+
+		const_reference at(size_type pos) const { return _at(pos); }
+
+		reference front() { return impl_.data[0]; }
+		const_reference front() const { return impl_.data[0]; }
+		reference back() { return impl_.data[impl_.size - 1]; }
+		const_reference back() const { return impl_.data[impl_.size - 1]; }
+
+		//underlying raw data
+		pointer data() noexcept { return impl_.data; }
+		const_pointer data() const noexcept { return impl_.data; }
+
+		//modifiers
+		template<typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			if (impl_.size == impl_.capacity)
+				return _emplace_back_grow(std::forward<Args>(args)...);
+
+			const auto p = impl_.data + impl_.size;
+			_construct(p, std::forward<Args>(args)...);
+			++impl_.size;
+			return *p;
+		}
+
+		void push_back(const T& value) { emplace_back(value); }
+		void push_back(T&& value) { emplace_back(std::move(value)); }
+
+		void pop_back()
+		{
+			--impl_.size;
+			_destroy(impl_.data + impl_.size, impl_.data + impl_.size + 1);
+		}
+
+		//construct the new element first: args may refer to an element of this vector
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			if (index == impl_.size) {
+				emplace_back(std::forward<Args>(args)...);
+				return begin() + index;
+			}
+
+			T value(std::forward<Args>(args)...);
+			reserve(_next_capacity(impl_.size + 1));
+
+			const auto p = impl_.data;
+			if constexpr (is_trivially_relocatable_v<T>) {
+				std::memmove(static_cast<void*>(p + index + 1), static_cast<const void*>(p + index),
+					(impl_.size - index) * sizeof(T));
+				_construct(p + index, std::move(value));
+			}
+			else {
+				_construct(p + impl_.size, std::move(p[impl_.size - 1]));
+				std::move_backward(p + index, p + impl_.size - 1, p + impl_.size);
+				p[index] = std::move(value);
+			}
+			++impl_.size;
+			return begin() + index;
+		}
+
+		iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+		iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+		iterator insert(const_iterator pos, size_type count, const T& value)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const T copy(value);
+			reserve(_next_capacity(impl_.size + count));
+			for (size_type i = 0; i < count; ++i, ++impl_.size)
+				_construct(impl_.data + impl_.size, copy);
+			return _rotate_back(index, count);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		iterator insert(const_iterator pos, InputIt first, InputIt last)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const auto old_size = impl_.size;
+			if constexpr (detail::is_forward_iterator_v<InputIt>)
+				reserve(_next_capacity(impl_.size + static_cast<size_type>(std::distance(first, last))));
+
+			for (; first != last; ++first)
+				emplace_back(*first);
+			return _rotate_back(index, impl_.size - old_size);
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<T> il)
+		{
+			return insert(pos, il.begin(), il.end());
+		}
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const auto index = static_cast<size_type>(first - cbegin());
+			const auto count = static_cast<size_type>(last - first);
+			if (count == 0)
+				return begin() + index;
+
+			const auto p = impl_.data;
+			const auto tail = impl_.size - index - count;
+			if constexpr (is_trivially_relocatable_v<T>) {
+				_destroy(p + index, p + index + count);
+				if (tail != 0)
+					std::memmove(static_cast<void*>(p + index), static_cast<const void*>(p + index + count),
+						tail * sizeof(T));
+			}
+			else {
+				std::move(p + index + count, p + impl_.size, p + index);
+				_destroy(p + impl_.size - count, p + impl_.size);
+			}
+			impl_.size -= count;
+			return begin() + index;
+		}
+
+		void clear() noexcept
+		{
+			_destroy(impl_.data, impl_.data + impl_.size);
+			impl_.size = 0;
+		}
+
+		//swap heap buffers when both are on the heap; else go through a temporary
+		void swap(small_vector& v) noexcept(detail::is_nothrow_relocatable_v<T>)
+		{
+			if (!is_inline() && !v.is_inline()) {
+				std::swap(impl_.data, v.impl_.data);
+				std::swap(impl_.size, v.impl_.size);
+				std::swap(impl_.capacity, v.impl_.capacity);
+				if constexpr (alloc_traits::propagate_on_container_swap::value)
+					std::swap(impl_.alloc(), v.impl_.alloc());
+				return;
+			}
+
+			//the heap buffer changes hands: so must the allocator that frees it
+			small_vector temp(std::move(v));
+			v._take(*this);
+			_take(temp);
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+				std::swap(impl_.alloc(), v.impl_.alloc());
+		}
+
+	private:
+		//data pointer, size, and capacity; derives from the allocator so that an empty one
+		//takes no space
+		struct impl : Allocator
+		{
+			pointer data;
+			size_type size{ 0 };
+			size_type capacity{ N };
+
+			impl(const Allocator& a, pointer buffer) noexcept : Allocator(a), data{ buffer } {}
+			impl(Allocator&& a, pointer buffer) noexcept : Allocator(std::move(a)), data{ buffer } {}
+
+			Allocator& alloc() noexcept { return *this; }
+			const Allocator& alloc() const noexcept { return *this; }
+		};
+
+		impl impl_;
+		alignas(T) unsigned char buffer_[sizeof(T) * (N == 0 ? 1 : N)];
+
+		pointer _buffer() noexcept { return reinterpret_cast<pointer>(buffer_); }
+		const_pointer _buffer() const noexcept { return reinterpret_cast<const_pointer>(buffer_); }
+
+		//elements are built and ended through the allocator: see uses-allocator construction
+		template<typename... Args>
+		void _construct(pointer p, Args&&... args)
+		{
+			alloc_traits::construct(impl_.alloc(), p, std::forward<Args>(args)...);
+		}
+
+		void _destroy(pointer first, pointer last) noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				for (; first != last; ++first)
+					alloc_traits::destroy(impl_.alloc(), first);
+		}
+
+		//capacity to hold count elements: geometric growth so that appends are amortized O(1)
+		size_type _next_capacity(size_type count) const
+		{
+			if (count <= impl_.capacity)
+				return impl_.capacity;
+			if (count > max_size())
+				throw std::length_error("small_vector too long");
+			return std::max(count, impl_.capacity > max_size() / 2 ? max_size() : 2 * impl_.capacity);
+		}
+
+		void _reallocate(size_type capacity)
+		{
+			if (capacity > max_size())
+				throw std::length_error("small_vector too long");
+
+			const auto p = alloc_traits::allocate(impl_.alloc(), capacity);
+			try {
+				detail::relocate(impl_.data, impl_.size, p);
+			}
+			catch (...) {
+				alloc_traits::deallocate(impl_.alloc(), p, capacity);
+				throw;
+			}
+			_free_heap();
+			impl_.data = p;
+			impl_.capacity = capacity;
+		}
+
+		//the new element is built in the new buffer before the old elements move
+		template<typename... Args>
+		reference _emplace_back_grow(Args&&... args)
+		{
+			const auto capacity = _next_capacity(impl_.size + 1);
+			const auto p = alloc_traits::allocate(impl_.alloc(), capacity);
+			try {
+				_construct(p + impl_.size, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				alloc_traits::deallocate(impl_.alloc(), p, capacity);
+				throw;
+			}
+
+			try {
+				detail::relocate(impl_.data, impl_.size, p);
+			}
+			catch (...) {
+				_destroy(p + impl_.size, p + impl_.size + 1);
+				alloc_traits::deallocate(impl_.alloc(), p, capacity);
+				throw;
+			}
+
+			_free_heap();
+			impl_.data = p;
+			impl_.capacity = capacity;
+			return p[impl_.size++];
+		}
+
+		void _free_heap() noexcept
+		{
+			if (!is_inline())
+				alloc_traits::deallocate(impl_.alloc(), impl_.data, impl_.capacity);
+		}
+
+		//destroy the elements and free the heap buffer: leaves the vector empty and inline
+		void _release() noexcept
+		{
+			clear();
+			_free_heap();
+			impl_.data = _buffer();
+			impl_.capacity = N;
+		}
+
+		//steal v's heap buffer, or relocate v's inline elements
+		//this vector must be empty and inline on entry; v is left empty and inline
+		void _take(small_vector& v) noexcept(detail::is_nothrow_relocatable_v<T>)
+		{
+			if (v.is_inline()) {
+				detail::relocate(v.impl_.data, v.impl_.size, impl_.data);
+				impl_.size = v.impl_.size;
+			}
+			else {
+				impl_.data = v.impl_.data;
+				impl_.size = v.impl_.size;
+				impl_.capacity = v.impl_.capacity;
+				v.impl_.data = v._buffer();
+				v.impl_.capacity = N;
+			}
+			v.impl_.size = 0;
+		}
+
+		void _append_copy(const small_vector& v)
+		{
+			reserve(v.size());
+			if constexpr (std::is_trivially_copyable_v<T> && !detail::has_allocator_construct_v<Allocator, T>) {
+				if (v.size() != 0)
+					std::memcpy(static_cast<void*>(impl_.data), static_cast<const void*>(v.data()),
+						v.size() * sizeof(T));
+				impl_.size = v.size();
+			}
+			else {
+				for (const auto& e : v) {
+					_construct(impl_.data + impl_.size, e);
+					++impl_.size;
+				}
+			}
+		}
+
+		//move the last count elements to index
+		iterator _rotate_back(size_type index, size_type count)
+		{
+			std::rotate(impl_.data + index, impl_.data + impl_.size - count, impl_.data + impl_.size);
+			return begin() + index;
+		}
+
+		template<typename... Args>
+		void _resize(size_type count, const Args&... value)
+		{
+			if (count < impl_.size) {
+				_destroy(impl_.data + count, impl_.data + impl_.size);
+				impl_.size = count;
+			}
+			else {
+				reserve(_next_capacity(count));
+				for (; impl_.size < count; ++impl_.size)
+					_construct(impl_.data + impl_.size, value...);
+			}
+		}
+
+		const_reference _at(size_type pos) const
+		{
+			if (pos < impl_.size)
+				return impl_.data[pos];
+			else
+				throw std::out_of_range("small_vector index out of range");
+		}
+
+	}; //template small_vector
+
+
+	//specialized algorithms
+	template<typename T, std::size_t N, typename Allocator>
+	void swap(small_vector<T, N, Allocator>& x, small_vector<T, N, Allocator>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: see C++17 [container.requirements.general]
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator==(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return x.size() == y.size() && detail::equal_elements(x.data(), y.data(), x.size());
+	}
+
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator!=(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator<(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return detail::less_elements(x.data(), x.size(), y.data(), y.size());
+	}
+
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator>(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return y < x;
+	}
+
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator<=(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename T, std::size_t N, typename Allocator>
+	bool operator>=(const small_vector<T, N, Allocator>& x, const small_vector<T, N, Allocator>& y)
+	{
+		return !(x < y);
+	}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	template<typename T, std::size_t N, typename Allocator>
+	std::compare_three_way_result_t<T> operator<=>(const small_vector<T, N, Allocator>& x,
+		const small_vector<T, N, Allocator>& y)
+	{
+		return detail::three_way_elements(x.data(), x.size(), y.data(), y.size());
+	}
+#endif
+
+}	//namespace sigcpp
+
+#endif
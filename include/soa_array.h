@@ -0,0 +1,361 @@
+/*
+* soa_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a fixed-size table of rows stored as a struct of arrays: one sigcpp::array per field
+* - a loop over one field reads only that field's array: no cache line carries fields the
+*   loop does not use, and the compiler can vectorize the loop
+* - rows are accessed through proxies: soa_reference<Fields...> is a tuple of references to
+*   the fields of one row; assigning to it writes through, and swap swaps the fields
+* - the value type of a row is std::tuple<Fields...>
+* - iterators are random-access, so standard algorithms such as std::sort work on rows
+* - see soa_vector.h for the growable version
+*/
+
+#ifndef SIGCPP_SOA_ARRAY_H
+#define SIGCPP_SOA_ARRAY_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	//the fields of one row: a tuple of references whose assignment writes through
+	//Ts are const-qualified for a row of a const table
+	template<typename... Ts>
+	class soa_reference : public std::tuple<Ts&...>
+	{
+		using base = std::tuple<Ts&...>;
+
+	public:
+		using value_type = std::tuple<std::remove_const_t<Ts>...>;
+
+		//ctors
+		explicit soa_reference(Ts&... fields) noexcept : base(fields...) {}
+		soa_reference(const soa_reference&) = default;
+
+		//row to const row
+		template<typename... Us, typename = std::enable_if_t<sizeof...(Us) == sizeof...(Ts) &&
+			(std::is_convertible_v<Us&, Ts&> && ...)>>
+		soa_reference(const soa_reference<Us...>& r) noexcept : base(static_cast<const std::tuple<Us&...>&>(r)) {}
+
+		//assignment copies fields into the row: it does not rebind the references
+		soa_reference& operator=(const soa_reference& r)
+		{
+			base::operator=(static_cast<const base&>(r));
+			return *this;
+		}
+
+		soa_reference& operator=(const value_type& v)
+		{
+			base::operator=(v);
+			return *this;
+		}
+
+		soa_reference& operator=(value_type&& v)
+		{
+			base::operator=(std::move(v));
+			return *this;
+		}
+
+		//copy of the fields
+		value_type value() const { return value_type(static_cast<const base&>(*this)); }
+
+		//swap the fields of two rows: the proxies are prvalues, so take them by value
+		friend void swap(soa_reference x, soa_reference y)
+		{
+			x._swap(y, std::index_sequence_for<Ts...>());
+		}
+
+	private:
+		template<std::size_t... I>
+		void _swap(soa_reference& r, std::index_sequence<I...>)
+		{
+			using std::swap;
+			(swap(std::get<I>(*this), std::get<I>(r)), ...);
+		}
+
+	}; //template soa_reference
+
+
+	//random-access iterator over the rows of a struct of arrays
+	//holds the first element of each field and a row index
+	template<typename... Ts>
+	class soa_iterator
+	{
+	public:
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::tuple<std::remove_const_t<Ts>...>;
+		using difference_type = std::ptrdiff_t;
+		using reference = soa_reference<Ts...>;
+
+		//operator-> returns a proxy that holds the row
+		struct pointer
+		{
+			reference ref;
+			reference* operator->() noexcept { return &ref; }
+		};
+
+		//ctors
+		soa_iterator() = default;
+		soa_iterator(std::tuple<Ts*...> columns, difference_type index) : columns_{ columns }, index_{ index } {}
+
+		//iterator to const_iterator conversion
+		template<typename... Us, typename = std::enable_if_t<sizeof...(Us) == sizeof...(Ts) &&
+			(std::is_convertible_v<Us*, Ts*> && ...)>>
+		soa_iterator(const soa_iterator<Us...>& it) : columns_(it.columns()), index_{ it.index() } {}
+
+		const std::tuple<Ts*...>& columns() const noexcept { return columns_; }
+		difference_type index() const noexcept { return index_; }
+
+		//dereference and member access
+		reference operator*() const { return _row(index_, std::index_sequence_for<Ts...>()); }
+		pointer operator->() const { return pointer{ **this }; }
+		reference operator[](difference_type n) const { return _row(index_ + n, std::index_sequence_for<Ts...>()); }
+
+		//increment and decrement
+		soa_iterator& operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		soa_iterator operator++(int)
+		{
+			soa_iterator beforeIncrement = *this;
+			++index_;
+			return beforeIncrement;
+		}
+
+		soa_iterator& operator--()
+		{
+			--index_;
+			return *this;
+		}
+
+		soa_iterator operator--(int)
+		{
+			soa_iterator beforeDecrement = *this;
+			--index_;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		soa_iterator& operator+=(difference_type n)
+		{
+			index_ += n;
+			return *this;
+		}
+
+		soa_iterator& operator-=(difference_type n)
+		{
+			index_ -= n;
+			return *this;
+		}
+
+		soa_iterator operator+(difference_type n) const { return soa_iterator(columns_, index_ + n); }
+		soa_iterator operator-(difference_type n) const { return soa_iterator(columns_, index_ - n); }
+
+		template<typename... Us>
+		difference_type operator-(const soa_iterator<Us...>& r) const { return index_ - r.index(); }
+
+		//comparison: iterators into the same table differ only in the index
+		template<typename... Us>
+		bool operator==(const soa_iterator<Us...>& r) const { return index_ == r.index(); }
+
+		template<typename... Us>
+		bool operator!=(const soa_iterator<Us...>& r) const { return index_ != r.index(); }
+
+		template<typename... Us>
+		bool operator<(const soa_iterator<Us...>& r) const { return index_ < r.index(); }
+
+		template<typename... Us>
+		bool operator>(const soa_iterator<Us...>& r) const { return index_ > r.index(); }
+
+		template<typename... Us>
+		bool operator<=(const soa_iterator<Us...>& r) const { return index_ <= r.index(); }
+
+		template<typename... Us>
+		bool operator>=(const soa_iterator<Us...>& r) const { return index_ >= r.index(); }
+
+	private:
+		template<std::size_t... I>
+		reference _row(difference_type i, std::index_sequence<I...>) const
+		{
+			return reference(std::get<I>(columns_)[i]...);
+		}
+
+		std::tuple<Ts*...> columns_{};
+		difference_type index_{ 0 };
+
+	}; //template soa_iterator
+
+
+	//n + it
+	template<typename... Ts>
+	soa_iterator<Ts...> operator+(std::ptrdiff_t n, const soa_iterator<Ts...>& it)
+	{
+		return it + n;
+	}
+
+
+	template<std::size_t N, typename... Fields>
+	struct soa_array
+	{
+		static_assert(sizeof...(Fields) != 0, "a table needs at least one field");
+
+		//types
+		using value_type = std::tuple<Fields...>;
+		using reference = soa_reference<Fields...>;
+		using const_reference = soa_reference<const Fields...>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = soa_iterator<Fields...>;
+		using const_iterator = soa_iterator<const Fields...>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		template<std::size_t I>
+		using field_type = std::tuple_element_t<I, value_type>;
+
+		template<std::size_t I>
+		using column_type = array<field_type<I>, N>;
+
+		//one array per field
+		std::tuple<array<Fields, N>...> columns;
+
+		//columns
+		template<std::size_t I>
+		constexpr column_type<I>& column() noexcept { return std::get<I>(columns); }
+
+		template<std::size_t I>
+		constexpr const column_type<I>& column() const noexcept { return std::get<I>(columns); }
+
+		//utility
+		void fill(const value_type& value) { _fill(value, std::index_sequence_for<Fields...>()); }
+
+		void swap(soa_array& a) noexcept(noexcept(std::declval<std::tuple<array<Fields, N>...>&>().swap(a.columns)))
+		{
+			columns.swap(a.columns);
+		}
+
+		//iterators
+		iterator begin() noexcept { return iterator(_data(std::index_sequence_for<Fields...>()), 0); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return begin() + N; }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(_data(std::index_sequence_for<Fields...>()), 0); }
+		const_iterator cend() const noexcept { return cbegin() + N; }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return N == 0; }
+		constexpr size_type size() const noexcept { return N; }
+		constexpr size_type max_size() const noexcept { return N; }
+
+		//unchecked element access
+		reference operator[](size_type pos) { return begin()[static_cast<difference_type>(pos)]; }
+		const_reference operator[](size_type pos) const { return cbegin()[static_cast<difference_type>(pos)]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		const_reference at(size_type pos) const
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		reference front() { return (*this)[0]; }
+		const_reference front() const { return (*this)[0]; }
+		reference back() { return (*this)[N - 1]; }
+		const_reference back() const { return (*this)[N - 1]; }
+
+	private:
+		template<std::size_t... I>
+		std::tuple<Fields*...> _data(std::index_sequence<I...>) noexcept
+		{
+			return { std::get<I>(columns).values... };
+		}
+
+		template<std::size_t... I>
+		std::tuple<const Fields*...> _data(std::index_sequence<I...>) const noexcept
+		{
+			return { std::get<I>(columns).values... };
+		}
+
+		template<std::size_t... I>
+		void _fill(const value_type& value, std::index_sequence<I...>)
+		{
+			(std::get<I>(columns).fill(std::get<I>(value)), ...);
+		}
+
+		static void _check(size_type pos)
+		{
+			if (pos >= N)
+				throw std::out_of_range("soa_array index out of range");
+		}
+
+	}; //template soa_array
+
+
+	//specialized algorithms
+	template<std::size_t N, typename... Fields>
+	void swap(soa_array<N, Fields...>& x, soa_array<N, Fields...>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: equal field by field
+	template<std::size_t N, typename... Fields>
+	bool operator==(const soa_array<N, Fields...>& x, const soa_array<N, Fields...>& y)
+	{
+		return x.columns == y.columns;
+	}
+
+	template<std::size_t N, typename... Fields>
+	bool operator!=(const soa_array<N, Fields...>& x, const soa_array<N, Fields...>& y)
+	{
+		return !(x == y);
+	}
+
+}	//namespace sigcpp
+
+
+//structured bindings of a row: auto [x, y] = *it binds references to the fields
+namespace std
+{
+	template<typename... Ts>
+	struct tuple_size<sigcpp::soa_reference<Ts...>> : integral_constant<size_t, sizeof...(Ts)> {};
+
+	template<size_t I, typename... Ts>
+	struct tuple_element<I, sigcpp::soa_reference<Ts...>> : tuple_element<I, tuple<Ts&...>> {};
+}
+
+#endif
@@ -0,0 +1,310 @@
+/*
+* soa_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a growable table of rows stored as a struct of arrays: one sigcpp::vector per field
+* - rows, iterators, and value type as in soa_array (see soa_array.h)
+* - every column has the same size: column<I>() is read-only, and data<I>() gives write
+*   access to the elements of a column without letting its size change
+* - an operation that grows the columns and throws leaves every column at its old size
+* - basic_soa_vector takes the allocator first, as the fields are a pack: every column draws
+*   from Allocator, rebound to its field; soa_vector uses std::allocator
+*/
+
+#ifndef SIGCPP_SOA_VECTOR_H
+#define SIGCPP_SOA_VECTOR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+#include "soa_array.h"
+#include "vector.h"
+
+namespace sigcpp
+{
+	template<typename Allocator, typename... Fields>
+	class basic_soa_vector
+	{
+		static_assert(sizeof...(Fields) != 0, "a table needs at least one field");
+
+		using indexes = std::index_sequence_for<Fields...>;
+
+		template<typename F>
+		using column_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<F>;
+
+	public:
+		//types
+		using value_type = std::tuple<Fields...>;
+		using reference = soa_reference<Fields...>;
+		using const_reference = soa_reference<const Fields...>;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = soa_iterator<Fields...>;
+		using const_iterator = soa_iterator<const Fields...>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		template<std::size_t I>
+		using field_type = std::tuple_element_t<I, value_type>;
+
+		template<std::size_t I>
+		using column_type = vector<field_type<I>, column_allocator<field_type<I>>>;
+
+		//ctors
+		basic_soa_vector() : basic_soa_vector(Allocator()) {}
+		explicit basic_soa_vector(const Allocator& alloc) : columns_(column_allocator<Fields>(alloc)...) {}
+
+		explicit basic_soa_vector(size_type count, const Allocator& alloc = Allocator()) : basic_soa_vector(alloc)
+		{
+			resize(count);
+		}
+
+		basic_soa_vector(size_type count, const value_type& value, const Allocator& alloc = Allocator())
+			: basic_soa_vector(alloc)
+		{
+			resize(count, value);
+		}
+
+		basic_soa_vector(std::initializer_list<value_type> il, const Allocator& alloc = Allocator())
+			: basic_soa_vector(alloc)
+		{
+			reserve(il.size());
+			for (const auto& value : il)
+				push_back(value);
+		}
+
+		//columns
+		template<std::size_t I>
+		const column_type<I>& column() const noexcept { return std::get<I>(columns_); }
+
+		template<std::size_t I>
+		field_type<I>* data() noexcept { return std::get<I>(columns_).data(); }
+
+		template<std::size_t I>
+		const field_type<I>* data() const noexcept { return std::get<I>(columns_).data(); }
+
+		allocator_type get_allocator() const noexcept { return Allocator(std::get<0>(columns_).get_allocator()); }
+
+		//iterators
+		iterator begin() noexcept { return iterator(_data(indexes()), 0); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return begin() + static_cast<difference_type>(size()); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(_data(indexes()), 0); }
+		const_iterator cend() const noexcept { return cbegin() + static_cast<difference_type>(size()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		bool empty() const noexcept { return size() == 0; }
+		size_type size() const noexcept { return std::get<0>(columns_).size(); }
+
+		//rows that fit without reallocating any column
+		size_type capacity() const noexcept { return _capacity(indexes()); }
+
+		void reserve(size_type count) { _reserve(count, indexes()); }
+		void shrink_to_fit() { _shrink_to_fit(indexes()); }
+
+		void resize(size_type count) { _resize(count, indexes()); }
+		void resize(size_type count, const value_type& value) { _resize(count, value, indexes()); }
+
+		//unchecked element access
+		reference operator[](size_type pos) { return begin()[static_cast<difference_type>(pos)]; }
+		const_reference operator[](size_type pos) const { return cbegin()[static_cast<difference_type>(pos)]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		const_reference at(size_type pos) const
+		{
+			_check(pos);
+			return (*this)[pos];
+		}
+
+		reference front() { return (*this)[0]; }
+		const_reference front() const { return (*this)[0]; }
+		reference back() { return (*this)[size() - 1]; }
+		const_reference back() const { return (*this)[size() - 1]; }
+
+		//modifiers
+		//one argument per field
+		template<typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Fields)>>
+		reference emplace_back(Args&&... args)
+		{
+			_emplace_back(indexes(), std::forward<Args>(args)...);
+			return back();
+		}
+
+		void push_back(const value_type& value) { _push_back(value, indexes()); }
+		void push_back(value_type&& value) { _push_back(std::move(value), indexes()); }
+
+		void pop_back() { _pop_back(indexes()); }
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			_erase(first.index(), last.index(), indexes());
+			return begin() + first.index();
+		}
+
+		void clear() noexcept { _clear(indexes()); }
+
+		void swap(basic_soa_vector& v) noexcept { columns_.swap(v.columns_); }
+
+		//comparison: equal field by field
+		friend bool operator==(const basic_soa_vector& x, const basic_soa_vector& y) { return x.columns_ == y.columns_; }
+		friend bool operator!=(const basic_soa_vector& x, const basic_soa_vector& y) { return !(x == y); }
+
+	private:
+		template<std::size_t... I>
+		std::tuple<Fields*...> _data(std::index_sequence<I...>) noexcept
+		{
+			return { std::get<I>(columns_).data()... };
+		}
+
+		template<std::size_t... I>
+		std::tuple<const Fields*...> _data(std::index_sequence<I...>) const noexcept
+		{
+			return { std::get<I>(columns_).data()... };
+		}
+
+		template<std::size_t... I>
+		size_type _capacity(std::index_sequence<I...>) const noexcept
+		{
+			size_type capacity = std::get<0>(columns_).capacity();
+			((capacity = std::min(capacity, std::get<I>(columns_).capacity())), ...);
+			return capacity;
+		}
+
+		template<std::size_t... I>
+		void _reserve(size_type count, std::index_sequence<I...>)
+		{
+			(std::get<I>(columns_).reserve(count), ...);
+		}
+
+		template<std::size_t... I>
+		void _shrink_to_fit(std::index_sequence<I...>)
+		{
+			(std::get<I>(columns_).shrink_to_fit(), ...);
+		}
+
+		//grow the columns one by one; if one throws, shrink all back: shrinking does not throw
+		template<typename Grow, std::size_t... I>
+		void _grow(Grow grow, std::index_sequence<I...>)
+		{
+			const auto oldSize = size();
+			try {
+				(grow(std::get<I>(columns_), std::integral_constant<std::size_t, I>()), ...);
+			}
+			catch (...) {
+				(_truncate(std::get<I>(columns_), oldSize), ...);
+				throw;
+			}
+		}
+
+		template<typename C>
+		static void _truncate(C& column, size_type count) noexcept
+		{
+			if (column.size() > count)
+				column.erase(column.begin() + static_cast<difference_type>(count), column.end());
+		}
+
+		template<std::size_t... I>
+		void _resize(size_type count, std::index_sequence<I...> is)
+		{
+			_grow([count](auto& column, auto) { column.resize(count); }, is);
+		}
+
+		template<std::size_t... I>
+		void _resize(size_type count, const value_type& value, std::index_sequence<I...> is)
+		{
+			_grow([count, &value](auto& column, auto i) { column.resize(count, std::get<decltype(i)::value>(value)); }, is);
+		}
+
+		template<std::size_t... I, typename... Args>
+		void _emplace_back(std::index_sequence<I...> is, Args&&... args)
+		{
+			auto values = std::forward_as_tuple(std::forward<Args>(args)...);
+			_grow([&values](auto& column, auto i) {
+				column.emplace_back(std::get<decltype(i)::value>(std::move(values)));
+			}, is);
+		}
+
+		template<typename V, std::size_t... I>
+		void _push_back(V&& value, std::index_sequence<I...> is)
+		{
+			_grow([&value](auto& column, auto i) {
+				column.push_back(std::get<decltype(i)::value>(std::forward<V>(value)));
+			}, is);
+		}
+
+		template<std::size_t... I>
+		void _pop_back(std::index_sequence<I...>)
+		{
+			(std::get<I>(columns_).pop_back(), ...);
+		}
+
+		template<std::size_t... I>
+		void _erase(difference_type first, difference_type last, std::index_sequence<I...>)
+		{
+			(std::get<I>(columns_).erase(std::get<I>(columns_).begin() + first,
+				std::get<I>(columns_).begin() + last), ...);
+		}
+
+		template<std::size_t... I>
+		void _clear(std::index_sequence<I...>) noexcept
+		{
+			(std::get<I>(columns_).clear(), ...);
+		}
+
+		void _check(size_type pos) const
+		{
+			if (pos >= size())
+				throw std::out_of_range("soa_vector index out of range");
+		}
+
+		std::tuple<vector<Fields, column_allocator<Fields>>...> columns_;
+
+	}; //template basic_soa_vector
+
+
+	template<typename... Fields>
+	using soa_vector = basic_soa_vector<std::allocator<std::tuple<Fields...>>, Fields...>;
+
+
+	//specialized algorithms
+	template<typename Allocator, typename... Fields>
+	void swap(basic_soa_vector<Allocator, Fields...>& x, basic_soa_vector<Allocator, Fields...>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,87 @@
+/*
+* sorted_search.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define binary search on sorted random-access ranges without data-dependent branches
+* - same results as std::lower_bound and std::upper_bound
+* - each step halves the range and advances by a mask of the comparison rather than by a
+*   branch: the loop runs ceil(log2(n)) times whatever the key, so there is nothing to
+*   mispredict (gcc turns the plainer `cond ? half : 0` back into a branch)
+* - without a branch the CPU does not run ahead into the next step, so each step prefetches
+*   both elements the next step may compare; else a range larger than the cache waits on
+*   each load in turn
+* - the prefetch is written out in each loop: gcc drops calls to a function whose only
+*   effect is a prefetch
+* - see Khuong and Morin, "Array layouts for comparison-based searching" (2017)
+*/
+
+#ifndef SIGCPP_SORTED_SEARCH_H
+#define SIGCPP_SORTED_SEARCH_H
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "simd.h"
+
+namespace sigcpp
+{
+	//first position in [first, last) whose element is not less than key
+	template<typename RandomIt, typename K, typename Compare = std::less<>>
+	constexpr RandomIt branchless_lower_bound(RandomIt first, RandomIt last, const K& key,
+		Compare comp = Compare())
+	{
+		auto n = last - first;
+		if (n == 0)
+			return first;
+
+		while (n > 1) {
+			const auto half = n / 2;
+			if constexpr (std::is_lvalue_reference_v<typename std::iterator_traits<RandomIt>::reference>) {
+				const auto next = (n - half) / 2;
+				if (!SIGCPP_IS_CONSTANT_EVALUATED() && next > 0) {
+					simd::prefetch(std::addressof(first[next - 1]));
+					simd::prefetch(std::addressof(first[half + next - 1]));
+				}
+			}
+			first += half & -static_cast<decltype(n)>(comp(first[half - 1], key));
+			n -= half;
+		}
+		return first + (comp(*first, key) ? 1 : 0);
+	}
+
+
+	//first position in [first, last) whose element is greater than key
+	template<typename RandomIt, typename K, typename Compare = std::less<>>
+	constexpr RandomIt branchless_upper_bound(RandomIt first, RandomIt last, const K& key,
+		Compare comp = Compare())
+	{
+		auto n = last - first;
+		if (n == 0)
+			return first;
+
+		while (n > 1) {
+			const auto half = n / 2;
+			if constexpr (std::is_lvalue_reference_v<typename std::iterator_traits<RandomIt>::reference>) {
+				const auto next = (n - half) / 2;
+				if (!SIGCPP_IS_CONSTANT_EVALUATED() && next > 0) {
+					simd::prefetch(std::addressof(first[next - 1]));
+					simd::prefetch(std::addressof(first[half + next - 1]));
+				}
+			}
+			first += half & -static_cast<decltype(n)>(!comp(key, first[half - 1]));
+			n -= half;
+		}
+		return first + (comp(key, *first) ? 0 : 1);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,280 @@
+/*
+* span.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for non-owning views of contiguous elements
+* - see C++20 [views.span] https://timsong-cpp.github.io/cppwp/n4861/views.span
+* - a span is constructible from a sigcpp::array, a C array, a pointer and a count, and
+*   any contiguous range with data() and size(), such as sigcpp::vector
+* - a function that takes span<const T> is compiled once for every size of array, where a
+*   function that takes const array<T, N>& is compiled once per N
+* - span<T, N> has a static extent: it holds only the pointer, and first<Count>() and
+*   subspan<Offset, Count>() keep the extent static
+* - iterators are array_iterator, as in sigcpp::array
+*/
+
+#ifndef SIGCPP_SPAN_H
+#define SIGCPP_SPAN_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+
+#include "array.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	//extent of a span whose size is known only at run time
+	inline constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+	template<typename T, std::size_t Extent = dynamic_extent>
+	class span;
+
+
+	namespace detail
+	{
+		template<typename T>
+		struct is_span : std::false_type {};
+
+		template<typename T, std::size_t Extent>
+		struct is_span<span<T, Extent>> : std::true_type {};
+
+		template<typename T>
+		struct is_sigcpp_array : std::false_type {};
+
+		template<typename T, std::size_t N>
+		struct is_sigcpp_array<array<T, N>> : std::true_type {};
+
+		//U converts to T by qualification only: a span never reinterprets its elements
+		template<typename U, typename T>
+		constexpr bool is_span_convertible_v = std::is_convertible_v<U(*)[], T(*)[]>;
+
+		//a contiguous range other than a span, a sigcpp::array, or a C array: those have
+		//ctors that keep the static extent
+		template<typename R, typename T, typename = void>
+		struct is_span_compatible_range : std::false_type {};
+
+		template<typename R, typename T>
+		struct is_span_compatible_range<R, T, std::void_t<decltype(std::declval<R&>().data()),
+			decltype(std::declval<R&>().size())>>
+			: std::bool_constant<!is_span<std::remove_cv_t<R>>::value &&
+				!is_sigcpp_array<std::remove_cv_t<R>>::value && !std::is_array_v<R> &&
+				is_span_convertible_v<std::remove_pointer_t<decltype(std::declval<R&>().data())>, T>> {};
+
+		//iterators whose elements are known to be contiguous: pointers and array_iterator
+		template<typename P>
+		constexpr P to_pointer(P p) noexcept { return p; }
+
+		template<typename P>
+		constexpr P to_pointer(array_iterator<P> it) noexcept { return it.base(); }
+
+		template<typename It, typename T, typename = void>
+		struct is_contiguous_iterator_of : std::false_type {};
+
+		template<typename It, typename T>
+		struct is_contiguous_iterator_of<It, T, std::enable_if_t<std::is_pointer_v<decltype(to_pointer(std::declval<It>()))>>>
+			: std::bool_constant<is_span_convertible_v<
+				std::remove_pointer_t<decltype(to_pointer(std::declval<It>()))>, T>> {};
+
+		template<typename It, typename T>
+		constexpr bool is_contiguous_iterator_of_v = is_contiguous_iterator_of<It, T>::value;
+
+		//the size of a span: stored only when the extent is dynamic
+		template<std::size_t Extent>
+		class span_extent
+		{
+		public:
+			constexpr explicit span_extent(std::size_t) noexcept {}
+			constexpr std::size_t size() const noexcept { return Extent; }
+		};
+
+		template<>
+		class span_extent<dynamic_extent>
+		{
+		public:
+			constexpr explicit span_extent(std::size_t size) noexcept : size_{ size } {}
+			constexpr std::size_t size() const noexcept { return size_; }
+
+		private:
+			std::size_t size_;
+		};
+	}
+
+
+	template<typename T, std::size_t Extent>
+	class span : private detail::span_extent<Extent>
+	{
+		using extent_base = detail::span_extent<Extent>;
+
+	public:
+		//types
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+		using iterator = array_iterator<pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+
+		static constexpr size_type extent = Extent;
+
+		//ctors
+		//a default span is empty: only with a dynamic or zero extent
+		template<std::size_t E = Extent, typename = std::enable_if_t<E == dynamic_extent || E == 0>>
+		constexpr span() noexcept : extent_base(0), data_{ nullptr } {}
+
+		//a pointer or an array_iterator, and a count or an end
+		//the caller ensures the size is Extent if the extent is static
+		template<typename It, typename = std::enable_if_t<detail::is_contiguous_iterator_of_v<It, T>>>
+		constexpr span(It first, size_type count) noexcept : extent_base(count), data_{ detail::to_pointer(first) } {}
+
+		template<typename It, typename = std::enable_if_t<detail::is_contiguous_iterator_of_v<It, T>>>
+		constexpr span(It first, It last) noexcept
+			: extent_base(static_cast<size_type>(last - first)), data_{ detail::to_pointer(first) } {}
+
+		template<std::size_t N, typename = std::enable_if_t<Extent == dynamic_extent || Extent == N>>
+		constexpr span(element_type(&a)[N]) noexcept : extent_base(N), data_{ a } {}
+
+		template<typename U, std::size_t N, typename = std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+			detail::is_span_convertible_v<U, T>>>
+		constexpr span(array<U, N>& a) noexcept : extent_base(N), data_{ a.data() } {}
+
+		template<typename U, std::size_t N, typename = std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+			detail::is_span_convertible_v<const U, T>>>
+		constexpr span(const array<U, N>& a) noexcept : extent_base(N), data_{ a.data() } {}
+
+		//a contiguous range: with a dynamic extent only, as its size is known at run time;
+		//a temporary range only for const elements, as the span outlives the temporary
+		template<typename R, typename = std::enable_if_t<Extent == dynamic_extent &&
+			detail::is_span_compatible_range<std::remove_reference_t<R>, T>::value &&
+			(std::is_lvalue_reference_v<R> || std::is_const_v<T>)>>
+		constexpr span(R&& r) noexcept(noexcept(r.data()) && noexcept(r.size()))
+			: extent_base(r.size()), data_{ r.data() } {}
+
+		//span<T> to span<const T>, and a static extent to the dynamic extent
+		template<typename U, std::size_t N, typename = std::enable_if_t<(Extent == dynamic_extent || Extent == N) &&
+			detail::is_span_convertible_v<U, T>>>
+		constexpr span(const span<U, N>& s) noexcept : extent_base(s.size()), data_{ s.data() } {}
+
+		//the dynamic extent to a static extent: explicit, as the caller ensures the size
+		template<typename U, std::size_t E = Extent, typename = std::enable_if_t<
+			E != dynamic_extent && detail::is_span_convertible_v<U, T>>>
+		constexpr explicit span(const span<U, dynamic_extent>& s) noexcept : extent_base(s.size()), data_{ s.data() } {}
+
+		constexpr span(const span&) noexcept = default;
+		constexpr span& operator=(const span&) noexcept = default;
+
+		//subviews
+		template<std::size_t Count>
+		constexpr span<T, Count> first() const noexcept
+		{
+			static_assert(Extent == dynamic_extent || Count <= Extent, "Count exceeds the extent");
+			return span<T, Count>(data_, Count);
+		}
+
+		template<std::size_t Count>
+		constexpr span<T, Count> last() const noexcept
+		{
+			static_assert(Extent == dynamic_extent || Count <= Extent, "Count exceeds the extent");
+			return span<T, Count>(data_ + (size() - Count), Count);
+		}
+
+		//the extent is static if Count is given, or if the span has a static extent
+		template<std::size_t Offset, std::size_t Count = dynamic_extent>
+		constexpr auto subspan() const noexcept
+		{
+			static_assert(Extent == dynamic_extent || Offset <= Extent, "Offset exceeds the extent");
+			static_assert(Extent == dynamic_extent || Count == dynamic_extent || Count <= Extent - Offset,
+				"Count exceeds the extent");
+
+			constexpr auto subExtent = Count != dynamic_extent ? Count :
+				(Extent != dynamic_extent ? Extent - Offset : dynamic_extent);
+			return span<T, subExtent>(data_ + Offset, Count != dynamic_extent ? Count : size() - Offset);
+		}
+
+		constexpr span<T> first(size_type count) const noexcept { return span<T>(data_, count); }
+		constexpr span<T> last(size_type count) const noexcept { return span<T>(data_ + (size() - count), count); }
+
+		constexpr span<T> subspan(size_type offset, size_type count = dynamic_extent) const noexcept
+		{
+			return span<T>(data_ + offset, count == dynamic_extent ? size() - offset : count);
+		}
+
+		//observers
+		using extent_base::size;
+		constexpr size_type size_bytes() const noexcept { return size() * sizeof(T); }
+		constexpr bool empty() const noexcept { return size() == 0; }
+
+		//unchecked element access
+		constexpr reference operator[](size_type pos) const { return data_[pos]; }
+		constexpr reference front() const { return data_[0]; }
+		constexpr reference back() const { return data_[size() - 1]; }
+
+		//checked element access
+		constexpr reference at(size_type pos) const
+		{
+			if (pos >= size())
+				throw std::out_of_range("span index out of range");
+			return data_[pos];
+		}
+
+		constexpr pointer data() const noexcept { return data_; }
+
+		//iterators: a span does not own its elements, so a const span is not a view of const
+		constexpr iterator begin() const noexcept { return iterator(data_); }
+		constexpr iterator end() const noexcept { return iterator(data_ + size()); }
+		constexpr reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+		constexpr reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+	private:
+		pointer data_;
+
+	}; //template span
+
+
+	//deduction guides
+	template<typename T, std::size_t N>
+	span(T(&)[N]) -> span<T, N>;
+
+	template<typename T, std::size_t N>
+	span(array<T, N>&) -> span<T, N>;
+
+	template<typename T, std::size_t N>
+	span(const array<T, N>&) -> span<const T, N>;
+
+	template<typename R, typename = decltype(std::declval<R&>().data())>
+	span(R&&) -> span<std::remove_pointer_t<decltype(std::declval<R&>().data())>>;
+
+
+	//views of the object representation
+	template<typename T, std::size_t Extent>
+	span<const std::byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>
+		as_bytes(span<T, Extent> s) noexcept
+	{
+		using byte_span = span<const std::byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>;
+		return byte_span(reinterpret_cast<const std::byte*>(s.data()), s.size_bytes());
+	}
+
+	template<typename T, std::size_t Extent, typename = std::enable_if_t<!std::is_const_v<T>>>
+	span<std::byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>
+		as_writable_bytes(span<T, Extent> s) noexcept
+	{
+		using byte_span = span<std::byte, Extent == dynamic_extent ? dynamic_extent : sizeof(T) * Extent>;
+		return byte_span(reinterpret_cast<std::byte*>(s.data()), s.size_bytes());
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,179 @@
+/*
+* spsc_queue.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for a bounded single-producer/single-consumer queue
+* - exactly one thread may push and exactly one thread may pop; every operation is wait-free
+* - the capacity N is a power of 2 so that an index maps to a slot with a mask
+* - head and tail are free-running counters: the queue is full when they are N apart, so
+*   all N slots are usable
+* - each side keeps a cached copy of the other side's index and rereads the shared index
+*   only when the cache says the queue is full (producer) or empty (consumer)
+* - push_n and pop_n move a batch with one acquire load and one release store
+*/
+
+#ifndef SIGCPP_SPSC_QUEUE_H
+#define SIGCPP_SPSC_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include "array.h"
+#include "aligned_array.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N>
+	class spsc_queue
+	{
+		static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of 2");
+		static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+		static_assert(std::is_move_assignable_v<T>, "T must be move assignable");
+
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+
+		//ctors
+		spsc_queue() = default;
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		//capacity
+		static constexpr size_type capacity() noexcept { return N; }
+
+		//approximate unless called from the producer or the consumer with the other side idle
+		size_type size() const noexcept
+		{
+			const auto head = head_.load(std::memory_order_acquire);
+			const auto tail = tail_.load(std::memory_order_acquire);
+			return tail - head;
+		}
+
+		bool empty() const noexcept { return size() == 0; }
+
+		//producer
+		bool try_push(const T& value) { return _try_push(value); }
+		bool try_push(T&& value) { return _try_push(std::move(value)); }
+
+		template<typename... Args>
+		bool try_emplace(Args&&... args)
+		{
+			return _try_push(T(std::forward<Args>(args)...));
+		}
+
+		//push up to count values from first; return the number pushed
+		template<typename InputIt>
+		size_type push_n(InputIt first, size_type count)
+		{
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			auto free = N - (tail - head_cache_);
+			if (free < count) {
+				head_cache_ = head_.load(std::memory_order_acquire);
+				free = N - (tail - head_cache_);
+			}
+
+			count = std::min(count, free);
+			for (size_type i = 0; i < count; ++i, ++first)
+				buffer_[(tail + i) & mask] = *first;
+			tail_.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		//consumer
+		bool try_pop(T& value)
+		{
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head == tail_cache_) {
+				tail_cache_ = tail_.load(std::memory_order_acquire);
+				if (head == tail_cache_)
+					return false;
+			}
+
+			value = std::move(buffer_[head & mask]);
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		//the oldest element, or nullptr if the queue is empty; pop() discards it
+		T* front()
+		{
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head == tail_cache_) {
+				tail_cache_ = tail_.load(std::memory_order_acquire);
+				if (head == tail_cache_)
+					return nullptr;
+			}
+			return &buffer_[head & mask];
+		}
+
+		//front() must have returned an element
+		void pop() noexcept
+		{
+			head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		//pop up to count values to out; return the number popped
+		template<typename OutputIt>
+		size_type pop_n(OutputIt out, size_type count)
+		{
+			const auto head = head_.load(std::memory_order_relaxed);
+			auto used = tail_cache_ - head;
+			if (used < count) {
+				tail_cache_ = tail_.load(std::memory_order_acquire);
+				used = tail_cache_ - head;
+			}
+
+			count = std::min(count, used);
+			for (size_type i = 0; i < count; ++i, ++out)
+				*out = std::move(buffer_[(head + i) & mask]);
+			head_.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+	private:
+		static constexpr size_type mask = N - 1;
+
+		//consumer line: the consumer writes head_ and reads tail_cache_ on every pop
+		alignas(cache_line_size) std::atomic<size_type> head_{ 0 };
+		size_type tail_cache_{ 0 };
+
+		//producer line
+		alignas(cache_line_size) std::atomic<size_type> tail_{ 0 };
+		size_type head_cache_{ 0 };
+
+		//starts on its own line so the first slots do not share a line with tail_
+		alignas(cache_line_size) array<T, N> buffer_{};
+
+		template<typename U>
+		bool _try_push(U&& value)
+		{
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_cache_ == N) {
+				head_cache_ = head_.load(std::memory_order_acquire);
+				if (tail - head_cache_ == N)
+					return false;
+			}
+
+			buffer_[tail & mask] = std::forward<U>(value);
+			tail_.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+	}; //template spsc_queue
+
+}	//namespace sigcpp
+
+#endif
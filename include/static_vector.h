@@ -0,0 +1,496 @@
+/*
+* static_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for vectors with a fixed capacity and no heap allocation
+* - interface of vector: see C++17 [vector] https://timsong-cpp.github.io/cppwp/n4659/vector
+* - elements live inside the object; capacity is N and never changes
+* - operations that would exceed the capacity throw std::length_error
+* - storage is uninitialized: only elements in [begin(), end()) are constructed
+* - trivial element types use plain array storage, so all members are constexpr (C++20)
+* - trivially copyable element types are copied, inserted, and erased with memcpy/memmove
+*/
+
+#ifndef SIGCPP_STATIC_VECTOR_H
+#define SIGCPP_STATIC_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+
+#include "array.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//elements and size of a static_vector
+		//trivial types: a plain array, which constant evaluation can read and write
+		template<typename T, std::size_t N, bool = std::is_trivial_v<T>>
+		struct static_vector_storage
+		{
+			T values[N == 0 ? 1 : N];
+			std::size_t size{ 0 };
+
+			constexpr T* data() noexcept { return values; }
+			constexpr const T* data() const noexcept { return values; }
+		};
+
+		//other types: raw bytes, with elements constructed in place and destroyed here
+		template<typename T, std::size_t N>
+		struct static_vector_storage<T, N, false>
+		{
+			alignas(T) unsigned char bytes[sizeof(T) * (N == 0 ? 1 : N)];
+			std::size_t size{ 0 };
+
+			static_vector_storage() noexcept {}
+			static_vector_storage(const static_vector_storage&) = delete;
+			static_vector_storage& operator=(const static_vector_storage&) = delete;
+
+			~static_vector_storage()
+			{
+				if constexpr (!std::is_trivially_destructible_v<T>)
+					for (std::size_t i = 0; i < size; ++i)
+						data()[i].~T();
+			}
+
+			T* data() noexcept { return reinterpret_cast<T*>(bytes); }
+			const T* data() const noexcept { return reinterpret_cast<const T*>(bytes); }
+		};
+	}
+
+
+	template<typename T, std::size_t N>
+	class static_vector
+	{
+	public:
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = array_iterator<pointer>;
+		using const_iterator = array_iterator<const_pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//ctors: user-provided default ctor so that value-initialization does not zero the storage
+		constexpr static_vector() noexcept {}
+
+		constexpr explicit static_vector(size_type count) { resize(count); }
+		constexpr static_vector(size_type count, const T& value) { assign(count, value); }
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		constexpr static_vector(InputIt first, InputIt last) { assign(first, last); }
+
+		constexpr static_vector(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+		constexpr static_vector(const static_vector& v) { _append_from(v); }
+
+		constexpr static_vector(static_vector&& v) noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			_append_from(std::move(v));
+		}
+
+		//assignment
+		constexpr static_vector& operator=(const static_vector& v)
+		{
+			if (this != &v) {
+				clear();
+				_append_from(v);
+			}
+			return *this;
+		}
+
+		constexpr static_vector& operator=(static_vector&& v) noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			if (this != &v) {
+				clear();
+				_append_from(std::move(v));
+			}
+			return *this;
+		}
+
+		constexpr static_vector& operator=(std::initializer_list<T> il)
+		{
+			assign(il.begin(), il.end());
+			return *this;
+		}
+
+		constexpr void assign(size_type count, const T& value)
+		{
+			_check_capacity(count);
+			clear();
+			for (; storage_.size < count; ++storage_.size)
+				_construct(_data() + storage_.size, value);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		constexpr void assign(InputIt first, InputIt last)
+		{
+			if constexpr (detail::is_forward_iterator_v<InputIt>)
+				_check_capacity(static_cast<size_type>(std::distance(first, last)));
+			clear();
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		constexpr void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(_data()); }
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr iterator end() noexcept { return iterator(_data() + storage_.size); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		constexpr const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_iterator cbegin() const noexcept { return const_iterator(_data()); }
+		constexpr const_iterator cend() const noexcept { return const_iterator(_data() + storage_.size); }
+		constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return storage_.size == 0; }
+		constexpr bool full() const noexcept { return storage_.size == N; }
+		constexpr size_type size() const noexcept { return storage_.size; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type capacity() noexcept { return N; }
+
+		constexpr void resize(size_type count) { _resize(count); }
+		constexpr void resize(size_type count, const T& value) { _resize(count, value); }
+
+		//unchecked element access
+		constexpr reference operator[](size_type pos) { return _data()[pos]; }
+		constexpr const_reference operator[](size_type pos) const { return _data()[pos]; }
+
+		//checked element access
+		constexpr reference at(size_type pos)
+		{
+			return const_cast<reference>(_at(pos));
+		}
+
+		constexpr const_reference at(size_type pos) const { return _at(pos); }
+
+		constexpr reference front() { return _data()[0]; }
+		constexpr const_reference front() const { return _data()[0]; }
+		constexpr reference back() { return _data()[storage_.size - 1]; }
+		constexpr const_reference back() const { return _data()[storage_.size - 1]; }
+
+		//underlying raw data
+		constexpr pointer data() noexcept { return _data(); }
+		constexpr const_pointer data() const noexcept { return _data(); }
+
+		//modifiers
+		template<typename... Args>
+		constexpr reference emplace_back(Args&&... args)
+		{
+			_check_capacity(1, storage_.size);
+			const auto p = _data() + storage_.size;
+			_construct(p, std::forward<Args>(args)...);
+			++storage_.size;
+			return *p;
+		}
+
+		constexpr void push_back(const T& value) { emplace_back(value); }
+		constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+		constexpr void pop_back()
+		{
+			--storage_.size;
+			_destroy(_data() + storage_.size, _data() + storage_.size + 1);
+		}
+
+		//construct the new element first: args may refer to an element of this vector
+		template<typename... Args>
+		constexpr iterator emplace(const_iterator pos, Args&&... args)
+		{
+			_check_capacity(1, storage_.size);
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const auto p = _data();
+			if (index == storage_.size) {
+				emplace_back(std::forward<Args>(args)...);
+				return begin() + index;
+			}
+
+			T value(std::forward<Args>(args)...);
+			if (_use_bulk_copy()) {
+				_move_bytes(p + index + 1, p + index, storage_.size - index);
+				_move_bytes(p + index, &value, 1);
+			}
+			else {
+				_construct(p + storage_.size, std::move(p[storage_.size - 1]));
+				std::move_backward(p + index, p + storage_.size - 1, p + storage_.size);
+				p[index] = std::move(value);
+			}
+			++storage_.size;
+			return begin() + index;
+		}
+
+		constexpr iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+		constexpr iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+		constexpr iterator insert(const_iterator pos, size_type count, const T& value)
+		{
+			_check_capacity(count, storage_.size);
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const T copy(value);
+			for (size_type i = 0; i < count; ++i)
+				emplace_back(copy);
+			return _rotate_back(index, count);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		constexpr iterator insert(const_iterator pos, InputIt first, InputIt last)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const auto old_size = storage_.size;
+			if constexpr (detail::is_forward_iterator_v<InputIt>) {
+				const auto count = static_cast<size_type>(std::distance(first, last));
+				_check_capacity(count, storage_.size);
+
+				//open a gap and copy into it
+				if (_use_bulk_copy()) {
+					const auto p = _data();
+					_move_bytes(p + index + count, p + index, old_size - index);
+					std::copy(first, last, p + index);
+					storage_.size += count;
+					return begin() + index;
+				}
+			}
+
+			for (; first != last; ++first)
+				emplace_back(*first);
+			return _rotate_back(index, storage_.size - old_size);
+		}
+
+		constexpr iterator insert(const_iterator pos, std::initializer_list<T> il)
+		{
+			return insert(pos, il.begin(), il.end());
+		}
+
+		constexpr iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		constexpr iterator erase(const_iterator first, const_iterator last)
+		{
+			const auto index = static_cast<size_type>(first - cbegin());
+			const auto count = static_cast<size_type>(last - first);
+			if (count == 0)
+				return begin() + index;
+
+			const auto p = _data();
+			const auto tail = storage_.size - index - count;
+			if (_use_bulk_copy())
+				_move_bytes(p + index, p + index + count, tail);
+			else
+				std::move(p + index + count, p + storage_.size, p + index);
+
+			_destroy(p + storage_.size - count, p + storage_.size);
+			storage_.size -= count;
+			return begin() + index;
+		}
+
+		constexpr void clear() noexcept
+		{
+			_destroy(_data(), _data() + storage_.size);
+			storage_.size = 0;
+		}
+
+		constexpr void swap(static_vector& v) noexcept(std::is_nothrow_swappable_v<T> &&
+			std::is_nothrow_move_constructible_v<T>)
+		{
+			auto& small = storage_.size < v.storage_.size ? *this : v;
+			auto& large = storage_.size < v.storage_.size ? v : *this;
+			const auto common = small.storage_.size;
+
+			if (_use_bulk_copy()) {
+				if constexpr (detail::is_short_block_v<T, N>)
+					detail::swap_bytes_short(_data(), v._data(), large.storage_.size * sizeof(T));
+				else
+					detail::swap_bytes(_data(), v._data(), large.storage_.size * sizeof(T));
+				std::swap(storage_.size, v.storage_.size);
+				return;
+			}
+
+			std::swap_ranges(small._data(), small._data() + common, large._data());
+			for (auto i = common; i < large.storage_.size; ++i)
+				small._construct(small._data() + i, std::move(large._data()[i]));
+			small.storage_.size = large.storage_.size;
+			large._destroy(large._data() + common, large._data() + large.storage_.size);
+			large.storage_.size = common;
+		}
+
+	private:
+		detail::static_vector_storage<T, N> storage_;
+
+		constexpr pointer _data() noexcept { return storage_.data(); }
+		constexpr const_pointer _data() const noexcept { return storage_.data(); }
+
+		//memcpy/memmove of elements: trivially copyable types at run time
+		static constexpr bool _use_bulk_copy() noexcept
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+				return !SIGCPP_IS_CONSTANT_EVALUATED();
+			else
+				return false;
+		}
+
+		//memmove count elements: only where _use_bulk_copy() is true
+		static void _move_bytes(void* dest, const void* src, size_type count) noexcept
+		{
+			if (count != 0)
+				std::memmove(dest, src, count * sizeof(T));
+		}
+
+		//throw unless count more elements fit alongside used elements
+		static constexpr void _check_capacity(size_type count, size_type used = 0)
+		{
+			if (count > N - used)
+				throw std::length_error("static_vector capacity exceeded");
+		}
+
+		template<typename... Args>
+		constexpr void _construct(pointer p, Args&&... args)
+		{
+			if constexpr (std::is_trivial_v<T>)
+				*p = T(std::forward<Args>(args)...);
+			else
+				::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+		}
+
+		constexpr void _destroy(pointer first, pointer last) noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				for (; first != last; ++first)
+					first->~T();
+		}
+
+		//append all elements of v, copied or moved
+		template<typename V>
+		constexpr void _append_from(V&& v)
+		{
+			const auto count = v.storage_.size;
+			if (_use_bulk_copy()) {
+				_move_bytes(_data(), v._data(), count);
+				storage_.size = count;
+				return;
+			}
+
+			for (size_type i = 0; i < count; ++i, ++storage_.size) {
+				if constexpr (std::is_lvalue_reference_v<V>)
+					_construct(_data() + i, v._data()[i]);
+				else
+					_construct(_data() + i, std::move(v._data()[i]));
+			}
+		}
+
+		//move the last count elements to index
+		constexpr iterator _rotate_back(size_type index, size_type count)
+		{
+			const auto p = _data();
+			std::rotate(p + index, p + storage_.size - count, p + storage_.size);
+			return begin() + index;
+		}
+
+		template<typename... Args>
+		constexpr void _resize(size_type count, const Args&... value)
+		{
+			_check_capacity(count);
+			if (count < storage_.size) {
+				_destroy(_data() + count, _data() + storage_.size);
+				storage_.size = count;
+			}
+			else {
+				for (; storage_.size < count; ++storage_.size)
+					_construct(_data() + storage_.size, value...);
+			}
+		}
+
+		constexpr const_reference _at(size_type pos) const
+		{
+			if (pos < storage_.size)
+				return _data()[pos];
+			else
+				throw std::out_of_range("static_vector index out of range");
+		}
+
+	}; //template static_vector
+
+
+	//specialized algorithms
+	template<typename T, std::size_t N>
+	constexpr void swap(static_vector<T, N>& x, static_vector<T, N>& y) noexcept(noexcept(x.swap(y)))
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: see C++17 [container.requirements.general]
+	template<typename T, std::size_t N>
+	constexpr bool operator==(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return x.size() == y.size() && detail::equal_elements(x.data(), y.data(), x.size());
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator!=(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return detail::less_elements<T, detail::is_short_block_v<T, N>>(x.data(), x.size(), y.data(), y.size());
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return y < x;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<=(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>=(const static_vector<T, N>& x, const static_vector<T, N>& y)
+	{
+		return !(x < y);
+	}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	template<typename T, std::size_t N>
+	constexpr std::compare_three_way_result_t<T> operator<=>(const static_vector<T, N>& x,
+		const static_vector<T, N>& y)
+	{
+		return detail::three_way_elements<T, detail::is_short_block_v<T, N>>(x.data(), x.size(), y.data(), y.size());
+	}
+#endif
+
+}	//namespace sigcpp
+
+#endif
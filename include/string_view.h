@@ -0,0 +1,674 @@
+/*
+* string_view.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define char traits and a class template for string views
+* - see C++17 [char.traits], [string.view]
+* - https://timsong-cpp.github.io/cppwp/n4659/char.traits
+* - https://timsong-cpp.github.io/cppwp/n4659/string.view
+*
+* Finders on views of char use SIMD kernels (see char_search.h) unless evaluated at compile time
+*/
+
+#ifndef SIGCPP_STRING_VIEW_H
+#define SIGCPP_STRING_VIEW_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "array_iterator.h"
+#include "char_search.h"
+#include "search.h"
+#include "simd.h"
+
+namespace sigcpp
+{
+	namespace detail
+	{
+		//shortest pattern for which string_view::find uses Two-Way instead of the naive search
+		constexpr std::size_t two_way_min_size = 32;
+
+		//a contiguous range of CharT: data() is a pointer to CharT and size() its length
+		//e.g. std::string, std::string_view, sigcpp::vector<char>
+		template<typename R, typename CharT, typename = void>
+		struct is_char_range : std::false_type {};
+
+		template<typename R, typename CharT>
+		struct is_char_range<R, CharT, std::void_t<decltype(std::declval<const R&>().data()),
+			decltype(std::declval<const R&>().size())>>
+			: std::bool_constant<std::is_convertible_v<decltype(std::declval<const R&>().data()), const CharT*> &&
+				std::is_same_v<std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const R&>().data())>>, CharT>> {};
+	}
+
+
+	//char traits: the members used by string_view
+	template<typename CharT>
+	struct char_traits
+	{
+		using char_type = CharT;
+		using int_type = typename std::char_traits<CharT>::int_type;
+
+		static constexpr bool eq(char_type c, char_type d) noexcept { return c == d; }
+
+		//compare char as unsigned char: see [char.traits.specializations.char]
+		static constexpr bool lt(char_type c, char_type d) noexcept
+		{
+			if constexpr (std::is_same_v<char_type, char>)
+				return static_cast<unsigned char>(c) < static_cast<unsigned char>(d);
+			else
+				return c < d;
+		}
+
+		static constexpr int compare(const char_type* s1, const char_type* s2, std::size_t n)
+		{
+			if constexpr (std::is_same_v<char_type, char>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+					return n == 0 ? 0 : std::memcmp(s1, s2, n);
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				if (lt(s1[i], s2[i]))
+					return -1;
+				if (lt(s2[i], s1[i]))
+					return 1;
+			}
+			return 0;
+		}
+
+		static constexpr std::size_t length(const char_type* s)
+		{
+			if constexpr (std::is_same_v<char_type, char>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+					return std::strlen(s);
+			}
+
+			std::size_t n = 0;
+			while (!eq(s[n], char_type()))
+				++n;
+			return n;
+		}
+
+		static constexpr const char_type* find(const char_type* s, std::size_t n, const char_type& a)
+		{
+			if constexpr (std::is_same_v<char_type, char>) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED()) {
+					const auto pos = detail::find_char(s, n, a);
+					return pos == detail::not_found ? nullptr : s + pos;
+				}
+			}
+
+			for (std::size_t i = 0; i < n; ++i)
+				if (eq(s[i], a))
+					return s + i;
+			return nullptr;
+		}
+
+		static char_type* copy(char_type* s1, const char_type* s2, std::size_t n)
+		{
+			return n == 0 ? s1 : static_cast<char_type*>(std::memcpy(s1, s2, n * sizeof(char_type)));
+		}
+	};
+
+
+	template<typename CharT, typename Traits = char_traits<CharT>>
+	class basic_string_view
+	{
+	public:
+		//types
+		using traits_type = Traits;
+		using value_type = CharT;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using const_iterator = array_iterator<const_pointer>;
+		using iterator = const_iterator;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using reverse_iterator = const_reverse_iterator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		static constexpr size_type npos = size_type(-1);
+
+		//ctors and assignment
+		constexpr basic_string_view() noexcept = default;
+		constexpr basic_string_view(const basic_string_view&) noexcept = default;
+		constexpr basic_string_view& operator=(const basic_string_view&) noexcept = default;
+
+		constexpr basic_string_view(const_pointer str) : data_{ str }, size_{ traits_type::length(str) } {}
+
+		constexpr basic_string_view(const_pointer str, size_type len) : data_{ str }, size_{ len } {}
+
+		//a contiguous range of chars, such as std::string or std::string_view
+		template<typename R, typename = std::enable_if_t<!std::is_same_v<R, basic_string_view> &&
+			detail::is_char_range<R, CharT>::value>>
+		constexpr basic_string_view(const R& r) noexcept(noexcept(r.data()) && noexcept(r.size()))
+			: data_{ r.data() }, size_{ static_cast<size_type>(r.size()) } {}
+
+		//explicit: with an implicit conversion each way, comparing with std::basic_string_view
+		//would be ambiguous
+		explicit constexpr operator std::basic_string_view<CharT>() const noexcept
+		{
+			return std::basic_string_view<CharT>(data_, size_);
+		}
+
+		//iterators
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+		constexpr const_iterator cbegin() const noexcept { return const_iterator(data_); }
+		constexpr const_iterator cend() const noexcept { return const_iterator(data_ + size_); }
+
+		constexpr const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(cend());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(cbegin());
+		}
+
+		//capacity
+		constexpr size_type size() const noexcept { return size_; }
+		constexpr size_type length() const noexcept { return size_; }
+		constexpr size_type max_size() const noexcept { return npos / sizeof(value_type) - 1; }
+		[[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+		//unchecked element access
+		constexpr const_reference operator[](size_type pos) const { return data_[pos]; }
+		constexpr const_reference front() const { return data_[0]; }
+		constexpr const_reference back() const { return data_[size_ - 1]; }
+		constexpr const_pointer data() const noexcept { return data_; }
+
+		//checked element access
+		constexpr const_reference at(size_type pos) const
+		{
+			if (pos >= size_)
+				throw std::out_of_range("string_view index out of range");
+			return data_[pos];
+		}
+
+		//modifiers
+		constexpr void remove_prefix(size_type n)
+		{
+			data_ += n;
+			size_ -= n;
+		}
+
+		constexpr void remove_suffix(size_type n) { size_ -= n; }
+
+		constexpr void swap(basic_string_view& s) noexcept
+		{
+			std::swap(data_, s.data_);
+			std::swap(size_, s.size_);
+		}
+
+		//operations
+		size_type copy(pointer s, size_type n, size_type pos = 0) const
+		{
+			const size_type rlen = _clamp_length(pos, n, "string_view::copy");
+			traits_type::copy(s, data_ + pos, rlen);
+			return rlen;
+		}
+
+		constexpr basic_string_view substr(size_type pos = 0, size_type n = npos) const
+		{
+			const size_type rlen = _clamp_length(pos, n, "string_view::substr");
+			return basic_string_view(data_ + pos, rlen);
+		}
+
+		constexpr int compare(basic_string_view s) const noexcept
+		{
+			const size_type rlen = std::min(size_, s.size_);
+			const int result = traits_type::compare(data_, s.data_, rlen);
+			if (result != 0)
+				return result;
+			return size_ == s.size_ ? 0 : (size_ < s.size_ ? -1 : 1);
+		}
+
+		constexpr int compare(size_type pos1, size_type n1, basic_string_view s) const
+		{
+			return substr(pos1, n1).compare(s);
+		}
+
+		constexpr int compare(size_type pos1, size_type n1, basic_string_view s,
+			size_type pos2, size_type n2) const
+		{
+			return substr(pos1, n1).compare(s.substr(pos2, n2));
+		}
+
+		constexpr int compare(const_pointer s) const { return compare(basic_string_view(s)); }
+
+		constexpr int compare(size_type pos1, size_type n1, const_pointer s) const
+		{
+			return substr(pos1, n1).compare(basic_string_view(s));
+		}
+
+		constexpr int compare(size_type pos1, size_type n1, const_pointer s, size_type n2) const
+		{
+			return substr(pos1, n1).compare(basic_string_view(s, n2));
+		}
+
+		//searching
+		constexpr size_type find(basic_string_view s, size_type pos = 0) const noexcept
+		{
+			return find(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type find(value_type c, size_type pos = 0) const noexcept
+		{
+			if (pos >= size_)
+				return npos;
+
+			const const_pointer p = traits_type::find(data_ + pos, size_ - pos, c);
+			return p == nullptr ? npos : static_cast<size_type>(p - data_);
+		}
+
+		//short patterns: find the first char of s, then compare the rest
+		//long patterns of char: Two-Way search, which is linear in the worst case
+		constexpr size_type find(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			if (n == 0)
+				return pos <= size_ ? pos : npos;
+			if (n > size_)
+				return npos;
+
+			if constexpr (_uses_char_kernels()) {
+				if (n >= detail::two_way_min_size && pos <= size_) {
+					const const_pointer first = data_ + pos, last = data_ + size_;
+					const const_pointer p = two_way_searcher<const_pointer>(s, s + n)(first, last).first;
+					return p == last ? npos : static_cast<size_type>(p - data_);
+				}
+			}
+
+			const size_type last = size_ - n;
+			while (pos <= last) {
+				const const_pointer p = traits_type::find(data_ + pos, last - pos + 1, s[0]);
+				if (p == nullptr)
+					return npos;
+
+				pos = static_cast<size_type>(p - data_);
+				if (traits_type::compare(p + 1, s + 1, n - 1) == 0)
+					return pos;
+				++pos;
+			}
+			return npos;
+		}
+
+		constexpr size_type find(const_pointer s, size_type pos = 0) const
+		{
+			return find(s, pos, traits_type::length(s));
+		}
+
+		constexpr size_type rfind(basic_string_view s, size_type pos = npos) const noexcept
+		{
+			return rfind(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type rfind(value_type c, size_type pos = npos) const noexcept
+		{
+			if (size_ == 0)
+				return npos;
+
+			const size_type n = std::min(pos, size_ - 1) + 1;
+			if constexpr (_uses_char_kernels()) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+					return _from_kernel(detail::rfind_char(data_, n, c));
+			}
+
+			for (size_type i = n; i-- != 0; )
+				if (traits_type::eq(data_[i], c))
+					return i;
+			return npos;
+		}
+
+		constexpr size_type rfind(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			if (n > size_)
+				return npos;
+
+			size_type i = std::min(pos, size_ - n);
+			if (n == 0)
+				return i;
+
+			//find the last char of s, then compare the rest
+			const value_type last_char = s[n - 1];
+			while (true) {
+				const size_type j = rfind(last_char, i + n - 1);
+				if (j == npos || j < n - 1)
+					return npos;
+
+				i = j - (n - 1);
+				if (traits_type::compare(data_ + i, s, n - 1) == 0)
+					return i;
+				if (i == 0)
+					return npos;
+				--i;
+			}
+		}
+
+		constexpr size_type rfind(const_pointer s, size_type pos = npos) const
+		{
+			return rfind(s, pos, traits_type::length(s));
+		}
+
+		constexpr size_type find_first_of(basic_string_view s, size_type pos = 0) const noexcept
+		{
+			return find_first_of(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type find_first_of(value_type c, size_type pos = 0) const noexcept
+		{
+			return find(c, pos);
+		}
+
+		constexpr size_type find_first_of(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			return _find_first(s, pos, n, true);
+		}
+
+		constexpr size_type find_first_of(const_pointer s, size_type pos = 0) const
+		{
+			return find_first_of(s, pos, traits_type::length(s));
+		}
+
+		constexpr size_type find_last_of(basic_string_view s, size_type pos = npos) const noexcept
+		{
+			return find_last_of(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type find_last_of(value_type c, size_type pos = npos) const noexcept
+		{
+			return rfind(c, pos);
+		}
+
+		constexpr size_type find_last_of(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			return _find_last(s, pos, n, true);
+		}
+
+		constexpr size_type find_last_of(const_pointer s, size_type pos = npos) const
+		{
+			return find_last_of(s, pos, traits_type::length(s));
+		}
+
+		constexpr size_type find_first_not_of(basic_string_view s, size_type pos = 0) const noexcept
+		{
+			return find_first_not_of(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type find_first_not_of(value_type c, size_type pos = 0) const noexcept
+		{
+			return find_first_not_of(&c, pos, 1);
+		}
+
+		constexpr size_type find_first_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			return _find_first(s, pos, n, false);
+		}
+
+		constexpr size_type find_first_not_of(const_pointer s, size_type pos = 0) const
+		{
+			return find_first_not_of(s, pos, traits_type::length(s));
+		}
+
+		constexpr size_type find_last_not_of(basic_string_view s, size_type pos = npos) const noexcept
+		{
+			return find_last_not_of(s.data_, pos, s.size_);
+		}
+
+		constexpr size_type find_last_not_of(value_type c, size_type pos = npos) const noexcept
+		{
+			return find_last_not_of(&c, pos, 1);
+		}
+
+		constexpr size_type find_last_not_of(const_pointer s, size_type pos, size_type n) const noexcept
+		{
+			return _find_last(s, pos, n, false);
+		}
+
+		constexpr size_type find_last_not_of(const_pointer s, size_type pos = npos) const
+		{
+			return find_last_not_of(s, pos, traits_type::length(s));
+		}
+
+	private:
+		const_pointer data_{ nullptr };
+		size_type size_{ 0 };
+
+		//utility functions to eliminate redundancy in public members
+
+		//SIMD kernels apply only to char with the default or the std traits
+		static constexpr bool _uses_char_kernels()
+		{
+			return std::is_same_v<value_type, char> &&
+				(std::is_same_v<traits_type, char_traits<char>> ||
+					std::is_same_v<traits_type, std::char_traits<char>>);
+		}
+
+		static constexpr size_type _from_kernel(std::size_t pos)
+		{
+			return pos == detail::not_found ? npos : pos;
+		}
+
+		//length of the range starting at pos with at most n chars
+		constexpr size_type _clamp_length(size_type pos, size_type n, const char* what) const
+		{
+			if (pos > size_)
+				throw std::out_of_range(what);
+			return std::min(n, size_ - pos);
+		}
+
+		static constexpr bool _in(const_pointer s, size_type n, value_type c)
+		{
+			for (size_type i = 0; i < n; ++i)
+				if (traits_type::eq(s[i], c))
+					return true;
+			return false;
+		}
+
+		//first position at or after pos whose membership in [s, s + n) equals in_set
+		constexpr size_type _find_first(const_pointer s, size_type pos, size_type n, bool in_set) const
+		{
+			if (pos >= size_ || (in_set && n == 0))
+				return npos;
+
+			if constexpr (_uses_char_kernels()) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED()) {
+					const auto i = detail::find_in_set(data_ + pos, size_ - pos, s, n, in_set);
+					return i == detail::not_found ? npos : pos + i;
+				}
+			}
+
+			for (size_type i = pos; i < size_; ++i)
+				if (_in(s, n, data_[i]) == in_set)
+					return i;
+			return npos;
+		}
+
+		//last position at or before pos whose membership in [s, s + n) equals in_set
+		constexpr size_type _find_last(const_pointer s, size_type pos, size_type n, bool in_set) const
+		{
+			if (size_ == 0 || (in_set && n == 0))
+				return npos;
+
+			const size_type count = std::min(pos, size_ - 1) + 1;
+			if constexpr (_uses_char_kernels()) {
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+					return _from_kernel(detail::rfind_in_set(data_, count, s, n, in_set));
+			}
+
+			for (size_type i = count; i-- != 0; )
+				if (_in(s, n, data_[i]) == in_set)
+					return i;
+			return npos;
+		}
+
+	}; //template basic_string_view
+
+
+	namespace detail
+	{
+		//a type in a non-deduced context: lets one operand of a comparison convert to a view
+		//see C++17 [string.view.comparison]
+		template<typename T>
+		struct type_identity { using type = T; };
+
+		template<typename T>
+		using type_identity_t = typename type_identity<T>::type;
+	}
+
+
+	//non-member comparison: each operator has 3 overloads so that either operand may be
+	//any type implicitly convertible to a view
+	template<typename CharT, typename Traits>
+	constexpr bool operator==(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.size() == y.size() && x.compare(y) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator==(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return x.size() == y.size() && x.compare(y) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator==(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.size() == y.size() && x.compare(y) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator!=(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return !(x == y);
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator!=(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return !(x == y);
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator!=(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return !(x == y);
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) < 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return x.compare(y) < 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) < 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) > 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return x.compare(y) > 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) > 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<=(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) <= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<=(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return x.compare(y) <= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator<=(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) <= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>=(basic_string_view<CharT, Traits> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) >= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>=(basic_string_view<CharT, Traits> x,
+		detail::type_identity_t<basic_string_view<CharT, Traits>> y) noexcept
+	{
+		return x.compare(y) >= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	constexpr bool operator>=(detail::type_identity_t<basic_string_view<CharT, Traits>> x,
+		basic_string_view<CharT, Traits> y) noexcept
+	{
+		return x.compare(y) >= 0;
+	}
+
+
+	//typedef names
+	using string_view = basic_string_view<char>;
+	using wstring_view = basic_string_view<wchar_t>;
+	using u16string_view = basic_string_view<char16_t>;
+	using u32string_view = basic_string_view<char32_t>;
+
+}	//namespace sigcpp
+
+#endif
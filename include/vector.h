@@ -0,0 +1,678 @@
+/*
+* vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for growable arrays
+* - see C++17 [vector] https://timsong-cpp.github.io/cppwp/n4659/vector
+* - the growth policy is a template parameter: see growth_factor
+* - growth, reserve, and shrink_to_fit relocate trivially relocatable elements with one
+*   memcpy rather than a move per element (see relocate.h)
+* - with std::allocator and a trivially relocatable T, the buffer is managed with
+*   malloc/realloc/free instead: realloc may extend the buffer in place, and if it cannot,
+*   it copies the bytes itself
+*/
+
+#ifndef SIGCPP_VECTOR_H
+#define SIGCPP_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+
+#include "array.h"
+#include "array_iterator.h"
+#include "relocate.h"
+
+namespace sigcpp
+{
+	//growth policy: multiply the capacity by Num / Den when the vector is full
+	//a policy is any type with a static next_capacity(capacity, required, max) that returns
+	//a capacity of at least required and at most max
+	template<std::size_t Num, std::size_t Den>
+	struct growth_factor
+	{
+		static_assert(Den != 0 && Num > Den, "growth factor must be greater than 1");
+
+		static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required,
+			std::size_t max) noexcept
+		{
+			const auto grown = capacity > max / Num * Den ? max : capacity * Num / Den;
+			return std::max(required, grown);
+		}
+	};
+
+	//1.5 rather than 2: after a few steps, the blocks freed earlier add up to the next request,
+	//so the allocator can reuse them (a factor of 2 never can)
+	using default_growth = growth_factor<3, 2>;
+
+
+	template<typename T, typename Allocator = std::allocator<T>, typename Growth = default_growth>
+	class vector
+	{
+		using alloc_traits = std::allocator_traits<Allocator>;
+
+		//manage the buffer with malloc/realloc/free
+		static constexpr bool uses_realloc = std::is_same_v<Allocator, std::allocator<T>> &&
+			is_trivially_relocatable_v<T> && alignof(T) <= alignof(std::max_align_t);
+
+	public:
+		//types
+		using value_type = T;
+		using allocator_type = Allocator;
+		using growth_policy = Growth;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = array_iterator<pointer>;
+		using const_iterator = array_iterator<const_pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static_assert(std::is_same_v<typename alloc_traits::value_type, T>, "allocator must allocate T");
+
+		//ctors
+		vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) : impl_{ Allocator() } {}
+		explicit vector(const Allocator& alloc) noexcept : impl_{ alloc } {}
+
+		explicit vector(size_type count, const Allocator& alloc = Allocator()) : impl_{ alloc }
+		{
+			resize(count);
+		}
+
+		vector(size_type count, const T& value, const Allocator& alloc = Allocator()) : impl_{ alloc }
+		{
+			assign(count, value);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		vector(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : impl_{ alloc }
+		{
+			assign(first, last);
+		}
+
+		vector(std::initializer_list<T> il, const Allocator& alloc = Allocator()) : impl_{ alloc }
+		{
+			assign(il.begin(), il.end());
+		}
+
+		vector(const vector& v) : impl_{ alloc_traits::select_on_container_copy_construction(v.get_allocator()) }
+		{
+			_append_copy(v);
+		}
+
+		vector(vector&& v) noexcept : impl_{ std::move(v.impl_.alloc()) }
+		{
+			_take(v);
+		}
+
+		//allocator-extended copy and move: see uses-allocator construction
+		vector(const vector& v, const Allocator& alloc) : impl_{ alloc }
+		{
+			_append_copy(v);
+		}
+
+		//steal v's buffer only if the allocators are equal; else move element by element
+		vector(vector&& v, const Allocator& alloc) : impl_{ alloc }
+		{
+			if (alloc_traits::is_always_equal::value || impl_.alloc() == v.impl_.alloc())
+				_take(v);
+			else {
+				reserve(v.size());
+				for (auto& e : v) {
+					_construct(impl_.data + impl_.size, std::move(e));
+					++impl_.size;
+				}
+				v.clear();
+			}
+		}
+
+		~vector() { _release(); }
+
+		//assignment
+		//adopt v's allocator if it propagates: free the buffer first if the allocators differ
+		vector& operator=(const vector& v)
+		{
+			if (this != &v) {
+				if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+					if (!alloc_traits::is_always_equal::value && !(impl_.alloc() == v.impl_.alloc()))
+						_release();
+					impl_.alloc() = v.impl_.alloc();
+				}
+				clear();
+				_append_copy(v);
+			}
+			return *this;
+		}
+
+		//steal the buffer if the allocators allow it; else move element by element
+		vector& operator=(vector&& v) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+			alloc_traits::is_always_equal::value)
+		{
+			if (this == &v)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+				_release();
+				impl_.alloc() = std::move(v.impl_.alloc());
+				_take(v);
+			}
+			else if (alloc_traits::is_always_equal::value || impl_.alloc() == v.impl_.alloc()) {
+				_release();
+				_take(v);
+			}
+			else {
+				clear();
+				reserve(v.size());
+				for (auto& e : v) {
+					_construct(impl_.data + impl_.size, std::move(e));
+					++impl_.size;
+				}
+				v.clear();
+			}
+			return *this;
+		}
+
+		vector& operator=(std::initializer_list<T> il)
+		{
+			assign(il.begin(), il.end());
+			return *this;
+		}
+
+		void assign(size_type count, const T& value)
+		{
+			clear();
+			reserve(count);
+			for (; impl_.size < count; ++impl_.size)
+				_construct(impl_.data + impl_.size, value);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		void assign(InputIt first, InputIt last)
+		{
+			clear();
+			if constexpr (detail::is_forward_iterator_v<InputIt>)
+				reserve(static_cast<size_type>(std::distance(first, last)));
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+		allocator_type get_allocator() const noexcept { return impl_.alloc(); }
+
+		//iterators
+		iterator begin() noexcept { return iterator(impl_.data); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(impl_.data + impl_.size); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(impl_.data); }
+		const_iterator cend() const noexcept { return const_iterator(impl_.data + impl_.size); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+		//capacity
+		bool empty() const noexcept { return impl_.size == 0; }
+		size_type size() const noexcept { return impl_.size; }
+		size_type capacity() const noexcept { return impl_.capacity; }
+
+		size_type max_size() const noexcept
+		{
+			if constexpr (uses_realloc)
+				return static_cast<size_type>(PTRDIFF_MAX) / sizeof(T);
+			else
+				return alloc_traits::max_size(impl_.alloc());
+		}
+
+		void reserve(size_type count)
+		{
+			if (count > impl_.capacity)
+				_reallocate(count);
+		}
+
+		void shrink_to_fit()
+		{
+			if (impl_.size < impl_.capacity)
+				_reallocate(impl_.size);
+		}
+
+		void resize(size_type count) { _resize(count); }
+		void resize(size_type count, const T& value)
+		{
+			//value may alias an element that reallocation frees
+			if (count > impl_.capacity) {
+				const T copy(value);
+				_resize(count, copy);
+			}
+			else
+				_resize(count, value);
+		}
+
+		//unchecked element access
+		reference operator[](size_type pos) { return impl_.data[pos]; }
+		const_reference operator[](size_type pos) const { return impl_.data[pos]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			return const_cast<reference>(_at(pos));
+		}
+
+		const_reference at(size_type pos) const { return _at(pos); }
+
+		reference front() { return impl_.data[0]; }
+		const_reference front() const { return impl_.data[0]; }
+		reference back() { return impl_.data[impl_.size - 1]; }
+		const_reference back() const { return impl_.data[impl_.size - 1]; }
+
+		//underlying raw data
+		pointer data() noexcept { return impl_.data; }
+		const_pointer data() const noexcept { return impl_.data; }
+
+		//modifiers
+		template<typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			if (impl_.size == impl_.capacity)
+				return _emplace_back_grow(std::forward<Args>(args)...);
+
+			const auto p = impl_.data + impl_.size;
+			_construct(p, std::forward<Args>(args)...);
+			++impl_.size;
+			return *p;
+		}
+
+		void push_back(const T& value) { emplace_back(value); }
+		void push_back(T&& value) { emplace_back(std::move(value)); }
+
+		void pop_back()
+		{
+			--impl_.size;
+			_destroy(impl_.data + impl_.size, impl_.data + impl_.size + 1);
+		}
+
+		//construct the new element first: args may refer to an element of this vector
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			if (index == impl_.size) {
+				emplace_back(std::forward<Args>(args)...);
+				return begin() + index;
+			}
+
+			T value(std::forward<Args>(args)...);
+			reserve(_next_capacity(impl_.size + 1));
+
+			const auto p = impl_.data;
+			if constexpr (is_trivially_relocatable_v<T>) {
+				std::memmove(static_cast<void*>(p + index + 1), static_cast<const void*>(p + index),
+					(impl_.size - index) * sizeof(T));
+				_construct(p + index, std::move(value));
+			}
+			else {
+				_construct(p + impl_.size, std::move(p[impl_.size - 1]));
+				std::move_backward(p + index, p + impl_.size - 1, p + impl_.size);
+				p[index] = std::move(value);
+			}
+			++impl_.size;
+			return begin() + index;
+		}
+
+		iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+		iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+		iterator insert(const_iterator pos, size_type count, const T& value)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const T copy(value);
+			reserve(_next_capacity(impl_.size + count));
+			for (size_type i = 0; i < count; ++i, ++impl_.size)
+				_construct(impl_.data + impl_.size, copy);
+			return _rotate_back(index, count);
+		}
+
+		template<typename InputIt, typename = detail::enable_if_input_iterator_t<InputIt>>
+		iterator insert(const_iterator pos, InputIt first, InputIt last)
+		{
+			const auto index = static_cast<size_type>(pos - cbegin());
+			const auto old_size = impl_.size;
+			if constexpr (detail::is_forward_iterator_v<InputIt>)
+				reserve(_next_capacity(impl_.size + static_cast<size_type>(std::distance(first, last))));
+
+			for (; first != last; ++first)
+				emplace_back(*first);
+			return _rotate_back(index, impl_.size - old_size);
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<T> il)
+		{
+			return insert(pos, il.begin(), il.end());
+		}
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const auto index = static_cast<size_type>(first - cbegin());
+			const auto count = static_cast<size_type>(last - first);
+			if (count == 0)
+				return begin() + index;
+
+			const auto p = impl_.data;
+			if constexpr (is_trivially_relocatable_v<T>) {
+				_destroy(p + index, p + index + count);
+				if (last != cend())
+					std::memmove(static_cast<void*>(p + index), static_cast<const void*>(p + index + count),
+						static_cast<size_type>(cend() - last) * sizeof(T));
+			}
+			else {
+				std::move(p + index + count, p + impl_.size, p + index);
+				_destroy(p + impl_.size - count, p + impl_.size);
+			}
+			impl_.size -= count;
+			return begin() + index;
+		}
+
+		void clear() noexcept
+		{
+			_destroy(impl_.data, impl_.data + impl_.size);
+			impl_.size = 0;
+		}
+
+		void swap(vector& v) noexcept
+		{
+			std::swap(impl_.data, v.impl_.data);
+			std::swap(impl_.size, v.impl_.size);
+			std::swap(impl_.capacity, v.impl_.capacity);
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+				std::swap(impl_.alloc(), v.impl_.alloc());
+		}
+
+	private:
+		//data pointer, size, and capacity; derives from the allocator so that an empty one
+		//takes no space
+		struct impl : Allocator
+		{
+			pointer data{ nullptr };
+			size_type size{ 0 };
+			size_type capacity{ 0 };
+
+			explicit impl(const Allocator& a) noexcept : Allocator(a) {}
+			explicit impl(Allocator&& a) noexcept : Allocator(std::move(a)) {}
+
+			Allocator& alloc() noexcept { return *this; }
+			const Allocator& alloc() const noexcept { return *this; }
+		};
+
+		impl impl_;
+
+		//elements are built and ended through the allocator: see uses-allocator construction
+		template<typename... Args>
+		void _construct(pointer p, Args&&... args)
+		{
+			alloc_traits::construct(impl_.alloc(), p, std::forward<Args>(args)...);
+		}
+
+		void _destroy(pointer first, pointer last) noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				for (; first != last; ++first)
+					alloc_traits::destroy(impl_.alloc(), first);
+		}
+
+		//buffer management
+		pointer _allocate(size_type count)
+		{
+			if constexpr (uses_realloc) {
+				const auto p = static_cast<pointer>(std::malloc(count * sizeof(T)));
+				if (p == nullptr)
+					throw std::bad_alloc();
+				return p;
+			}
+			else
+				return alloc_traits::allocate(impl_.alloc(), count);
+		}
+
+		void _deallocate(pointer p, size_type count) noexcept
+		{
+			if (p == nullptr)
+				return;
+			if constexpr (uses_realloc)
+				std::free(p);
+			else
+				alloc_traits::deallocate(impl_.alloc(), p, count);
+		}
+
+		//capacity to hold count elements, as the growth policy decides
+		size_type _next_capacity(size_type count) const
+		{
+			if (count <= impl_.capacity)
+				return impl_.capacity;
+			if (count > max_size())
+				throw std::length_error("vector too long");
+			return Growth::next_capacity(impl_.capacity, count, max_size());
+		}
+
+		//move the elements to a buffer of the given capacity
+		void _reallocate(size_type capacity)
+		{
+			if (capacity > max_size())
+				throw std::length_error("vector too long");
+
+			if (capacity == 0) {
+				_deallocate(impl_.data, impl_.capacity);
+				impl_.data = nullptr;
+				impl_.capacity = 0;
+				return;
+			}
+
+			if constexpr (uses_realloc) {
+				const auto p = static_cast<pointer>(std::realloc(impl_.data, capacity * sizeof(T)));
+				if (p == nullptr)
+					throw std::bad_alloc();
+				impl_.data = p;
+			}
+			else {
+				const auto p = _allocate(capacity);
+				try {
+					detail::relocate(impl_.data, impl_.size, p);
+				}
+				catch (...) {
+					_deallocate(p, capacity);
+					throw;
+				}
+				_deallocate(impl_.data, impl_.capacity);
+				impl_.data = p;
+			}
+			impl_.capacity = capacity;
+		}
+
+		//args may refer to an element, which the buffer change may move or free
+		template<typename... Args>
+		reference _emplace_back_grow(Args&&... args)
+		{
+			const auto capacity = _next_capacity(impl_.size + 1);
+
+			if constexpr (uses_realloc) {
+				T value(std::forward<Args>(args)...);
+				_reallocate(capacity);
+				const auto p = impl_.data + impl_.size;
+				_construct(p, std::move(value));
+				++impl_.size;
+				return *p;
+			}
+			else {
+				//build the new element in the new buffer before the old elements move
+				const auto p = _allocate(capacity);
+				try {
+					_construct(p + impl_.size, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					_deallocate(p, capacity);
+					throw;
+				}
+
+				try {
+					detail::relocate(impl_.data, impl_.size, p);
+				}
+				catch (...) {
+					_destroy(p + impl_.size, p + impl_.size + 1);
+					_deallocate(p, capacity);
+					throw;
+				}
+
+				_deallocate(impl_.data, impl_.capacity);
+				impl_.data = p;
+				impl_.capacity = capacity;
+				return p[impl_.size++];
+			}
+		}
+
+		//destroy the elements and free the buffer
+		void _release() noexcept
+		{
+			clear();
+			_deallocate(impl_.data, impl_.capacity);
+			impl_.data = nullptr;
+			impl_.capacity = 0;
+		}
+
+		//steal v's buffer; this vector must have no buffer on entry; v is left empty
+		void _take(vector& v) noexcept
+		{
+			impl_.data = std::exchange(v.impl_.data, nullptr);
+			impl_.size = std::exchange(v.impl_.size, 0);
+			impl_.capacity = std::exchange(v.impl_.capacity, 0);
+		}
+
+		void _append_copy(const vector& v)
+		{
+			reserve(v.size());
+			if constexpr (std::is_trivially_copyable_v<T> && !detail::has_allocator_construct_v<Allocator, T>) {
+				if (v.size() != 0)
+					std::memcpy(static_cast<void*>(impl_.data), static_cast<const void*>(v.data()),
+						v.size() * sizeof(T));
+				impl_.size = v.size();
+			}
+			else {
+				for (const auto& e : v) {
+					_construct(impl_.data + impl_.size, e);
+					++impl_.size;
+				}
+			}
+		}
+
+		//move the last count elements to index
+		iterator _rotate_back(size_type index, size_type count)
+		{
+			std::rotate(impl_.data + index, impl_.data + impl_.size - count, impl_.data + impl_.size);
+			return begin() + index;
+		}
+
+		template<typename... Args>
+		void _resize(size_type count, const Args&... value)
+		{
+			if (count < impl_.size) {
+				_destroy(impl_.data + count, impl_.data + impl_.size);
+				impl_.size = count;
+			}
+			else {
+				reserve(_next_capacity(count));
+				for (; impl_.size < count; ++impl_.size)
+					_construct(impl_.data + impl_.size, value...);
+			}
+		}
+
+		const_reference _at(size_type pos) const
+		{
+			if (pos < impl_.size)
+				return impl_.data[pos];
+			else
+				throw std::out_of_range("vector index out of range");
+		}
+
+	}; //template vector
+
+
+	//specialized algorithms
+	template<typename T, typename Allocator, typename Growth>
+	void swap(vector<T, Allocator, Growth>& x, vector<T, Allocator, Growth>& y) noexcept
+	{
+		x.swap(y);
+	}
+
+
+	//comparison: see C++17 [container.requirements.general]
+	template<typename T, typename Allocator, typename Growth>
+	bool operator==(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return x.size() == y.size() && detail::equal_elements(x.data(), y.data(), x.size());
+	}
+
+	template<typename T, typename Allocator, typename Growth>
+	bool operator!=(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return !(x == y);
+	}
+
+	template<typename T, typename Allocator, typename Growth>
+	bool operator<(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return detail::less_elements(x.data(), x.size(), y.data(), y.size());
+	}
+
+	template<typename T, typename Allocator, typename Growth>
+	bool operator>(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return y < x;
+	}
+
+	template<typename T, typename Allocator, typename Growth>
+	bool operator<=(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return !(y < x);
+	}
+
+	template<typename T, typename Allocator, typename Growth>
+	bool operator>=(const vector<T, Allocator, Growth>& x, const vector<T, Allocator, Growth>& y)
+	{
+		return !(x < y);
+	}
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	template<typename T, typename Allocator, typename Growth>
+	std::compare_three_way_result_t<T> operator<=>(const vector<T, Allocator, Growth>& x,
+		const vector<T, Allocator, Growth>& y)
+	{
+		return detail::three_way_elements(x.data(), x.size(), y.data(), y.size());
+	}
+#endif
+
+}	//namespace sigcpp
+
+#endif
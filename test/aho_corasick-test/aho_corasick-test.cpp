@@ -0,0 +1,120 @@
+/*
+* aho_corasick-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for the Aho-Corasick multi-pattern matcher
+*/
+
+#include <string>
+#include <vector>
+
+#include "../../include/aho_corasick.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::aho_corasick;
+using sigcpp::string_view;
+
+void test_aho_corasick_build();
+void test_aho_corasick_matches();
+void test_aho_corasick_first();
+void test_aho_corasick_edge_cases();
+
+void aho_corasick_test()
+{
+	test_aho_corasick_build();
+	test_aho_corasick_matches();
+	test_aho_corasick_first();
+	test_aho_corasick_edge_cases();
+}
+
+
+void test_aho_corasick_build()
+{
+	//classic example from the paper: 4 patterns over 5 distinct chars
+	aho_corasick ac{ "he", "she", "his", "hers" };
+	is_true(ac.pattern_count() == 4, "ac.pattern_count()");
+	is_true(ac.class_count() == 6, "ac.class_count()");
+	is_true(ac.state_count() == 10, "ac.state_count()");
+
+	//build from a range of strings
+	std::vector<string_view> keywords{ "alpha", "beta" };
+	aho_corasick ac_r(keywords.begin(), keywords.end());
+	is_true(ac_r.pattern_count() == 2, "ac_r.pattern_count()");
+	is_true(ac_r.contains_any("the beta test"), "ac_r.contains_any()");
+
+	//a range of std::string
+	std::vector<std::string> names{ "gamma", "delta", "epsilon" };
+	aho_corasick ac_s(names.begin(), names.end());
+	is_true(ac_s.pattern_count() == 3, "ac_s.pattern_count()");
+	is_true(ac_s.contains_any("a delta wing"), "ac_s.contains_any()");
+}
+
+
+//matches are reported by end position; at one end position, longest first
+void test_aho_corasick_matches()
+{
+	aho_corasick ac{ "he", "she", "his", "hers" };
+
+	//               0123456789
+	string_view text{ "ushers his" };
+	const auto matches = ac.find_all(text);
+
+	//expected (pattern, position): she@1, he@2, hers@2, his@7
+	const aho_corasick::match expected[]{ { 1, 1 }, { 0, 2 }, { 3, 2 }, { 2, 7 } };
+
+	bool match_test = matches.size() == 4;
+	for (std::size_t i = 0; i < 4 && match_test; ++i)
+		match_test = matches[i].pattern == expected[i].pattern && matches[i].position == expected[i].position;
+	is_true(match_test, "ac.find_all(text)");
+
+	//for_each_match sees the same matches
+	std::size_t count = 0;
+	ac.for_each_match(text, [&count](const aho_corasick::match&) { ++count; });
+	is_true(count == 4, "ac.for_each_match(text)");
+
+	//overlapping and nested patterns
+	aho_corasick ac_n{ "a", "aa", "aaa" };
+	is_true(ac_n.find_all("aaaa").size() == 9, "ac_n.find_all(aaaa)");
+}
+
+
+void test_aho_corasick_first()
+{
+	aho_corasick ac{ "error", "warn", "fatal" };
+
+	auto m = ac.find_first("[warn] disk low; [error] disk full");
+	is_true(m.pattern == 1 && m.position == 1, "ac.find_first(text)");
+
+	m = ac.find_first("[info] all good");
+	is_true(m.position == aho_corasick::npos, "ac.find_first(text) missing");
+	is_false(ac.contains_any("[info] all good"), "ac.contains_any(text) missing");
+}
+
+
+void test_aho_corasick_edge_cases()
+{
+	//no patterns: nothing matches
+	aho_corasick ac_empty;
+	is_true(ac_empty.find_all("anything").empty(), "ac_empty.find_all()");
+
+	//empty and duplicate patterns: empty never matches, duplicates each report
+	aho_corasick ac_dup{ "", "ab", "ab" };
+	const auto matches = ac_dup.find_all("xabx");
+	is_true(matches.size() == 2 && matches[0].pattern == 1 && matches[1].pattern == 2, "ac_dup.find_all()");
+	is_true(ac_dup.find_all("").empty(), "ac_dup.find_all(empty text)");
+
+	//chars with the high bit set and embedded nul
+	const char bytes[]{ 'x', '\xE9', '\0', 'y', '\xE9', '\0' };
+	string_view pattern{ bytes + 1, 2 };
+	aho_corasick ac_bytes{ pattern };
+	const auto found = ac_bytes.find_all(string_view(bytes, sizeof(bytes)));
+	is_true(found.size() == 2 && found[0].position == 1 && found[1].position == 4, "ac_bytes.find_all()");
+}
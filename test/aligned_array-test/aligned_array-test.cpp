@@ -0,0 +1,144 @@
+/*
+* aligned_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for aligned_array and padded_array
+*/
+
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+#include "../../include/aligned_array.h"
+
+#include "../verifiers.h"
+
+using sigcpp::aligned_array;
+using sigcpp::padded_array;
+
+void test_aligned_array();
+void test_padded_array_layout();
+void test_padded_array_interface();
+
+void aligned_array_test()
+{
+	test_aligned_array();
+	test_padded_array_layout();
+	test_padded_array_interface();
+}
+
+
+static bool is_aligned(const void* p, std::size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+
+void test_aligned_array()
+{
+	//on the stack, after an object that misaligns the next one
+	char c{ 'c' };
+	aligned_array<float, 8, 32> a{ 1, 2, 3, 4, 5, 6, 7, 8 };
+	is_true(c == 'c' && is_aligned(a.data(), 32), "a.data() aligned to 32");
+	is_true(alignof(decltype(a)) == 32 && decltype(a)::alignment == 32, "alignof(a)");
+
+	//on the heap
+	auto h = std::make_unique<aligned_array<double, 3>>();
+	is_true(is_aligned(h->data(), sigcpp::cache_line_size), "heap aligned_array data() aligned");
+
+	//array interface
+	is_true(a.size() == 8 && a[0] == 1 && a.back() == 8, "a.size(), a[0], a.back()");
+	is_true(std::accumulate(a.begin(), a.end(), 0.0f) == 36, "a iterators");
+	is_true(*a.rbegin() == 8, "a.rbegin()");
+
+	aligned_array<float, 8, 32> b;
+	b.fill(1);
+	is_true(std::count(b.begin(), b.end(), 1.0f) == 8, "b.fill()");
+
+	swap(a, b);
+	is_true(a[7] == 1 && b[7] == 8, "swap(a, b)");
+	is_true(a != b && a < b, "a != b, a < b");
+}
+
+
+//each element starts its own line, so threads updating neighbours do not share a line
+void test_padded_array_layout()
+{
+	padded_array<int, 4> p{ 1, 2, 3, 4 };
+	const auto line = sigcpp::cache_line_size;
+
+	bool layoutTest = true;
+	for (std::size_t i = 0; i < p.size() && layoutTest; ++i)
+		layoutTest = is_aligned(&p[i], line);
+	is_true(layoutTest, "padded_array elements aligned to a line");
+
+	const auto distance = reinterpret_cast<const char*>(&p[1]) - reinterpret_cast<const char*>(&p[0]);
+	is_true(distance == static_cast<std::ptrdiff_t>(line), "padded_array element distance");
+	is_true(sizeof(p) == 4 * line, "sizeof(padded_array)");
+
+	//custom padding
+	padded_array<char, 3, 128> q{};
+	is_true(is_aligned(&q[2], 128) && sizeof(q) == 3 * 128, "padded_array with 128-byte padding");
+}
+
+
+void test_padded_array_interface()
+{
+	padded_array<int, 5> p{ 5, 9, 3, 1, 6 };
+	const int expected[]{ 5, 9, 3, 1, 6 };
+
+	is_true(p.size() == 5 && !p.empty(), "p.size()");
+	is_true(p.front() == 5 && p.back() == 6 && p.at(2) == 3, "p.front(), p.back(), p.at()");
+
+	bool thrown = false;
+	try {
+		(void)p.at(5);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "p.at(size())");
+
+	is_true(std::equal(p.begin(), p.end(), expected), "p forward iterator");
+	is_true(std::equal(p.rbegin(), p.rend(), std::rbegin(expected)), "p reverse iterator");
+
+	//random access
+	auto first = p.begin();
+	is_true(p.end() - first == 5 && first[4] == 6 && *(2 + first) == 3, "p iterator arithmetic");
+	padded_array<int, 5>::const_iterator cfirst = first;
+	is_true(cfirst == p.cbegin(), "p const_iterator from iterator");
+
+	//iterator and const_iterator mix in either order
+	auto last = p.end();
+	auto clast = p.cend();
+	is_true(first == cfirst && cfirst == first, "p: it == cit, cit == it");
+	is_true(last != cfirst && cfirst != last, "p: it != cit, cit != it");
+	is_true(last - cfirst == 5 && clast - first == 5, "p: it - cit, cit - it");
+	is_true(first < clast && cfirst < last, "p: it < cit, cit < it");
+	is_true(last > cfirst && clast > first, "p: it > cit, cit > it");
+	is_true(first <= cfirst && cfirst <= last, "p: it <= cit, cit <= it");
+	is_true(last >= clast && clast >= first, "p: it >= cit, cit >= it");
+
+	std::sort(p.begin(), p.end());
+	is_true(std::is_sorted(p.cbegin(), p.cend()) && p[0] == 1 && p[4] == 9, "std::sort(p)");
+
+	padded_array<int, 5> q;
+	q.fill(7);
+	is_true(std::all_of(q.begin(), q.end(), [](int e) { return e == 7; }), "q.fill()");
+
+	swap(p, q);
+	is_true(p[0] == 7 && q[0] == 1, "swap(p, q)");
+	is_true(q < p && q != p && p == p, "padded_array comparison");
+
+	padded_array<int, 0> e;
+	is_true(e.empty() && e.begin() == e.end(), "empty padded_array");
+}
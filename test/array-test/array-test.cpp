@@ -13,6 +13,8 @@
 */
 
 #include <algorithm>
+#include <iterator>
+#include <memory>
 
 #include "../../include/array.h"
 
@@ -86,6 +88,41 @@ void array_test()
 		iteratorTest = *it == urExpected[i];
 	is_true(iteratorTest, "reverse iterator");
 
+	//iterator arithmetic
+	auto first = u.begin(), last = u.end();
+	is_true(last - first == 5, "u.end() - u.begin()");
+	is_true(*(2 + first) == 3, "2 + u.begin()");
+	is_true(*(first + 2) == 3, "u.begin() + 2");
+	is_true(first + 5 == last, "u.begin() + 5 == u.end()");
+	is_true(first[4] == 6, "u.begin()[4]");
+
+	//iterator to const_iterator conversion
+	array<unsigned, 5>::const_iterator cfirst = first;
+	is_true(cfirst == u.cbegin(), "const_iterator from iterator");
+
+	//iterator and const_iterator mix in either order
+	auto clast = u.cend();
+	is_true(first == cfirst && cfirst == first, "it == cit, cit == it");
+	is_true(last != cfirst && cfirst != last, "it != cit, cit != it");
+	is_true(last - cfirst == 5 && clast - first == 5, "it - cit, cit - it");
+	is_true(first < clast && cfirst < last, "it < cit, cit < it");
+	is_true(last > cfirst && clast > first, "it > cit, cit > it");
+	is_true(first <= cfirst && cfirst <= last, "it <= cit, cit <= it");
+	is_true(last >= clast && clast >= first, "it >= cit, cit >= it");
+
+	//std algorithms on trivially copyable elements: the bulk memmove/memcmp paths
+	array<unsigned, 5> uCopy{};
+	std::copy(u.begin(), u.end(), uCopy.begin());
+	is_true(std::equal(u.begin(), u.end(), uCopy.begin()), "std::copy and std::equal");
+	std::fill(uCopy.begin(), uCopy.end(), 4u);
+	is_true(std::count(uCopy.begin(), uCopy.end(), 4u) == 5, "std::fill");
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	static_assert(std::contiguous_iterator<array<unsigned, 5>::iterator>);
+	static_assert(std::contiguous_iterator<array<unsigned, 5>::const_iterator>);
+	is_true(std::to_address(first + 1) == u.data() + 1, "std::to_address(u.begin() + 1)");
+#endif
+
 	//zero-size array
 	array<char, 0> c;
 	is_true(c.empty(), "c.empty()");
@@ -121,4 +158,59 @@ void array_test()
 	for (std::size_t idx = 0; idx < m.size() && swapTest; ++idx)
 		swapTest = m[idx] == mExpected[idx] && n[idx] == nExpected[idx];
 	is_true(swapTest, "m.swap(n)");
+
+
+	//fill and swap on arrays large enough for the bulk paths, with an odd-sized element
+	struct point { float x, y, z; };
+	array<point, 100> pa, pb;
+	pa.fill({ 1, 2, 3 });
+	pb.fill({ 4, 5, 6 });
+	bool bulkTest = std::all_of(pa.begin(), pa.end(),
+		[](const point& e) { return e.x == 1 && e.y == 2 && e.z == 3; }
+	);
+	is_true(bulkTest, "pa.fill()");
+
+	swap(pa, pb);
+	bulkTest = std::all_of(pa.begin(), pa.end(), [](const point& e) { return e.x == 4 && e.z == 6; }) &&
+		std::all_of(pb.begin(), pb.end(), [](const point& e) { return e.x == 1 && e.z == 3; });
+	is_true(bulkTest, "swap(pa, pb)");
+
+
+	//comparison
+	array<int, 3> mCopy{ m };
+	is_true(m == mCopy, "m == mCopy");
+	is_false(m != mCopy, "m != mCopy");
+	is_false(m == n, "m == n");
+	is_true(n < m && m > n, "n < m");
+	is_true(m <= mCopy && m >= mCopy, "m <= mCopy");
+	is_false(m < mCopy, "m < mCopy");
+
+	//long arrays: the first difference is past the first SIMD blocks
+	array<long long, 70> la{}, lb{};
+	la[66] = -1;
+	is_true(la < lb && lb > la, "la < lb (negative at 66)");
+	is_false(la == lb, "la == lb");
+	lb[66] = -1;
+	is_true(la == lb && !(la < lb), "la == lb after update");
+
+	array<unsigned char, 90> ca{}, cb{};
+	cb[89] = 0x80;
+	is_true(ca < cb && ca != cb, "ca < cb (high bit)");
+
+	array<char, 0> ea, eb;
+	is_true(ea == eb && !(ea < eb), "empty arrays compare equal");
+
+	//non-integer elements use the element operators: -0.0 == 0.0
+	array<double, 8> da{}, db{};
+	db[5] = -0.0;
+	is_true(da == db, "da == db (signed zero)");
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	is_true((la <=> lb) == 0, "la <=> lb");
+	is_true((n <=> m) < 0, "n <=> m");
+	is_true((da <=> db) == 0, "da <=> db");
+
+	constexpr array<int, 3> ce1{ 1, 2, 3 }, ce2{ 1, 2, 4 };
+	static_assert(ce1 < ce2 && ce1 != ce2 && (ce1 <=> ce2) < 0);
+#endif
 }
@@ -0,0 +1,143 @@
+/*
+* bit_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for bit_vector and rank_select
+*/
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "../../include/bit_vector.h"
+
+#include "../verifiers.h"
+
+using bit_vector = sigcpp::bit_vector<>;
+using rank_select = sigcpp::rank_select<>;
+
+void test_bit_vector_modifiers();
+void test_bit_vector_bulk();
+void test_rank_select();
+
+void bit_vector_test()
+{
+	test_bit_vector_modifiers();
+	test_bit_vector_bulk();
+	test_rank_select();
+}
+
+
+void test_bit_vector_modifiers()
+{
+	bit_vector v;
+	is_true(v.empty() && v.none() && v.find_first() == 0, "v empty");
+
+	for (std::size_t i = 0; i < 130; ++i)
+		v.push_back(i % 3 == 0);
+	is_true(v.size() == 130 && v.count() == 44 && v[129] && !v[128] && v.word_count() == 3, "v.push_back()");
+
+	v.pop_back();
+	v.pop_back();
+	is_true(v.size() == 128 && v.word_count() == 2 && v.count() == 43, "v.pop_back()");
+
+	v.resize(200, true);
+	is_true(v.size() == 200 && v.count() == 43 + 72 && v[150] && v[128], "v.resize(count, true)");
+
+	v.resize(70);
+	is_true(v.count() == 24 && v.data()[1] == 0x24, "v.resize(smaller) clears the bits past size()");
+
+	v.resize(100, true);
+	is_true(v[69] && v[70] && v[99] && v.count() == 54, "v.resize() fills the rest of the last word");
+
+	const bit_vector w{ true, false, true, true };
+	is_true(w.size() == 4 && w.count() == 3 && !w[1], "bit_vector(initializer_list)");
+
+	bit_vector all(77, true);
+	is_true(all.all() && all.count() == 77 && (~all).none(), "bit_vector(count, true), ~v");
+
+	bool thrown = false;
+	try {
+		all.set(77);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "v.set(size())");
+
+	all.clear();
+	is_true(all.empty() && all.word_count() == 0, "v.clear()");
+}
+
+
+void test_bit_vector_bulk()
+{
+	bit_vector x(2000), y(2000);
+	for (std::size_t i = 0; i < 2000; ++i) {
+		x[i] = i % 2 == 0;
+		y[i] = i % 3 == 0;
+	}
+
+	bit_vector both = x, either = x, one = x, only = x;
+	both &= y;
+	either |= y;
+	one ^= y;
+	only.and_not(y);
+	is_true(both.count() == 334 && either.count() == 1333 && one.count() == 999 && only.count() == 666,
+		"bulk ops");
+	is_true(both.find_first() == 0 && both.find_next(1) == 6, "find_next after &=");
+
+	std::size_t visited = 0, last = 0;
+	for (auto pos : only.ones()) {
+		++visited;
+		last = pos;
+	}
+	is_true(visited == 666 && last == 1996, "v.ones()");
+
+	bool thrown = false;
+	try {
+		x &= bit_vector(10);
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "bulk op on different sizes");
+}
+
+
+//rank and select against a scan, on a sparse run, a dense run, and empty words
+void test_rank_select()
+{
+	bit_vector v(20000);
+	for (std::size_t i = 0; i < 20000; ++i)
+		v[i] = (i < 5000 && i % 37 == 0) || (i >= 8000 && i < 16000 && i % 3 != 0) || i == 19999;
+
+	const rank_select rs(v);
+	is_true(rs.count() == v.count() && rs.size() == 20000, "rs.count()");
+
+	bool ranks = true, selects = true;
+	std::size_t ones = 0;
+	for (std::size_t i = 0; i <= 20000; ++i) {
+		ranks = ranks && rs.rank(i) == ones;
+		if (i < 20000 && v[i]) {
+			selects = selects && rs.select(ones) == i;
+			++ones;
+		}
+	}
+	is_true(ranks, "rs.rank()");
+	is_true(selects, "rs.select()");
+	is_true(rs.select(ones) == 20000, "rs.select(count())");
+
+	const bit_vector full(512, true);
+	const rank_select fs(full);
+	is_true(fs.rank(512) == 512 && fs.select(511) == 511 && fs.select(0) == 0, "rank_select: full blocks");
+
+	const bit_vector e;
+	const rank_select es(e);
+	is_true(es.rank(0) == 0 && es.select(0) == 0 && es.count() == 0, "rank_select: empty");
+}
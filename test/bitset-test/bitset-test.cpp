@@ -0,0 +1,148 @@
+/*
+* bitset-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for bitset
+*/
+
+#include <cstddef>
+#include <bitset>
+#include <stdexcept>
+
+#include "../../include/bitset.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::bitset;
+
+void test_bitset_access();
+void test_bitset_bulk();
+void test_bitset_set_bits();
+
+void bitset_test()
+{
+	test_bitset_access();
+	test_bitset_bulk();
+	test_bitset_set_bits();
+}
+
+
+void test_bitset_access()
+{
+	bitset<70> b;
+	is_true(b.none() && !b.any() && b.count() == 0 && b.size() == 70, "b empty");
+
+	b[3] = true;
+	b.set(64).set(69);
+	is_true(b[3] && b.test(64) && b[69] && !b[4] && b.count() == 3, "b[pos] = value, b.set(pos)");
+
+	b.flip(3).reset(64);
+	is_true(!b[3] && !b[64] && b.count() == 1, "b.flip(pos), b.reset(pos)");
+
+	b.set();
+	is_true(b.all() && b.count() == 70 && b.data()[1] == 0x3F, "b.set(): bits past N stay zero");
+
+	b.flip();
+	is_true(b.none(), "b.flip()");
+
+	bool thrown = false;
+	try {
+		b.test(70);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "b.test(size())");
+
+	const bitset<10> small(0xFFFFu);
+	is_true(small.count() == 10 && small.all(), "bitset(value) keeps N bits");
+
+	bitset<130> s(0b1011u);
+	s <<= 100;
+	is_true(s[100] && s[101] && !s[102] && s[103] && s.count() == 3, "b <<= n, across words");
+	s >>= 99;
+	is_true(s[1] && s[2] && s[4] && s.count() == 3, "b >>= n");
+	is_true((s << 128).count() == 1 && (s << 200).none(), "b << n drops bits past N");
+
+	is_true(~bitset<65>() == bitset<65>().set(), "~b");
+}
+
+
+//against std::bitset, over many words: the AVX2 paths need 16 words
+template<std::size_t N>
+bool same_as_std_bitset()
+{
+	bitset<N> x, y;
+	std::bitset<N> sx, sy;
+	for (std::size_t i = 0; i < N; ++i) {
+		const bool a = (i * 7 + i / 3) % 5 < 2, b = (i * 13) % 7 < 3;
+		x[i] = a;
+		sx[i] = a;
+		y[i] = b;
+		sy[i] = b;
+	}
+
+	bool same = x.count() == sx.count() && y.count() == sy.count();
+	const auto matches = [](const bitset<N>& m, const std::bitset<N>& s) {
+		bool equal = m.count() == s.count();
+		for (std::size_t i = 0; i < N; ++i)
+			equal = equal && m[i] == s[i];
+		return equal;
+	};
+	same = same && matches(x & y, sx & sy) && matches(x | y, sx | sy) && matches(x ^ y, sx ^ sy);
+	same = same && matches(bitset<N>(x).and_not(y), sx & ~sy);
+	return same;
+}
+
+
+void test_bitset_bulk()
+{
+	is_true(same_as_std_bitset<64>(), "bulk ops: 1 word");
+	is_true(same_as_std_bitset<300>(), "bulk ops: 5 words");
+	is_true(same_as_std_bitset<1000>(), "bulk ops: 16 words");
+	is_true(same_as_std_bitset<4133>(), "bulk ops: 65 words");
+
+	bitset<200> x(5), y(3);
+	x &= y;
+	is_true(x == bitset<200>(1) && x != y, "b &= c, b == c");
+}
+
+
+void test_bitset_set_bits()
+{
+	bitset<1000> b;
+	const std::size_t positions[]{ 0, 5, 63, 64, 200, 511, 512, 999 };
+	for (auto pos : positions)
+		b.set(pos);
+
+	sigcpp::vector<std::size_t> visited;
+	b.for_each_set([&visited](std::size_t pos) { visited.push_back(pos); });
+	bool same = visited.size() == 8;
+	for (std::size_t i = 0; same && i < 8; ++i)
+		same = visited[i] == positions[i];
+	is_true(same, "b.for_each_set()");
+
+	visited.clear();
+	for (auto pos : b.ones())
+		visited.push_back(pos);
+	same = visited.size() == 8;
+	for (std::size_t i = 0; same && i < 8; ++i)
+		same = visited[i] == positions[i];
+	is_true(same, "b.ones()");
+
+	is_true(b.find_first() == 0 && b.find_next(1) == 5 && b.find_next(65) == 200 && b.find_next(1000) == 1000,
+		"b.find_first(), b.find_next()");
+
+	b.reset(999);
+	is_true(b.find_next(513) == 1000, "b.find_next(): none is size()");
+
+	const bitset<128> e;
+	is_true(e.ones().begin() == e.ones().end() && e.find_first() == 128, "e has no set bits");
+}
@@ -0,0 +1,106 @@
+/*
+* bloom_filter-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for bloom_filter
+*/
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../../include/bloom_filter.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::bloom_filter;
+
+void test_bloom_filter_membership();
+void test_bloom_filter_false_positives();
+void test_bloom_filter_copy_merge();
+
+void bloom_filter_test()
+{
+	test_bloom_filter_membership();
+	test_bloom_filter_false_positives();
+	test_bloom_filter_copy_merge();
+}
+
+
+void test_bloom_filter_membership()
+{
+	bloom_filter<> f(100);
+	is_true(f.block_count() == 5 && f.size_bytes() == 160 && !f.contains("apple"), "bloom_filter(100)");
+
+	f.insert("apple");
+	f.insert(std::string("banana"));
+	f.insert(sigcpp::string_view("cherry"));
+	is_true(f.contains(std::string_view("apple")) && f.contains("banana") && f.contains(std::string("cherry")),
+		"f.insert(key), f.contains(key): any string type");
+
+	f.clear();
+	is_true(!f.contains("apple"), "f.clear()");
+}
+
+
+void test_bloom_filter_false_positives()
+{
+	constexpr std::size_t count = 10000;
+	bloom_filter<> f(count);
+	for (std::size_t i = 0; i < count; ++i)
+		f.insert("key" + std::to_string(i));
+
+	bool all = true;
+	for (std::size_t i = 0; i < count; ++i)
+		all = all && f.contains("key" + std::to_string(i));
+	is_true(all, "no false negatives");
+
+	//about 0.5% at 12 bits per key
+	std::size_t falsePositives = 0;
+	for (std::size_t i = 0; i < 10 * count; ++i)
+		falsePositives += f.contains("absent" + std::to_string(i));
+	is_true(falsePositives < count * 10 / 50, "false-positive rate below 2% at 12 bits per key");
+}
+
+
+void test_bloom_filter_copy_merge()
+{
+	bloom_filter<> a(1000), b(1000);
+	for (std::size_t i = 0; i < 500; ++i) {
+		a.insert("a" + std::to_string(i));
+		b.insert("b" + std::to_string(i));
+	}
+
+	bloom_filter<> copy(a);
+	bool all = true;
+	for (std::size_t i = 0; i < 500; ++i)
+		all = all && copy.contains("a" + std::to_string(i));
+	is_true(all, "bloom_filter(a)");
+
+	copy.merge(b);
+	for (std::size_t i = 0; i < 500; ++i)
+		all = all && copy.contains("a" + std::to_string(i)) && copy.contains("b" + std::to_string(i));
+	is_true(all, "copy.merge(b)");
+
+	a = copy;
+	swap(a, b);
+	is_true(b.contains("b7") && b.contains("a7"), "a = copy, swap(a, b)");
+
+	bloom_filter<> small(10);
+	bool thrown = false;
+	try {
+		small.merge(a);
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "merge of a different size throws");
+}
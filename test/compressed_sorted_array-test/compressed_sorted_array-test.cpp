@@ -0,0 +1,169 @@
+/*
+* compressed_sorted_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for compressed_sorted_array
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../../include/compressed_sorted_array.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using compressed_sorted_array = sigcpp::compressed_sorted_array<>;
+
+void test_compressed_sorted_array_basics();
+void test_compressed_sorted_array_search();
+void test_compressed_sorted_array_blocks();
+
+void compressed_sorted_array_test()
+{
+	test_compressed_sorted_array_basics();
+	test_compressed_sorted_array_search();
+	test_compressed_sorted_array_blocks();
+}
+
+
+//count sorted values: gaps of mixed widths, some repeats, and a run past 2^31
+sigcpp::vector<std::uint32_t> make_sorted(std::size_t count)
+{
+	sigcpp::vector<std::uint32_t> values;
+	std::uint32_t value = 5;
+	for (std::size_t i = 0; i < count; ++i) {
+		values.push_back(value);
+		const auto r = static_cast<std::uint32_t>((i * 2654435761u) >> 20);
+		value += i % 300 < 150 ? r % 8 : r % 5000;
+		if (i == count / 2)
+			value += 0x80000000u;
+	}
+	return values;
+}
+
+
+bool equals(const compressed_sorted_array& c, const sigcpp::vector<std::uint32_t>& values)
+{
+	return c.size() == values.size() && std::equal(c.begin(), c.end(), values.begin(), values.end());
+}
+
+
+void test_compressed_sorted_array_basics()
+{
+	compressed_sorted_array empty;
+	is_true(empty.empty() && empty.size() == 0 && empty.begin() == empty.end() && empty.block_count() == 0,
+		"default compressed_sorted_array");
+
+	compressed_sorted_array small{ 1, 1, 4, 9, 100 };
+	const sigcpp::vector<std::uint32_t> smallValues{ 1, 1, 4, 9, 100 };
+	is_true(equals(small, smallValues) && small.block_count() == 1, "compressed_sorted_array{list}");
+
+	const auto values = make_sorted(1000);
+	compressed_sorted_array c(values);
+	is_true(equals(c, values) && c.block_count() == 8, "compressed_sorted_array(vector): 1000 values");
+	is_true(c.size_bytes() < values.size() * sizeof(std::uint32_t) / 2, "compressed size less than half");
+
+	sigcpp::vector<std::uint32_t> visited;
+	c.for_each([&visited](std::uint32_t v) { visited.push_back(v); });
+	is_true(visited == values, "c.for_each(f)");
+
+	compressed_sorted_array same(values);
+	is_true(c == same && c != small, "c == same, c != small");
+
+	swap(c, small);
+	is_true(equals(small, values) && c.size() == 5, "swap(c, small)");
+
+	compressed_sorted_array repeats(sigcpp::vector<std::uint32_t>(300, 7));
+	is_true(repeats.size() == 300 && std::all_of(repeats.begin(), repeats.end(), [](std::uint32_t v) { return v == 7; }),
+		"repeated values: width 0");
+
+	bool thrown = false;
+	try {
+		compressed_sorted_array unsorted{ 1, 3, 2 };
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "unsorted values throw");
+
+	auto unsortedAcross = make_sorted(200);
+	unsortedAcross[128] = 0;
+	thrown = false;
+	try {
+		compressed_sorted_array unsorted(unsortedAcross);
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "values unsorted across blocks throw");
+}
+
+
+void test_compressed_sorted_array_search()
+{
+	const auto values = make_sorted(5000);
+	compressed_sorted_array c(values);
+
+	//every value, and the values in between
+	bool found = true;
+	for (std::size_t i = 0; i < values.size(); i += 7) {
+		for (std::uint32_t probe : { values[i], values[i] + 1, values[i] - 1 }) {
+			const auto expected = std::lower_bound(values.begin(), values.end(), probe) - values.begin();
+			const auto it = c.lower_bound(probe);
+			const auto index = it == c.end() ? values.size() : it.index();
+			found = found && index == static_cast<std::size_t>(expected) && (it == c.end() || *it == values[index]);
+		}
+	}
+	is_true(found, "c.lower_bound(value) matches std::lower_bound");
+
+	is_true(c.lower_bound(values.back() + 1) == c.end() && c.lower_bound(0).index() == 0, "c.lower_bound at the ends");
+	is_true(c.contains(values[4321]) && !c.contains(values[4321] + 1) == (values[4322] != values[4321] + 1),
+		"c.contains(value)");
+
+	//seek: an intersection with every 97th value
+	sigcpp::vector<std::uint32_t> probes;
+	for (std::size_t i = 0; i < values.size(); i += 97)
+		probes.push_back(values[i]);
+
+	auto it = c.begin();
+	std::size_t matches = 0;
+	for (auto probe : probes) {
+		it.seek(probe);
+		if (it != c.end() && *it == probe)
+			++matches;
+	}
+	is_true(matches == probes.size(), "it.seek(value)");
+
+	it.seek(values.back() + 1);
+	is_true(it == c.end(), "it.seek past the last value");
+}
+
+
+void test_compressed_sorted_array_blocks()
+{
+	const auto values = make_sorted(300);
+	compressed_sorted_array c(values);
+
+	sigcpp::vector<std::uint32_t> out(compressed_sorted_array::block_size);
+	const auto count = c.decode_block(2, out);
+	is_true(count == 44 && std::equal(out.begin(), out.begin() + 44, values.begin() + 256) &&
+		c.block_max(2) == values.back(), "c.decode_block(2): the last, partial block");
+
+	bool thrown = false;
+	try {
+		c.decode_block(3, out);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "c.decode_block(3) throws");
+}
@@ -0,0 +1,102 @@
+/*
+* cuckoo_filter-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for cuckoo_filter
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../../include/cuckoo_filter.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::cuckoo_filter;
+
+void test_cuckoo_filter_membership();
+void test_cuckoo_filter_false_positives();
+void test_cuckoo_filter_full();
+
+void cuckoo_filter_test()
+{
+	test_cuckoo_filter_membership();
+	test_cuckoo_filter_false_positives();
+	test_cuckoo_filter_full();
+}
+
+
+void test_cuckoo_filter_membership()
+{
+	cuckoo_filter<> f(100);
+	is_true(f.empty() && f.bucket_count() == 32 && f.capacity() == 128 && f.size_bytes() == 256,
+		"cuckoo_filter(100)");
+
+	f.insert("apple");
+	f.insert(std::string("banana"));
+	f.insert(sigcpp::string_view("cherry"));
+	is_true(f.size() == 3 && f.contains(std::string_view("apple")) && f.contains("banana") &&
+		f.contains(std::string("cherry")) && !f.contains("durian"), "f.insert(key), f.contains(key)");
+
+	f.insert("apple");
+	is_true(f.erase("apple") && f.contains("apple") && f.erase("apple") && !f.contains("apple") && f.size() == 2,
+		"f.erase(key): one copy at a time");
+	is_true(!f.erase("apple"), "f.erase(key) of an absent key");
+
+	f.clear();
+	is_true(f.empty() && !f.contains("banana"), "f.clear()");
+}
+
+
+//false positives among 10 * count absent keys, with count keys inserted
+template<typename Fingerprint>
+std::size_t false_positives(std::size_t count)
+{
+	cuckoo_filter<Fingerprint> f(count);
+	for (std::size_t i = 0; i < count; ++i)
+		f.insert("key" + std::to_string(i));
+
+	std::size_t falsePositives = 0;
+	for (std::size_t i = 0; i < 10 * count; ++i)
+		falsePositives += f.contains("absent" + std::to_string(i));
+	return falsePositives;
+}
+
+
+void test_cuckoo_filter_false_positives()
+{
+	//about 8 / 2^Bits at full load; less at the load of these filters
+	is_true(false_positives<std::uint16_t>(10000) < 100000 / 1000, "16-bit fingerprints: rate below 0.1%");
+	is_true(false_positives<std::uint8_t>(10000) < 100000 / 20, "8-bit fingerprints: rate below 5%");
+}
+
+
+void test_cuckoo_filter_full()
+{
+	cuckoo_filter<> f(1000);
+	std::size_t inserted = 0;
+	while (f.insert("key" + std::to_string(inserted)))
+		++inserted;
+
+	is_true(f.full() && f.size() == inserted && f.load_factor() > 0.9, "insert until full: load over 90%");
+
+	bool all = true;
+	for (std::size_t i = 0; i < inserted; ++i)
+		all = all && f.contains("key" + std::to_string(i));
+	is_true(all, "no false negatives when full");
+
+	for (std::size_t i = 0; i < inserted; ++i)
+		all = all && f.erase("key" + std::to_string(i));
+	is_true(all && f.empty() && !f.full(), "erase every key");
+
+	is_true(f.insert("again") && f.contains("again"), "insert after erase");
+}
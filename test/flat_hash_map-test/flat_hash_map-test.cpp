@@ -0,0 +1,296 @@
+/*
+* flat_hash_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for flat_hash_map
+*/
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../../include/flat_hash_map.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::flat_hash_map;
+
+void test_flat_hash_map_basic();
+void test_flat_hash_map_growth();
+void test_flat_hash_map_erase();
+void test_flat_hash_map_strings();
+void test_flat_hash_map_copy_move();
+void test_flat_hash_map_rehash_exceptions();
+
+void flat_hash_map_test()
+{
+	test_flat_hash_map_basic();
+	test_flat_hash_map_growth();
+	test_flat_hash_map_erase();
+	test_flat_hash_map_strings();
+	test_flat_hash_map_copy_move();
+	test_flat_hash_map_rehash_exceptions();
+}
+
+
+void test_flat_hash_map_basic()
+{
+	flat_hash_map<int, int> e;
+	is_true(e.empty() && e.size() == 0 && e.capacity() == 0, "e empty");
+	is_true(e.begin() == e.end(), "e.begin() == e.end()");
+	is_true(e.find(3) == e.end() && !e.contains(3), "e.find()");
+	is_true(e.erase(3) == 0, "e.erase(key)");
+
+	flat_hash_map<int, int> m{ { 1, 10 }, { 2, 20 }, { 3, 30 } };
+	is_true(m.size() == 3 && m.at(2) == 20, "m from init list");
+
+	auto [it, inserted] = m.insert({ 4, 40 });
+	is_true(inserted && it->first == 4 && it->second == 40, "m.insert(new)");
+	auto [it2, inserted2] = m.insert({ 4, 99 });
+	is_true(!inserted2 && it2->second == 40, "m.insert(existing)");
+
+	is_true(m.try_emplace(5, 50).second && !m.try_emplace(5, 51).second, "m.try_emplace()");
+	is_true(m.insert_or_assign(5, 55).second == false && m[5] == 55, "m.insert_or_assign(existing)");
+	is_true(m.emplace(6, 60).second && m.count(6) == 1, "m.emplace()");
+
+	m[7] = 70;
+	is_true(m.size() == 7 && m[7] == 70, "m[new key]");
+	is_true(m[8] == 0 && m.size() == 8, "m[new key] value-initialized");
+
+	bool thrown = false;
+	try {
+		m.at(100);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "m.at(missing)");
+
+	//iteration visits every element once
+	int keySum = 0;
+	for (const auto& [key, value] : m)
+		keySum += key;
+	is_true(keySum == 36, "iteration");
+
+	const auto& cm = m;
+	is_true(cm.find(3)->second == 30 && cm.load_factor() <= cm.max_load_factor(), "const find");
+}
+
+
+//against std::unordered_map through growth, erase, and reinsertion
+void test_flat_hash_map_growth()
+{
+	flat_hash_map<int, int> m;
+	std::unordered_map<int, int> r;
+	bool same = true;
+	unsigned x = 12345;
+	for (int i = 0; i < 20000; ++i) {
+		x = x * 1103515245u + 12345u;
+		const auto key = static_cast<int>((x >> 8) % 5000);
+		switch ((x >> 4) % 4) {
+		case 0:
+		case 1:
+			same = same && m.insert({ key, i }).second == r.insert({ key, i }).second;
+			break;
+		case 2:
+			same = same && m.erase(key) == r.erase(key);
+			break;
+		default:
+			same = same && m.contains(key) == (r.count(key) == 1);
+		}
+	}
+
+	same = same && m.size() == r.size();
+	for (const auto& [key, value] : r) {
+		const auto it = m.find(key);
+		same = same && it != m.end() && it->second == value;
+	}
+	is_true(same, "flat_hash_map matches unordered_map");
+	is_true(m.load_factor() <= m.max_load_factor(), "load factor within limit");
+
+	//reserve makes room for count elements without a rehash
+	flat_hash_map<int, int> v;
+	v.reserve(1000);
+	const auto capacity = v.capacity();
+	for (int i = 0; i < 1000; ++i)
+		v[i] = i;
+	is_true(v.capacity() == capacity && capacity >= 1000, "v.reserve(1000)");
+
+	v.clear();
+	is_true(v.empty() && v.begin() == v.end() && v.capacity() == capacity, "v.clear()");
+	v.rehash(0);
+	is_true(v.capacity() == 0, "v.rehash(0) when empty");
+}
+
+
+void test_flat_hash_map_erase()
+{
+	flat_hash_map<int, int> m;
+	for (int i = 0; i < 100; ++i)
+		m[i] = i;
+
+	//erase while iterating
+	for (auto it = m.begin(); it != m.end();) {
+		if (it->first % 2 == 0)
+			it = m.erase(it);
+		else
+			++it;
+	}
+	is_true(m.size() == 50 && !m.contains(10) && m.contains(11), "erase even keys while iterating");
+
+	//erase and reinsert many times: tombstones must not pile up without a cleanup
+	const auto capacity = m.capacity();
+	for (int round = 0; round < 100; ++round) {
+		for (int i = 1000; i < 1040; ++i)
+			m[i] = i;
+		for (int i = 1000; i < 1040; ++i)
+			m.erase(i);
+	}
+	is_true(m.size() == 50 && m.capacity() == capacity, "erase/reinsert does not grow the table");
+}
+
+
+void test_flat_hash_map_strings()
+{
+	flat_hash_map<std::string, int> m;
+	m["alpha"] = 1;
+	m.try_emplace("a string long enough to need its own heap buffer", 2);
+	m.emplace("gamma", 3);
+
+	//lookup without building a std::string
+	is_true(m.find(std::string_view("alpha"))->second == 1, "find(std::string_view)");
+	is_true(m.contains(sigcpp::string_view("gamma")), "contains(sigcpp::string_view)");
+	is_true(m.count("gamma") == 1 && m.count("delta") == 0, "count(const char*)");
+	is_true(m.erase(std::string_view("gamma")) == 1 && m.size() == 2, "erase(std::string_view)");
+
+	for (int i = 0; i < 1000; ++i)
+		m[std::to_string(i)] = i;
+	is_true(m.size() == 1002 && m.at("999") == 999 && m.at("alpha") == 1, "strings after growth");
+}
+
+
+void test_flat_hash_map_copy_move()
+{
+	flat_hash_map<std::string, std::string> m;
+	for (int i = 0; i < 100; ++i)
+		m[std::to_string(i)] = std::string(40, static_cast<char>('a' + i % 26));
+
+	auto copy = m;
+	is_true(copy == m && copy.size() == 100, "copy ctor");
+
+	copy["0"] = "changed";
+	is_true(copy != m, "copy is independent");
+
+	auto moved = std::move(copy);
+	is_true(moved.size() == 100 && copy.empty() && copy.begin() == copy.end(), "move ctor");
+
+	swap(moved, m);
+	is_true(m["0"] == "changed" && moved["0"] != "changed", "swap");
+
+	m = moved;
+	is_true(m == moved, "copy assignment");
+
+	//a moved-from map is usable
+	copy["x"] = "y";
+	is_true(copy.size() == 1, "moved-from map reused");
+
+	flat_hash_map<int, std::unique_ptr<int>> u;
+	u.try_emplace(1, std::make_unique<int>(5));
+	for (int i = 2; i < 100; ++i)
+		u[i] = std::make_unique<int>(i);
+	is_true(*u[1] == 5 && *u[99] == 99, "move-only mapped type across growth");
+}
+
+
+//a hasher that throws once armed, and a mapped type whose move may throw and whose copy
+//throws on the n-th call once armed
+static int hash_calls_left = -1;
+
+struct throwing_hash
+{
+	std::size_t operator()(int key) const
+	{
+		if (hash_calls_left == 0)
+			throw std::runtime_error("hash");
+		if (hash_calls_left > 0)
+			--hash_calls_left;
+		return std::hash<int>()(key);
+	}
+};
+
+static int copies_left = -1;
+
+struct throwing_copy
+{
+	int value;
+
+	throwing_copy(int v) : value{ v } {}
+
+	throwing_copy(const throwing_copy& t) : value{ t.value }
+	{
+		if (copies_left == 0)
+			throw std::runtime_error("copy");
+		if (copies_left > 0)
+			--copies_left;
+	}
+
+	throwing_copy(throwing_copy&& t) noexcept(false) : value{ t.value } {}
+	throwing_copy& operator=(const throwing_copy&) = default;
+};
+
+
+//a rehash that throws leaves the map as it was
+void test_flat_hash_map_rehash_exceptions()
+{
+	flat_hash_map<int, int, throwing_hash> h;
+	for (int i = 0; i < 100; ++i)
+		h[i] = i;
+	const auto capacity = h.capacity();
+
+	bool thrown = false;
+	hash_calls_left = 50;
+	try {
+		h.reserve(10000);
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	hash_calls_left = -1;
+
+	bool same = true;
+	for (int i = 0; i < 100; ++i)
+		same = same && h.contains(i) && h.at(i) == i;
+	is_true(thrown && same && h.size() == 100 && h.capacity() == capacity, "hasher throws in rehash");
+
+	flat_hash_map<int, throwing_copy> c;
+	for (int i = 0; i < 100; ++i)
+		c.try_emplace(i, i);
+
+	thrown = false;
+	copies_left = 50;
+	try {
+		c.reserve(10000);
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	copies_left = -1;
+
+	same = true;
+	for (int i = 0; i < 100; ++i)
+		same = same && c.contains(i) && c.at(i).value == i;
+	is_true(thrown && same && c.size() == 100, "element copy throws in rehash");
+
+	c.reserve(10000);
+	is_true(c.size() == 100 && c.at(99).value == 99 && c.capacity() >= 10000, "rehash copies elements whose move may throw");
+}
@@ -0,0 +1,145 @@
+/*
+* flat_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for flat_map
+*/
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../../include/array.h"
+#include "../../include/flat_map.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::flat_map;
+
+void test_flat_map_basic();
+void test_flat_map_bulk();
+void test_flat_map_fixed();
+
+void flat_map_test()
+{
+	test_flat_map_basic();
+	test_flat_map_bulk();
+	test_flat_map_fixed();
+}
+
+
+void test_flat_map_basic()
+{
+	flat_map<int, std::string> e;
+	is_true(e.empty() && e.begin() == e.end() && !e.contains(1), "e empty");
+
+	flat_map<int, std::string> m{ { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "duplicate" } };
+	is_true(m.size() == 3 && m.at(1) == "a", "m sorted, first duplicate kept");
+	is_true(m.begin()->first == 1 && (m.end() - 1)->second == "c", "m iteration");
+	is_true(std::is_sorted(m.keys().begin(), m.keys().end()), "m.keys() sorted");
+
+	//proxy references
+	auto [key, value] = *m.find(2);
+	is_true(key == 2 && value == "b", "*m.find()");
+	value = "B";
+	is_true(m[2] == "B", "assign through reference");
+
+	is_true(m.try_emplace(0, "z").second && !m.try_emplace(0, "y").second && m[0] == "z", "m.try_emplace()");
+	is_true(!m.insert_or_assign(0, "y").second && m[0] == "y", "m.insert_or_assign(existing)");
+	is_true(m.insert({ 5, "e" }).second && m.emplace(4, "d").second, "m.insert(), m.emplace()");
+	m[6] = "f";
+	is_true(m.size() == 7 && m.values().back() == "f", "m[new key]");
+
+	is_true(m.lower_bound(3)->first == 3 && m.upper_bound(3)->first == 4, "m.lower_bound(), m.upper_bound()");
+	is_true(m.erase(3) == 1 && !m.contains(3) && m.size() == 6, "m.erase(key)");
+	is_true(m.erase(m.begin())->first == 1, "m.erase(pos)");
+
+	bool thrown = false;
+	try {
+		m.at(100);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "m.at(missing)");
+
+	auto copy = m;
+	is_true(copy == m, "copy == m");
+	copy[7] = "g";
+	is_true(copy != m && m < copy, "m < copy");
+
+	auto c = std::move(copy).extract();
+	is_true(c.keys.size() == 6 && c.values.size() == 6 && copy.empty(), "extract()");
+
+	//transparent lookup
+	flat_map<std::string, int, std::less<>> names{ { "delta", 4 }, { "alpha", 1 } };
+	is_true(names.find(std::string_view("alpha"))->second == 1 && names.count("bravo") == 0, "transparent lookup");
+}
+
+
+//against std::map: bulk construction and merges
+void test_flat_map_bulk()
+{
+	sigcpp::vector<int> keys, values;
+	std::map<int, int> reference;
+	unsigned x = 1;
+	for (int i = 0; i < 2000; ++i) {
+		x = x * 1103515245u + 12345u;
+		const auto key = static_cast<int>((x >> 8) % 1500);
+		keys.push_back(key);
+		values.push_back(i);
+		reference.insert({ key, i });
+	}
+
+	flat_map<int, int> m(std::move(keys), std::move(values));
+	bool same = m.size() == reference.size();
+	for (const auto& [key, value] : reference)
+		same = same && m.contains(key) && m.at(key) == value;
+	is_true(same, "flat_map(keys, values) matches std::map");
+
+	std::pair<int, int> more[100];
+	for (int i = 0; i < 100; ++i) {
+		more[i] = { 3000 - i * 17, -i };
+		reference.insert(more[i]);
+	}
+	m.insert(more, more + 100);
+	same = m.size() == reference.size() && std::is_sorted(m.keys().begin(), m.keys().end());
+	for (const auto& [key, value] : reference)
+		same = same && m.at(key) == value;
+	is_true(same, "m.insert(first, last) matches std::map");
+
+	bool thrown = false;
+	try {
+		flat_map<int, int> bad(sigcpp::vector<int>{ 1, 2 }, sigcpp::vector<int>{ 1 });
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "containers of different sizes");
+}
+
+
+//compile-time sized table over arrays: the mapped values stay assignable
+void test_flat_map_fixed()
+{
+	using table = flat_map<int, char, std::less<int>, sigcpp::array<int, 4>, sigcpp::array<char, 4>>;
+	table t(sigcpp::array<int, 4>{ 30, 10, 40, 20 }, sigcpp::array<char, 4>{ 'c', 'a', 'd', 'b' });
+	is_true(t.size() == 4 && t.begin()->first == 10 && t.at(40) == 'd', "flat_map over arrays sorted");
+	is_true(t.find(20)->second == 'b' && t.find(25) == t.end(), "flat_map over arrays lookup");
+
+	t.find(20)->second = 'x';
+	is_true(t.at(20) == 'x', "flat_map over arrays: assign mapped value");
+
+	const auto& ct = t;
+	is_true(ct.lower_bound(25)->first == 30, "const lower_bound");
+}
@@ -0,0 +1,169 @@
+/*
+* flat_set-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for flat_set and the branchless binary searches it uses
+*/
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../../include/array.h"
+#include "../../include/flat_set.h"
+#include "../../include/sorted_search.h"
+#include "../../include/static_vector.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::flat_set;
+
+void test_branchless_bounds();
+void test_flat_set_basic();
+void test_flat_set_bulk();
+void test_flat_set_fixed();
+
+void flat_set_test()
+{
+	test_branchless_bounds();
+	test_flat_set_basic();
+	test_flat_set_bulk();
+	test_flat_set_fixed();
+}
+
+
+//same positions as std::lower_bound and std::upper_bound for every size and key
+void test_branchless_bounds()
+{
+	const int values[]{ 1, 3, 3, 3, 5, 7, 9, 9, 11, 13, 15, 17, 19 };
+	bool same = true;
+	for (int n = 0; n <= 13; ++n) {
+		for (int key = 0; key <= 20; ++key) {
+			same = same && sigcpp::branchless_lower_bound(values, values + n, key) ==
+				std::lower_bound(values, values + n, key);
+			same = same && sigcpp::branchless_upper_bound(values, values + n, key) ==
+				std::upper_bound(values, values + n, key);
+		}
+	}
+	is_true(same, "branchless bounds match std::lower_bound and std::upper_bound");
+
+	const int descending[]{ 9, 7, 7, 5, 1 };
+	is_true(sigcpp::branchless_lower_bound(descending, descending + 5, 7, std::greater<>()) == descending + 1,
+		"branchless_lower_bound(greater)");
+
+	static constexpr int primes[]{ 2, 3, 5, 7, 11, 13 };
+	static_assert(*sigcpp::branchless_lower_bound(primes, primes + 6, 8) == 11);
+}
+
+
+void test_flat_set_basic()
+{
+	flat_set<int> e;
+	is_true(e.empty() && e.size() == 0 && e.begin() == e.end(), "e empty");
+	is_true(e.find(3) == e.end() && !e.contains(3), "e.find()");
+
+	flat_set<int> s{ 5, 1, 4, 1, 3 };
+	const int expected[]{ 1, 3, 4, 5 };
+	is_true(s.size() == 4 && std::equal(s.begin(), s.end(), expected), "s sorted and unique");
+
+	auto [it, inserted] = s.insert(2);
+	is_true(inserted && *it == 2 && s.size() == 5, "s.insert(new)");
+	is_true(!s.insert(4).second && s.size() == 5, "s.insert(existing)");
+	is_true(s.emplace(6).second && s.count(6) == 1, "s.emplace()");
+
+	is_true(*s.lower_bound(3) == 3 && *s.upper_bound(3) == 4, "s.lower_bound(), s.upper_bound()");
+	auto [first, last] = s.equal_range(4);
+	is_true(last - first == 1 && *first == 4, "s.equal_range()");
+
+	is_true(s.erase(3) == 1 && s.erase(3) == 0 && !s.contains(3), "s.erase(key)");
+	is_true(*s.erase(s.begin()) == 2, "s.erase(pos)");
+	is_true(*s.rbegin() == 6, "s.rbegin()");
+
+	flat_set<int> t{ 2, 4, 5, 6 };
+	is_true(s == t && !(s < t), "s == t");
+	t.insert(7);
+	is_true(s != t && s < t, "s < t");
+
+	auto keys = std::move(t).extract();
+	is_true(keys.size() == 5 && t.empty(), "extract()");
+	t.replace(std::move(keys));
+	is_true(t.size() == 5 && t.contains(7), "replace()");
+
+	//transparent lookup
+	flat_set<std::string, std::less<>> names{ "delta", "alpha", "charlie" };
+	is_true(names.contains(std::string_view("alpha")) && names.count("bravo") == 0, "transparent lookup");
+	is_true(*names.begin() == "alpha", "names sorted");
+}
+
+
+void test_flat_set_bulk()
+{
+	//construction from a container sorts once and drops duplicates
+	sigcpp::vector<int> raw;
+	for (int i = 0; i < 1000; ++i)
+		raw.push_back((i * 7919) % 500);
+	flat_set<int> s(std::move(raw));
+	is_true(s.size() == 500 && std::is_sorted(s.begin(), s.end()), "flat_set(container)");
+	is_true(s.contains(0) && s.contains(499) && !s.contains(500), "flat_set(container) keys");
+
+	//bulk insert merges: duplicates of existing keys are dropped
+	const int more[]{ 1000, 2, 999, 1000, 3 };
+	s.insert(more, more + 5);
+	is_true(s.size() == 502 && *s.rbegin() == 1000 && std::is_sorted(s.begin(), s.end()), "s.insert(first, last)");
+
+	const int sorted[]{ 1001, 1002 };
+	s.insert(sigcpp::sorted_unique, sorted, sorted + 2);
+	is_true(s.size() == 504 && *s.rbegin() == 1002, "s.insert(sorted_unique, first, last)");
+
+	//of equivalent keys, the first in the input stays, as in flat_map
+	const auto byTens = [](int x, int y) { return x / 10 < y / 10; };
+	sigcpp::vector<int> tens;
+	int firstOf[20]{};
+	bool seen[20]{};
+	for (int i = 0; i < 200; ++i) {
+		const auto key = (i * 37) % 200;
+		tens.push_back(key);
+		if (!seen[key / 10]) {
+			seen[key / 10] = true;
+			firstOf[key / 10] = key;
+		}
+	}
+	flat_set<int, decltype(byTens)> firsts(std::move(tens), byTens);
+	bool ok = firsts.size() == 20;
+	for (int i = 0; i < 20; ++i)
+		ok = ok && *firsts.find(i * 10) == firstOf[i];
+	is_true(ok, "flat_set(container): first of equivalent keys stays");
+
+	//fixed capacity store
+	flat_set<int, std::less<int>, sigcpp::static_vector<int, 8>> small{ 3, 1, 2, 3 };
+	is_true(small.size() == 3 && *small.begin() == 1, "flat_set over static_vector");
+}
+
+
+//compile-time sized table over array: read-only, keys must be unique
+void test_flat_set_fixed()
+{
+	using table = flat_set<int, std::less<int>, sigcpp::array<int, 5>>;
+	table t(sigcpp::array<int, 5>{ 40, 10, 30, 20, 50 });
+	is_true(t.size() == 5 && *t.begin() == 10 && *t.rbegin() == 50, "flat_set over array sorted");
+	is_true(t.contains(30) && !t.contains(35), "flat_set over array lookup");
+	is_true(*t.lower_bound(35) == 40, "flat_set over array lower_bound");
+
+	bool thrown = false;
+	try {
+		table dup(sigcpp::array<int, 5>{ 1, 2, 2, 3, 4 });
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "flat_set over array with duplicates throws");
+}
@@ -0,0 +1,78 @@
+/*
+* mdarray-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for mdarray
+*/
+
+#include <numeric>
+#include <stdexcept>
+
+#include "../../include/mdarray.h"
+
+#include "../verifiers.h"
+
+using sigcpp::mdarray;
+
+void test_mdarray_access();
+void test_mdarray_views();
+
+void mdarray_test()
+{
+	test_mdarray_access();
+	test_mdarray_views();
+}
+
+
+void test_mdarray_access()
+{
+	mdarray<int, 2, 3> m{ 1, 2, 3, 4, 5, 6 };
+	is_true(m.rank() == 2 && m.extent(0) == 2 && m.extent(1) == 3 && m.size() == 6, "m shape");
+	is_true(m(0, 0) == 1 && m(0, 2) == 3 && m(1, 0) == 4 && m(1, 2) == 6, "m(i, j)");
+	is_true(m.stride(0) == 3 && m.stride(1) == 1, "m.stride()");
+
+	static_assert(mdarray<int, 2, 3>{ 1, 2, 3, 4, 5, 6 }(1, 1) == 5, "constexpr m(i, j)");
+
+	m(1, 1) = 50;
+	is_true(m.data()[4] == 50 && std::accumulate(m.begin(), m.end(), 0) == 66, "m(i, j) = value");
+
+	bool thrown = false;
+	try {
+		m.at(0, 3);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown && m.at(1, 1) == 50, "m.at()");
+
+	mdarray<int, 2, 3> n{};
+	is_true(m != n, "m != n");
+	n.fill(7);
+	swap(m, n);
+	is_true(m(1, 2) == 7 && n(1, 1) == 50, "fill, swap");
+
+	const mdarray<double, 2, 2, 2> cube{ 0, 1, 2, 3, 4, 5, 6, 7 };
+	is_true(cube(1, 0, 1) == 5 && cube.stride(0) == 4, "rank 3");
+
+	mdarray<int, 3, 0> e;
+	is_true(e.empty() && e.begin() == e.end() && e.extent(0) == 3, "e empty");
+}
+
+
+void test_mdarray_views()
+{
+	mdarray<int, 3, 4> m{};
+	auto v = m.to_mdspan();
+	v(2, 3) = 11;
+	is_true(m(2, 3) == 11 && v.extent(1) == 4, "m.to_mdspan()");
+
+	const auto& cm = m;
+	const auto column = submdspan(cm.to_mdspan(), sigcpp::full_extent, 3);
+	is_true(column.extent(0) == 3 && column(2) == 11, "submdspan(m.to_mdspan())");
+}
@@ -0,0 +1,131 @@
+/*
+* mdspan-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for mdspan, its layouts, and submdspan
+*/
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "../../include/mdspan.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::mdspan;
+using sigcpp::submdspan;
+using sigcpp::full_extent;
+
+void test_mdspan_layouts();
+void test_mdspan_blocked();
+void test_submdspan();
+
+void mdspan_test()
+{
+	test_mdspan_layouts();
+	test_mdspan_blocked();
+	test_submdspan();
+}
+
+
+void test_mdspan_layouts()
+{
+	int values[]{ 0, 1, 2, 3, 4, 5 };
+
+	mdspan m(values, 2, 3);
+	is_true(m.rank() == 2 && m.extent(0) == 2 && m.extent(1) == 3 && m.size() == 6, "m shape");
+	is_true(m(0, 2) == 2 && m(1, 0) == 3 && m.stride(0) == 3 && m.stride(1) == 1, "layout_right");
+
+	m(1, 1) = 40;
+	is_true(values[4] == 40, "m(i, j) writes through");
+
+	const mdspan<const int, 2, sigcpp::layout_left> c(values, 2, 3);
+	is_true(c(1, 0) == 1 && c(0, 1) == 2 && c(1, 2) == 5 && c.stride(1) == 2, "layout_left");
+
+	//a zero stride repeats a row
+	const mdspan<int, 2, sigcpp::layout_stride> r(values, { { 4, 3 }, { 0, 1 } });
+	is_true(r(3, 2) == 2 && r.required_span_size() == 3, "layout_stride");
+
+	const mdspan<const int, 2> cm = m;
+	is_true(cm(1, 1) == 40 && cm.data() == values, "mdspan<T> to mdspan<const T>");
+
+	bool thrown = false;
+	try {
+		m.at(2, 0);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown && m.at(1, 2) == 5, "m.at()");
+
+	const mdspan<int, 3> e(values, 2, 0, 3);
+	is_true(e.empty() && e.required_span_size() == 0, "e empty");
+}
+
+
+void test_mdspan_blocked()
+{
+	using blocked = sigcpp::layout_blocked<4>;
+
+	//6x6 pads to 8x8: four tiles of 16
+	sigcpp::vector<int> storage(64, -1);
+	const mdspan<int, 2, blocked> b(storage.data(), 6, 6);
+	is_true(b.required_span_size() == 64, "b.required_span_size()");
+
+	for (std::size_t i = 0; i < 6; ++i)
+		for (std::size_t j = 0; j < 6; ++j)
+			b(i, j) = static_cast<int>(i * 6 + j);
+
+	//tile (0, 0) is rows 0-3 and columns 0-3; tile (0, 1) follows
+	is_true(storage[0] == 0 && storage[1] == 1 && storage[4] == 6 && storage[15] == 21, "first tile");
+	is_true(storage[16] == 4 && storage[17] == 5 && storage[18] == -1 && storage[32] == 24, "next tiles");
+
+	bool distinct = true;
+	for (std::size_t i = 0; i < 6; ++i)
+		for (std::size_t j = 0; j < 6; ++j)
+			distinct = distinct && b(i, j) == static_cast<int>(i * 6 + j);
+	is_true(distinct, "every element has its own offset");
+
+	const mdspan<int, 3, blocked> b3(storage.data(), 4, 4, 4);
+	is_true(b3.required_span_size() == 64 && &b3(1, 2, 3) == storage.data() + 16 + 8 + 3, "rank 3");
+}
+
+
+void test_submdspan()
+{
+	int values[24];
+	for (int i = 0; i < 24; ++i)
+		values[i] = i;
+
+	const mdspan m(values, 2, 3, 4);
+
+	const auto row = submdspan(m, 1, 2, full_extent);
+	is_true(row.rank() == 1 && row.extent(0) == 4 && row(0) == 20 && row(3) == 23, "submdspan(index, index, all)");
+
+	const auto column = submdspan(m, full_extent, 1, 3);
+	is_true(column.rank() == 1 && column.extent(0) == 2 && column(1) == 19 && column.stride(0) == 12,
+		"submdspan(all, index, index)");
+
+	const auto block = submdspan(m, 1, std::pair{ 1, 3 }, std::pair{ 2, 4 });
+	is_true(block.rank() == 2 && block.extent(0) == 2 && block.extent(1) == 2, "submdspan(range) shape");
+	is_true(block(0, 0) == 18 && block(1, 1) == 23, "submdspan(range) elements");
+
+	//a slice of a slice; and a slice of a column-major view
+	const auto inner = submdspan(block, full_extent, 1);
+	is_true(inner.extent(0) == 2 && inner(1) == 23, "submdspan(submdspan)");
+
+	const mdspan<int, 2, sigcpp::layout_left> left(values, 4, 6);
+	const auto leftRow = submdspan(left, 2, std::pair{ 1, 4 });
+	is_true(leftRow(0) == 6 && leftRow(2) == 14, "submdspan(layout_left)");
+
+	const auto element = submdspan(m, 1, 1, 1);
+	is_true(element.rank() == 0 && element() == 17, "submdspan(indices)");
+}
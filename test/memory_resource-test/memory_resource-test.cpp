@@ -0,0 +1,310 @@
+/*
+* memory_resource-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for monotonic_arena, pool_resource, and resource_allocator
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../include/array.h"
+#include "../../include/bit_vector.h"
+#include "../../include/bloom_filter.h"
+#include "../../include/compressed_sorted_array.h"
+#include "../../include/cuckoo_filter.h"
+#include "../../include/flat_hash_map.h"
+#include "../../include/memory_resource.h"
+#include "../../include/slot_map.h"
+#include "../../include/small_vector.h"
+#include "../../include/soa_vector.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::monotonic_arena;
+using sigcpp::pool_resource;
+using sigcpp::resource_allocator;
+
+void test_monotonic_arena();
+void test_pool_resource();
+void test_resource_allocator();
+
+void memory_resource_test()
+{
+	test_monotonic_arena();
+	test_pool_resource();
+	test_resource_allocator();
+}
+
+
+//an upstream resource that counts the bytes it has out
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+	std::size_t bytes = 0;
+	std::size_t allocations = 0;
+
+protected:
+	void* do_allocate(std::size_t n, std::size_t alignment) override
+	{
+		bytes += n;
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(n, alignment);
+	}
+
+	void do_deallocate(void* p, std::size_t n, std::size_t alignment) override
+	{
+		bytes -= n;
+		std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override { return this == &r; }
+};
+
+
+bool is_aligned(const void* p, std::size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+
+void test_monotonic_arena()
+{
+	counting_resource upstream;
+	sigcpp::array<std::byte, 256> buffer;
+	{
+		monotonic_arena arena(buffer, &upstream);
+		const auto a = arena.allocate(10, 1);
+		const auto b = arena.allocate(16, 16);
+		is_true(a == buffer.data() && is_aligned(b, 16) && upstream.allocations == 0,
+			"arena: the initial buffer serves the first allocations");
+
+		//past the buffer: chunks from upstream
+		for (int i = 0; i < 100; ++i)
+			(void)arena.allocate(40, 8);
+		const auto chunks = upstream.allocations;
+		is_true(chunks >= 1 && upstream.bytes >= 100 * 40 - 256, "arena: chunks from upstream past the buffer");
+
+		const auto big = arena.allocate(100000, 64);
+		is_true(is_aligned(big, 64) && upstream.bytes >= 100000, "arena: an allocation larger than a chunk");
+
+		//reset: the same memory again, and no chunk freed or allocated
+		const auto bytes = upstream.bytes, allocations = upstream.allocations;
+		arena.reset();
+		const auto again = arena.allocate(10, 1);
+		for (int i = 0; i < 100; ++i)
+			(void)arena.allocate(40, 8);
+		(void)arena.allocate(100000, 64);
+		is_true(again == a && upstream.bytes == bytes && upstream.allocations == allocations,
+			"arena.reset(): chunks are reused");
+
+		arena.deallocate(again, 10, 1);
+		arena.release();
+		is_true(upstream.bytes == 0 && arena.allocate(10, 1) == a, "arena.release(): chunks return upstream");
+	}
+	is_true(upstream.bytes == 0, "~monotonic_arena");
+
+	monotonic_arena unbuffered(&upstream);
+	const auto p = unbuffered.allocate(8, 8);
+	is_true(p != nullptr && upstream.allocations != 0 && unbuffered.is_equal(unbuffered) &&
+		!unbuffered.is_equal(upstream), "arena without a buffer");
+
+	//a request too large for any chunk throws rather than returning nullptr
+	bool thrown = false;
+	try {
+		(void)unbuffered.allocate(std::numeric_limits<std::size_t>::max() - 8, 16);
+	}
+	catch (const std::bad_alloc&) {
+		thrown = true;
+	}
+	is_true(thrown, "arena: an allocation too large throws bad_alloc");
+}
+
+
+void test_pool_resource()
+{
+	counting_resource upstream;
+	{
+		pool_resource pool(24, 8, &upstream);
+		is_true(pool.block_size() % alignof(std::max_align_t) == 0 && pool.block_size() >= 24, "pool.block_size()");
+
+		void* blocks[20];
+		for (auto& block : blocks)
+			block = pool.allocate(24, 8);
+		is_true(upstream.allocations == 3 && is_aligned(blocks[19], alignof(std::max_align_t)),
+			"pool: 20 blocks from 3 chunks of 8");
+
+		//a freed block is the next one given out
+		pool.deallocate(blocks[5], 24, 8);
+		is_true(pool.allocate(16, 8) == blocks[5] && upstream.allocations == 3, "pool: free list reuse");
+
+		//larger than a block: upstream
+		const auto big = pool.allocate(1000, 8);
+		is_true(upstream.allocations == 4, "pool: a large allocation goes upstream");
+		pool.deallocate(big, 1000, 8);
+
+		pool.release();
+		is_true(upstream.bytes == 0, "pool.release()");
+	}
+	is_true(upstream.bytes == 0, "~pool_resource");
+}
+
+
+void test_resource_allocator()
+{
+	counting_resource upstream;
+	monotonic_arena arena(&upstream);
+
+	//sigcpp containers with an Allocator parameter
+	sigcpp::vector<int, resource_allocator<int>> v(&arena);
+	for (int i = 0; i < 1000; ++i)
+		v.push_back(i);
+	is_true(v.size() == 1000 && v[999] == 999 && upstream.allocations != 0 && v.get_allocator().resource() == &arena,
+		"sigcpp::vector with resource_allocator");
+
+	sigcpp::small_vector<std::string, 2, resource_allocator<std::string>> sv(&arena);
+	sv.push_back("a");
+	sv.push_back("b");
+	sv.push_back("c");
+	is_true(sv.size() == 3 && sv[2] == "c", "sigcpp::small_vector with resource_allocator");
+
+	using map_allocator = resource_allocator<std::pair<const int, int>>;
+	sigcpp::flat_hash_map<int, int, std::hash<int>, std::equal_to<int>, map_allocator> m(0, std::hash<int>(),
+		std::equal_to<int>(), map_allocator(&arena));
+	for (int i = 0; i < 100; ++i)
+		m[i] = i * i;
+	is_true(m.size() == 100 && m[9] == 81, "sigcpp::flat_hash_map with resource_allocator");
+
+	//assignment keeps the target's resource: resource_allocator does not propagate
+	using arena_map = sigcpp::flat_hash_map<int, int, std::hash<int>, std::equal_to<int>, map_allocator>;
+	arena_map plainMap;
+	plainMap[1] = 10;
+	arena_map copied(0, std::hash<int>(), std::equal_to<int>(), map_allocator(&arena));
+	copied = plainMap;
+	is_true(copied.get_allocator().resource() == &arena && copied.size() == 1 && copied[1] == 10,
+		"sigcpp::flat_hash_map copy assignment between resources");
+
+	copied = std::move(plainMap);
+	is_true(copied.get_allocator().resource() == &arena && copied.size() == 1 && copied[1] == 10 && plainMap.empty(),
+		"sigcpp::flat_hash_map move assignment between resources");
+
+	arena_map moved(0, std::hash<int>(), std::equal_to<int>(), map_allocator(&arena));
+	const auto capacity = m.capacity();
+	moved = std::move(m);
+	is_true(moved.get_allocator().resource() == &arena && moved.size() == 100 && moved.capacity() == capacity &&
+		moved[9] == 81 && m.empty(), "sigcpp::flat_hash_map move assignment within a resource");
+
+	moved.swap(copied);
+	is_true(moved.size() == 1 && copied.size() == 100 && moved.get_allocator().resource() == &arena,
+		"sigcpp::flat_hash_map swap within a resource");
+
+	pool_resource pool(sizeof(int) * 4, 64, &upstream);
+	sigcpp::slot_map<int, resource_allocator<int>> slots{ resource_allocator<int>(&pool) };
+	const auto h = slots.insert(42);
+	is_true(slots[h] == 42 && slots.get_allocator().resource() == &pool, "sigcpp::slot_map with resource_allocator");
+
+	//containers of several arrays rebind the allocator for each
+	sigcpp::basic_soa_vector<resource_allocator<std::byte>, int, std::string> table{ resource_allocator<std::byte>(&arena) };
+	table.emplace_back(1, "one");
+	table.emplace_back(2, "two");
+	is_true(table.size() == 2 && table.column<1>()[1] == "two" && table.column<1>().get_allocator().resource() == &arena &&
+		table.get_allocator().resource() == &arena, "sigcpp::basic_soa_vector with resource_allocator");
+
+	using word_allocator = resource_allocator<std::uint64_t>;
+	sigcpp::bit_vector<word_allocator> bits(1000, false, word_allocator(&arena));
+	bits.set(3).set(700);
+	const sigcpp::rank_select<word_allocator> index(bits, word_allocator(&pool));
+	is_true(bits.get_allocator().resource() == &arena && index.get_allocator().resource() == &pool &&
+		index.rank(701) == 2 && index.select(1) == 700, "sigcpp::bit_vector and rank_select with resource_allocator");
+
+	sigcpp::vector<std::uint32_t> sorted(1000);
+	for (std::uint32_t i = 0; i < 1000; ++i)
+		sorted[i] = i * 3;
+	using value_allocator = resource_allocator<std::uint32_t>;
+	const sigcpp::compressed_sorted_array<value_allocator> compressed(sorted, value_allocator(&arena));
+	is_true(compressed.contains(2997) && !compressed.contains(2998) && compressed.get_allocator().resource() == &arena,
+		"sigcpp::compressed_sorted_array with resource_allocator");
+
+	using bloom = sigcpp::bloom_filter<sigcpp::string_hash, resource_allocator<std::uint32_t>>;
+	bloom bf(100, 12, sigcpp::string_hash(), resource_allocator<std::uint32_t>(&arena));
+	bf.insert("key");
+	is_true(bf.contains("key") && bf.get_allocator().resource() == &arena, "sigcpp::bloom_filter with resource_allocator");
+
+	//move assignment between resources moves the lanes to a buffer aligned afresh
+	bloom other(100, 12, sigcpp::string_hash(), resource_allocator<std::uint32_t>(&pool));
+	other = std::move(bf);
+	is_true(other.contains("key") && other.get_allocator().resource() == &pool,
+		"sigcpp::bloom_filter move assignment between resources");
+
+	//copy assignment keeps the target's resource
+	bloom plain(100);
+	plain.insert("copied");
+	bloom target(100, 12, sigcpp::string_hash(), resource_allocator<std::uint32_t>(&arena));
+	target = plain;
+	is_true(target.contains("copied") && target.get_allocator().resource() == &arena &&
+		plain.get_allocator().resource() == std::pmr::get_default_resource(),
+		"sigcpp::bloom_filter copy assignment between resources");
+
+	using cuckoo = sigcpp::cuckoo_filter<std::uint16_t, sigcpp::string_hash, resource_allocator<std::uint16_t>>;
+	cuckoo cf(100, sigcpp::string_hash(), resource_allocator<std::uint16_t>(&arena));
+	cf.insert("key");
+	is_true(cf.contains("key") && cf.get_allocator().resource() == &arena, "sigcpp::cuckoo_filter with resource_allocator");
+
+	//uses-allocator construction: nested containers draw from the outer container's resource
+	using inner = sigcpp::vector<int, resource_allocator<int>>;
+	sigcpp::vector<inner, resource_allocator<inner>> outer(&arena);
+	outer.emplace_back();
+	outer.back().push_back(1);
+	inner plainInner{ 2, 3 };
+	outer.push_back(plainInner);
+	outer.push_back(std::move(plainInner));
+	outer.resize(5);
+	bool nested = true;
+	for (const auto& e : outer)
+		nested = nested && e.get_allocator().resource() == &arena;
+	is_true(nested && outer[1][1] == 3 && outer[2][0] == 2 && outer[4].empty(),
+		"sigcpp::vector of vectors: uses-allocator construction");
+
+	using small_inner = sigcpp::small_vector<int, 1, resource_allocator<int>>;
+	sigcpp::small_vector<small_inner, 1, resource_allocator<small_inner>> smallOuter(&arena);
+	smallOuter.emplace_back(3, 7);
+	smallOuter.push_back(small_inner{ 1, 2 });
+	is_true(smallOuter[0].get_allocator().resource() == &arena && smallOuter[1].get_allocator().resource() == &arena &&
+		smallOuter[0][2] == 7 && smallOuter[1][1] == 2, "sigcpp::small_vector of small_vectors: uses-allocator construction");
+
+	sigcpp::vector<std::pmr::string, resource_allocator<std::pmr::string>> strings(&arena);
+	strings.emplace_back("a string long enough to need a buffer of its own");
+	is_true(strings[0].get_allocator().resource() == &arena, "sigcpp::vector of std::pmr::string: uses-allocator construction");
+
+	//a copy uses the default resource, as with polymorphic_allocator
+	const auto copy = v;
+	is_true(copy.get_allocator().resource() == std::pmr::get_default_resource() && copy == v,
+		"copy of a container: default resource");
+
+	//std containers, and conversion to and from polymorphic_allocator
+	std::list<int, resource_allocator<int>> list{ resource_allocator<int>(&pool) };
+	for (int i = 0; i < 10; ++i)
+		list.push_back(i);
+	is_true(list.size() == 10 && list.back() == 9, "std::list with resource_allocator and pool_resource");
+
+	std::pmr::polymorphic_allocator<int> pa = resource_allocator<int>(&arena);
+	std::pmr::vector<int> pv(pa);
+	pv.push_back(1);
+	const resource_allocator<long> back(pa);
+	is_true(pa.resource() == &arena && back == resource_allocator<int>(&arena) && back != resource_allocator<int>(&pool),
+		"conversion to and from std::pmr::polymorphic_allocator");
+}
@@ -0,0 +1,157 @@
+/*
+* mpmc_queue-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for mpmc_queue
+*/
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/mpmc_queue.h"
+
+#include "../verifiers.h"
+
+using sigcpp::mpmc_queue;
+
+void test_mpmc_queue_single_thread();
+void test_mpmc_queue_threads();
+void test_mpmc_queue_blocking();
+
+void mpmc_queue_test()
+{
+	test_mpmc_queue_single_thread();
+	test_mpmc_queue_threads();
+	test_mpmc_queue_blocking();
+}
+
+
+void test_mpmc_queue_single_thread()
+{
+	mpmc_queue<int, 4> q;
+	is_true(q.empty() && q.size() == 0 && q.capacity() == 4, "q empty");
+
+	//each cell on its own line
+	static_assert(alignof(sigcpp::detail::mpmc_cell<int>) == sigcpp::cache_line_size);
+
+	int value = -1;
+	is_false(q.try_pop(value), "q.try_pop() when empty");
+
+	for (int i = 1; i <= 4; ++i)
+		q.try_push(i);
+	is_true(q.size() == 4, "q.size() when full");
+	is_false(q.try_push(5), "q.try_push() when full");
+
+	//FIFO, across a lap of the cells
+	is_true(q.try_pop(value) && value == 1, "q.try_pop()");
+	is_true(q.try_push(5) && q.try_emplace(6) == false, "q.try_push() after pop");
+	for (int expected = 2; expected <= 5; ++expected) {
+		is_true(q.try_pop(value) && value == expected, "q.try_pop() across lap");
+	}
+	is_true(q.empty(), "q empty after draining");
+
+	mpmc_queue<std::unique_ptr<int>, 2> u;
+	is_true(u.try_push(std::make_unique<int>(7)), "u.try_push(unique_ptr)");
+	std::unique_ptr<int> p;
+	is_true(u.try_pop(p) && *p == 7, "u.try_pop(unique_ptr)");
+
+	mpmc_queue<std::string, 2> s;
+	is_true(s.try_emplace(3, 'x'), "s.try_emplace(count, char)");
+	std::string str;
+	is_true(s.try_pop(str) && str == "xxx", "s.try_pop() after emplace");
+}
+
+
+//several producers and consumers: every value arrives exactly once
+void test_mpmc_queue_threads()
+{
+	constexpr int producers = 3, consumers = 3, per_producer = 20000;
+	constexpr int total = producers * per_producer;
+	auto q = std::make_unique<mpmc_queue<int, 64>>();
+	auto seen = std::make_unique<std::atomic<int>[]>(total);
+	std::atomic<int> popped{ 0 };
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p)
+		threads.emplace_back([&q, p] {
+			for (int i = 0; i < per_producer; ++i)
+				while (!q->try_push(p * per_producer + i))
+					std::this_thread::yield();
+		});
+
+	for (int c = 0; c < consumers; ++c)
+		threads.emplace_back([&] {
+			int value;
+			while (popped.load() < total) {
+				if (q->try_pop(value)) {
+					seen[value].fetch_add(1);
+					popped.fetch_add(1);
+				}
+				else
+					std::this_thread::yield();
+			}
+		});
+
+	for (auto& t : threads)
+		t.join();
+
+	bool once = true;
+	for (int i = 0; i < total; ++i)
+		once = once && seen[i].load() == 1;
+	is_true(once && popped.load() == total, "threads: every value popped once");
+	is_true(q->empty(), "threads: q empty at end");
+}
+
+
+void test_mpmc_queue_blocking()
+{
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	constexpr int count = 20000;
+	auto q = std::make_unique<mpmc_queue<long, 8>>();
+
+	//blocking producers against a mix of blocking and non-blocking consumers
+	std::thread p1([&q] {
+		for (int i = 1; i <= count; ++i)
+			q->push(i);
+	});
+	std::thread p2([&q] {
+		for (int i = 1; i <= count; ++i)
+			q->emplace(i);
+	});
+
+	long sum = 0;
+	std::thread c1([&q, &sum] {
+		for (int i = 0; i < count; ++i)
+			sum += q->pop();
+	});
+
+	long trySum = 0;
+	long value;
+	for (int i = 0; i < count;) {
+		if (q->try_pop(value)) {
+			trySum += value;
+			++i;
+		}
+		else
+			std::this_thread::yield();
+	}
+
+	p1.join();
+	p2.join();
+	c1.join();
+
+	const long expected = 2L * count * (count + 1) / 2;
+	is_true(sum + trySum == expected, "blocking push/pop: sum of values");
+	is_true(q->empty(), "blocking: q empty at end");
+#endif
+}
@@ -20,11 +20,29 @@
 #include <cstddef>
 #include <cassert>
 #include <climits>
+#include <utility>
+
+#include "../include/array.h"
+#include "../include/perfect_hash_map.h"
 
 #include "options.h"
 #include "options-exceptions.h"
 #include "utils.h"
 
+namespace
+{
+	//options in name-value pairs
+	enum class option_name { header, header_text, summary, prm, threshold, run, file };
+
+	//names of cmd-line options: a perfect hash built at compile time
+	//file options share a kind: get_file_open_mode tells them apart
+	using namespace std::string_view_literals;
+	constexpr auto option_names = sigcpp::make_perfect_hash_map(sigcpp::array<std::pair<std::string_view, option_name>, 9>{ {
+		{ "-h"sv, option_name::header }, { "-ht"sv, option_name::header_text }, { "-s"sv, option_name::summary },
+		{ "-p"sv, option_name::prm }, { "-t"sv, option_name::threshold }, { "-run"sv, option_name::run },
+		{ "-fn"sv, option_name::file }, { "-fo"sv, option_name::file }, { "-fa"sv, option_name::file } } });
+}
+
 Options get_options(char* arguments[], const std::size_t size)
 {
 	//args should not be empty: args[0] should be path to executable file ("command name")
@@ -49,11 +67,6 @@ Options get_options(char* arguments[], const std::size_t size)
 
 	options.command_name = command_path.replace_extension("").filename().string();
 
-	//names in name-value pair for cmd-line options
-	constexpr std::string_view option_name_header{ "-h" }, option_name_header_text{ "-ht" },
-		option_name_summary{ "-s" }, option_name_prm{ "-p" }, option_name_threshold{ "-t" },
-		option_name_file_start{ "-f" }, option_name_run{ "-run" };
-
 	std::string_view prm_value;
 	std::string output_filepath_value;
 
@@ -73,25 +86,35 @@ Options get_options(char* arguments[], const std::size_t size)
 		else if (name[0] != '-')
 			throw invalid_option_name{ name };
 
-		if (name == option_name_header)
+		const auto option = option_names.find(name);
+		if (option == nullptr) { //unknown option
+			assert(false);
+			throw invalid_option_name{ name };
+		}
+
+		switch (*option) {
+		case option_name::header:
 			options.header = strtobool(value);
-		else if (name == option_name_header_text)
+			break;
+		case option_name::header_text:
 			options.header_text = value;
-		else if (name == option_name_summary)
+			break;
+		case option_name::summary:
 			options.summary = strtobool(value);
-		else if (name == option_name_prm)
+			break;
+		case option_name::prm:
 			prm_value = value; //delay converting prm to enum until after file open mode is known
-		else if (name == option_name_threshold)
+			break;
+		case option_name::threshold:
 			options.fail_threshold = get_fail_threshold(value);
-		else if (name == option_name_run)
+			break;
+		case option_name::run:
 			options.suites_to_run = value;
-		else if (name._Starts_with(option_name_file_start)) {
+			break;
+		case option_name::file:
 			options.fom = get_file_open_mode(name);
 			output_filepath_value = value;
-		}
-		else { //unknown option
-			assert(false);
-			throw invalid_option_name{ name };
+			break;
 		}
 	}
 
@@ -0,0 +1,175 @@
+/*
+* packed_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for packed_array
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "../../include/packed_array.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::packed_array;
+
+void test_packed_array_access();
+void test_packed_array_iterators();
+void test_packed_array_bulk();
+
+void packed_array_test()
+{
+	test_packed_array_access();
+	test_packed_array_iterators();
+	test_packed_array_bulk();
+}
+
+
+//value i of a test pattern, kept to Bits bits
+template<unsigned Bits>
+std::uint32_t pattern_value(std::size_t i)
+{
+	return static_cast<std::uint32_t>((i * 2654435761u) >> 7) & packed_array<Bits, 1>::max_value;
+}
+
+
+void test_packed_array_access()
+{
+	packed_array<7, 20> a{ 1, 2, 127, 128 };
+	is_true(a.size() == 20 && !a.empty() && a[0] == 1 && a[2] == 127 && a[3] == 0 && a[19] == 0,
+		"packed_array{list}: values keep their low Bits bits");
+	is_true(sizeof(a) == 4 * sizeof(std::uint64_t), "packed_array<7, 20> size: 140 bits in 3 words, and a spare word");
+
+	//value 9 spans words 0 and 1
+	a[9] = 100;
+	a.at(10) = a[9];
+	is_true(a[9] == 100 && a.at(10) == 100 && a[8] == 0 && a[11] == 0, "a[pos] = value across a word");
+
+	a.front() = 5;
+	a.back() = 6;
+	is_true(a[0] == 5 && a[19] == 6 && a.front() == 5 && a.back() == 6, "front(), back()");
+
+	bool thrown = false;
+	try {
+		a.at(20);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "a.at(20) throws");
+
+	packed_array<7, 20> b;
+	b.fill(127);
+	is_true(std::all_of(b.cbegin(), b.cend(), [](std::uint32_t v) { return v == 127; }), "b.fill(127)");
+
+	b.swap(a);
+	is_true(a[0] == 127 && b[0] == 5 && a != b, "a.swap(b)");
+
+	b = a;
+	is_true(a == b, "a == b");
+
+	packed_array<32, 3> full{ 0xFFFFFFFF, 0, 0x80000001 };
+	is_true(full[0] == 0xFFFFFFFF && full[1] == 0 && full[2] == 0x80000001, "packed_array<32, N>");
+
+	constexpr packed_array<5, 4> c{ 31, 1, 2, 3 };
+	static_assert(c[0] == 31 && c[3] == 3 && c.size() == 4, "constexpr packed_array");
+}
+
+
+void test_packed_array_iterators()
+{
+	packed_array<12, 100> a;
+	for (std::size_t i = 0; i < a.size(); ++i)
+		a[i] = pattern_value<12>(i);
+
+	//standard algorithms through the proxy references and iterators
+	std::sort(a.begin(), a.end());
+	is_true(std::is_sorted(a.cbegin(), a.cend()), "std::sort(a.begin(), a.end())");
+
+	std::reverse(a.begin(), a.end());
+	is_true(std::is_sorted(a.crbegin(), a.crend()) && *a.rbegin() == a[99] && *a.crbegin() == a.back(),
+		"std::reverse, reverse iterators");
+
+	std::iota(a.begin(), a.end(), 4000u);
+	is_true(a[0] == 4000 && a[99] == 4099 % 4096 && a.end() - a.begin() == 100, "std::iota wraps at Bits");
+
+	auto it = a.begin();
+	it += 10;
+	packed_array<12, 100>::const_iterator cit = it;
+	is_true(*cit == 4010 && cit == it && it - a.begin() == 10 && a.cbegin() < cit, "iterator to const_iterator");
+
+	swap(a[0], a[1]);
+	is_true(a[0] == 4001 && a[1] == 4000, "swap(a[0], a[1])");
+
+	is_true(std::count(a.cbegin(), a.cend(), 4000u) == 1 && std::find(a.begin(), a.end(), 4002u) - a.begin() == 2,
+		"std::count, std::find");
+}
+
+
+//unpack and pack values [first, first + count) of a packed_array<Bits, 1000>
+template<unsigned Bits>
+bool check_bulk(std::size_t first, std::size_t count)
+{
+	packed_array<Bits, 1000> a;
+	for (std::size_t i = 0; i < a.size(); ++i)
+		a[i] = pattern_value<Bits>(i);
+
+	sigcpp::vector<std::uint32_t> out(count);
+	a.unpack_into(out, first);
+	for (std::size_t i = 0; i < count; ++i)
+		if (out[i] != pattern_value<Bits>(first + i))
+			return false;
+
+	//pack a different pattern: values outside the range must not change
+	for (auto& v : out)
+		v = ~v;
+	a.pack_from(out, first);
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		const auto inRange = i >= first && i < first + count;
+		const auto expected = inRange ? ~pattern_value<Bits>(i) & a.max_value : pattern_value<Bits>(i);
+		if (a[i] != expected)
+			return false;
+	}
+	return true;
+}
+
+
+template<unsigned Bits>
+bool check_bulk_ranges()
+{
+	return check_bulk<Bits>(0, 1000) && check_bulk<Bits>(3, 990) && check_bulk<Bits>(8, 17) &&
+		check_bulk<Bits>(500, 7) && check_bulk<Bits>(999, 1) && check_bulk<Bits>(1000, 0);
+}
+
+
+void test_packed_array_bulk()
+{
+	is_true(check_bulk_ranges<3>() && check_bulk_ranges<4>() && check_bulk_ranges<7>(),
+		"unpack_into, pack_from: Bits 3, 4, 7");
+	is_true(check_bulk_ranges<12>() && check_bulk_ranges<13>() && check_bulk_ranges<20>(),
+		"unpack_into, pack_from: Bits 12, 13, 20");
+	is_true(check_bulk_ranges<25>() && check_bulk_ranges<26>() && check_bulk_ranges<32>(),
+		"unpack_into, pack_from: Bits 25, 26, 32");
+
+	packed_array<9, 10> a;
+	sigcpp::vector<std::uint32_t> out(4);
+	bool thrown = false;
+	try {
+		a.unpack_into(out, 7);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "unpack_into past the end throws");
+}
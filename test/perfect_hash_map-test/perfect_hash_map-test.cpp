@@ -0,0 +1,115 @@
+/*
+* perfect_hash_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for perfect_hash_map
+*/
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../../include/array.h"
+#include "../../include/perfect_hash_map.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::perfect_hash_map;
+using sigcpp::make_perfect_hash_map;
+
+void test_perfect_hash_map_constexpr();
+void test_perfect_hash_map_many();
+void test_perfect_hash_map_duplicates();
+
+void perfect_hash_map_test()
+{
+	test_perfect_hash_map_constexpr();
+	test_perfect_hash_map_many();
+	test_perfect_hash_map_duplicates();
+}
+
+
+void test_perfect_hash_map_constexpr()
+{
+	using namespace std::string_view_literals;
+	constexpr auto colors = make_perfect_hash_map(sigcpp::array<std::pair<std::string_view, int>, 6>{ {
+		{ "red"sv, 0xFF0000 }, { "green"sv, 0x00FF00 }, { "blue"sv, 0x0000FF },
+		{ "black"sv, 0 }, { "white"sv, 0xFFFFFF }, { "gray"sv, 0x808080 } } });
+
+	static_assert(colors.size() == 6 && colors.slot_count == 8);
+	static_assert(*colors.find("green") == 0x00FF00 && colors.at("gray") == 0x808080);
+	static_assert(!colors.contains("grey") && !colors.contains("") && !colors.contains("redd"));
+
+	//the same lookups at run time
+	std::string key{ "white" };
+	is_true(colors.contains(key) && colors.at(key) == 0xFFFFFF, "colors.at(run-time key)");
+	key = "purple";
+	is_true(colors.find(key) == nullptr, "colors.find(missing)");
+
+	bool thrown = false;
+	try {
+		colors.at(key);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "colors.at(missing)");
+
+	//sigcpp::string_view keys
+	constexpr perfect_hash_map<sigcpp::string_view, char, 3> grades(sigcpp::array<std::pair<sigcpp::string_view, char>, 3>{ {
+		{ "pass", 'P' }, { "fail", 'F' }, { "incomplete", 'I' } } });
+	static_assert(grades.at("fail") == 'F' && !grades.contains("pas"));
+
+	constexpr perfect_hash_map<std::string_view, int, 0> none(sigcpp::array<std::pair<std::string_view, int>, 0>{});
+	static_assert(none.empty() && !none.contains("a"));
+
+	constexpr auto one = make_perfect_hash_map(sigcpp::array<std::pair<std::string_view, int>, 1>{ { { "a"sv, 1 } } });
+	static_assert(one.at("a") == 1 && !one.contains("b") && !one.contains(""));
+}
+
+
+//built at run time: every key found, and similar keys that are not in the table missed
+void test_perfect_hash_map_many()
+{
+	constexpr std::size_t n = 500;
+	sigcpp::array<std::string, n> names;
+	sigcpp::array<std::pair<std::string_view, std::size_t>, n> entries;
+	for (std::size_t i = 0; i < n; ++i) {
+		names[i] = "key-" + std::to_string(i * 7);
+		entries[i] = { names[i], i };
+	}
+
+	const auto table = make_perfect_hash_map(entries);
+	bool same = true;
+	for (std::size_t i = 0; i < n; ++i)
+		same = same && table.contains(names[i]) && table.at(names[i]) == i;
+	is_true(same, "every key found");
+
+	bool missed = true;
+	for (std::size_t i = 0; i < n; ++i)
+		missed = missed && !table.contains("key-" + std::to_string(i * 7 + 1));
+	is_true(missed, "other keys missed");
+}
+
+
+void test_perfect_hash_map_duplicates()
+{
+	using namespace std::string_view_literals;
+	bool thrown = false;
+	try {
+		make_perfect_hash_map(sigcpp::array<std::pair<std::string_view, int>, 3>{ {
+			{ "x"sv, 1 }, { "y"sv, 2 }, { "x"sv, 3 } } });
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "duplicate keys");
+}
@@ -0,0 +1,162 @@
+/*
+* search-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for searchers and the search algorithm
+* - see C++17 [func.search], [alg.search]
+* - https://timsong-cpp.github.io/cppwp/n4659/func.search
+*/
+
+#include <string>
+
+#include "../../include/array.h"
+#include "../../include/search.h"
+#include "../../include/string_view.h"
+
+#include "../verifiers.h"
+
+using sigcpp::string_view;
+
+void test_search_algorithm();
+void test_bmh_searcher();
+void test_two_way_searcher();
+void test_searcher_reuse();
+void test_string_view_long_find();
+
+void search_test()
+{
+	test_search_algorithm();
+	test_bmh_searcher();
+	test_two_way_searcher();
+	test_searcher_reuse();
+	test_string_view_long_find();
+}
+
+
+void test_search_algorithm()
+{
+	sigcpp::array<int, 8> a{ 3, 1, 4, 1, 5, 9, 2, 6 };
+	sigcpp::array<int, 2> p{ 1, 5 };
+	sigcpp::array<int, 2> q{ 6, 1 };
+
+	is_true(sigcpp::search(a.begin(), a.end(), p.begin(), p.end()) - a.begin() == 3, "search(a, p)");
+	is_true(sigcpp::search(a.begin(), a.end(), q.begin(), q.end()) == a.end(), "search(a, q) missing");
+	is_true(sigcpp::search(a.begin(), a.end(), p.begin(), p.begin()) == a.begin(), "search(a, empty)");
+
+	sigcpp::default_searcher<sigcpp::array<int, 2>::iterator> ds(p.begin(), p.end());
+	auto [first, last] = ds(a.begin(), a.end());
+	is_true(first - a.begin() == 3 && last - first == 2, "default_searcher(a)");
+	is_true(sigcpp::search(a.begin(), a.end(), ds) - a.begin() == 3, "search(a, default_searcher)");
+}
+
+
+void test_bmh_searcher()
+{
+	//                   0         1         2
+	//                   0123456789012345678901234
+	sigcpp::array<char, 25> text{ 'h','e','r','e',' ','i','s',' ','a',' ','s','i','m','p','l','e',' ',
+		'e','x','a','m','p','l','e','!' };
+
+	string_view pattern{ "example" };
+	sigcpp::boyer_moore_horspool_searcher<string_view::const_iterator> bmh(pattern.begin(), pattern.end());
+
+	auto [first, last] = bmh(text.begin(), text.end());
+	is_true(first - text.begin() == 17, "bmh(text).first");
+	is_true(last - first == 7, "bmh(text).second");
+
+	string_view missing{ "samples" };
+	sigcpp::boyer_moore_horspool_searcher<const char*> bmh_m(missing.data(), missing.data() + missing.size());
+	is_true(sigcpp::search(text.begin(), text.end(), bmh_m) == text.end(), "bmh(text) missing");
+
+	//pattern at the very start and at the very end
+	string_view sv{ text.data(), text.size() };
+	string_view head{ "here" }, tail{ "ple!" };
+	sigcpp::boyer_moore_horspool_searcher<const char*> bmh_h(head.data(), head.data() + head.size());
+	sigcpp::boyer_moore_horspool_searcher<const char*> bmh_t(tail.data(), tail.data() + tail.size());
+	is_true(sigcpp::search(sv.begin(), sv.end(), bmh_h) == sv.begin(), "bmh(text) at start");
+	is_true(sigcpp::search(sv.begin(), sv.end(), bmh_t) - sv.begin() == 21, "bmh(text) at end");
+
+	//empty pattern matches at the start
+	sigcpp::boyer_moore_horspool_searcher<const char*> bmh_e(head.data(), head.data());
+	is_true(sigcpp::search(sv.begin(), sv.end(), bmh_e) == sv.begin(), "bmh(text) empty pattern");
+}
+
+
+void test_two_way_searcher()
+{
+	//periodic pattern in a text of near matches: the naive search is quadratic here
+	std::string text(200, 'a');
+	text += "ab";
+	std::string pattern(50, 'a');
+	pattern += 'b';
+
+	sigcpp::two_way_searcher<std::string::const_iterator> tw(pattern.cbegin(), pattern.cend());
+	auto [first, last] = tw(text.cbegin(), text.cend());
+	is_true(first - text.cbegin() == 151, "two_way(text).first periodic");
+	is_true(last == text.cend(), "two_way(text).second periodic");
+
+	//non-periodic pattern
+	std::string mixed{ "the quick brown fox jumps over the lazy dog" };
+	std::string word{ "lazy" };
+	sigcpp::two_way_searcher<std::string::const_iterator> tw_w(word.cbegin(), word.cend());
+	is_true(sigcpp::search(mixed.cbegin(), mixed.cend(), tw_w) - mixed.cbegin() == 35, "two_way(mixed)");
+
+	std::string absent{ "lazy cat" };
+	sigcpp::two_way_searcher<std::string::const_iterator> tw_a(absent.cbegin(), absent.cend());
+	is_true(sigcpp::search(mixed.cbegin(), mixed.cend(), tw_a) == mixed.cend(), "two_way(mixed) missing");
+
+	//non-char elements
+	sigcpp::array<int, 10> a{ 1, 2, 1, 2, 1, 3, 1, 2, 1, 2 };
+	sigcpp::array<int, 4> p{ 1, 2, 1, 3 };
+	sigcpp::two_way_searcher<sigcpp::array<int, 4>::iterator> tw_i(p.begin(), p.end());
+	is_true(sigcpp::search(a.begin(), a.end(), tw_i) - a.begin() == 2, "two_way(int array)");
+}
+
+
+//a searcher is built once and applied to many haystacks
+void test_searcher_reuse()
+{
+	string_view pattern{ "needle" };
+	sigcpp::boyer_moore_horspool_searcher<const char*> bmh(pattern.data(), pattern.data() + pattern.size());
+	sigcpp::two_way_searcher<const char*> tw(pattern.data(), pattern.data() + pattern.size());
+
+	string_view haystacks[]{ "needle", "hay needle", "haystack", "needlneedle", "" };
+	std::size_t expected[]{ 0, 4, string_view::npos, 5, string_view::npos };
+
+	bool reuse_test{ true };
+	for (std::size_t i = 0; i < 5 && reuse_test; ++i) {
+		const auto& h = haystacks[i];
+		const auto b = sigcpp::search(h.data(), h.data() + h.size(), bmh);
+		const auto t = sigcpp::search(h.data(), h.data() + h.size(), tw);
+		const auto pos_b = b == h.data() + h.size() ? string_view::npos : static_cast<std::size_t>(b - h.data());
+		const auto pos_t = t == h.data() + h.size() ? string_view::npos : static_cast<std::size_t>(t - h.data());
+		reuse_test = pos_b == expected[i] && pos_t == expected[i];
+	}
+	is_true(reuse_test, "searcher reuse");
+}
+
+
+//string_view::find uses Two-Way for long patterns
+void test_string_view_long_find()
+{
+	std::string text(300, 'x');
+	std::string pattern(40, 'x');
+	pattern += 'y';
+	text.replace(250, pattern.size(), pattern);
+
+	string_view sv{ text.data(), text.size() };
+	string_view p{ pattern.data(), pattern.size() };
+
+	is_true(sv.find(p) == 250, "sv.find(long pattern)");
+	is_true(sv.find(p, 250) == 250, "sv.find(long pattern, pos)");
+	is_true(sv.find(p, 251) == string_view::npos, "sv.find(long pattern, pos) past match");
+	is_true(sv.find(p, sv.size() + 1) == string_view::npos, "sv.find(long pattern, pos > size)");
+	is_true(sv.substr(0, 291).find(p) == 250, "sv.find(long pattern) at end");
+	is_true(sv.substr(0, 290).find(p) == string_view::npos, "sv.find(long pattern) truncated");
+}
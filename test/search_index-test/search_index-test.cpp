@@ -0,0 +1,140 @@
+/*
+* search_index-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for eytzinger_index and s_tree_index
+*/
+
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "../../include/array.h"
+#include "../../include/search_index.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::eytzinger_index;
+using sigcpp::s_tree_index;
+
+void test_eytzinger_index();
+void test_s_tree_index();
+void test_search_index_input();
+
+void search_index_test()
+{
+	test_eytzinger_index();
+	test_s_tree_index();
+	test_search_index_input();
+}
+
+
+//every size up to a few levels and every key in range, with runs of duplicates
+//lower_bound and contains must agree with std::lower_bound on the original range
+template<typename Index, typename T, typename Compare = std::less<T>>
+bool same_as_lower_bound(int minSize, int maxSize, Compare comp = Compare())
+{
+	bool same = true;
+	for (int n = minSize; n <= maxSize; ++n) {
+		sigcpp::vector<T> sorted;
+		for (int i = 0; i < n; ++i)
+			sorted.push_back(static_cast<T>(i / 3 * 2));
+		std::sort(sorted.begin(), sorted.end(), comp);
+
+		const Index index(sorted.begin(), sorted.end(), comp);
+		same = same && index.size() == static_cast<std::size_t>(n);
+		for (int key = -2; key <= n + 2; ++key) {
+			const auto expected = std::lower_bound(sorted.begin(), sorted.end(), static_cast<T>(key), comp);
+			const auto found = expected != sorted.end() && !comp(static_cast<T>(key), *expected);
+			same = same && index.lower_bound(static_cast<T>(key)) == static_cast<std::size_t>(expected - sorted.begin());
+			same = same && index.contains(static_cast<T>(key)) == found;
+		}
+	}
+	return same;
+}
+
+
+void test_eytzinger_index()
+{
+	eytzinger_index<int> e;
+	is_true(e.empty() && e.lower_bound(5) == 0 && !e.contains(5), "e empty");
+
+	is_true(same_as_lower_bound<eytzinger_index<int>, int>(0, 300), "eytzinger_index<int>");
+	is_true(same_as_lower_bound<eytzinger_index<double>, double>(0, 100), "eytzinger_index<double>");
+	is_true(same_as_lower_bound<eytzinger_index<long long, std::greater<>>, long long>(0, 100, std::greater<>()),
+		"eytzinger_index<long long, greater>");
+
+	const sigcpp::array<int, 7> primes{ 2, 3, 5, 7, 11, 13, 17 };
+	const eytzinger_index<int> p(primes);
+	is_true(primes[p.lower_bound(8)] == 11 && p.lower_bound(18) == 7, "eytzinger_index(array)");
+	is_true(p.contains(13) && !p.contains(12), "eytzinger_index(array).contains()");
+
+	const sigcpp::vector<int> evens{ 0, 2, 4, 6 };
+	const eytzinger_index<int> v(evens);
+	is_true(v.lower_bound(3) == 2 && v.contains(6), "eytzinger_index(vector)");
+
+	auto copy = p;
+	const auto moved = std::move(copy);
+	is_true(moved.size() == 7 && moved.lower_bound(2) == 0, "eytzinger_index copy, move");
+}
+
+
+void test_s_tree_index()
+{
+	s_tree_index<int> e;
+	is_true(e.empty() && e.lower_bound(5) == 0 && !e.contains(5), "e empty");
+	is_true(s_tree_index<int>::node_size == 16 && s_tree_index<std::int64_t>::node_size == 8, "node_size");
+
+	//int and float use the SSE2 count: 300 ints need two levels above the leaves, 5000 three
+	is_true(same_as_lower_bound<s_tree_index<int>, int>(0, 300), "s_tree_index<int>");
+	is_true(same_as_lower_bound<s_tree_index<int>, int>(4990, 5000), "s_tree_index<int>: three inner levels");
+	is_true(same_as_lower_bound<s_tree_index<float>, float>(0, 300), "s_tree_index<float>");
+	is_true(same_as_lower_bound<s_tree_index<double>, double>(0, 200), "s_tree_index<double>");
+	is_true(same_as_lower_bound<s_tree_index<int, std::greater<>>, int>(0, 300, std::greater<>()),
+		"s_tree_index<int, greater>");
+
+	const sigcpp::array<int, 7> primes{ 2, 3, 5, 7, 11, 13, 17 };
+	const s_tree_index<int> p(primes);
+	is_true(primes[p.lower_bound(8)] == 11 && p.lower_bound(18) == 7, "s_tree_index(array)");
+	is_true(p.contains(13) && !p.contains(12), "s_tree_index(array).contains()");
+
+	const sigcpp::vector<int> evens{ 0, 2, 4, 6 };
+	const s_tree_index<int> v(evens);
+	is_true(v.lower_bound(3) == 2 && v.contains(6), "s_tree_index(vector)");
+
+	auto copy = p;
+	const auto moved = std::move(copy);
+	is_true(moved.size() == 7 && moved.lower_bound(2) == 0, "s_tree_index copy, move");
+}
+
+
+void test_search_index_input()
+{
+	const int unsorted[]{ 1, 3, 2 };
+
+	bool thrown = false;
+	try {
+		eytzinger_index<int> e(unsorted, unsorted + 3);
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "eytzinger_index(unsorted)");
+
+	thrown = false;
+	try {
+		s_tree_index<int> s(unsorted, unsorted + 3);
+	}
+	catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	is_true(thrown, "s_tree_index(unsorted)");
+}
@@ -0,0 +1,153 @@
+/*
+* slot_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for slot_map
+*/
+
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "../../include/slot_map.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::slot_map;
+using sigcpp::slot_handle;
+
+void test_slot_map_basics();
+void test_slot_map_handles();
+void test_slot_map_churn();
+
+void slot_map_test()
+{
+	test_slot_map_basics();
+	test_slot_map_handles();
+	test_slot_map_churn();
+}
+
+
+void test_slot_map_basics()
+{
+	slot_map<std::string> m;
+	is_true(m.empty() && m.size() == 0 && m.begin() == m.end(), "default slot_map");
+
+	const auto a = m.insert("apple");
+	const auto b = m.emplace(3, 'b');
+	std::string cherry = "cherry";
+	const auto c = m.insert(std::move(cherry));
+	is_true(m.size() == 3 && m[a] == "apple" && m.at(b) == "bbb" && *m.find(c) == "cherry",
+		"m.insert(value), m.emplace(args), m[h], m.at(h), m.find(h)");
+
+	//iteration is a walk of the dense values
+	is_true(m.end() - m.begin() == 3 && m.data() == &*m.begin() && std::count(m.begin(), m.end(), "bbb") == 1,
+		"dense iteration");
+
+	m[a] += " pie";
+	is_true(m.at(a) == "apple pie", "m[h] = value");
+
+	const auto& cm = m;
+	is_true(cm[b] == "bbb" && cm.find(a) != cm.end() && cm.handle_of(cm.find(c)) == c, "const access, handle_of");
+
+	slot_map<std::string> other;
+	other.insert("other");
+	swap(m, other);
+	is_true(m.size() == 1 && other.size() == 3 && other[c] == "cherry", "swap(m, other)");
+
+	//insert a copy of a value of the map itself when the values must grow
+	slot_map<std::string> full;
+	full.reserve(8);
+	slot_handle h{};
+	for (int i = 0; i < 8; ++i)
+		h = full.insert(std::string(100, static_cast<char>('a' + i)));
+	const auto first = *full.begin();
+	is_true(full.capacity() == full.size(), "full.capacity() == full.size()");
+	const auto h2 = full.insert(full[h]);
+	const auto h3 = full.insert(*full.begin());
+	is_true(full.size() == 10 && full[h2] == std::string(100, 'h') && full[h3] == first && full[h] == full[h2],
+		"full.insert(full[h]) at capacity");
+}
+
+
+void test_slot_map_handles()
+{
+	slot_map<int> m;
+	const auto a = m.insert(1);
+	const auto b = m.insert(2);
+	const auto c = m.insert(3);
+
+	is_true(m.erase(a) && !m.contains(a) && m.find(a) == m.end() && !m.erase(a), "m.erase(h): h finds nothing");
+	is_true(m.size() == 2 && m[b] == 2 && m[c] == 3, "erase keeps the other handles");
+
+	//the freed slot is reused with a new generation: the old handle still finds nothing
+	const auto d = m.insert(4);
+	is_true(d.index == a.index && d != a && !m.contains(a) && m[d] == 4, "reused slot, new generation");
+
+	bool thrown = false;
+	try {
+		m.at(a);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "m.at(stale handle) throws");
+
+	const auto next = m.erase(m.find(b));
+	is_true(!m.contains(b) && m.size() == 2 && next - m.begin() <= 1 && m[c] == 3 && m[d] == 4,
+		"m.erase(iterator)");
+
+	m.clear();
+	is_true(m.empty() && !m.contains(c) && !m.contains(d), "m.clear(): every handle stops finding its value");
+
+	const auto e = m.insert(5);
+	is_true(m.size() == 1 && m[e] == 5 && e != c && e != d, "insert after clear");
+
+	const slot_handle forged{ 100, 0 };
+	is_true(!m.contains(forged), "a handle past the slots finds nothing");
+}
+
+
+//random inserts and erases, checked against std::unordered_map
+void test_slot_map_churn()
+{
+	slot_map<std::size_t> m;
+	std::unordered_map<std::size_t, slot_handle> live;
+	sigcpp::vector<slot_handle> dead;
+
+	std::size_t state = 12345;
+	for (std::size_t i = 0; i < 20000; ++i) {
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		if ((state >> 33) % 3 != 0 || live.empty())
+			live.emplace(i, m.insert(i));
+		else {
+			const auto it = std::next(live.begin(), static_cast<std::ptrdiff_t>((state >> 40) % std::min<std::size_t>(live.size(), 8)));
+			m.erase(it->second);
+			dead.push_back(it->second);
+			live.erase(it);
+		}
+	}
+
+	bool ok = m.size() == live.size();
+	for (const auto& [value, h] : live)
+		ok = ok && m.contains(h) && m[h] == value;
+	for (const auto& h : dead)
+		ok = ok && !m.contains(h);
+	is_true(ok, "churn: live handles find their values, erased handles none");
+
+	const auto sum = std::accumulate(m.begin(), m.end(), std::size_t{ 0 });
+	std::size_t expected = 0;
+	for (const auto& entry : live)
+		expected += entry.first;
+	is_true(sum == expected, "churn: dense values are the live values");
+}
@@ -0,0 +1,247 @@
+/*
+* small_object_allocator-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for small_object_allocator
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/mpmc_queue.h"
+#include "../../include/slot_map.h"
+#include "../../include/small_object_allocator.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::small_object_allocator;
+using sigcpp::small_object_allocate;
+using sigcpp::small_object_deallocate;
+using sigcpp::small_object_stats;
+
+void test_small_object_blocks();
+void test_small_object_allocator();
+void test_small_object_threads();
+
+void small_object_allocator_test()
+{
+	test_small_object_blocks();
+	test_small_object_allocator();
+	test_small_object_threads();
+}
+
+
+//the counts of the calling thread since before
+small_object_stats thread_delta(const small_object_stats& before)
+{
+	const auto now = sigcpp::small_object_thread_statistics();
+	small_object_stats d;
+	d.allocations = now.allocations - before.allocations;
+	d.deallocations = now.deallocations - before.deallocations;
+	d.large_allocations = now.large_allocations - before.large_allocations;
+	d.batch_fetches = now.batch_fetches - before.batch_fetches;
+	d.batch_returns = now.batch_returns - before.batch_returns;
+	d.spans = now.spans - before.spans;
+	return d;
+}
+
+
+void test_small_object_blocks()
+{
+	using namespace sigcpp::detail;
+
+	//size classes
+	is_true(small_class_of(0) == 0 && small_class_of(1) == 0 && small_class_of(16) == 0, "small_class_of(0..16)");
+	is_true(small_class_of(17) == 1 && small_class_of(256) == small_class_count - 1, "small_class_of(17, 256)");
+	is_true(small_class_size(0) == 16 && small_class_size(small_class_count - 1) == 256, "small_class_size()");
+	is_true(small_batch_size(0) == 128 && small_batch_size(small_class_count - 1) == 32, "small_batch_size()");
+
+	auto before = sigcpp::small_object_thread_statistics();
+
+	//aligned to 16, and the last block freed is the first reused
+	auto p = small_object_allocate(24);
+	auto q = small_object_allocate(24);
+	is_true(p != q && reinterpret_cast<std::uintptr_t>(p) % 16 == 0 && reinterpret_cast<std::uintptr_t>(q) % 16 == 0,
+		"small_object_allocate() aligned");
+	std::memset(p, 0xAB, 24);
+	std::memset(q, 0xCD, 24);
+	small_object_deallocate(q, 24);
+	auto r = small_object_allocate(32);
+	is_true(r == q, "small_object_allocate() reuses a block of the class");
+	small_object_deallocate(r, 32);
+	small_object_deallocate(p, 24);
+
+	//past the largest class: operator new
+	auto large = small_object_allocate(1000);
+	std::memset(large, 0, 1000);
+	small_object_deallocate(large, 1000);
+
+	auto d = thread_delta(before);
+	is_true(d.allocations == 3 && d.deallocations == 3 && d.large_allocations == 1, "thread statistics");
+
+	//frees past twice a batch return a batch to the central list; flush returns the rest
+	constexpr std::size_t count = 1000;
+	std::vector<void*> blocks(count);
+	before = sigcpp::small_object_thread_statistics();
+	for (auto& b : blocks)
+		b = small_object_allocate(200);
+	for (auto b : blocks)
+		small_object_deallocate(b, 200);
+	d = thread_delta(before);
+	is_true(d.allocations == count && d.deallocations == count && d.batch_returns > 0, "batch returns");
+
+	sigcpp::small_object_flush();
+	d = thread_delta(before);
+	is_true(d.batch_returns >= count / small_batch_size(small_class_of(200)), "small_object_flush()");
+
+	//the next allocation of the class takes a batch back
+	before = sigcpp::small_object_thread_statistics();
+	p = small_object_allocate(200);
+	is_true(thread_delta(before).batch_fetches == 1, "batch fetch after flush");
+	small_object_deallocate(p, 200);
+
+	//program-wide counts include this thread's, as of its last transfer
+	const auto all = sigcpp::small_object_statistics();
+	const auto mine = sigcpp::small_object_thread_statistics();
+	is_true(all.allocations >= mine.allocations - 1 && all.spans >= mine.spans, "program statistics");
+}
+
+
+struct alignas(64) wide
+{
+	char bytes[64];
+};
+
+void test_small_object_allocator()
+{
+	//stateless: every instance frees for every other
+	small_object_allocator<int> a;
+	small_object_allocator<double> b(a);
+	is_true(a == b && !(a != b) && std::allocator_traits<small_object_allocator<int>>::is_always_equal::value,
+		"small_object_allocator equality");
+
+	auto p = a.allocate(10);
+	for (int i = 0; i < 10; ++i)
+		p[i] = i;
+	small_object_allocator<int>(b).deallocate(p, 10);
+
+	//more aligned than a block: operator new
+	small_object_allocator<wide> w;
+	auto pw = w.allocate(3);
+	is_true(reinterpret_cast<std::uintptr_t>(pw) % 64 == 0, "small_object_allocator over-aligned");
+	w.deallocate(pw, 3);
+
+	//sigcpp::vector: small buffers, then large ones as it grows
+	sigcpp::vector<int, small_object_allocator<int>> v;
+	for (int i = 0; i < 1000; ++i)
+		v.push_back(i);
+	auto sum = 0;
+	for (auto e : v)
+		sum += e;
+	is_true(v.size() == 1000 && sum == 999 * 1000 / 2, "sigcpp::vector with small_object_allocator");
+
+	//node containers: one small block per node
+	std::list<std::string, small_object_allocator<std::string>> l;
+	for (int i = 0; i < 100; ++i)
+		l.push_back(std::to_string(i));
+	l.remove_if([](const std::string& s) { return s.size() == 1; });
+	is_true(l.size() == 90 && l.front() == "10" && l.back() == "99", "std::list with small_object_allocator");
+
+	std::map<int, int, std::less<int>, small_object_allocator<std::pair<const int, int>>> m;
+	for (int i = 0; i < 100; ++i)
+		m[i % 37] += i;
+	is_true(m.size() == 37 && m[0] == 0 + 37 + 74, "std::map with small_object_allocator");
+
+	sigcpp::slot_map<std::string, small_object_allocator<std::string>> s;
+	const auto h = s.insert("handle");
+	s.insert("other");
+	is_true(s.size() == 2 && s[h] == "handle", "slot_map with small_object_allocator");
+}
+
+
+void test_small_object_threads()
+{
+	constexpr unsigned threadCount = 4;
+	constexpr std::size_t rounds = 20000;
+	const auto before = sigcpp::small_object_statistics();
+
+	//churn: each thread keeps a window of live blocks of mixed sizes, and checks that no
+	//other thread wrote to them
+	std::vector<std::thread> threads;
+	std::vector<int> errors(threadCount, 0);
+	for (unsigned t = 0; t < threadCount; ++t) {
+		threads.emplace_back([t, &errors] {
+			constexpr std::size_t window = 512;
+			std::vector<std::pair<unsigned char*, std::size_t>> live(window, { nullptr, 0 });
+			for (std::size_t i = 0; i < rounds; ++i) {
+				auto& [p, size] = live[(i * 7919) % window];
+				if (p != nullptr) {
+					for (std::size_t j = 0; j < size; ++j)
+						errors[t] += p[j] != static_cast<unsigned char>(t + size);
+					small_object_deallocate(p, size);
+				}
+				size = 1 + (i * 31 + t) % 256;
+				p = static_cast<unsigned char*>(small_object_allocate(size));
+				std::memset(p, static_cast<int>(t + size), size);
+			}
+			for (auto [p, size] : live)
+				small_object_deallocate(p, size);
+		});
+	}
+	for (auto& t : threads)
+		t.join();
+
+	auto errorCount = 0;
+	for (auto e : errors)
+		errorCount += e;
+	is_true(errorCount == 0, "churn: no block shared between threads");
+
+	//the threads reported their counts as they exited
+	const auto after = sigcpp::small_object_statistics();
+	is_true(after.allocations - before.allocations == threadCount * rounds, "churn: program allocations");
+	is_true(after.deallocations - before.deallocations == threadCount * rounds, "churn: program deallocations");
+	is_true(after.batch_returns > before.batch_returns, "churn: caches returned at thread exit");
+
+	//a producer allocates, a consumer frees: blocks flow back through the central list
+	sigcpp::mpmc_queue<void*, 1024> handoff;
+	constexpr std::size_t handoffCount = 50000;
+	std::thread producer([&handoff] {
+		for (std::size_t i = 0; i < handoffCount; ++i) {
+			auto p = small_object_allocate(48);
+			std::memset(p, 0x5A, 48);
+			while (!handoff.try_push(p))
+				std::this_thread::yield();
+		}
+	});
+	std::thread consumer([&handoff] {
+		void* p;
+		for (std::size_t i = 0; i < handoffCount; ++i) {
+			while (!handoff.try_pop(p))
+				std::this_thread::yield();
+			small_object_deallocate(p, 48);
+		}
+	});
+	producer.join();
+	consumer.join();
+
+	const auto last = sigcpp::small_object_statistics();
+	is_true(last.allocations - after.allocations == handoffCount && last.deallocations - after.deallocations == handoffCount,
+		"handoff: counts");
+
+	//the producer reused the consumer's blocks: far fewer spans than blocks would need
+	const auto blocksPerSpan = (sigcpp::detail::small_span_size - 16) / 48;
+	is_true(last.spans - after.spans < handoffCount / blocksPerSpan, "handoff: blocks recycled");
+}
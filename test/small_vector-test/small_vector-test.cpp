@@ -0,0 +1,324 @@
+/*
+* small_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for small_vector
+* - allocations are counted with an allocator that records every call
+*/
+
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "../../include/array.h"
+#include "../../include/small_vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::small_vector;
+
+//allocator that counts calls; all instances share the counts
+template<typename T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	static inline std::size_t allocations = 0;
+	static inline std::size_t deallocations = 0;
+
+	counting_allocator() = default;
+	template<typename U>
+	counting_allocator(const counting_allocator<U>&) noexcept {}
+
+	T* allocate(std::size_t n)
+	{
+		++allocations;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		++deallocations;
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	static void reset() { allocations = deallocations = 0; }
+
+	template<typename U>
+	bool operator==(const counting_allocator<U>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const counting_allocator<U>&) const noexcept { return false; }
+};
+
+//allocator that propagates on swap; each instance id tracks what it has outstanding, so a
+//buffer freed through the wrong instance unbalances two ids
+template<typename T>
+struct swapping_allocator
+{
+	using value_type = T;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	static inline std::ptrdiff_t outstanding[4]{};
+
+	int id{ 0 };
+
+	swapping_allocator() = default;
+	explicit swapping_allocator(int i) noexcept : id{ i } {}
+	template<typename U>
+	swapping_allocator(const swapping_allocator<U>& a) noexcept : id{ a.id } {}
+
+	T* allocate(std::size_t n)
+	{
+		outstanding[id] += static_cast<std::ptrdiff_t>(n);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		outstanding[id] -= static_cast<std::ptrdiff_t>(n);
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<typename U>
+	bool operator==(const swapping_allocator<U>& a) const noexcept { return id == a.id; }
+	template<typename U>
+	bool operator!=(const swapping_allocator<U>& a) const noexcept { return id != a.id; }
+};
+
+//allocator that propagates on copy assignment; tracks outstanding elements per id as
+//swapping_allocator does
+template<typename T>
+struct copying_allocator
+{
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using is_always_equal = std::false_type;
+
+	static inline std::ptrdiff_t outstanding[4]{};
+
+	int id{ 0 };
+
+	copying_allocator() = default;
+	explicit copying_allocator(int i) noexcept : id{ i } {}
+	template<typename U>
+	copying_allocator(const copying_allocator<U>& a) noexcept : id{ a.id } {}
+
+	T* allocate(std::size_t n)
+	{
+		outstanding[id] += static_cast<std::ptrdiff_t>(n);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		outstanding[id] -= static_cast<std::ptrdiff_t>(n);
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<typename U>
+	bool operator==(const copying_allocator<U>& a) const noexcept { return id == a.id; }
+	template<typename U>
+	bool operator!=(const copying_allocator<U>& a) const noexcept { return id != a.id; }
+};
+
+template<typename T, std::size_t N>
+using counted_vector = small_vector<T, N, counting_allocator<T>>;
+
+using int_allocator = counting_allocator<int>;
+using string_allocator = counting_allocator<std::string>;
+
+void test_small_vector_inline();
+void test_small_vector_spill();
+void test_small_vector_move();
+void test_small_vector_modifiers();
+void test_small_vector_nontrivial();
+
+void small_vector_test()
+{
+	test_small_vector_inline();
+	test_small_vector_spill();
+	test_small_vector_move();
+	test_small_vector_modifiers();
+	test_small_vector_nontrivial();
+}
+
+
+//up to N elements: no heap hits, whatever the operation
+void test_small_vector_inline()
+{
+	int_allocator::reset();
+	{
+		counted_vector<int, 16> v;
+		for (int i = 0; i < 15; ++i)
+			v.push_back(i);
+		v.insert(v.begin() + 3, 99);
+		v.erase(v.begin() + 3);
+		v.resize(10);
+		v.resize(16, 7);
+		v.reserve(12);
+
+		counted_vector<int, 16> copy{ v };
+		counted_vector<int, 16> moved{ std::move(copy) };
+		moved.swap(v);
+		v.shrink_to_fit();
+
+		is_true(v.is_inline() && v.size() == 16 && v.capacity() == 16, "v inline");
+		is_true(v[15] == 7 && v[2] == 2, "v inline elements");
+	}
+	is_true(int_allocator::allocations == 0, "no allocation up to N elements");
+
+	//same iterator type as array
+	static_assert(std::is_same_v<small_vector<int, 4>::iterator, sigcpp::array<int, 4>::iterator>);
+	static_assert(std::is_same_v<small_vector<int, 4>::const_iterator, sigcpp::array<int, 4>::const_iterator>);
+}
+
+
+void test_small_vector_spill()
+{
+	int_allocator::reset();
+	{
+		counted_vector<int, 4> v{ 1, 2, 3, 4 };
+		is_true(int_allocator::allocations == 0, "no allocation at N elements");
+
+		v.push_back(5);
+		is_true(!v.is_inline() && v.capacity() >= 5, "spill at N + 1 elements");
+		is_true(int_allocator::allocations == 1, "one allocation to spill");
+
+		for (int i = 6; i <= 1000; ++i)
+			v.push_back(i);
+		is_true(v.size() == 1000 && v.back() == 1000 && v[4] == 5, "v after growth");
+		is_true(int_allocator::allocations <= 10, "geometric growth");
+
+		//pushing an element of the vector itself while the buffer moves
+		v.shrink_to_fit();
+		v.push_back(v[0]);
+		is_true(v.back() == 1, "v.push_back(v[0]) with reallocation");
+
+		//back inside the object when small enough again
+		v.resize(3);
+		v.shrink_to_fit();
+		is_true(v.is_inline() && v.capacity() == 4 && v[2] == 3, "shrink_to_fit back inline");
+	}
+	is_true(int_allocator::allocations == int_allocator::deallocations, "every allocation released");
+}
+
+
+void test_small_vector_move()
+{
+	int_allocator::reset();
+	counted_vector<int, 4> heap{ 1, 2, 3, 4, 5, 6 };
+	const auto allocations = int_allocator::allocations;
+	const int* buffer = heap.data();
+
+	//the heap buffer is stolen, not copied
+	counted_vector<int, 4> stolen{ std::move(heap) };
+	is_true(stolen.data() == buffer && stolen.size() == 6, "move ctor steals heap buffer");
+	is_true(heap.empty() && heap.is_inline(), "moved-from vector is empty and inline");
+
+	counted_vector<int, 4> assigned;
+	assigned = std::move(stolen);
+	is_true(assigned.data() == buffer && assigned.size() == 6, "move assignment steals heap buffer");
+	is_true(int_allocator::allocations == allocations, "no allocation on move");
+
+	//inline elements are relocated
+	counted_vector<int, 4> small{ 7, 8 };
+	counted_vector<int, 4> relocated{ std::move(small) };
+	is_true(relocated.is_inline() && relocated.size() == 2 && relocated[1] == 8, "move ctor inline");
+
+	//swap of heap and inline vectors
+	swap(assigned, relocated);
+	is_true(assigned.size() == 2 && relocated.size() == 6 && relocated.data() == buffer, "swap heap and inline");
+	is_true(assigned.is_inline() && assigned[0] == 7, "swap heap and inline: inline side");
+
+	//the allocator that propagates on swap follows the heap buffer
+	{
+		using alloc = swapping_allocator<int>;
+		small_vector<int, 2, alloc> x{ { 1, 2, 3 }, alloc(1) };
+		small_vector<int, 2, alloc> y{ { 4 }, alloc(2) };
+		x.swap(y);
+		is_true(y.size() == 3 && !y.is_inline() && y.get_allocator().id == 1 && x.get_allocator().id == 2,
+			"swap heap and inline: allocators swap");
+	}
+	is_true(swapping_allocator<int>::outstanding[1] == 0 && swapping_allocator<int>::outstanding[2] == 0,
+		"swap heap and inline: buffer freed by its allocator");
+
+	//the allocator that propagates on copy assignment: the target's heap buffer is freed
+	//by its own allocator before the target adopts the other
+	{
+		using alloc = copying_allocator<int>;
+		small_vector<int, 2, alloc> x{ { 1, 2, 3 }, alloc(1) };
+		small_vector<int, 2, alloc> y{ { 4, 5, 6, 7 }, alloc(2) };
+		y = x;
+		is_true(y.size() == 3 && y[2] == 3 && y.get_allocator().id == 1, "copy assignment: allocator propagates");
+	}
+	is_true(copying_allocator<int>::outstanding[1] == 0 && copying_allocator<int>::outstanding[2] == 0,
+		"copy assignment: buffers freed by their allocators");
+}
+
+
+void test_small_vector_modifiers()
+{
+	small_vector<int, 4> v{ 1, 2, 3 };
+
+	v.insert(v.begin() + 1, { 7, 8, 9 });
+	is_true(v.size() == 6 && v[1] == 7 && v[3] == 9 && v[4] == 2, "v.insert(pos, il) across spill");
+
+	v.insert(v.begin(), 2, 0);
+	is_true(v[0] == 0 && v[1] == 0 && v[2] == 1, "v.insert(pos, count, value)");
+
+	v.erase(v.begin(), v.begin() + 3);
+	const int expected[]{ 7, 8, 9, 2, 3 };
+	is_true(v.size() == 5 && std::equal(v.begin(), v.end(), expected), "v.erase(first, last)");
+
+	v.emplace(v.end(), 4);
+	small_vector<int, 4> w{ 7, 8, 9, 2, 3, 4 };
+	is_true(v == w && !(v < w), "v == w");
+	w.pop_back();
+	is_true(w < v && w != v, "w < v");
+
+	bool thrown = false;
+	try {
+		v.at(6);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "v.at(size())");
+}
+
+
+void test_small_vector_nontrivial()
+{
+	string_allocator::reset();
+	{
+		counted_vector<std::string, 2> v{ "alpha", "beta" };
+		v.push_back("a string long enough to need its own heap buffer");
+		v.insert(v.begin(), "gamma");
+		is_true(v.size() == 4 && v[0] == "gamma" && v[3][0] == 'a', "nontrivial insert across spill");
+
+		v.erase(v.begin() + 1);
+		is_true(v.size() == 3 && v[0] == "gamma" && v[1] == "beta", "nontrivial erase");
+
+		auto copy = v;
+		is_true(copy == v, "nontrivial copy");
+
+		//resize from an element of the vector itself across a reallocation
+		const std::string first = v[0];
+		v.resize(10, v[0]);
+		is_true(v.size() == 10 && v[9] == first && v[3] == first, "v.resize(10, v[0])");
+
+		v.resize(1);
+		v.shrink_to_fit();
+		is_true(v.is_inline() && v[0] == "gamma", "nontrivial shrink back inline");
+	}
+	is_true(string_allocator::allocations == string_allocator::deallocations, "nontrivial: every allocation released");
+}
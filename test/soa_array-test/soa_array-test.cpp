@@ -0,0 +1,123 @@
+/*
+* soa_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for soa_array and its row proxies and iterators
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "../../include/soa_array.h"
+
+#include "../verifiers.h"
+
+using sigcpp::soa_array;
+
+void test_soa_array_access();
+void test_soa_array_rows();
+void test_soa_array_algorithms();
+
+void soa_array_test()
+{
+	test_soa_array_access();
+	test_soa_array_rows();
+	test_soa_array_algorithms();
+}
+
+
+void test_soa_array_access()
+{
+	soa_array<4, int, double> s{ { { 1, 2, 3, 4 }, { 0.5, 1.5, 2.5, 3.5 } } };
+	is_true(s.size() == 4 && !s.empty(), "s.size()");
+	is_true(s.column<0>()[2] == 3 && s.column<1>()[3] == 3.5, "s.column<I>()");
+	is_true(std::get<0>(s[1]) == 2 && std::get<1>(s.back()) == 3.5, "s[pos], s.back()");
+
+	const int total = std::accumulate(s.column<0>().begin(), s.column<0>().end(), 0);
+	is_true(total == 10, "accumulate one column");
+
+	bool thrown = false;
+	try {
+		s.at(4);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "s.at(size())");
+
+	s.fill({ 7, 0.25 });
+	is_true(std::get<0>(s.front()) == 7 && std::get<1>(s[2]) == 0.25, "s.fill()");
+
+	soa_array<4, int, double> t{};
+	is_true(s != t, "s != t");
+	swap(s, t);
+	is_true(std::get<0>(t[3]) == 7 && std::get<0>(s[3]) == 0, "swap(s, t)");
+
+	soa_array<0, int> e;
+	is_true(e.empty() && e.begin() == e.end(), "e empty");
+}
+
+
+//proxies: assignment writes through, structured bindings refer to the fields
+void test_soa_array_rows()
+{
+	soa_array<3, int, std::string> s{ { { 1, 2, 3 }, { "one", "two", "three" } } };
+
+	auto [number, name] = s[1];
+	number = 20;
+	name = "twenty";
+	is_true(s.column<0>()[1] == 20 && s.column<1>()[1] == "twenty", "structured binding writes through");
+
+	s[0] = std::make_tuple(10, std::string("ten"));
+	is_true(s.column<0>()[0] == 10 && s.column<1>()[0] == "ten", "assign a value to a row");
+
+	s[2] = s[0];
+	is_true(s.column<0>()[2] == 10 && s.column<1>()[2] == "ten", "assign a row to a row");
+
+	const std::tuple<int, std::string> copy = s[1];
+	s[1] = std::make_tuple(0, std::string());
+	is_true(std::get<0>(copy) == 20 && std::get<1>(copy) == "twenty", "row value is a copy");
+
+	swap(s[0], s[1]);
+	is_true(s.column<0>()[0] == 0 && s.column<1>()[1] == "ten", "swap(row, row)");
+
+	auto it = s.begin();
+	is_true(std::get<0>(it->value()) == 0 && std::get<1>(it->value()).empty(), "it->value()");
+	is_true(std::get<1>(it[1]) == "ten" && (it + 2) - it == 2 && it < s.end(), "iterator arithmetic");
+
+	const auto& cs = s;
+	soa_array<3, int, std::string>::const_iterator cit = s.begin();
+	is_true(cit == cs.begin() && std::get<0>(*cs.rbegin()) == 10, "const iterators");
+}
+
+
+void test_soa_array_algorithms()
+{
+	soa_array<6, int, char> s{ { { 5, 3, 6, 1, 4, 2 }, { 'e', 'c', 'f', 'a', 'd', 'b' } } };
+
+	//the fields of a row move together
+	std::sort(s.begin(), s.end());
+	is_true(std::is_sorted(s.column<0>().begin(), s.column<0>().end()) &&
+		std::is_sorted(s.column<1>().begin(), s.column<1>().end()), "std::sort(rows)");
+
+	std::sort(s.begin(), s.end(), [](const auto& x, const auto& y) { return std::get<1>(x) > std::get<1>(y); });
+	is_true(s.column<0>()[0] == 6 && s.column<1>()[5] == 'a', "std::sort(rows, comp)");
+
+	std::reverse(s.begin(), s.end());
+	std::rotate(s.begin(), s.begin() + 2, s.end());
+	std::stable_sort(s.begin(), s.end());
+	is_true(s.column<0>()[0] == 1 && s.column<1>()[5] == 'f', "reverse, rotate, stable_sort");
+
+	const auto it = std::find_if(s.cbegin(), s.cend(), [](const auto& row) { return std::get<1>(row) == 'd'; });
+	is_true(it - s.cbegin() == 3 && std::get<0>(*it) == 4, "std::find_if(rows)");
+}
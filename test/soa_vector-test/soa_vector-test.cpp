@@ -0,0 +1,108 @@
+/*
+* soa_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for soa_vector
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "../../include/soa_vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::soa_vector;
+
+void test_soa_vector_modifiers();
+void test_soa_vector_exceptions();
+
+void soa_vector_test()
+{
+	test_soa_vector_modifiers();
+	test_soa_vector_exceptions();
+}
+
+
+void test_soa_vector_modifiers()
+{
+	soa_vector<int, std::string> v;
+	is_true(v.empty() && v.begin() == v.end(), "v empty");
+
+	v.push_back({ 3, "three" });
+	v.emplace_back(1, "one");
+	auto row = v.emplace_back(2, "two");
+	is_true(v.size() == 3 && std::get<0>(row) == 2 && v.column<1>()[0] == "three", "push_back, emplace_back");
+
+	std::sort(v.begin(), v.end());
+	is_true(v.column<0>()[0] == 1 && v.column<1>()[2] == "three", "std::sort(rows)");
+
+	v.data<0>()[1] = 20;
+	is_true(std::get<0>(v[1]) == 20, "v.data<I>()");
+
+	v.reserve(100);
+	is_true(v.capacity() >= 100 && v.column<0>().capacity() >= 100 && v.column<1>().capacity() >= 100,
+		"v.reserve()");
+
+	v.resize(5, { 9, "nine" });
+	is_true(v.size() == 5 && v.column<1>().size() == 5 && std::get<1>(v.back()) == "nine", "v.resize(count, value)");
+
+	auto it = v.erase(v.begin() + 1, v.begin() + 3);
+	is_true(v.size() == 3 && std::get<0>(*it) == 9 && v.column<1>().size() == 3, "v.erase(first, last)");
+
+	v.pop_back();
+	is_true(v.size() == 2 && v.column<0>().size() == 2, "v.pop_back()");
+
+	soa_vector<int, std::string> w{ { 1, "one" }, { 9, "nine" } };
+	is_true(v == w, "v == w");
+	w.clear();
+	is_true(w.empty() && w.column<1>().empty() && v != w, "w.clear()");
+}
+
+
+//a field whose copy throws: every column stays at the old size
+struct fragile
+{
+	static inline int copies_left = 0;
+
+	fragile() = default;
+	fragile(const fragile&)
+	{
+		if (copies_left-- == 0)
+			throw std::runtime_error("copy failed");
+	}
+	fragile& operator=(const fragile&) = default;
+};
+
+void test_soa_vector_exceptions()
+{
+	soa_vector<int, fragile> v(2);
+
+	bool thrown = false;
+	fragile::copies_left = 0;
+	try {
+		v.push_back({ 1, fragile() });
+	}
+	catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	is_true(thrown && v.size() == 2 && v.column<0>().size() == 2 && v.column<1>().size() == 2,
+		"push_back that throws leaves the sizes");
+
+	bool outOfRange = false;
+	try {
+		v.at(2);
+	}
+	catch (const std::out_of_range&) {
+		outOfRange = true;
+	}
+	is_true(outOfRange, "v.at(size())");
+}
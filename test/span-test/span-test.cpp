@@ -0,0 +1,133 @@
+/*
+* span-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for span
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../../include/array.h"
+#include "../../include/span.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::span;
+using sigcpp::dynamic_extent;
+
+void test_span_ctors();
+void test_span_subviews();
+void test_span_bytes();
+
+void span_test()
+{
+	test_span_ctors();
+	test_span_subviews();
+	test_span_bytes();
+}
+
+
+//one function for every size
+static int sum(span<const int> s)
+{
+	return std::accumulate(s.begin(), s.end(), 0);
+}
+
+
+void test_span_ctors()
+{
+	span<int> e;
+	is_true(e.empty() && e.data() == nullptr && e.begin() == e.end(), "e empty");
+
+	sigcpp::array<int, 4> a{ 1, 2, 3, 4 };
+	int c[]{ 5, 6, 7 };
+	sigcpp::vector<int> v{ 8, 9 };
+	const sigcpp::array<int, 2> ca{ 10, 11 };
+	is_true(sum(a) == 10 && sum(c) == 18 && sum(v) == 17 && sum(ca) == 21, "span<const T> from containers");
+
+	span sa(a);
+	span sc(c);
+	span sv(v);
+	span sca(ca);
+	static_assert(std::is_same_v<decltype(sa), span<int, 4>> && std::is_same_v<decltype(sc), span<int, 3>>,
+		"deduced static extents");
+	static_assert(std::is_same_v<decltype(sv), span<int>> && std::is_same_v<decltype(sca), span<const int, 2>>,
+		"deduced element types");
+	static_assert(!std::is_constructible_v<span<int>, sigcpp::vector<int>&&> &&
+		std::is_constructible_v<span<const int>, sigcpp::vector<int>&&> && std::is_constructible_v<span<int>, sigcpp::vector<int>&>,
+		"a temporary range: const elements only");
+	is_true(sizeof(span<int, 4>) == sizeof(int*) && sizeof(span<int>) == 2 * sizeof(int*), "span size");
+
+	sa[1] = 20;
+	is_true(a[1] == 20 && sa.front() == 1 && sa.back() == 4 && sa.size_bytes() == 4 * sizeof(int), "sa writes through");
+
+	span<int> p(v.data(), v.size());
+	span<int> q(a.begin(), a.end());
+	is_true(p.size() == 2 && p[1] == 9 && q.size() == 4 && q[1] == 20, "span(first, count), span(first, last)");
+
+	const span<const int, 4> cs = sa;
+	const span<const int> ds = cs;
+	const span<int, 2> fixed(sv);
+	is_true(ds.size() == 4 && ds[3] == 4 && fixed[0] == 8, "span conversions");
+
+	bool thrown = false;
+	try {
+		sv.at(2);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown && sv.at(1) == 9, "sv.at()");
+
+	is_true(*sa.rbegin() == 4 && sa.rend() - sa.rbegin() == 4, "reverse iterators");
+}
+
+
+void test_span_subviews()
+{
+	int c[]{ 0, 1, 2, 3, 4, 5, 6, 7 };
+	const span s(c);
+
+	const auto f = s.first<3>();
+	const auto l = s.last<2>();
+	static_assert(decltype(f)::extent == 3 && decltype(l)::extent == 2, "first<Count>, last<Count> extents");
+	is_true(f[2] == 2 && l[0] == 6, "first<Count>, last<Count>");
+
+	const auto sub = s.subspan<2, 3>();
+	const auto rest = s.subspan<5>();
+	static_assert(decltype(sub)::extent == 3 && decltype(rest)::extent == 3, "subspan<Offset> extents");
+	is_true(sub[0] == 2 && rest[2] == 7, "subspan<Offset, Count>, subspan<Offset>");
+
+	const span<int> d = s;
+	const auto dynamicRest = d.subspan<6>();
+	static_assert(decltype(dynamicRest)::extent == dynamic_extent, "subspan<Offset> of a dynamic span");
+	is_true(dynamicRest.size() == 2 && dynamicRest[1] == 7, "dynamic subspan<Offset>");
+
+	is_true(d.first(2).size() == 2 && d.last(3)[0] == 5 && d.subspan(1, 2)[1] == 2 && d.subspan(7).size() == 1,
+		"first(count), last(count), subspan(offset, count)");
+}
+
+
+void test_span_bytes()
+{
+	std::uint16_t c[]{ 0x0102, 0x0304 };
+	const auto bytes = sigcpp::as_bytes(span(c));
+	static_assert(decltype(bytes)::extent == 4, "as_bytes extent");
+	is_true(bytes.size() == 4 && bytes.data() == reinterpret_cast<const std::byte*>(c), "as_bytes");
+
+	const auto writable = sigcpp::as_writable_bytes(span<std::uint16_t>(c));
+	writable[0] = std::byte{ 0 };
+	writable[1] = std::byte{ 0 };
+	is_true(c[0] == 0 && writable.size() == 4, "as_writable_bytes");
+}
@@ -0,0 +1,138 @@
+/*
+* spsc_queue-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for spsc_queue
+*/
+
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+
+#include "../../include/array.h"
+#include "../../include/spsc_queue.h"
+
+#include "../verifiers.h"
+
+using sigcpp::spsc_queue;
+
+void test_spsc_queue_single_thread();
+void test_spsc_queue_batch();
+void test_spsc_queue_two_threads();
+
+void spsc_queue_test()
+{
+	test_spsc_queue_single_thread();
+	test_spsc_queue_batch();
+	test_spsc_queue_two_threads();
+}
+
+
+void test_spsc_queue_single_thread()
+{
+	spsc_queue<int, 4> q;
+	is_true(q.empty() && q.size() == 0 && q.capacity() == 4, "q empty");
+
+	int value = -1;
+	is_false(q.try_pop(value), "q.try_pop() when empty");
+	is_true(q.front() == nullptr, "q.front() when empty");
+
+	//all N slots are usable
+	for (int i = 1; i <= 4; ++i)
+		q.try_push(i);
+	is_true(q.size() == 4, "q.size() when full");
+	is_false(q.try_push(5), "q.try_push() when full");
+
+	is_true(q.try_pop(value) && value == 1, "q.try_pop()");
+	is_true(q.try_push(5), "q.try_push() after pop");
+
+	//indices wrap around the buffer
+	is_true(*q.front() == 2, "q.front()");
+	q.pop();
+	for (int expected = 3; expected <= 5; ++expected) {
+		is_true(q.try_pop(value) && value == expected, "q.try_pop() across wrap");
+	}
+	is_true(q.empty(), "q empty after draining");
+
+	//move-only and non-trivial elements
+	spsc_queue<std::unique_ptr<int>, 2> u;
+	is_true(u.try_push(std::make_unique<int>(7)), "u.try_push(unique_ptr)");
+	std::unique_ptr<int> p;
+	is_true(u.try_pop(p) && *p == 7, "u.try_pop(unique_ptr)");
+
+	spsc_queue<std::string, 2> s;
+	is_true(s.try_emplace(3, 'x'), "s.try_emplace(count, char)");
+	std::string str;
+	is_true(s.try_pop(str) && str == "xxx", "s.try_pop() after emplace");
+}
+
+
+void test_spsc_queue_batch()
+{
+	spsc_queue<int, 8> q;
+	const int values[]{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+	//push_n stops when full
+	is_true(q.push_n(values, 10) == 8, "q.push_n() beyond capacity");
+	is_true(q.push_n(values, 1) == 0, "q.push_n() when full");
+
+	sigcpp::array<int, 10> out{};
+	is_true(q.pop_n(out.begin(), 3) == 3, "q.pop_n(3)");
+	is_true(out[0] == 1 && out[2] == 3, "q.pop_n(3) values");
+
+	//a batch that wraps around the buffer
+	is_true(q.push_n(values + 8, 2) == 2, "q.push_n() across wrap");
+	is_true(q.pop_n(out.begin(), 10) == 7, "q.pop_n() up to size");
+	const int expected[]{ 4, 5, 6, 7, 8, 9, 10 };
+	is_true(std::equal(expected, expected + 7, out.begin()), "q.pop_n() values across wrap");
+	is_true(q.pop_n(out.begin(), 1) == 0, "q.pop_n() when empty");
+}
+
+
+//a producer thread and a consumer thread: every value arrives once and in order
+void test_spsc_queue_two_threads()
+{
+	constexpr int count = 100000;
+	auto q = std::make_unique<spsc_queue<int, 64>>();
+
+	std::thread producer([&q] {
+		int next = 0;
+		int batch[16];
+		while (next < count) {
+			if (next % 3 == 0) {
+				if (q->try_push(next))
+					++next;
+			}
+			else {
+				const auto n = std::min(16, count - next);
+				std::iota(batch, batch + n, next);
+				next += static_cast<int>(q->push_n(batch, static_cast<std::size_t>(n)));
+			}
+			std::this_thread::yield();
+		}
+	});
+
+	bool ordered = true;
+	int expected = 0;
+	int batch[8];
+	while (expected < count) {
+		const auto n = q->pop_n(batch, 8);
+		for (std::size_t i = 0; i < n; ++i, ++expected)
+			ordered = ordered && batch[i] == expected;
+		if (n == 0)
+			std::this_thread::yield();
+	}
+	producer.join();
+
+	is_true(ordered && expected == count, "two threads: values in order");
+	is_true(q->empty(), "two threads: q empty at end");
+}
@@ -0,0 +1,242 @@
+/*
+* static_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Unit tests for static_vector
+* - see C++17 [vector] https://timsong-cpp.github.io/cppwp/n4659/vector
+*/
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/static_vector.h"
+
+#include "../verifiers.h"
+
+using sigcpp::static_vector;
+
+void test_static_vector_basics();
+void test_static_vector_insert_erase();
+void test_static_vector_nontrivial();
+void test_static_vector_capacity();
+void test_static_vector_copy_swap_compare();
+void test_static_vector_constexpr();
+
+void static_vector_test()
+{
+	test_static_vector_basics();
+	test_static_vector_insert_erase();
+	test_static_vector_nontrivial();
+	test_static_vector_capacity();
+	test_static_vector_copy_swap_compare();
+	test_static_vector_constexpr();
+}
+
+
+template<typename T, std::size_t N, std::size_t M>
+static bool has_elements(const static_vector<T, N>& v, const T(&expected)[M])
+{
+	return v.size() == M && std::equal(v.begin(), v.end(), expected);
+}
+
+
+void test_static_vector_basics()
+{
+	static_vector<int, 8> v;
+	is_true(v.empty() && v.size() == 0 && v.capacity() == 8, "empty static_vector");
+
+	v.push_back(3);
+	v.emplace_back(1);
+	v.push_back(4);
+	is_true(has_elements(v, { 3, 1, 4 }), "v.push_back(), v.emplace_back()");
+	is_true(v.front() == 3 && v.back() == 4 && v[1] == 1 && v.at(2) == 4, "v element access");
+	is_true(*v.rbegin() == 4 && v.end() - v.begin() == 3, "v iterators");
+
+	//data() is inside the object: no allocation
+	const auto* object = reinterpret_cast<const char*>(&v);
+	const auto* elements = reinterpret_cast<const char*>(v.data());
+	is_true(elements >= object && elements < object + sizeof(v), "v.data() inside the object");
+
+	v.pop_back();
+	is_true(has_elements(v, { 3, 1 }), "v.pop_back()");
+
+	v.resize(4);
+	is_true(has_elements(v, { 3, 1, 0, 0 }), "v.resize(4)");
+	v.resize(5, 9);
+	is_true(has_elements(v, { 3, 1, 0, 0, 9 }), "v.resize(5, 9)");
+	v.resize(1);
+	is_true(has_elements(v, { 3 }), "v.resize(1)");
+
+	v.assign(3, 7);
+	is_true(has_elements(v, { 7, 7, 7 }), "v.assign(3, 7)");
+	v.clear();
+	is_true(v.empty(), "v.clear()");
+
+	static_vector<int, 4> counted(3, 2);
+	is_true(has_elements(counted, { 2, 2, 2 }), "static_vector(3, 2)");
+	static_vector<int, 4> sized(2);
+	is_true(has_elements(sized, { 0, 0 }), "static_vector(2)");
+}
+
+
+void test_static_vector_insert_erase()
+{
+	static_vector<int, 16> v{ 1, 2, 3, 4, 5 };
+
+	auto it = v.insert(v.begin() + 2, 9);
+	is_true(*it == 9 && has_elements(v, { 1, 2, 9, 3, 4, 5 }), "v.insert(pos, value)");
+
+	it = v.insert(v.end(), 6);
+	is_true(*it == 6 && has_elements(v, { 1, 2, 9, 3, 4, 5, 6 }), "v.insert(end, value)");
+
+	it = v.insert(v.begin(), 2, 0);
+	is_true(it == v.begin() && has_elements(v, { 0, 0, 1, 2, 9, 3, 4, 5, 6 }), "v.insert(pos, count, value)");
+
+	const int more[]{ 7, 8 };
+	it = v.insert(v.begin() + 3, std::begin(more), std::end(more));
+	is_true(*it == 7 && has_elements(v, { 0, 0, 1, 7, 8, 2, 9, 3, 4, 5, 6 }), "v.insert(pos, first, last)");
+
+	it = v.erase(v.begin() + 1);
+	is_true(*it == 1 && has_elements(v, { 0, 1, 7, 8, 2, 9, 3, 4, 5, 6 }), "v.erase(pos)");
+
+	it = v.erase(v.begin() + 2, v.begin() + 6);
+	is_true(*it == 3 && has_elements(v, { 0, 1, 3, 4, 5, 6 }), "v.erase(first, last)");
+
+	//inserting an element of the vector itself
+	v.insert(v.begin(), v.back());
+	is_true(has_elements(v, { 6, 0, 1, 3, 4, 5, 6 }), "v.insert(pos, v.back())");
+
+	//input iterators: inserted one at a time, then rotated into place
+	std::string digits{ "89" };
+	static_vector<char, 8> c{ 'a', 'b' };
+	c.insert(c.begin() + 1, std::istreambuf_iterator<char>(), std::istreambuf_iterator<char>());
+	c.insert(c.begin() + 1, digits.begin(), digits.end());
+	is_true(has_elements(c, { 'a', '8', '9', 'b' }), "c.insert(pos, first, last)");
+}
+
+
+void test_static_vector_nontrivial()
+{
+	using sv = static_vector<std::string, 6>;
+	sv v{ "one", "two", "three" };
+
+	v.insert(v.begin() + 1, "four");
+	v.emplace(v.begin(), 3, 'x');
+	is_true(has_elements(v, { std::string("xxx"), std::string("one"), std::string("four"),
+		std::string("two"), std::string("three") }), "v.insert(), v.emplace() nontrivial");
+
+	v.erase(v.begin() + 1, v.begin() + 3);
+	is_true(has_elements(v, { std::string("xxx"), std::string("two"), std::string("three") }),
+		"v.erase() nontrivial");
+
+	sv w{ "a" };
+	w.swap(v);
+	is_true(w.size() == 3 && v.size() == 1 && w[2] == "three" && v[0] == "a", "w.swap(v) nontrivial");
+
+	sv moved{ std::move(w) };
+	is_true(moved.size() == 3 && moved[0] == "xxx", "move ctor nontrivial");
+
+	sv copy;
+	copy = moved;
+	is_true(copy == moved && copy[1] == "two", "copy assignment nontrivial");
+}
+
+
+void test_static_vector_capacity()
+{
+	static_vector<int, 3> v{ 1, 2, 3 };
+	is_true(v.full(), "v.full()");
+
+	bool thrown = false;
+	try {
+		v.push_back(4);
+	}
+	catch (const std::length_error&) {
+		thrown = true;
+	}
+	is_true(thrown && v.size() == 3, "v.push_back() when full");
+
+	thrown = false;
+	try {
+		v.insert(v.begin(), std::size_t(-1), 0);
+	}
+	catch (const std::length_error&) {
+		thrown = true;
+	}
+	is_true(thrown && v.size() == 3, "v.insert(huge count)");
+
+	thrown = false;
+	try {
+		static_vector<int, 2> w{ 1, 2, 3 };
+	}
+	catch (const std::length_error&) {
+		thrown = true;
+	}
+	is_true(thrown, "static_vector(il) over capacity");
+
+	thrown = false;
+	try {
+		v.at(3);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "v.at(size())");
+}
+
+
+void test_static_vector_copy_swap_compare()
+{
+	static_vector<int, 8> a{ 1, 2, 3 };
+	static_vector<int, 8> b{ a };
+	is_true(a == b, "copy ctor");
+
+	b.push_back(4);
+	is_true(a != b && a < b && b > a, "a < b (prefix)");
+
+	swap(a, b);
+	is_true(a.size() == 4 && b.size() == 3 && a[3] == 4, "swap(a, b)");
+
+	b = a;
+	is_true(a == b && a <= b && a >= b, "copy assignment");
+
+	b[1] = -1;
+	is_true(b < a, "b < a (negative element)");
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	is_true((b <=> a) < 0 && (a <=> a) == 0, "a <=> b");
+#endif
+}
+
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+constexpr int constexpr_static_vector()
+{
+	static_vector<int, 8> v{ 5, 1, 4 };
+	v.push_back(2);
+	v.insert(v.begin(), 3);
+	v.erase(v.begin() + 1);
+	std::sort(v.begin(), v.end());
+
+	static_vector<int, 8> w;
+	w = v;
+	w.swap(v);
+	return w.size() == 4 && w == v ? w[0] * 1000 + w[1] * 100 + w[2] * 10 + w[3] : -1;
+}
+#endif
+
+void test_static_vector_constexpr()
+{
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	static_assert(constexpr_static_vector() == 1234);
+	is_true(constexpr_static_vector() == 1234, "static_vector in constant evaluation");
+#endif
+}
@@ -14,10 +14,15 @@
 */
 
 #include <stdexcept>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "../../include/string_view.h"
 
 #include "../verifiers.h"
 
-using std::string_view;
+using sigcpp::string_view;
 
 void test_ctors_and_assignment();
 void test_non_member_comparison();
@@ -26,6 +31,7 @@ void test_iterator();
 void test_modifiers();
 void test_operations();
 void test_finders();
+void test_finders_long();
 
 void string_view_test()
 {
@@ -36,6 +42,7 @@ void string_view_test()
 	test_modifiers();
 	test_operations();
 	test_finders();
+	test_finders_long();
 }
 
 
@@ -86,6 +93,21 @@ void test_ctors_and_assignment()
 	is_true(sv_a.length() == sv_a.size(), "sv_a.length() == sv_a.size()");
 	is_false(sv_a.empty(), "sv_a.empty()");
 	is_true(sv_a.data() == z_h, "sv_a.data() == sv_c.data()");
+
+	//custom ctor, contiguous range of chars
+	const std::string s_hw{ z_hw };
+	string_view sv_s{ s_hw };
+	is_true(sv_s.data() == s_hw.data() && sv_s.size() == s_hw.size(), "sv_s from std::string");
+
+	const std::string_view ssv_hw{ z_hw };
+	string_view sv_ssv = ssv_hw;
+	is_true(sv_ssv.data() == z_hw && sv_ssv.size() == 13, "sv_ssv from std::string_view");
+	is_true(sv_ssv == s_hw && s_hw == sv_ssv, "sv_ssv == std::string");
+
+	//conversion to std::string_view
+	const auto ssv = static_cast<std::string_view>(sv_f);
+	is_true(ssv.data() == z_hw && ssv.size() == 5, "std::string_view from sv_f");
+	is_true(std::string(std::string_view(sv)) == s_hw, "std::string from sv");
 }
 
 
@@ -403,6 +425,46 @@ void test_finders()
 }
 
 
+//finders on text long enough to use SIMD kernels: matches in the first block, in a
+//later block, and in the scalar tail; also chars with the high bit set
+void test_finders_long()
+{
+	//100 dots with markers at positions 5, 40, 97; '\xE9' at position 70
+	std::string text(100, '.');
+	text[5] = 'x';
+	text[40] = 'y';
+	text[70] = '\xE9';
+	text[97] = 'x';
+	string_view sv{ text.data(), text.size() };
+
+	is_true(sv.find('x') == 5, "sv_long.find(c)");
+	is_true(sv.find('x', 6) == 97, "sv_long.find(c, pos) tail");
+	is_true(sv.find('y') == 40, "sv_long.find(c) second block");
+	is_true(sv.find('\xE9') == 70, "sv_long.find(c) high bit");
+	is_true(sv.find('z') == string_view::npos, "sv_long.find(c) missing");
+
+	is_true(sv.rfind('x') == 97, "sv_long.rfind(c)");
+	is_true(sv.rfind('x', 96) == 5, "sv_long.rfind(c, pos)");
+	is_true(sv.rfind('y') == 40, "sv_long.rfind(c) middle block");
+	is_true(sv.rfind('z') == string_view::npos, "sv_long.rfind(c) missing");
+
+	is_true(sv.find("y.") == 40, "sv_long.find(str)");
+	is_true(sv.rfind(".x") == 96, "sv_long.rfind(str)");
+
+	is_true(sv.find_first_of("zy") == 40, "sv_long.find_first_of(str)");
+	is_true(sv.find_first_of("\xE9q") == 70, "sv_long.find_first_of(str) high bit");
+	is_true(sv.find_first_of("abcdefghijklmnopqrstuvwxyz", 41) == 97, "sv_long.find_first_of(str) large set");
+	is_true(sv.find_last_of("xy", 96) == 40, "sv_long.find_last_of(str)");
+	is_true(sv.find_last_of("abcdefghijklmnopqrstuvwxyz", 96) == 40, "sv_long.find_last_of(str) large set");
+
+	is_true(sv.find_first_not_of(".") == 5, "sv_long.find_first_not_of(str)");
+	is_true(sv.find_first_not_of(".x", 6) == 40, "sv_long.find_first_not_of(str, pos)");
+	is_true(sv.find_last_not_of(".") == 97, "sv_long.find_last_not_of(str)");
+	is_true(sv.find_last_not_of(".x") == 70, "sv_long.find_last_not_of(str) high bit");
+	is_true(sv.find_last_not_of(".xy\xE9") == string_view::npos, "sv_long.find_last_not_of(str) none");
+}
+
+
 void test_modifiers()
 {
 	string_view sv{ "hello, world!" };
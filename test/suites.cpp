@@ -87,9 +87,36 @@ START_SUITES_COLLECTION //same as void build_suites_collection() {
 	//add one line per test suite: macro parameter should be the name of a suite-runner function
 	//the semi-colon at the end of macro invocation is not required but its use make things look "authentic"
 
+	TEST_SUITE(aho_corasick_test);
+	TEST_SUITE(aligned_array_test);
 	TEST_SUITE(array_test);
+	TEST_SUITE(bit_vector_test);
+	TEST_SUITE(bitset_test);
+	TEST_SUITE(bloom_filter_test);
+	TEST_SUITE(compressed_sorted_array_test);
+	TEST_SUITE(cuckoo_filter_test);
 	TEST_SUITE(driver_test);
+	TEST_SUITE(flat_hash_map_test);
+	TEST_SUITE(flat_map_test);
+	TEST_SUITE(flat_set_test);
+	TEST_SUITE(mdarray_test);
+	TEST_SUITE(mdspan_test);
+	TEST_SUITE(memory_resource_test);
+	TEST_SUITE(mpmc_queue_test);
+	TEST_SUITE(packed_array_test);
+	TEST_SUITE(perfect_hash_map_test);
+	TEST_SUITE(search_index_test);
+	TEST_SUITE(search_test);
+	TEST_SUITE(slot_map_test);
+	TEST_SUITE(small_object_allocator_test);
+	TEST_SUITE(small_vector_test);
+	TEST_SUITE(soa_array_test);
+	TEST_SUITE(soa_vector_test);
+	TEST_SUITE(span_test);
+	TEST_SUITE(spsc_queue_test);
+	TEST_SUITE(static_vector_test);
 	TEST_SUITE(string_view_test);
+	TEST_SUITE(vector_test);
 
 // do not add/edit anything after this line
 END_SUITES_COLLECTION	// same as }
@@ -0,0 +1,301 @@
+/*
+* vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test vector template
+* - see C++17 [vector] https://timsong-cpp.github.io/cppwp/n4659/vector
+*/
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "../../include/array.h"
+#include "../../include/vector.h"
+
+#include "../verifiers.h"
+
+//allocator that does not compare equal to another instance unless ids match
+template<typename T>
+struct tagged_allocator
+{
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::false_type;
+	using is_always_equal = std::false_type;
+
+	int id{ 0 };
+
+	tagged_allocator() = default;
+	explicit tagged_allocator(int i) noexcept : id{ i } {}
+	template<typename U>
+	tagged_allocator(const tagged_allocator<U>& a) noexcept : id{ a.id } {}
+
+	T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+	void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+	template<typename U>
+	bool operator==(const tagged_allocator<U>& a) const noexcept { return id == a.id; }
+	template<typename U>
+	bool operator!=(const tagged_allocator<U>& a) const noexcept { return id != a.id; }
+};
+
+//allocator that propagates on copy assignment; each instance id tracks what it has
+//outstanding, so a buffer freed through the wrong instance unbalances two ids
+template<typename T>
+struct copying_allocator
+{
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using is_always_equal = std::false_type;
+
+	static inline std::ptrdiff_t outstanding[4]{};
+
+	int id{ 0 };
+
+	copying_allocator() = default;
+	explicit copying_allocator(int i) noexcept : id{ i } {}
+	template<typename U>
+	copying_allocator(const copying_allocator<U>& a) noexcept : id{ a.id } {}
+
+	T* allocate(std::size_t n)
+	{
+		outstanding[id] += static_cast<std::ptrdiff_t>(n);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		outstanding[id] -= static_cast<std::ptrdiff_t>(n);
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	template<typename U>
+	bool operator==(const copying_allocator<U>& a) const noexcept { return id == a.id; }
+	template<typename U>
+	bool operator!=(const copying_allocator<U>& a) const noexcept { return id != a.id; }
+};
+
+void vector_test()
+{
+	using sigcpp::vector;
+
+	//non-empty vector with init list
+	vector<short> s{ 8, -2, 7 };
+
+	//vector with count default-initialized elements
+	vector<short> p(5);
+
+	//empty vector
+	vector<short> e;
+
+
+	//capacity
+	is_false(s.empty(), "s.empty()");
+	is_true(s.size() == 3, "s.size()");
+	is_true(s.capacity() >= s.size(), "s.capacity()");
+	is_true(s.max_size() >= s.size(), "s.max_size()");
+
+	is_false(p.empty(), "p.empty()");
+	is_true(p.size() == 5, "p.size()");
+
+	is_true(e.empty(), "e.empty()");
+	is_true(e.size() == 0 && e.capacity() == 0, "e.capacity()");
+	is_true(e.data() == nullptr, "e.data()");
+
+
+	//element access
+	is_true(s[0] == 8, "s[0]");
+	is_true(s[1] == -2, "s[1]");
+	is_true(s[2] == 7, "s[2]");
+
+	is_true(p[0] == 0, "p[0]");
+	is_true(p[4] == 0, "p[4]");
+
+	is_true(s.at(0) == 8, "s.at(0)");
+	is_true(s.at(2) == 7, "s.at(2)");
+	is_true(s.front() == 8, "s.front()");
+	is_true(s.back() == 7, "s.back()");
+	is_true(*s.data() == 8, "s.data()");
+
+	bool thrown = false;
+	try {
+		s.at(3);
+	}
+	catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	is_true(thrown, "s.at(size())");
+
+
+	//iterators: same types as array
+	static_assert(std::is_same_v<vector<short>::iterator, sigcpp::array<short, 3>::iterator>);
+	static_assert(std::is_same_v<vector<short>::const_iterator, sigcpp::array<short, 3>::const_iterator>);
+
+	is_true(*s.begin() == 8, "*s.begin()");
+	is_true(*(s.end() - 1) == 7, "*(s.end() - 1)");
+	is_true(*s.rbegin() == 7, "*s.rbegin()");
+	is_true(*(s.rend() - 1) == 8, "*(s.rend() - 1)");
+	is_true(std::distance(s.cbegin(), s.cend()) == 3, "distance(s.cbegin(), s.cend())");
+	is_true(e.begin() == e.end(), "e.begin() == e.end()");
+
+
+	//modifiers
+	vector<int> v;
+	for (int i = 0; i < 1000; ++i)
+		v.push_back(i);
+	is_true(v.size() == 1000 && v[0] == 0 && v[999] == 999, "v.push_back()");
+
+	v.insert(v.begin() + 1, { 7, 8, 9 });
+	is_true(v.size() == 1003 && v[1] == 7 && v[3] == 9 && v[4] == 1, "v.insert(pos, il)");
+
+	v.erase(v.begin() + 1, v.begin() + 4);
+	is_true(v.size() == 1000 && v[1] == 1, "v.erase(first, last)");
+
+	v.insert(v.begin(), 2, -1);
+	is_true(v[0] == -1 && v[1] == -1 && v[2] == 0, "v.insert(pos, count, value)");
+
+	v.erase(v.begin());
+	v.erase(v.begin());
+	v.emplace(v.begin() + 500, 42);
+	is_true(v[500] == 42 && v[501] == 500, "v.emplace(pos, value)");
+	v.erase(v.begin() + 500);
+
+	v.pop_back();
+	is_true(v.size() == 999 && v.back() == 998, "v.pop_back()");
+
+	v.resize(3);
+	is_true(v.size() == 3 && v[2] == 2, "v.resize(3)");
+	v.resize(5, 9);
+	is_true(v.size() == 5 && v[4] == 9, "v.resize(5, 9)");
+
+	//an element of the vector itself as the argument while the buffer moves
+	v.shrink_to_fit();
+	v.push_back(v[0]);
+	is_true(v.back() == 0, "v.push_back(v[0]) with reallocation");
+	v.shrink_to_fit();
+	v.insert(v.begin(), v[5]);
+	is_true(v[0] == 0 && v.size() == 7, "v.insert(begin, v[5]) with reallocation");
+
+
+	//assign, fill ctor, and copy
+	vector<int> f(4, 3);
+	is_true(f.size() == 4 && std::count(f.begin(), f.end(), 3) == 4, "vector(4, 3)");
+	f.assign({ 1, 2 });
+	is_true(f.size() == 2 && f[1] == 2, "f.assign(il)");
+
+	vector<int> c{ f };
+	is_true(c == f && c.data() != f.data(), "vector(f)");
+
+
+	//swap and move: buffers change hands, elements stay put
+	vector<int> x{ 1, 2, 3 };
+	vector<int> y{ 4, 5 };
+	const int* xData = x.data();
+	x.swap(y);
+	is_true(y.data() == xData && y.size() == 3 && x.size() == 2, "x.swap(y)");
+	swap(x, y);
+	is_true(x.data() == xData, "swap(x, y)");
+
+	vector<int> m{ std::move(x) };
+	is_true(m.data() == xData && x.empty() && x.capacity() == 0, "move ctor steals buffer");
+	x = std::move(m);
+	is_true(x.data() == xData && m.empty(), "move assignment steals buffer");
+
+
+	//comparisons
+	vector<int> lo{ 1, 2, 3 };
+	vector<int> hi{ 1, 2, 4 };
+	vector<int> shorter{ 1, 2 };
+	is_true(lo == lo && lo != hi, "==, !=");
+	is_true(lo < hi && hi > lo && lo <= hi && hi >= lo, "<, >, <=, >=");
+	is_true(shorter < lo, "shorter < lo");
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	is_true((lo <=> hi) < 0, "lo <=> hi");
+#endif
+
+
+	//growth policy
+	using doubling = sigcpp::growth_factor<2, 1>;
+	static_assert(doubling::next_capacity(8, 9, 1000) == 16);
+	static_assert(doubling::next_capacity(0, 1, 1000) == 1);
+	static_assert(doubling::next_capacity(8, 40, 1000) == 40);
+	static_assert(doubling::next_capacity(600, 601, 1000) == 1000);
+	static_assert(sigcpp::default_growth::next_capacity(10, 11, 1000) == 15);
+
+	vector<int, std::allocator<int>, doubling> d;
+	std::size_t growths = 0;
+	for (int i = 0; i < 1024; ++i) {
+		const auto capacity = d.capacity();
+		d.push_back(i);
+		if (d.capacity() != capacity)
+			++growths;
+	}
+	is_true(d.capacity() == 1024 && growths == 11, "doubling growth");
+
+	vector<int, std::allocator<int>, doubling> g;
+	growths = 0;
+	for (std::size_t i = 0; i < 1024; ++i) {
+		const auto capacity = g.capacity();
+		g.resize(g.size() + 1);
+		if (g.capacity() != capacity)
+			++growths;
+	}
+	is_true(g.capacity() == 1024 && growths == 11, "resize follows growth policy");
+
+
+	//reserve and shrink_to_fit
+	vector<int> r;
+	r.reserve(100);
+	is_true(r.capacity() == 100 && r.empty(), "r.reserve(100)");
+	r.assign(50, 1);
+	r.reserve(10);
+	is_true(r.capacity() == 100, "r.reserve(10) does not shrink");
+	r.shrink_to_fit();
+	is_true(r.capacity() == 50 && r.size() == 50 && r[49] == 1, "r.shrink_to_fit()");
+	r.clear();
+	r.shrink_to_fit();
+	is_true(r.capacity() == 0 && r.data() == nullptr, "r.shrink_to_fit() when empty");
+
+
+	//non-trivial elements with an allocator
+	using tagged = tagged_allocator<std::string>;
+	vector<std::string, tagged> t{ { "alpha", "beta" }, tagged(1) };
+	t.push_back("a string long enough to need its own heap buffer");
+	t.insert(t.begin(), "gamma");
+	is_true(t.size() == 4 && t[0] == "gamma" && t[3][0] == 'a', "nontrivial insert");
+	t.erase(t.begin() + 1);
+	is_true(t.size() == 3 && t[1] == "beta", "nontrivial erase");
+	t.reserve(64);
+	t.shrink_to_fit();
+	is_true(t.capacity() == 3 && t[2][0] == 'a', "nontrivial shrink_to_fit");
+
+	//resize from an element of the vector itself across a reallocation
+	vector<std::string> a{ std::string(100, 'x'), "y" };
+	a.resize(50, a[0]);
+	is_true(a.size() == 50 && a[1] == "y" && a[49] == std::string(100, 'x'), "a.resize(50, a[0])");
+
+	//unequal allocator that does not propagate: elements move one at a time
+	vector<std::string, tagged> u{ tagged(2) };
+	u = std::move(t);
+	is_true(u.size() == 3 && u[0] == "gamma" && u.get_allocator().id == 2, "move assignment, unequal allocators");
+
+	//allocator that propagates on copy assignment: the target adopts it and frees its own buffer
+	{
+		using copying = copying_allocator<std::string>;
+		vector<std::string, copying> x{ { "one", "two", "three" }, copying(1) };
+		vector<std::string, copying> y{ { "four" }, copying(2) };
+		y = x;
+		is_true(y == x && y.get_allocator().id == 1, "copy assignment, allocator propagates");
+	}
+	is_true(copying_allocator<std::string>::outstanding[1] == 0 && copying_allocator<std::string>::outstanding[2] == 0,
+		"copy assignment, buffers freed by their allocators");
+}